@@ -29,6 +29,10 @@
 
 #include <stdexcept>
 
+#ifdef MARS_ALLOCATION_TRACKING
+  #include <mars/utils/AllocationHook.h>
+#endif
+
 
 void qtExitHandler(int sig) {
   mars::app::exit_main(sig);
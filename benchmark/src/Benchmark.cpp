@@ -0,0 +1,487 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file Benchmark.cpp
+ * \brief Implementation of the Benchmark.
+ */
+
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+#include "StateHash.h"
+
+#include <lib_manager/LibManager.hpp>
+#include <mars/interfaces/sim/ControlCenter.h>
+#include <mars/interfaces/sim/PhysicsInterface.h>
+#include <mars/interfaces/graphics/GraphicsManagerInterface.h>
+#include <mars/cfg_manager/CFGManagerInterface.h>
+#include <mars/utils/misc.h>
+#include <configmaps/ConfigData.h>
+
+#include <clocale>
+#include <cstdlib>
+
+#ifndef WIN32
+  #include <sys/resource.h>
+#endif
+
+namespace mars {
+  namespace benchmark {
+
+    using namespace interfaces;
+
+    namespace {
+
+      long getPeakRssKb() {
+#ifdef WIN32
+        return 0;
+#else
+        struct rusage usage;
+        if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+        // kilobytes on Linux
+        return usage.ru_maxrss;
+#endif
+      }
+
+      const char* getSolverName(const PhysicsInterface *physics) {
+        if(!physics->fast_step) return "world";
+        return physics->adaptive_iterations ? "adaptive" : "quick";
+      }
+
+      std::string escapeString(const std::string &s) {
+        std::string escaped;
+        for(size_t i=0; i<s.size(); ++i) {
+          if(s[i] == '"' || s[i] == '\\') escaped += '\\';
+          escaped += s[i];
+        }
+        return escaped;
+      }
+
+      double perStep(long long value, unsigned long steps) {
+        return steps ? (double)value / steps : 0.0;
+      }
+
+      const char* stageNames[] = {"sensors", "physics", "joints", "motors",
+                                  "controllers", "data_broker", "plugins",
+                                  "graphics", "total"};
+
+      void stageValues(StepTimes *times, long long *values[9]) {
+        values[0] = &times->sensors;
+        values[1] = &times->physics;
+        values[2] = &times->joints;
+        values[3] = &times->motors;
+        values[4] = &times->controllers;
+        values[5] = &times->dataBroker;
+        values[6] = &times->plugins;
+        values[7] = &times->graphics;
+        values[8] = &times->total;
+      }
+
+    } // end of anonymous namespace
+
+    Benchmark::Benchmark(const BenchmarkOptions &options)
+      : options(options), libManager(new lib_manager::LibManager()),
+        sim(NULL), control(NULL) {
+    }
+
+    Benchmark::~Benchmark() {
+      if(sim) {
+        sim->exitMars();
+        libManager->releaseLibrary("mars_sim");
+      }
+      if(options.graphics) libManager->releaseLibrary("mars_graphics");
+      libManager->releaseLibrary("cfg_manager");
+      delete libManager;
+    }
+
+    const std::vector<std::string>& Benchmark::getSceneNames() {
+      static std::vector<std::string> names;
+      if(names.empty()) {
+        names.push_back("box_stack");
+        names.push_back("robot_field");
+        names.push_back("legged_robot");
+        names.push_back("rover_heightmap");
+        names.push_back("rover_mls");
+        names.push_back("ray_sensor");
+        names.push_back("data_broker_fanout");
+        names.push_back("plot_stress");
+        names.push_back("obstacle_field");
+        names.push_back("joint_chain");
+        names.push_back("camera_readback");
+        names.push_back("draw_objects");
+        names.push_back("material_load");
+        names.push_back("viz_playback");
+        names.push_back("robot_graph");
+        names.push_back("mls_collision");
+      }
+      return names;
+    }
+
+    bool Benchmark::init() {
+#ifndef WIN32
+      // the scene files are written with '.' as decimal point
+      setenv("LC_ALL", "C", 1);
+      unsetenv("LANG");
+      setlocale(LC_ALL, "C");
+#endif
+
+      libManager->loadLibrary("cfg_manager");
+      cfg_manager::CFGManagerInterface *cfg;
+      cfg = libManager->getLibraryAs<cfg_manager::CFGManagerInterface>("cfg_manager");
+      if(cfg) {
+        cfg->getOrCreateProperty("Config", "config_path", options.configDir);
+        // created before the simulation, thus the simulation uses them
+        cfg->getOrCreateProperty("Simulator", "plugin threads",
+                                 options.pluginThreads);
+        cfg->getOrCreateProperty("Simulator", "deterministic",
+                                 options.deterministic);
+        cfg->getOrCreateProperty("Simulator", "random seed",
+                                 (int)options.seed);
+      }
+
+      loadLibraries();
+      sim = libManager->getLibraryAs<SimulatorInterface>("mars_sim");
+      if(!sim) {
+        fprintf(stderr, "mars_benchmark: could not load mars_sim\n");
+        return false;
+      }
+      control = sim->getControlCenter();
+      if(options.graphics) {
+        if(!control->graphics) {
+          fprintf(stderr, "mars_benchmark: could not load mars_graphics\n");
+          return false;
+        }
+        control->graphics->initializeOSG(NULL, false);
+      }
+      return true;
+    }
+
+    void Benchmark::loadLibraries() {
+      if(!options.libsFile.empty()) {
+        libManager->loadConfigFile(options.libsFile);
+        return;
+      }
+      // the libraries of the application without gui
+      libManager->loadLibrary("data_broker");
+      if(options.graphics) libManager->loadLibrary("mars_graphics");
+      libManager->loadLibrary("mars_sim");
+      libManager->loadLibrary("mars_entity_factory", NULL, true);
+      libManager->loadLibrary("mars_scene_loader", NULL, true);
+      libManager->loadLibrary("envire_smurf_loader", NULL, true);
+      libManager->loadLibrary("envire_physics", NULL, true);
+      libManager->loadLibrary("envire_joints", NULL, true);
+      libManager->loadLibrary("envire_motors", NULL, true);
+      libManager->loadLibrary("envire_sensors", NULL, true);
+    }
+
+    void Benchmark::runScene(const std::string &name, SceneResult *result) {
+      result->name = name;
+      result->skipped = true;
+      result->graphics = options.graphics;
+      BenchmarkScene *scene = BenchmarkScene::create(name, options,
+                                                     libManager);
+      if(!scene) {
+        result->reason = "unknown scene";
+        return;
+      }
+
+      scene->prepare(control);
+      sim->runSimulation(false);
+      // set after the start, otherwise the config files would override it
+      if(!options.solver.empty() && control->cfg) {
+        control->cfg->setPropertyValue("Simulator", "faststep", "value",
+                                       options.solver != "world");
+        control->cfg->setPropertyValue("Simulator", "adaptive iterations",
+                                       "value", options.solver == "adaptive");
+      }
+      long long buildTime = utils::getTimeMicro();
+      bool built = scene->build(control, &result->reason);
+      result->buildSeconds = (utils::getTimeMicro() - buildTime)*1e-6;
+      // scenes may change the step size
+      result->calcMs = sim->getCalcMs();
+      if(!built) {
+        result->model = scene->getModel();
+        scene->cleanup(control);
+        delete scene;
+        return;
+      }
+      result->model = scene->getModel();
+      PhysicsInterface *physics = sim->getPhysics();
+      result->solver = getSolverName(physics);
+
+      FILE *hashFile = NULL;
+      if(!options.hashFile.empty()) {
+        hashFile = fopen(options.hashFile.c_str(), "w");
+        if(!hashFile) {
+          result->reason = "could not write " + options.hashFile;
+          scene->cleanup(control);
+          delete scene;
+          return;
+        }
+      }
+      unsigned long step = 0;
+
+      double time = 0.0;
+      for(unsigned long i=0; i<options.warmup; ++i) {
+        scene->update(control, time);
+        sim->step();
+        if(control->graphics) control->graphics->draw();
+        time += result->calcMs*0.001;
+        if(hashFile) {
+          fprintf(hashFile, "%lu %016llx\n", step++,
+                  computeStateHash(control));
+        }
+      }
+
+      StepTimes times;
+      sim->getStepTimes(&times, true);
+      utils::AllocationStats startCount;
+      utils::AllocationTracker::getStats(&startCount);
+      long long startTime = utils::getTimeMicro();
+      double constraintError = 0.0, iterations = 0.0;
+      for(unsigned long i=0; i<options.steps; ++i) {
+        scene->update(control, time);
+        sim->step();
+        if(control->graphics) control->graphics->draw();
+        time += result->calcMs*0.001;
+        double error = physics->getConstraintError();
+        constraintError += error;
+        if(error > result->maxConstraintError) {
+          result->maxConstraintError = error;
+        }
+        iterations += physics->getSolverIterations();
+        if(hashFile) {
+          fprintf(hashFile, "%lu %016llx\n", step++,
+                  computeStateHash(control));
+        }
+      }
+      long long duration = utils::getTimeMicro() - startTime;
+      utils::AllocationStats endCount;
+      utils::AllocationTracker::getStats(&endCount);
+      sim->getStepTimes(&result->times, true);
+
+      result->skipped = false;
+      result->steps = options.steps;
+      result->seconds = duration*1e-6;
+      result->stepsPerSecond = duration > 0 ? options.steps/result->seconds : 0.0;
+      result->allocations = endCount - startCount;
+      result->allocationsPerStep = perStep(result->allocations.getTotalCount(),
+                                           options.steps);
+      result->bytesPerStep = perStep(result->allocations.getTotalBytes(),
+                                     options.steps);
+      result->peakRssKb = getPeakRssKb();
+      if(options.steps) {
+        result->constraintError = constraintError / options.steps;
+        result->solverIterations = iterations / options.steps;
+      }
+      if(hashFile) fclose(hashFile);
+
+      if(!scene->check(control, &result->reason)) result->failed = true;
+      scene->cleanup(control);
+      delete scene;
+    }
+
+    void writeResult(FILE *file, const SceneResult &result,
+                     const std::string &indent) {
+      const char *in = indent.c_str();
+      fprintf(file, "%s{\n", in);
+      fprintf(file, "%s  \"name\": \"%s\",\n", in,
+              escapeString(result.name).c_str());
+      fprintf(file, "%s  \"model\": \"%s\",\n", in,
+              escapeString(result.model).c_str());
+      fprintf(file, "%s  \"skipped\": %s,\n", in,
+              result.skipped ? "true" : "false");
+      fprintf(file, "%s  \"failed\": %s,\n", in,
+              result.failed ? "true" : "false");
+      fprintf(file, "%s  \"reason\": \"%s\",\n", in,
+              escapeString(result.reason).c_str());
+      fprintf(file, "%s  \"solver\": \"%s\",\n", in,
+              escapeString(result.solver).c_str());
+      fprintf(file, "%s  \"graphics\": %s,\n", in,
+              result.graphics ? "true" : "false");
+      fprintf(file, "%s  \"steps\": %lu,\n", in, result.steps);
+      fprintf(file, "%s  \"calc_ms\": %.6f,\n", in, result.calcMs);
+      fprintf(file, "%s  \"build_seconds\": %.6f,\n", in,
+              result.buildSeconds);
+      fprintf(file, "%s  \"seconds\": %.6f,\n", in, result.seconds);
+      fprintf(file, "%s  \"steps_per_second\": %.6f,\n", in,
+              result.stepsPerSecond);
+      fprintf(file, "%s  \"stage_us_per_step\": {\n", in);
+      StepTimes times = result.times;
+      long long *values[9];
+      stageValues(&times, values);
+      for(int i=0; i<9; ++i) {
+        fprintf(file, "%s    \"%s\": %.6f%s\n", in, stageNames[i],
+                perStep(*values[i], times.steps), i < 8 ? "," : "");
+      }
+      fprintf(file, "%s  },\n", in);
+      fprintf(file, "%s  \"allocations_per_step\": %.6f,\n", in,
+              result.allocationsPerStep);
+      fprintf(file, "%s  \"allocated_bytes_per_step\": %.6f,\n", in,
+              result.bytesPerStep);
+      fprintf(file, "%s  \"allocations_by_tag\": {\n", in);
+      for(int i=0; i<utils::ALLOCATION_TAG_COUNT; ++i) {
+        utils::AllocationTag tag = (utils::AllocationTag)i;
+        fprintf(file, "%s    \"%s\": {\"count\": %.6f, \"bytes\": %.6f}%s\n",
+                in, utils::AllocationTracker::getTagName(tag),
+                perStep(result.allocations.count[i], result.steps),
+                perStep(result.allocations.bytes[i], result.steps),
+                i+1 < utils::ALLOCATION_TAG_COUNT ? "," : "");
+      }
+      fprintf(file, "%s  },\n", in);
+      fprintf(file, "%s  \"constraint_error\": %.9f,\n", in,
+              result.constraintError);
+      fprintf(file, "%s  \"max_constraint_error\": %.9f,\n", in,
+              result.maxConstraintError);
+      fprintf(file, "%s  \"solver_iterations\": %.6f,\n", in,
+              result.solverIterations);
+      fprintf(file, "%s  \"peak_rss_kb\": %ld\n", in, result.peakRssKb);
+      fprintf(file, "%s}", in);
+    }
+
+    void writeResults(FILE *file, const std::vector<SceneResult> &results,
+                      const std::vector<Regression> &regressions,
+                      const BenchmarkOptions &options) {
+      fprintf(file, "{\n");
+      fprintf(file, "  \"benchmark\": \"mars_benchmark\",\n");
+      fprintf(file, "  \"version\": 1,\n");
+      fprintf(file, "  \"tolerance\": %.6f,\n", options.tolerance);
+      fprintf(file, "  \"scenes\": [\n");
+      for(size_t i=0; i<results.size(); ++i) {
+        writeResult(file, results[i], "    ");
+        fprintf(file, "%s\n", i+1 < results.size() ? "," : "");
+      }
+      fprintf(file, "  ],\n");
+      fprintf(file, "  \"regressions\": [\n");
+      for(size_t i=0; i<regressions.size(); ++i) {
+        fprintf(file, "    {\"scene\": \"%s\", \"metric\": \"%s\", "
+                "\"baseline\": %.6f, \"value\": %.6f}%s\n",
+                escapeString(regressions[i].scene).c_str(),
+                regressions[i].metric.c_str(), regressions[i].baseline,
+                regressions[i].value, i+1 < regressions.size() ? "," : "");
+      }
+      fprintf(file, "  ]\n");
+      fprintf(file, "}\n");
+    }
+
+    namespace {
+
+      void readResult(configmaps::ConfigMap &map, SceneResult *result) {
+        result->name = (std::string)map["name"];
+        result->model = (std::string)map["model"];
+        result->skipped = map["skipped"];
+        result->reason = (std::string)map["reason"];
+        result->steps = map["steps"];
+        result->calcMs = map["calc_ms"];
+        result->seconds = map["seconds"];
+        result->stepsPerSecond = map["steps_per_second"];
+        result->allocationsPerStep = map["allocations_per_step"];
+        result->bytesPerStep = map["allocated_bytes_per_step"];
+        result->peakRssKb = (int)map["peak_rss_kb"];
+        // not written by older versions
+        if(map.hasKey("solver")) {
+          result->solver = (std::string)map["solver"];
+          result->constraintError = map["constraint_error"];
+          result->maxConstraintError = map["max_constraint_error"];
+          result->solverIterations = map["solver_iterations"];
+        }
+        if(map.hasKey("failed")) {
+          result->failed = map["failed"];
+        }
+        if(map.hasKey("build_seconds")) {
+          result->buildSeconds = map["build_seconds"];
+          result->graphics = map["graphics"];
+        }
+        // the stage times and allocations by tag are only reported
+      }
+
+    } // end of anonymous namespace
+
+    bool readResults(const std::string &filename,
+                     std::vector<SceneResult> *results) {
+      if(!utils::pathExists(filename)) return false;
+      // JSON is read as YAML
+      configmaps::ConfigMap map = configmaps::ConfigMap::fromYamlFile(filename);
+      if(map.hasKey("scenes")) {
+        configmaps::ConfigVector::iterator it;
+        for(it=map["scenes"].begin(); it!=map["scenes"].end(); ++it) {
+          SceneResult result;
+          readResult(*it, &result);
+          results->push_back(result);
+        }
+      } else if(map.hasKey("name")) {
+        SceneResult result;
+        readResult(map, &result);
+        results->push_back(result);
+      } else {
+        return false;
+      }
+      return true;
+    }
+
+    void compareResults(const std::vector<SceneResult> &results,
+                        const std::vector<SceneResult> &baseline,
+                        double tolerance,
+                        std::vector<Regression> *regressions) {
+      for(size_t i=0; i<results.size(); ++i) {
+        const SceneResult &r = results[i];
+        if(r.skipped) continue;
+        for(size_t k=0; k<baseline.size(); ++k) {
+          const SceneResult &b = baseline[k];
+          if(b.name != r.name || b.model != r.model || b.skipped) continue;
+          if(!b.solver.empty() && b.solver != r.solver) continue;
+          if(b.graphics != r.graphics) continue;
+          Regression regression;
+          // a scene may be run with several solvers
+          regression.scene = r.name;
+          if(!r.solver.empty()) regression.scene += "/" + r.solver;
+          if(r.stepsPerSecond < b.stepsPerSecond*(1.0-tolerance)) {
+            regression.metric = "steps_per_second";
+            regression.baseline = b.stepsPerSecond;
+            regression.value = r.stepsPerSecond;
+            regressions->push_back(regression);
+          }
+          // one allocation per step of slack for scenes without any
+          if(r.allocationsPerStep > b.allocationsPerStep*(1.0+tolerance)+1.0) {
+            regression.metric = "allocations_per_step";
+            regression.baseline = b.allocationsPerStep;
+            regression.value = r.allocationsPerStep;
+            regressions->push_back(regression);
+          }
+          // 10 ms of slack for scenes that are built instantly
+          if(r.buildSeconds > b.buildSeconds*(1.0+tolerance)+0.01) {
+            regression.metric = "build_seconds";
+            regression.baseline = b.buildSeconds;
+            regression.value = r.buildSeconds;
+            regressions->push_back(regression);
+          }
+          if(r.peakRssKb > b.peakRssKb*(1.0+tolerance)) {
+            regression.metric = "peak_rss_kb";
+            regression.baseline = b.peakRssKb;
+            regression.value = r.peakRssKb;
+            regressions->push_back(regression);
+          }
+          break;
+        }
+      }
+    }
+
+  } // end of namespace benchmark
+} // end of namespace mars
@@ -0,0 +1,180 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file Benchmark.h
+ * \brief Runs the benchmark scenes and compares their results against
+ * a stored baseline.
+ */
+
+#ifndef MARS_BENCHMARK_BENCHMARK_H
+#define MARS_BENCHMARK_BENCHMARK_H
+
+#ifdef _PRINT_HEADER_
+  #warning "Benchmark.h"
+#endif
+
+#include <mars/interfaces/sim/SimulatorInterface.h>
+#include <mars/utils/AllocationTracker.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef DEFAULT_CONFIG_DIR
+    #define DEFAULT_CONFIG_DIR "."
+#endif
+
+namespace lib_manager {
+  class LibManager;
+}
+
+namespace mars {
+
+  namespace interfaces {
+    class ControlCenter;
+  }
+
+  namespace benchmark {
+
+    struct BenchmarkOptions {
+      BenchmarkOptions() : configDir(DEFAULT_CONFIG_DIR), steps(2000),
+                           warmup(200), robots(16), receivers(100),
+                           tolerance(0.1), pluginThreads(0),
+                           deterministic(false), seed(0), graphics(false) {}
+      std::string configDir;
+      //! optional lib_manager config file, the default libraries otherwise
+      std::string libsFile;
+      //! optional SMURF robot for the legged scene
+      std::string smurfFile;
+      //! map file or tile directory for the MLS scene
+      std::string mlsFile;
+      //! scene of the viz playback scene, should have 50 or more joints
+      std::string vizFile;
+      unsigned long steps, warmup;
+      int robots, receivers;
+      //! relative tolerance of the baseline comparison
+      double tolerance;
+      //! "Simulator/plugin threads"
+      int pluginThreads;
+      //! "Simulator/deterministic" and "Simulator/random seed"
+      bool deterministic;
+      unsigned long seed;
+      //! if set, the state hash of every step is written to this file
+      std::string hashFile;
+      //! "world", "quick" or "adaptive", the configured solver if empty
+      std::string solver;
+      //! load mars_graphics without window and draw a frame every step
+      bool graphics;
+    };
+
+    struct SceneResult {
+      SceneResult() : skipped(true), failed(false), graphics(false),
+                      steps(0), calcMs(0.0),
+                      buildSeconds(0.0), seconds(0.0),
+                      stepsPerSecond(0.0), allocationsPerStep(0.0),
+                      bytesPerStep(0.0), peakRssKb(0),
+                      constraintError(0.0), maxConstraintError(0.0),
+                      solverIterations(0.0) {}
+      std::string name;
+      //! "builtin" or the loaded file; only equal models are compared
+      std::string model;
+      bool skipped;
+      //! the check of the scene failed, see reason
+      bool failed;
+      std::string reason;
+      //! drawn with --graphics, only results with equal mode are compared
+      bool graphics;
+      unsigned long steps;
+      double calcMs;
+      //! time to create the scene, e.g. the load time of the materials
+      double buildSeconds;
+      double seconds, stepsPerSecond;
+      interfaces::StepTimes times;
+      double allocationsPerStep, bytesPerStep;
+      //! allocations of all measured steps by subsystem
+      utils::AllocationStats allocations;
+      long peakRssKb;
+      //! the solver the scene ran with, see BenchmarkOptions::solver
+      std::string solver;
+      //! joint constraint error (m), mean and maximum of the measured steps
+      double constraintError, maxConstraintError;
+      //! mean iterations of the iterative solver, 0 for dWorldStep
+      double solverIterations;
+    };
+
+    struct Regression {
+      std::string scene, metric;
+      double baseline, value;
+    };
+
+    /**
+     * \brief Builds one scene through the simulation managers and measures
+     * the simulation steps.
+     *
+     * The simulation is started without its thread and by default without
+     * graphics, the steps are called from the benchmark. The peak RSS covers the
+     * whole process, thus every scene should run in its own process.
+     */
+    class Benchmark {
+    public:
+      Benchmark(const BenchmarkOptions &options);
+      ~Benchmark();
+
+      /** \return false if the simulation libraries could not be loaded */
+      bool init();
+      void runScene(const std::string &name, SceneResult *result);
+
+      static const std::vector<std::string>& getSceneNames();
+
+    private:
+      BenchmarkOptions options;
+      lib_manager::LibManager *libManager;
+      interfaces::SimulatorInterface *sim;
+      interfaces::ControlCenter *control;
+
+      void loadLibraries();
+
+    }; // end of class Benchmark
+
+    void writeResult(FILE *file, const SceneResult &result,
+                     const std::string &indent);
+    void writeResults(FILE *file, const std::vector<SceneResult> &results,
+                      const std::vector<Regression> &regressions,
+                      const BenchmarkOptions &options);
+
+    /** Reads a file written by writeResult or writeResults. */
+    bool readResults(const std::string &filename,
+                     std::vector<SceneResult> *results);
+
+    /**
+     * Compares the steps per second, allocations per step, build time and
+     * peak RSS of \a results with \a baseline. Skipped scenes and scenes
+     * with a different model, solver or graphics mode are not compared.
+     */
+    void compareResults(const std::vector<SceneResult> &results,
+                        const std::vector<SceneResult> &baseline,
+                        double tolerance,
+                        std::vector<Regression> *regressions);
+
+  } // end of namespace benchmark
+} // end of namespace mars
+
+#endif // MARS_BENCHMARK_BENCHMARK_H
@@ -0,0 +1,1129 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file BenchmarkScenes.cpp
+ * \brief Implementation of the benchmark scenes.
+ */
+
+#include "BenchmarkScenes.h"
+
+#include <mars/interfaces/sim/ControlCenter.h>
+#include <mars/interfaces/sim/SimulatorInterface.h>
+#include <mars/interfaces/sim/NodeManagerInterface.h>
+#include <mars/interfaces/sim/JointManagerInterface.h>
+#include <mars/interfaces/sim/MotorManagerInterface.h>
+#include <mars/interfaces/sim/SensorManagerInterface.h>
+#include <mars/interfaces/sim/PluginInterface.h>
+#include <mars/interfaces/graphics/GraphicsManagerInterface.h>
+#include <mars/interfaces/NodeData.h>
+#include <mars/interfaces/JointData.h>
+#include <mars/interfaces/MotorData.h>
+#include <mars/interfaces/terrainStruct.h>
+#include <mars/interfaces/core_objects_exchange.h>
+#include <mars/utils/mathUtils.h>
+#include <mars/utils/misc.h>
+#include <mars/utils/PlotSeries.h>
+#include <mars/cfg_manager/CFGManagerInterface.h>
+#include <mars/sim/CameraSensor.h>
+#include <mars/sim/NodePhysics.h>
+#include <mars/sim/WorldPhysics.h>
+#include <mars/sim/mlsfield.h>
+#include <mars/utils/MutexLocker.h>
+#include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/data_broker/ReceiverInterface.h>
+#include <mars/data_broker/DataPackage.h>
+#include <configmaps/ConfigData.h>
+#include <lib_manager/LibManager.hpp>
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/items/Item.hpp>
+#include <envire_core/items/Transform.hpp>
+
+#ifdef HAVE_ENVIRE_MLS
+#include <mars/plugins/envire_mls/EnvireMls.hpp>
+#endif
+
+#ifdef HAVE_MARS_VIZ
+#include <mars/viz/Viz.h>
+#endif
+
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace mars {
+  namespace benchmark {
+
+    using namespace interfaces;
+    using namespace utils;
+
+    namespace {
+
+      // a fixed sequence of pseudo random numbers that does not depend
+      // on the platform's rand()
+      class SceneRandom {
+      public:
+        SceneRandom(unsigned long seed) : state(seed) {}
+        // uniform in [min, max)
+        double uniform(double min, double max) {
+          state = state * 1103515245UL + 12345UL;
+          double r = ((state >> 16) & 0x7fff) / 32768.0;
+          return min + r*(max-min);
+        }
+      private:
+        unsigned long state;
+      };
+
+      std::string indexedName(const std::string &prefix, int index) {
+        std::stringstream s;
+        s << prefix << index;
+        return s.str();
+      }
+
+      NodeId addBox(ControlCenter *control, const std::string &name,
+                    const Vector &pos, const Vector &ext, sReal mass,
+                    bool movable) {
+        NodeData node(name, pos);
+        node.initPrimitive(NODE_TYPE_BOX, ext, mass);
+        node.movable = movable;
+        return control->nodes->addNode(&node);
+      }
+
+      NodeId addGround(ControlCenter *control) {
+        return addBox(control, "ground", Vector(0.0, 0.0, -0.5),
+                      Vector(200.0, 200.0, 1.0), 1.0, false);
+      }
+
+      unsigned long addHinge(ControlCenter *control, const std::string &name,
+                             NodeId node1, NodeId node2,
+                             const Vector &anchor, const Vector &axis) {
+        JointData joint(name, JOINT_TYPE_HINGE, node1, node2);
+        joint.anchorPos = ANCHOR_CUSTOM;
+        joint.anchor = anchor;
+        joint.axis1 = axis;
+        return control->joints->addJoint(&joint);
+      }
+
+      unsigned long addMotor(ControlCenter *control, const std::string &name,
+                             unsigned long jointId, MotorType type) {
+        MotorData motor(name, type);
+        motor.jointIndex = jointId;
+        motor.axis = 1;
+        motor.maxSpeed = 10.0;
+        motor.maxEffort = 20.0;
+        motor.p = 10.0;
+        motor.d = 0.1;
+        return control->motors->addMotor(&motor);
+      }
+
+      /**
+       * A box chassis with four wheels driven by velocity motors.
+       * \return the id of the chassis
+       */
+      NodeId addRover(ControlCenter *control, const std::string &name,
+                      const Vector &pos, sReal speed) {
+        NodeId chassis = addBox(control, name + "_chassis", pos,
+                                Vector(0.6, 0.4, 0.15), 10.0, true);
+        // the cylinder axis is z, the wheels turn around y
+        Quaternion wheelRot = eulerToQuaternion(Vector(90.0, 0.0, 0.0));
+        const double x[4] = {0.2, 0.2, -0.2, -0.2};
+        const double y[4] = {0.25, -0.25, 0.25, -0.25};
+        for(int i=0; i<4; ++i) {
+          Vector wheelPos = pos + Vector(x[i], y[i], -0.05);
+          NodeData wheel(indexedName(name + "_wheel", i), wheelPos, wheelRot);
+          wheel.initPrimitive(NODE_TYPE_CYLINDER, Vector(0.1, 0.06, 0.0), 1.0);
+          wheel.movable = true;
+          NodeId wheelId = control->nodes->addNode(&wheel);
+          unsigned long joint = addHinge(control, indexedName(name + "_axle", i),
+                                         chassis, wheelId, wheelPos,
+                                         Vector(0.0, 1.0, 0.0));
+          unsigned long motor = addMotor(control,
+                                         indexedName(name + "_motor", i),
+                                         joint, MOTOR_TYPE_VELOCITY);
+          control->motors->setMotorValue(motor, speed);
+        }
+        return chassis;
+      }
+
+      /** Moves every position motor of the simulation on a sine curve. */
+      void swingMotors(ControlCenter *control, double time) {
+        std::vector<core_objects_exchange> motors;
+        control->motors->getListMotors(&motors);
+        for(size_t i=0; i<motors.size(); ++i) {
+          double phase = (i % 2) ? M_PI : 0.0;
+          control->motors->setMotorValue(motors[i].index,
+                                         0.4*sin(2.0*M_PI*time + phase));
+        }
+      }
+
+    } // end of anonymous namespace
+
+    /** 8 x 8 columns of 8 boxes that collapse onto the ground. */
+    class BoxStackScene : public BenchmarkScene {
+    public:
+      BoxStackScene(const BenchmarkOptions &options,
+                    lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        addGround(control);
+        SceneRandom random(1);
+        for(int x=0; x<8; ++x) {
+          for(int y=0; y<8; ++y) {
+            for(int z=0; z<8; ++z) {
+              // small offsets make the columns topple reproducibly
+              Vector pos(x*1.0 + random.uniform(-0.05, 0.05),
+                         y*1.0 + random.uniform(-0.05, 0.05),
+                         0.21 + z*0.41);
+              addBox(control, indexedName("box", (x*8+y)*8+z), pos,
+                     Vector(0.4, 0.4, 0.4), 1.0, true);
+            }
+          }
+        }
+        return true;
+      }
+    }; // end of class BoxStackScene
+
+    /** A grid of rovers driving on flat ground. */
+    class RobotFieldScene : public BenchmarkScene {
+    public:
+      RobotFieldScene(const BenchmarkOptions &options,
+                      lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        addGround(control);
+        int columns = (int)ceil(sqrt((double)options.robots));
+        for(int i=0; i<options.robots; ++i) {
+          Vector pos((i % columns)*2.0, (i / columns)*2.0, 0.3);
+          addRover(control, indexedName("rover", i), pos, 2.0 + 0.1*(i % 5));
+        }
+        return true;
+      }
+    }; // end of class RobotFieldScene
+
+    /**
+     * A walking robot loaded from a SMURF file. Without file a built in
+     * quadruped with two joints per leg is used.
+     */
+    class LeggedRobotScene : public BenchmarkScene {
+    public:
+      LeggedRobotScene(const BenchmarkOptions &options,
+                       lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        addGround(control);
+        if(!options.smurfFile.empty()) {
+          model = options.smurfFile;
+          if(!control->sim->loadScene(options.smurfFile, false,
+                                      "benchmark_robot")) {
+            *reason = "could not load " + options.smurfFile;
+            return false;
+          }
+          return true;
+        }
+
+        Vector bodyPos(0.0, 0.0, 0.6);
+        NodeId body = addBox(control, "body", bodyPos,
+                             Vector(0.6, 0.3, 0.1), 8.0, true);
+        const double x[4] = {0.25, 0.25, -0.25, -0.25};
+        const double y[4] = {0.2, -0.2, 0.2, -0.2};
+        for(int i=0; i<4; ++i) {
+          Vector hip = bodyPos + Vector(x[i], y[i], 0.0);
+          Vector knee = hip + Vector(0.0, 0.0, -0.25);
+          NodeId upper = addBox(control, indexedName("upper_leg", i),
+                                hip + Vector(0.0, 0.0, -0.125),
+                                Vector(0.05, 0.05, 0.25), 0.5, true);
+          NodeId lower = addBox(control, indexedName("lower_leg", i),
+                                knee + Vector(0.0, 0.0, -0.125),
+                                Vector(0.04, 0.04, 0.25), 0.3, true);
+          unsigned long hipJoint = addHinge(control, indexedName("hip", i),
+                                            body, upper, hip,
+                                            Vector(0.0, 1.0, 0.0));
+          unsigned long kneeJoint = addHinge(control, indexedName("knee", i),
+                                             upper, lower, knee,
+                                             Vector(0.0, 1.0, 0.0));
+          addMotor(control, indexedName("hip_motor", i), hipJoint,
+                   MOTOR_TYPE_POSITION);
+          addMotor(control, indexedName("knee_motor", i), kneeJoint,
+                   MOTOR_TYPE_POSITION);
+        }
+        return true;
+      }
+
+      void update(ControlCenter *control, double time) {
+        swingMotors(control, time);
+      }
+    }; // end of class LeggedRobotScene
+
+    /** A rover on a generated height map. */
+    class HeightmapRoverScene : public BenchmarkScene {
+    public:
+      HeightmapRoverScene(const BenchmarkOptions &options,
+                          lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        terrainStruct terrain;
+        terrain.name = "heightmap";
+        terrain.srcname = "benchmark";
+        terrain.width = terrain.height = 257;
+        terrain.targetWidth = terrain.targetHeight = 64.0;
+        terrain.scale = 2.0;
+        // released by the node, see SimNode
+        terrain.pixelData = (double*)calloc(terrain.width*terrain.height,
+                                            sizeof(double));
+        SceneRandom random(2);
+        for(int y=0; y<terrain.height; ++y) {
+          for(int x=0; x<terrain.width; ++x) {
+            terrain.pixelData[y*terrain.width+x] =
+              0.5 + 0.2*sin(x*0.15)*cos(y*0.1) + random.uniform(-0.02, 0.02);
+          }
+        }
+        control->nodes->addTerrain(&terrain);
+        addRover(control, "rover", Vector(0.0, 0.0, terrain.scale + 0.3), 2.0);
+        return true;
+      }
+    }; // end of class HeightmapRoverScene
+
+    /** A rover on the MLS map given with --mls. */
+    class MlsRoverScene : public BenchmarkScene {
+    public:
+      MlsRoverScene(const BenchmarkOptions &options,
+                    lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+#ifdef HAVE_ENVIRE_MLS
+        if(options.mlsFile.empty()) {
+          *reason = "no MLS map given";
+          return false;
+        }
+        model = options.mlsFile;
+        plugins::envire_mls::EnvireMls *mls;
+        mls = libManager->getLibraryAs<plugins::envire_mls::EnvireMls>("envire_mls");
+        if(!mls) {
+          libManager->loadLibrary("envire_mls");
+          mls = libManager->getLibraryAs<plugins::envire_mls::EnvireMls>("envire_mls");
+        }
+        if(!mls) {
+          *reason = "envire_mls is not available";
+          return false;
+        }
+        mls->addMLS("center", options.mlsFile);
+        // the map is loaded in the background and added in the plugin update
+        for(int i=0; i<30000 && mls->isLoading(); ++i) {
+          control->sim->step();
+          msleep(1);
+        }
+        if(mls->isLoading()) {
+          *reason = "timeout while loading " + options.mlsFile;
+          return false;
+        }
+        addRover(control, "rover", Vector(0.0, 0.0, 1.0), 2.0);
+        return true;
+#else
+        *reason = "built without envire_mls";
+        return false;
+#endif
+      }
+    }; // end of class MlsRoverScene
+
+    /** A static 64 beam lidar in a field of obstacles. */
+    class RaySensorScene : public BenchmarkScene {
+    public:
+      RaySensorScene(const BenchmarkOptions &options,
+                     lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        addGround(control);
+        SceneRandom random(3);
+        for(int i=0; i<100; ++i) {
+          double angle = random.uniform(0.0, 2.0*M_PI);
+          double distance = random.uniform(2.0, 30.0);
+          Vector ext(random.uniform(0.2, 2.0), random.uniform(0.2, 2.0),
+                     random.uniform(0.2, 3.0));
+          addBox(control, indexedName("obstacle", i),
+                 Vector(cos(angle)*distance, sin(angle)*distance, ext.z()*0.5),
+                 ext, 1.0, false);
+        }
+
+        envire::core::Transform tf;
+        tf.transform.translation << 0.0, 0.0, 1.0;
+        tf.transform.orientation = base::Quaterniond::Identity();
+        control->graph->addTransform("center", "benchmark_lidar", tf);
+
+        configmaps::ConfigMap config;
+        config["type"] = "RotatingRaySensor";
+        config["name"] = "lidar64";
+        config["frame"] = "benchmark_lidar";
+        config["lasers"] = 64;
+        config["bands"] = 4;
+        config["max_distance"] = 50.0;
+        config["rate"] = 10;
+        config["draw_rays"] = false;
+        BaseSensor *sensor = control->sensors->createAndAddSensor(&config);
+        if(!sensor) {
+          *reason = "could not create the RotatingRaySensor";
+          return false;
+        }
+        // the sensor is demand driven and needs a consumer to be updated
+        control->sensors->addSensorConsumer(sensor->getID());
+        return true;
+      }
+    }; // end of class RaySensorScene
+
+    /** Pushes a package of 64 values every step. */
+    class FanoutProducer : public PluginInterface {
+    public:
+      FanoutProducer(ControlCenter *control)
+        : PluginInterface(control), dataId(0) {
+        for(int i=0; i<64; ++i) {
+          package.add(indexedName("value", i), 0.0);
+        }
+      }
+
+      void init() {
+        dataId = control->dataBroker->pushData("benchmark", "fanout", package,
+                                               NULL,
+                                               data_broker::DATA_PACKAGE_READ_FLAG);
+      }
+      void reset() {}
+      void update(sReal time_ms) {
+        for(size_t i=0; i<package.size(); ++i) {
+          package[i].d += time_ms;
+        }
+        control->dataBroker->pushData(dataId, package);
+      }
+
+    private:
+      data_broker::DataPackage package;
+      unsigned long dataId;
+    }; // end of class FanoutProducer
+
+    class FanoutReceiver : public data_broker::ReceiverInterface {
+    public:
+      FanoutReceiver() : received(0) {}
+      void receiveData(const data_broker::DataInfo &info,
+                       const data_broker::DataPackage &package,
+                       int callbackParam) {
+        ++received;
+      }
+      unsigned long received;
+    }; // end of class FanoutReceiver
+
+    /** One producer plugin and many synchronous receivers. */
+    class FanoutScene : public BenchmarkScene {
+    public:
+      FanoutScene(const BenchmarkOptions &options,
+                  lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager), producer(NULL) {}
+
+      ~FanoutScene() {
+        for(size_t i=0; i<receivers.size(); ++i) delete receivers[i];
+        delete producer;
+      }
+
+      void prepare(ControlCenter *control) {
+        if(!control->dataBroker) return;
+        // the plugin is initialized when the simulation starts
+        producer = new FanoutProducer(control);
+        pluginStruct plugin;
+        plugin.name = "benchmark_fanout";
+        plugin.p_interface = producer;
+        plugin.p_destroy = NULL;
+        plugin.timer = plugin.timer_gui = 0.0;
+        plugin.t_count = plugin.t_count_gui = 0;
+        control->sim->addPlugin(plugin);
+      }
+
+      bool build(ControlCenter *control, std::string *reason) {
+        if(!producer) {
+          *reason = "no data broker";
+          return false;
+        }
+        for(int i=0; i<options.receivers; ++i) {
+          receivers.push_back(new FanoutReceiver());
+          control->dataBroker->registerSyncReceiver(receivers.back(),
+                                                    "benchmark", "fanout");
+        }
+        return true;
+      }
+
+      void cleanup(ControlCenter *control) {
+        for(size_t i=0; i<receivers.size(); ++i) {
+          control->dataBroker->unregisterSyncReceiver(receivers[i],
+                                                      "benchmark", "fanout");
+        }
+        if(producer) control->sim->removePlugin(producer);
+      }
+
+    private:
+      FanoutProducer *producer;
+      std::vector<FanoutReceiver*> receivers;
+    }; // end of class FanoutScene
+
+    /** Pushes one sample of every plot channel per step. */
+    class PlotProducer : public PluginInterface {
+    public:
+      PlotProducer(ControlCenter *control, int channels)
+        : PluginInterface(control), dataId(0), time(0.0) {
+        package.add("time", 0.0);
+        for(int i=0; i<channels; ++i) {
+          package.add(indexedName("channel", i), 0.0);
+        }
+      }
+
+      void init() {
+        dataId = control->dataBroker->pushData("benchmark", "plot", package,
+                                               NULL,
+                                               data_broker::DATA_PACKAGE_READ_FLAG);
+      }
+      void reset() {}
+      void update(sReal time_ms) {
+        time += time_ms*0.001;
+        package[0].d = time;
+        for(size_t i=1; i<package.size(); ++i) {
+          package[i].d = sin(time*i) + 0.1*sin(time*97.0*i);
+        }
+        control->dataBroker->pushData(dataId, package);
+      }
+
+    private:
+      data_broker::DataPackage package;
+      unsigned long dataId;
+      double time;
+    }; // end of class PlotProducer
+
+    /** Stores the channels the same way the data broker plotter does. */
+    class PlotReceiver : public data_broker::ReceiverInterface {
+    public:
+      PlotReceiver(int channels, double xRange)
+        : series(channels, PlotSeries((size_t)(xRange*1000.0))),
+          xRange(xRange) {}
+
+      void receiveData(const data_broker::DataInfo &info,
+                       const data_broker::DataPackage &package,
+                       int callbackParam) {
+        double x = package[0].d;
+        for(size_t i=0; i<series.size() && i+1<package.size(); ++i) {
+          series[i].append(x, package[i+1].d);
+          series[i].dropBefore(x-xRange);
+        }
+      }
+
+      /** Decimates every channel as for one redraw of the plot. */
+      void draw(int columns) {
+        bool haveBounds = false;
+        double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+        double x0, x1, y0, y1;
+        for(size_t i=0; i<series.size(); ++i) {
+          if(series[i].getBounds(&x0, &x1, &y0, &y1)) {
+            if(!haveBounds || x0 < minX) minX = x0;
+            if(!haveBounds || x1 > maxX) maxX = x1;
+            haveBounds = true;
+          }
+        }
+        if(!haveBounds) return;
+        for(size_t i=0; i<series.size(); ++i) {
+          series[i].decimate(minX, maxX, columns, &xDecimated, &yDecimated);
+        }
+      }
+
+    private:
+      std::vector<PlotSeries> series;
+      std::vector<double> xDecimated, yDecimated;
+      double xRange;
+    }; // end of class PlotReceiver
+
+    /**
+     * 100 plot channels at 1 kHz with a 10 s window, redrawn at 25 Hz
+     * onto a full HD wide plot.
+     */
+    class PlotStressScene : public BenchmarkScene {
+    public:
+      PlotStressScene(const BenchmarkOptions &options,
+                      lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager), producer(NULL),
+          receiver(channels, 10.0), nextDraw(0.0) {}
+
+      ~PlotStressScene() {
+        delete producer;
+      }
+
+      void prepare(ControlCenter *control) {
+        if(!control->dataBroker) return;
+        if(control->cfg) {
+          control->cfg->setPropertyValue("Simulator", "calc_ms", "value",
+                                         1.0);
+        }
+        producer = new PlotProducer(control, channels);
+        pluginStruct plugin;
+        plugin.name = "benchmark_plot";
+        plugin.p_interface = producer;
+        plugin.p_destroy = NULL;
+        plugin.timer = plugin.timer_gui = 0.0;
+        plugin.t_count = plugin.t_count_gui = 0;
+        control->sim->addPlugin(plugin);
+      }
+
+      bool build(ControlCenter *control, std::string *reason) {
+        if(!producer) {
+          *reason = "no data broker";
+          return false;
+        }
+        control->dataBroker->registerSyncReceiver(&receiver, "benchmark",
+                                                  "plot");
+        return true;
+      }
+
+      void update(ControlCenter *control, double time) {
+        if(time < nextDraw) return;
+        receiver.draw(1920);
+        nextDraw = time + 0.04;
+      }
+
+      void cleanup(ControlCenter *control) {
+        if(!producer) return;
+        control->dataBroker->unregisterSyncReceiver(&receiver, "benchmark",
+                                                    "plot");
+        control->sim->removePlugin(producer);
+      }
+
+    private:
+      static const int channels = 100;
+      PlotProducer *producer;
+      PlotReceiver receiver;
+      double nextDraw;
+    }; // end of class PlotStressScene
+
+    /**
+     * 20 x 20 boxes and cylinders resting on the ground. They settle in
+     * the warm up and sleep while they are measured.
+     */
+    class ObstacleFieldScene : public BenchmarkScene {
+    public:
+      ObstacleFieldScene(const BenchmarkOptions &options,
+                         lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        if(control->cfg) {
+          control->cfg->setPropertyValue("Simulator", "body sleeping",
+                                         "value", true);
+          // the adaptive QuickStep unless a solver is given
+          if(options.solver.empty()) {
+            control->cfg->setPropertyValue("Simulator", "faststep",
+                                           "value", true);
+            control->cfg->setPropertyValue("Simulator", "adaptive iterations",
+                                           "value", true);
+          }
+        }
+        addGround(control);
+        SceneRandom random(4);
+        for(int x=0; x<20; ++x) {
+          for(int y=0; y<20; ++y) {
+            std::string name = indexedName("obstacle", x*20+y);
+            Vector pos(x*1.5 + random.uniform(-0.3, 0.3),
+                       y*1.5 + random.uniform(-0.3, 0.3), 0.0);
+            if((x+y) % 2) {
+              Vector ext(random.uniform(0.2, 1.0), random.uniform(0.2, 1.0),
+                         random.uniform(0.2, 1.0));
+              pos.z() = ext.z()*0.5 + 0.01;
+              addBox(control, name, pos, ext, 2.0, true);
+            } else {
+              // upright, thus they do not roll away
+              Vector ext(random.uniform(0.1, 0.4), random.uniform(0.2, 1.0),
+                         0.0);
+              pos.z() = ext.y()*0.5 + 0.01;
+              NodeData node(name, pos);
+              node.initPrimitive(NODE_TYPE_CYLINDER, ext, 2.0);
+              node.movable = true;
+              control->nodes->addNode(&node);
+            }
+          }
+        }
+        return true;
+      }
+    }; // end of class ObstacleFieldScene
+
+    /**
+     * 60 hinged links swinging from a fixed anchor. The long chain builds
+     * up joint constraint error and is used to compare the solvers, see
+     * --solver.
+     */
+    class JointChainScene : public BenchmarkScene {
+    public:
+      JointChainScene(const BenchmarkOptions &options,
+                      lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        const double length = 0.2;
+        Vector anchor(0.0, 0.0, 15.0);
+        NodeId previous = addBox(control, "chain_anchor", anchor,
+                                 Vector(0.1, 0.1, 0.1), 1.0, false);
+        // starts horizontal and swings down
+        for(int i=0; i<60; ++i) {
+          Vector pos = anchor + Vector((i+0.5)*length, 0.0, 0.0);
+          NodeId link = addBox(control, indexedName("chain_link", i), pos,
+                               Vector(length, 0.04, 0.04), 0.2, true);
+          addHinge(control, indexedName("chain_joint", i), previous, link,
+                   anchor + Vector(i*length, 0.0, 0.0),
+                   Vector(0.0, 1.0, 0.0));
+          previous = link;
+        }
+        return true;
+      }
+    }; // end of class JointChainScene
+
+    /** A rover with eight cameras that are read every step. */
+    class CameraReadbackScene : public BenchmarkScene {
+    public:
+      CameraReadbackScene(const BenchmarkOptions &options,
+                          lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        if(!control->graphics) {
+          *reason = "needs --graphics";
+          return false;
+        }
+        addGround(control);
+        SceneRandom random(5);
+        for(int i=0; i<50; ++i) {
+          Vector ext(random.uniform(0.2, 1.0), random.uniform(0.2, 1.0),
+                     random.uniform(0.2, 2.0));
+          addBox(control, indexedName("obstacle", i),
+                 Vector(random.uniform(-10.0, 10.0),
+                        random.uniform(-10.0, 10.0), ext.z()*0.5),
+                 ext, 1.0, false);
+        }
+        NodeId chassis = addRover(control, "rover", Vector(0.0, 0.0, 0.3),
+                                  1.0);
+        for(int i=0; i<8; ++i) {
+          configmaps::ConfigMap config;
+          config["type"] = "CameraSensor";
+          config["name"] = indexedName("camera", i);
+          config["attached_node"] = chassis;
+          config["width"] = 640;
+          config["height"] = 480;
+          config["rate"] = 10;
+          config["position_offset"]["x"] = 0.0;
+          config["position_offset"]["y"] = 0.0;
+          config["position_offset"]["z"] = 0.2;
+          config["orientation_offset"]["roll"] = 0.0;
+          config["orientation_offset"]["pitch"] = 0.0;
+          config["orientation_offset"]["yaw"] = i*45.0;
+          BaseSensor *sensor = control->sensors->createAndAddSensor(&config);
+          sim::CameraSensor *camera = dynamic_cast<sim::CameraSensor*>(sensor);
+          if(!camera) {
+            *reason = "could not create the CameraSensor";
+            return false;
+          }
+          control->sensors->addSensorConsumer(camera->getID());
+          cameras.push_back(camera);
+        }
+        return true;
+      }
+
+      void update(ControlCenter *control, double time) {
+        // reads the images of the last frame as a controller would
+        for(size_t i=0; i<cameras.size(); ++i) {
+          const sim::CameraConfigStruct &config = cameras[i]->getConfig();
+          image.resize(config.width*config.height);
+          cameras[i]->getImage(image);
+        }
+      }
+
+    private:
+      std::vector<sim::CameraSensor*> cameras;
+      std::vector<sim::Pixel> image;
+    }; // end of class CameraReadbackScene
+
+    /** 10000 draw objects moved every step without physics. */
+    class DrawObjectsScene : public BenchmarkScene {
+    public:
+      DrawObjectsScene(const BenchmarkOptions &options,
+                       lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        if(!control->graphics) {
+          *reason = "needs --graphics";
+          return false;
+        }
+        for(int i=0; i<10000; ++i) {
+          NodeData node(indexedName("object", i),
+                        Vector((i % 100)*0.5, (i / 100)*0.5, 0.0));
+          node.initPrimitive(NODE_TYPE_BOX, Vector(0.2, 0.2, 0.2), 1.0);
+          DrawObjectPose pose;
+          pose.id = control->graphics->addDrawObject(node);
+          pose.pos = node.pos;
+          pose.rot = node.rot;
+          poses.push_back(pose);
+        }
+        return true;
+      }
+
+      void update(ControlCenter *control, double time) {
+        for(size_t i=0; i<poses.size(); ++i) {
+          poses[i].pos.z() = 0.5*sin(2.0*time + i*0.01);
+          poses[i].rot = eulerToQuaternion(Vector(0.0, 0.0, time*10.0 + i));
+        }
+        control->graphics->setDrawObjectPoses(poses);
+      }
+
+      void cleanup(ControlCenter *control) {
+        for(size_t i=0; i<poses.size(); ++i) {
+          control->graphics->removeDrawObject(poses[i].id);
+        }
+      }
+
+    private:
+      DrawObjectPoseList poses;
+    }; // end of class DrawObjectsScene
+
+    /**
+     * 1000 objects with 200 materials, the build time is the load time of
+     * the materials. Every 100 steps the shadows are toggled, which
+     * regenerates the shaders of all materials.
+     */
+    class MaterialLoadScene : public BenchmarkScene {
+    public:
+      MaterialLoadScene(const BenchmarkOptions &options,
+                        lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager), frame(0), shadow(false) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        if(!control->graphics) {
+          *reason = "needs --graphics";
+          return false;
+        }
+        SceneRandom random(6);
+        for(int i=0; i<1000; ++i) {
+          NodeData node(indexedName("object", i),
+                        Vector((i % 40)*1.0, (i / 40)*1.0, 0.5));
+          NodeType type = (i % 3) ? NODE_TYPE_BOX : NODE_TYPE_SPHERE;
+          node.initPrimitive(type, Vector(0.4, 0.4, 0.4), 1.0);
+          node.movable = false;
+          int m = i % 200;
+          node.material.name = indexedName("material", m);
+          node.material.diffuseFront = Color(random.uniform(0.0, 1.0),
+                                             random.uniform(0.0, 1.0),
+                                             random.uniform(0.0, 1.0), 1.0);
+          node.material.shininess = m % 100;
+          node.material.transparency = (m % 10) ? 0.0 : 0.5;
+          control->nodes->addNode(&node);
+        }
+        return true;
+      }
+
+      void update(ControlCenter *control, double time) {
+        if(++frame % 100 || !control->cfg) return;
+        shadow = !shadow;
+        control->cfg->setPropertyValue("Graphics", "marsShadow", "value",
+                                       shadow);
+      }
+
+    private:
+      unsigned long frame;
+      bool shadow;
+    }; // end of class MaterialLoadScene
+
+    /**
+     * Plays back sine trajectories on all joints of the viz scene given
+     * with --viz-scene, the model should have 50 or more joints.
+     */
+    class VizPlaybackScene : public BenchmarkScene {
+    public:
+      VizPlaybackScene(const BenchmarkOptions &options,
+                       lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager), player(NULL) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+#ifdef HAVE_MARS_VIZ
+        if(!control->graphics) {
+          *reason = "needs --graphics";
+          return false;
+        }
+        if(options.vizFile.empty()) {
+          *reason = "no viz scene given";
+          return false;
+        }
+        model = options.vizFile;
+        lib_manager::LibInterface *lib = libManager->acquireLibrary("mars_viz");
+        player = dynamic_cast<viz::Viz*>(lib);
+        if(!player) {
+          if(lib) libManager->releaseLibrary("mars_viz");
+          *reason = "mars_viz is not available";
+          return false;
+        }
+        // uses the already initialized graphics
+        player->init(false);
+        player->loadScene(options.vizFile);
+        values.resize(player->getNumControllerJoints());
+        if(values.empty()) {
+          *reason = "no controlled joints in " + options.vizFile;
+          return false;
+        }
+        return true;
+#else
+        *reason = "built without mars_viz";
+        return false;
+#endif
+      }
+
+      void update(ControlCenter *control, double time) {
+#ifdef HAVE_MARS_VIZ
+        // the draw objects are updated in the next frame
+        for(size_t i=0; i<values.size(); ++i) {
+          values[i] = 0.5*sin(2.0*M_PI*time + i*0.3);
+        }
+        player->setJointValues(values);
+#endif
+      }
+
+      void cleanup(ControlCenter *control) {
+#ifdef HAVE_MARS_VIZ
+        if(player) libManager->releaseLibrary("mars_viz");
+#endif
+      }
+
+    private:
+#ifdef HAVE_MARS_VIZ
+      viz::Viz *player;
+#else
+      void *player;
+#endif
+      std::vector<double> values;
+    }; // end of class VizPlaybackScene
+
+    /**
+     * 16 robots of 32 links each that are only described in the envire
+     * graph. envire_physics creates the nodes from the items and writes
+     * their poses back into the 512 frames every step.
+     */
+    class RobotGraphScene : public BenchmarkScene {
+    public:
+      RobotGraphScene(const BenchmarkOptions &options,
+                      lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        // the nodes are only created if the plugin listens to the graph
+        if(!libManager->getLibrary("envire_physics")) {
+          *reason = "envire_physics is not available";
+          return false;
+        }
+        libManager->releaseLibrary("envire_physics");
+        addGround(control);
+        for(int r=0; r<16; ++r) {
+          std::string robot = indexedName("graph_robot", r) + "_link";
+          // a trunk of 8 links along x with a leg of 8 links along y at
+          // every second trunk link
+          int link = 0;
+          std::string trunk = addLink(control, "center",
+                                      indexedName(robot, link++),
+                                      Vector(0.0, r*4.0, 0.11));
+          for(int i=1; i<8; ++i) {
+            trunk = addLink(control, trunk, indexedName(robot, link++),
+                            Vector(0.3, 0.0, 0.0));
+            if(i % 2) continue;
+            std::string leg = trunk;
+            for(int k=0; k<8; ++k) {
+              leg = addLink(control, leg, indexedName(robot, link++),
+                            Vector(0.0, 0.3, 0.0));
+            }
+          }
+        }
+        return true;
+      }
+
+    private:
+      /** Adds a frame below \a parent with a box node item. */
+      std::string addLink(ControlCenter *control, const std::string &parent,
+                          const std::string &name, const Vector &offset) {
+        envire::core::Transform tf;
+        tf.transform.translation = offset;
+        tf.transform.orientation = base::Quaterniond::Identity();
+        control->graph->addTransform(parent, name, tf);
+
+        configmaps::ConfigMap config;
+        config["name"] = name;
+        config["physicmode"] = "box";
+        config["extend"]["x"] = 0.2;
+        config["extend"]["y"] = 0.2;
+        config["extend"]["z"] = 0.2;
+        config["mass"] = 0.5;
+        config["movable"] = true;
+        envire::core::Item<configmaps::ConfigMap>::Ptr item;
+        item.reset(new envire::core::Item<configmaps::ConfigMap>(config));
+        control->graph->addItemToFrame(name, item);
+        return name;
+      }
+    }; // end of class RobotGraphScene
+
+    /**
+     * 36 boxes, spheres, capsules and cylinders dropped on a wavy
+     * mlsfield. The check fails if one of them fell through the field.
+     */
+    class MlsCollisionScene : public BenchmarkScene {
+    public:
+      MlsCollisionScene(const BenchmarkOptions &options,
+                        lib_manager::LibManager *libManager)
+        : BenchmarkScene(options, libManager), data(NULL), field(NULL) {}
+
+      bool build(ControlCenter *control, std::string *reason) {
+        // 128 x 128 samples of 0.1 m
+        const int samples = 128;
+        const double size = (samples-1)*0.1;
+        heights.resize(samples*samples);
+        for(int z=0; z<samples; ++z) {
+          for(int x=0; x<samples; ++x) {
+            heights[x+z*samples] = fieldHeight(x*0.1 - size*0.5,
+                                               z*0.1 - size*0.5);
+          }
+        }
+        data = dGeomMlsfieldDataCreate();
+        dGeomMlsfieldDataBuildDouble(data, &heights[0], 0, size, size,
+                                     samples, samples, 1.0, 0.0, 0.5, 0);
+        field = dCreateMlsfield(0, data, 1);
+        // the height of the field is given along its y axis
+        dMatrix3 R;
+        dRFromAxisAndAngle(R, 1.0, 0.0, 0.0, M_PI*0.5);
+        dGeomSetRotation(field, R);
+
+        sim::geom_data *gd = new sim::geom_data;
+        gd->setZero();
+        gd->sense_contact_force = 0;
+        gd->parent_geom = 0;
+        dGeomSetData(field, gd);
+        sim::WorldPhysics *world = (sim::WorldPhysics*)control->sim->getPhysics();
+        {
+          MutexLocker locker(&(world->iMutex));
+          dSpaceAdd(world->getSpace(), field);
+        }
+
+        const NodeType types[4] = {NODE_TYPE_BOX, NODE_TYPE_SPHERE,
+                                   NODE_TYPE_CAPSULE, NODE_TYPE_CYLINDER};
+        const Vector ext[4] = {Vector(0.3, 0.3, 0.2), Vector(0.15, 0.0, 0.0),
+                               Vector(0.1, 0.3, 0.0), Vector(0.15, 0.2, 0.0)};
+        for(int i=0; i<36; ++i) {
+          Vector pos(-1.5 + (i%6)*0.6, -1.5 + (i/6)*0.6, 0.0);
+          pos.z() = surfaceHeight(pos.x(), pos.y()) + 0.4;
+          NodeData node(indexedName("mls_object", i), pos);
+          node.initPrimitive(types[i%4], ext[i%4], 1.0);
+          node.movable = true;
+          nodes.push_back(control->nodes->addNode(&node));
+        }
+        return true;
+      }
+
+      bool check(ControlCenter *control, std::string *reason) {
+        for(size_t i=0; i<nodes.size(); ++i) {
+          // the centers rest above the surface
+          Vector pos = control->nodes->getPosition(nodes[i]);
+          if(pos.z() < surfaceHeight(pos.x(), pos.y()) - 0.05) {
+            *reason = indexedName("mls_object", i) +
+              " fell through the mlsfield";
+            return false;
+          }
+        }
+        return true;
+      }
+
+      void cleanup(ControlCenter *control) {
+        if(!field) return;
+        sim::WorldPhysics *world = (sim::WorldPhysics*)control->sim->getPhysics();
+        {
+          MutexLocker locker(&(world->iMutex));
+          world->removeContactPairs(field);
+          dSpaceID space = dGeomGetSpace(field);
+          if(space) dSpaceRemove(space, field);
+        }
+        delete (sim::geom_data*)dGeomGetData(field);
+        dGeomDestroy(field);
+        dGeomMlsfieldDataDestroy(data);
+        field = NULL;
+        data = NULL;
+      }
+
+    private:
+      dMlsfieldDataID data;
+      dGeomID field;
+      std::vector<double> heights;
+      std::vector<NodeId> nodes;
+
+      // waves of 5 cm in the frame of the field
+      static double fieldHeight(double x, double z) {
+        return 0.05*sin(2.0*x)*cos(2.0*z);
+      }
+
+      // the field is rotated by 90 degree around x, its z axis is -y
+      static double surfaceHeight(double x, double y) {
+        return fieldHeight(x, -y);
+      }
+    }; // end of class MlsCollisionScene
+
+    BenchmarkScene* BenchmarkScene::create(const std::string &name,
+                                           const BenchmarkOptions &options,
+                                           lib_manager::LibManager *libManager) {
+      if(name == "box_stack") {
+        return new BoxStackScene(options, libManager);
+      } else if(name == "robot_field") {
+        return new RobotFieldScene(options, libManager);
+      } else if(name == "legged_robot") {
+        return new LeggedRobotScene(options, libManager);
+      } else if(name == "rover_heightmap") {
+        return new HeightmapRoverScene(options, libManager);
+      } else if(name == "rover_mls") {
+        return new MlsRoverScene(options, libManager);
+      } else if(name == "ray_sensor") {
+        return new RaySensorScene(options, libManager);
+      } else if(name == "data_broker_fanout") {
+        return new FanoutScene(options, libManager);
+      } else if(name == "plot_stress") {
+        return new PlotStressScene(options, libManager);
+      } else if(name == "obstacle_field") {
+        return new ObstacleFieldScene(options, libManager);
+      } else if(name == "joint_chain") {
+        return new JointChainScene(options, libManager);
+      } else if(name == "camera_readback") {
+        return new CameraReadbackScene(options, libManager);
+      } else if(name == "draw_objects") {
+        return new DrawObjectsScene(options, libManager);
+      } else if(name == "material_load") {
+        return new MaterialLoadScene(options, libManager);
+      } else if(name == "viz_playback") {
+        return new VizPlaybackScene(options, libManager);
+      } else if(name == "robot_graph") {
+        return new RobotGraphScene(options, libManager);
+      } else if(name == "mls_collision") {
+        return new MlsCollisionScene(options, libManager);
+      }
+      return NULL;
+    }
+
+  } // end of namespace benchmark
+} // end of namespace mars
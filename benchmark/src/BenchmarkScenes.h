@@ -0,0 +1,94 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file BenchmarkScenes.h
+ * \brief The scenes of the benchmark. All scenes are created from fixed
+ * parameters, thus two runs with the same options simulate the same world.
+ */
+
+#ifndef MARS_BENCHMARK_BENCHMARK_SCENES_H
+#define MARS_BENCHMARK_BENCHMARK_SCENES_H
+
+#ifdef _PRINT_HEADER_
+  #warning "BenchmarkScenes.h"
+#endif
+
+#include "Benchmark.h"
+
+#include <string>
+
+namespace mars {
+  namespace benchmark {
+
+    class BenchmarkScene {
+    public:
+      BenchmarkScene(const BenchmarkOptions &options,
+                     lib_manager::LibManager *libManager)
+        : options(options), libManager(libManager), model("builtin") {}
+      virtual ~BenchmarkScene() {}
+
+      /** Called before the simulation is started, e.g. to add plugins. */
+      virtual void prepare(interfaces::ControlCenter *control) {}
+
+      /**
+       * Creates the scene in the started simulation.
+       * \return false if the scene is not available, \a reason then
+       *         describes why
+       */
+      virtual bool build(interfaces::ControlCenter *control,
+                         std::string *reason) = 0;
+
+      /** Called before every step, \a time is the simulation time in s. */
+      virtual void update(interfaces::ControlCenter *control, double time) {}
+
+      /**
+       * Called after the measured steps.
+       * \return false if the scene did not behave as expected, \a reason
+       *         then describes why
+       */
+      virtual bool check(interfaces::ControlCenter *control,
+                         std::string *reason) {
+        return true;
+      }
+
+      /** Called before the simulation is closed. */
+      virtual void cleanup(interfaces::ControlCenter *control) {}
+
+      const std::string& getModel() const {
+        return model;
+      }
+
+      /** \return NULL if there is no scene with the name */
+      static BenchmarkScene* create(const std::string &name,
+                                    const BenchmarkOptions &options,
+                                    lib_manager::LibManager *libManager);
+
+    protected:
+      BenchmarkOptions options;
+      lib_manager::LibManager *libManager;
+      std::string model;
+
+    }; // end of class BenchmarkScene
+
+  } // end of namespace benchmark
+} // end of namespace mars
+
+#endif // MARS_BENCHMARK_BENCHMARK_SCENES_H
@@ -0,0 +1,138 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file StateHash.cpp
+ * \brief Implementation of the state hash.
+ */
+
+#include "StateHash.h"
+
+#include <mars/interfaces/sim/NodeManagerInterface.h>
+#include <mars/interfaces/sim/SensorManagerInterface.h>
+#include <mars/interfaces/sensor_bases.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace mars {
+  namespace benchmark {
+
+    using namespace interfaces;
+
+    namespace {
+
+      // 64 bit FNV-1a
+      class Hash {
+      public:
+        Hash() : value(14695981039346656037ULL) {}
+
+        void add(const void *data, size_t size) {
+          const unsigned char *bytes = (const unsigned char*)data;
+          for(size_t i=0; i<size; ++i) {
+            value ^= bytes[i];
+            value *= 1099511628211ULL;
+          }
+        }
+
+        void add(double d) {
+          add(&d, sizeof(d));
+        }
+
+        void add(const utils::Vector &v) {
+          add(v.x());
+          add(v.y());
+          add(v.z());
+        }
+
+        void add(const utils::Quaternion &q) {
+          add(q.x());
+          add(q.y());
+          add(q.z());
+          add(q.w());
+        }
+
+        unsigned long long value;
+      };
+
+    } // end of anonymous namespace
+
+    unsigned long long computeStateHash(ControlCenter *control) {
+      Hash hash;
+      // both lists are sorted by id
+      std::vector<core_objects_exchange> objects;
+      control->nodes->getListNodes(&objects);
+      for(size_t i=0; i<objects.size(); ++i) {
+        NodeId id = objects[i].index;
+        hash.add(&id, sizeof(id));
+        hash.add(objects[i].pos);
+        hash.add(objects[i].rot);
+        hash.add(control->nodes->getLinearVelocity(id));
+        hash.add(control->nodes->getAngularVelocity(id));
+      }
+
+      std::vector<double> values;
+      control->sensors->getListSensors(&objects);
+      for(size_t i=0; i<objects.size(); ++i) {
+        unsigned long id = objects[i].index;
+        const BaseSensor *sensor = control->sensors->getSimSensor(id);
+        if(!sensor) continue;
+        values.clear();
+        sensor->appendSensorData(&values);
+        hash.add(&id, sizeof(id));
+        if(!values.empty()) {
+          hash.add(&values[0], values.size()*sizeof(double));
+        }
+      }
+      return hash.value;
+    }
+
+    long compareStateHashes(const std::string &file1,
+                            const std::string &file2,
+                            unsigned long *steps) {
+      FILE *f1 = fopen(file1.c_str(), "r");
+      FILE *f2 = fopen(file2.c_str(), "r");
+      long result = -1;
+      *steps = 0;
+      if(!f1 || !f2) {
+        result = -2;
+      } else {
+        unsigned long step1, step2;
+        unsigned long long hash1, hash2;
+        while(true) {
+          int n1 = fscanf(f1, "%lu %llx", &step1, &hash1);
+          int n2 = fscanf(f2, "%lu %llx", &step2, &hash2);
+          if(n1 != 2 && n2 != 2) break;
+          // a run that ended early differs at its last step
+          if(n1 != 2 || n2 != 2 || hash1 != hash2) {
+            result = (long)*steps;
+            break;
+          }
+          ++*steps;
+        }
+      }
+      if(f1) fclose(f1);
+      if(f2) fclose(f2);
+      return result;
+    }
+
+  } // end of namespace benchmark
+} // end of namespace mars
@@ -0,0 +1,62 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file StateHash.h
+ * \brief Hashes the simulation state to compare two runs step by step.
+ */
+
+#ifndef MARS_BENCHMARK_STATE_HASH_H
+#define MARS_BENCHMARK_STATE_HASH_H
+
+#ifdef _PRINT_HEADER_
+  #warning "StateHash.h"
+#endif
+
+#include <mars/interfaces/sim/ControlCenter.h>
+
+#include <string>
+
+namespace mars {
+  namespace benchmark {
+
+    /**
+     * \brief Hashes the poses and velocities of all nodes and the values
+     * of all sensors in the order of their ids.
+     *
+     * The values are hashed bit by bit, thus any difference of two runs
+     * changes the hash. The sensors are read directly and not through the
+     * SensorManager, so hashing does not change their activity.
+     */
+    unsigned long long computeStateHash(interfaces::ControlCenter *control);
+
+    /**
+     * Compares two files with one hash per step.
+     * \return the first step that differs, -1 if the files are equal or
+     *         -2 if a file could not be read
+     */
+    long compareStateHashes(const std::string &file1,
+                            const std::string &file2,
+                            unsigned long *steps);
+
+  } // end of namespace benchmark
+} // end of namespace mars
+
+#endif // MARS_BENCHMARK_STATE_HASH_H
@@ -0,0 +1,336 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file main.cpp
+ * \brief Runs the benchmark scenes, each in its own process, and writes
+ * the results as JSON. With --check-determinism every scene is run twice
+ * and the state hashes of the two runs are compared step by step.
+ */
+
+#include "Benchmark.h"
+#include "StateHash.h"
+
+// counts the allocations of the whole process by subsystem
+#include <mars/utils/AllocationHook.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+
+#ifndef WIN32
+  #include <unistd.h>
+#endif
+
+using namespace mars::benchmark;
+
+namespace {
+
+  void printUsage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --scene NAME        run only this scene, may be repeated\n"
+            "  --steps N           measured steps per scene (2000)\n"
+            "  --warmup N          steps before the measurement (200)\n"
+            "  --robots N          rovers of the robot_field scene (16)\n"
+            "  --receivers N       receivers of the data_broker_fanout scene (100)\n"
+            "  --smurf FILE        robot of the legged_robot scene\n"
+            "  --mls FILE          map or tile directory of the rover_mls scene\n"
+            "  --viz-scene FILE    model of the viz_playback scene (50+ joints)\n"
+            "  --graphics          load mars_graphics without window and draw a\n"
+            "                      frame every step, needed by the camera_readback,\n"
+            "                      draw_objects, material_load and viz_playback\n"
+            "                      scenes\n"
+            "  --output FILE       write the results to FILE instead of stdout\n"
+            "  --baseline FILE     compare with the results of a previous run\n"
+            "  --tolerance X       relative tolerance of the comparison (0.1)\n"
+            "  --config_dir DIR    configuration directory of the simulation\n"
+            "  --libs FILE         lib_manager config file of the libraries to load\n"
+            "  --plugin-threads N  worker threads of the plugin update (0)\n"
+            "  --seed N            run in deterministic mode with this random seed\n"
+            "  --solver NAME       world (dWorldStep), quick (dWorldQuickStep) or\n"
+            "                      adaptive (QuickStep with adaptive iterations);\n"
+            "                      may be repeated to run every scene per solver\n"
+            "  --check-determinism run every scene twice in deterministic mode and\n"
+            "                      compare the state hashes of every step\n"
+            "scenes:", name);
+    const std::vector<std::string> &names = Benchmark::getSceneNames();
+    for(size_t i=0; i<names.size(); ++i) {
+      fprintf(stderr, " %s", names[i].c_str());
+    }
+    fprintf(stderr, "\n"
+            "The exit code is 1 if a scene regressed against the baseline or\n"
+            "if the two runs of --check-determinism differ.\n"
+            "A baseline is the output of an earlier run on the same machine.\n");
+  }
+
+  std::string quote(const std::string &arg) {
+    std::string quoted = "'";
+    for(size_t i=0; i<arg.size(); ++i) {
+      if(arg[i] == '\'') quoted += "'\\''";
+      else quoted += arg[i];
+    }
+    return quoted + "'";
+  }
+
+  // runs one scene in a new process of the benchmark, thus every scene
+  // starts with a fresh simulation and gets its own peak RSS
+  void runSceneProcess(const std::string &self, const std::string &scene,
+                       const std::vector<std::string> &args,
+                       const std::string &hashFile,
+                       SceneResult *result) {
+    result->name = scene;
+    char tmpName[] = "/tmp/mars_benchmark_XXXXXX";
+    int fd = mkstemp(tmpName);
+    if(fd < 0) {
+      result->reason = "could not create a temporary file";
+      return;
+    }
+    close(fd);
+
+    std::string command = quote(self) + " --run-scene " + quote(scene) +
+      " --output " + quote(tmpName);
+    if(!hashFile.empty()) command += " --hashes " + quote(hashFile);
+    for(size_t i=0; i<args.size(); ++i) {
+      command += " " + quote(args[i]);
+    }
+    fprintf(stderr, "mars_benchmark: running %s\n", scene.c_str());
+    int status = system(command.c_str());
+
+    std::vector<SceneResult> results;
+    if(status != 0 || !readResults(tmpName, &results) || results.empty()) {
+      char reason[64];
+      sprintf(reason, "scene process failed with status %d", status);
+      result->reason = reason;
+    } else {
+      *result = results[0];
+    }
+    remove(tmpName);
+  }
+
+  // runs every scene twice in its own process and compares the state
+  // hashes, different addresses in the two processes reveal orders that
+  // depend on pointers
+  int checkDeterminism(const std::string &self,
+                       const std::vector<std::string> &scenes,
+                       const std::vector<std::string> &args) {
+    int exitCode = 0;
+    for(size_t i=0; i<scenes.size(); ++i) {
+      char hashNames[2][32] = {"/tmp/mars_hashes_XXXXXX",
+                               "/tmp/mars_hashes_XXXXXX"};
+      SceneResult results[2];
+      bool skipped = false;
+      for(int k=0; k<2 && !skipped; ++k) {
+        int fd = mkstemp(hashNames[k]);
+        if(fd < 0) {
+          fprintf(stderr, "mars_benchmark: could not create a temporary file\n");
+          return 2;
+        }
+        close(fd);
+        runSceneProcess(self, scenes[i], args, hashNames[k], &results[k]);
+        skipped = results[k].skipped;
+      }
+      if(skipped) {
+        printf("%s: skipped: %s\n", scenes[i].c_str(),
+               (results[0].skipped ? results[0] : results[1]).reason.c_str());
+      } else {
+        unsigned long steps;
+        long step = compareStateHashes(hashNames[0], hashNames[1], &steps);
+        if(step == -1) {
+          printf("%s: reproducible over %lu steps\n", scenes[i].c_str(),
+                 steps);
+        } else if(step == -2) {
+          printf("%s: could not read the state hashes\n", scenes[i].c_str());
+          exitCode = 2;
+        } else {
+          printf("%s: diverged at step %ld\n", scenes[i].c_str(), step);
+          if(exitCode == 0) exitCode = 1;
+        }
+      }
+      remove(hashNames[0]);
+      remove(hashNames[1]);
+    }
+    return exitCode;
+  }
+
+} // end of anonymous namespace
+
+int main(int argc, char **argv) {
+  BenchmarkOptions options;
+  std::vector<std::string> scenes, solvers, forwardArgs;
+  std::string runScene, outputFile, baselineFile;
+  bool determinismCheck = false;
+
+  static struct option long_options[] = {
+    {"scene", required_argument, 0, 's'},
+    {"steps", required_argument, 0, 'n'},
+    {"warmup", required_argument, 0, 'w'},
+    {"robots", required_argument, 0, 'r'},
+    {"receivers", required_argument, 0, 'R'},
+    {"smurf", required_argument, 0, 'S'},
+    {"mls", required_argument, 0, 'm'},
+    {"viz-scene", required_argument, 0, 'V'},
+    {"graphics", no_argument, 0, 'g'},
+    {"output", required_argument, 0, 'o'},
+    {"baseline", required_argument, 0, 'b'},
+    {"tolerance", required_argument, 0, 't'},
+    {"config_dir", required_argument, 0, 'C'},
+    {"libs", required_argument, 0, 'l'},
+    {"plugin-threads", required_argument, 0, 'p'},
+    {"seed", required_argument, 0, 'd'},
+    {"solver", required_argument, 0, 'v'},
+    {"check-determinism", no_argument, 0, 'c'},
+    {"run-scene", required_argument, 0, 'x'},
+    {"hashes", required_argument, 0, 'H'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  int c, option_index = 0;
+  while((c = getopt_long(argc, argv, "h", long_options,
+                         &option_index)) != -1) {
+    switch(c) {
+    case 's': scenes.push_back(optarg); break;
+    case 'n': options.steps = strtoul(optarg, NULL, 10); break;
+    case 'w': options.warmup = strtoul(optarg, NULL, 10); break;
+    case 'r': options.robots = atoi(optarg); break;
+    case 'R': options.receivers = atoi(optarg); break;
+    case 'S': options.smurfFile = optarg; break;
+    case 'm': options.mlsFile = optarg; break;
+    case 'V': options.vizFile = optarg; break;
+    case 'g': options.graphics = true; break;
+    case 'o': outputFile = optarg; break;
+    case 'b': baselineFile = optarg; break;
+    case 't': options.tolerance = atof(optarg); break;
+    case 'C': options.configDir = optarg; break;
+    case 'l': options.libsFile = optarg; break;
+    case 'p': options.pluginThreads = atoi(optarg); break;
+    case 'd':
+      options.deterministic = true;
+      options.seed = strtoul(optarg, NULL, 10);
+      break;
+    case 'v':
+      if(strcmp(optarg, "world") && strcmp(optarg, "quick") &&
+         strcmp(optarg, "adaptive")) {
+        printUsage(argv[0]);
+        return 2;
+      }
+      options.solver = optarg;
+      solvers.push_back(optarg);
+      break;
+    case 'c': determinismCheck = true; break;
+    case 'x': runScene = optarg; break;
+    case 'H': options.hashFile = optarg; break;
+    case 'h':
+      printUsage(argv[0]);
+      return 0;
+    default:
+      printUsage(argv[0]);
+      return 2;
+    }
+    // the scene processes get the same scene options
+    if(c != 's' && c != 'o' && c != 'b' && c != 't' && c != 'x' &&
+       c != 'c' && c != 'H' && c != 'v') {
+      forwardArgs.push_back(std::string("--") +
+                            long_options[option_index].name);
+      if(optarg) forwardArgs.push_back(optarg);
+    }
+  }
+
+  if(!runScene.empty()) {
+    SceneResult result;
+    Benchmark benchmark(options);
+    if(!benchmark.init()) return 2;
+    benchmark.runScene(runScene, &result);
+    FILE *file = outputFile.empty() ? stdout : fopen(outputFile.c_str(), "w");
+    if(!file) return 2;
+    writeResult(file, result, "");
+    fprintf(file, "\n");
+    if(file != stdout) fclose(file);
+    return 0;
+  }
+
+  if(scenes.empty()) scenes = Benchmark::getSceneNames();
+  // one set of scene process arguments per solver
+  std::vector< std::vector<std::string> > runArgs;
+  for(size_t i=0; i<solvers.size(); ++i) {
+    runArgs.push_back(forwardArgs);
+    runArgs.back().push_back("--solver");
+    runArgs.back().push_back(solvers[i]);
+  }
+  if(runArgs.empty()) runArgs.push_back(forwardArgs);
+
+  if(determinismCheck) {
+    int exitCode = 0;
+    for(size_t i=0; i<runArgs.size(); ++i) {
+      if(!options.deterministic) {
+        runArgs[i].push_back("--seed");
+        runArgs[i].push_back("0");
+      }
+      if(!solvers.empty()) printf("solver %s:\n", solvers[i].c_str());
+      int code = checkDeterminism(argv[0], scenes, runArgs[i]);
+      if(code > exitCode) exitCode = code;
+    }
+    return exitCode;
+  }
+
+  std::vector<SceneResult> results(scenes.size()*runArgs.size());
+  for(size_t i=0; i<scenes.size(); ++i) {
+    for(size_t k=0; k<runArgs.size(); ++k) {
+      runSceneProcess(argv[0], scenes[i], runArgs[k], "",
+                      &results[i*runArgs.size()+k]);
+    }
+  }
+
+  std::vector<Regression> regressions;
+  if(!baselineFile.empty()) {
+    std::vector<SceneResult> baseline;
+    if(!readResults(baselineFile, &baseline)) {
+      fprintf(stderr, "mars_benchmark: could not read baseline %s\n",
+              baselineFile.c_str());
+      return 2;
+    }
+    compareResults(results, baseline, options.tolerance, &regressions);
+  }
+
+  FILE *file = outputFile.empty() ? stdout : fopen(outputFile.c_str(), "w");
+  if(!file) {
+    fprintf(stderr, "mars_benchmark: could not write %s\n",
+            outputFile.c_str());
+    return 2;
+  }
+  writeResults(file, results, regressions, options);
+  if(file != stdout) fclose(file);
+
+  bool failed = false;
+  for(size_t i=0; i<results.size(); ++i) {
+    if(!results[i].failed) continue;
+    fprintf(stderr, "mars_benchmark: %s failed: %s\n",
+            results[i].name.c_str(), results[i].reason.c_str());
+    failed = true;
+  }
+  for(size_t i=0; i<regressions.size(); ++i) {
+    fprintf(stderr, "mars_benchmark: %s regressed in %s: %g -> %g\n",
+            regressions[i].scene.c_str(), regressions[i].metric.c_str(),
+            regressions[i].baseline, regressions[i].value);
+  }
+  return (regressions.empty() && !failed) ? 0 : 1;
+}
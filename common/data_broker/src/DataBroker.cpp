@@ -47,6 +47,7 @@
 
 #include <mars/utils/MutexLocker.h>
 #include <mars/utils/misc.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cstdio>
 #include <cerrno>
@@ -95,8 +96,8 @@ namespace mars {
       next_id(1), thread_running(false), stop_thread(false),
       realtimeThreadRunning(false), startingRealtimeThread(false) {
 
-      updatedElementsBackBuffer = new std::set<DataElement*>;
-      updatedElementsFrontBuffer = new std::set<DataElement*>;
+      updatedElementsBackBuffer = new DataElementSet;
+      updatedElementsFrontBuffer = new DataElementSet;
 
       DataElement *e;
       e = createDataElement("data_broker", "newStream", DATA_PACKAGE_READ_FLAG);
@@ -289,7 +290,7 @@ namespace mars {
       std::map<std::string, Timer>::iterator timerIt, endIt;
       std::list<DeferredCallback> deferredCallbacks;
       std::set<DataItemConnection> activeConnections;
-      std::set<DataElement*> connectionActivatedElements;
+      DataElementSet connectionActivatedElements;
       DataItem currentItem;
 
       //bool ok = false;
@@ -302,6 +303,10 @@ namespace mars {
       if(timerIt == endIt) {
         return false;
       }
+      // the copies of the broker are counted for the data broker and the
+      // receivers for the caller
+      utils::AllocationTag callerTag = utils::AllocationTracker::getCurrentTag();
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_DATA_BROKER);
       //ok = true;
       timerIt->second.lock->lockForWrite();
       timerIt->second.t += step;
@@ -380,19 +385,22 @@ namespace mars {
       timerIt->second.lock->unlock();
 
       // call all deferred receivers
-      for(timedReceiverIt = deferredReceivers.begin();
-          timedReceiverIt != deferredReceivers.end();
-          ++timedReceiverIt) {
-        DataElement *element = timedReceiverIt->element;
-        element->bufferLock->lockForRead();
-        timedReceiverIt->receiver->receiveData(element->info,
-                                               *element->frontBuffer,
-                                               timedReceiverIt->callbackParam);
-        element->bufferLock->unlock();
+      {
+        utils::AllocationScope receiverScope(callerTag);
+        for(timedReceiverIt = deferredReceivers.begin();
+            timedReceiverIt != deferredReceivers.end();
+            ++timedReceiverIt) {
+          DataElement *element = timedReceiverIt->element;
+          element->bufferLock->lockForRead();
+          timedReceiverIt->receiver->receiveData(element->info,
+                                                 *element->frontBuffer,
+                                                 timedReceiverIt->callbackParam);
+          element->bufferLock->unlock();
+        }
       }
 
       // connections
-      std::set<DataElement*>::iterator toElementIt;
+      DataElementSet::iterator toElementIt;
       fflush(stderr);
       for(toElementIt = connectionActivatedElements.begin();
           toElementIt != connectionActivatedElements.end(); ++toElementIt) {
@@ -403,6 +411,7 @@ namespace mars {
       // call deferred sync callbacks
       std::list<DeferredCallback>::iterator callbackIt;
       std::list<Receiver>::iterator receiverIt;
+      utils::AllocationScope receiverScope(callerTag);
       for(callbackIt = deferredCallbacks.begin();
           callbackIt != deferredCallbacks.end();
           ++callbackIt) {
@@ -910,15 +919,18 @@ namespace mars {
                                        const ReceiverInterface *producer) {
       std::list<Receiver>::iterator syncReceiverIt;
       std::map<unsigned long, DataElement*>::iterator elementIt;
-      std::set<DataElement*> connectionActivatedElements;
+      DataElementSet connectionActivatedElements;
       std::list<Receiver> syncReceivers;
       DataInfo info;
       DataElement *element = NULL;
+      utils::AllocationTag callerTag = utils::AllocationTracker::getCurrentTag();
+      utils::AllocationTracker::setCurrentTag(utils::ALLOCATION_TAG_DATA_BROKER);
       elementsLock.lockForRead();
       elementIt = elementsById.find(id);
       if(elementIt == elementsById.end()) {
         // ERROR: id not found!
         elementsLock.unlock();
+        utils::AllocationTracker::setCurrentTag(callerTag);
         return 0;
       } else {
         element = elementIt->second;
@@ -948,6 +960,7 @@ namespace mars {
         }
       }
       elementsLock.unlock();
+      utils::AllocationTracker::setCurrentTag(callerTag);
 
       // do the synchronous callbacks
       for(syncReceiverIt = syncReceivers.begin();
@@ -958,7 +971,7 @@ namespace mars {
                                                 syncReceiverIt->callbackParam);
       }
 
-      for(std::set<DataElement*>::iterator toElementIt = connectionActivatedElements.begin(); toElementIt != connectionActivatedElements.end(); ++toElementIt) {
+      for(DataElementSet::iterator toElementIt = connectionActivatedElements.begin(); toElementIt != connectionActivatedElements.end(); ++toElementIt) {
         DataElement *toElement = *toElementIt;
         pushData(toElement->info.dataId, *toElement->frontBuffer);
       }
@@ -1038,7 +1051,7 @@ namespace mars {
     }
 
     void DataBroker::run() {
-      std::set<DataElement*>::iterator updatedElementsIt;
+      DataElementSet::iterator updatedElementsIt;
       std::list<Receiver>::iterator receiverIt;
       std::list<DeferredCallback> deferredCallbacks;
       std::list<DeferredCallback>::iterator callbackIt;
@@ -1155,6 +1168,56 @@ namespace mars {
       return info;
     }
 
+    int DataBroker::getReceiverCount(const std::string &groupName,
+                                     const std::string &dataName) {
+      std::map<std::pair<std::string, std::string>, DataElement*>::const_iterator elementIt;
+      std::map<std::string, Timer>::iterator timerIt;
+      std::map<std::string, Trigger>::iterator triggerIt;
+      std::list<TimedReceiver>::const_iterator timedIt;
+      std::list<TriggeredReceiver>::const_iterator triggeredIt;
+      DataElement *element = NULL;
+      int count = 0;
+
+      elementsLock.lockForRead();
+      elementIt = elementsByName.find(std::make_pair(groupName, dataName));
+      if(elementIt != elementsByName.end()) {
+        element = elementIt->second;
+        element->receiverLock->lockForRead();
+        count += element->syncReceivers.size();
+        count += element->asyncReceivers.size();
+        element->receiverLock->unlock();
+        count += element->connections.size();
+      }
+      elementsLock.unlock();
+      if(!element) {
+        return 0;
+      }
+
+      timersLock.lockForRead();
+      for(timerIt = timers.begin(); timerIt != timers.end(); ++timerIt) {
+        timerIt->second.lock->lockForRead();
+        for(timedIt = timerIt->second.receivers.begin();
+            timedIt != timerIt->second.receivers.end(); ++timedIt) {
+          if(timedIt->element == element) ++count;
+        }
+        timerIt->second.lock->unlock();
+      }
+      timersLock.unlock();
+
+      triggersLock.lockForRead();
+      for(triggerIt = triggers.begin(); triggerIt != triggers.end();
+          ++triggerIt) {
+        triggerIt->second.lock->lockForRead();
+        for(triggeredIt = triggerIt->second.receivers.begin();
+            triggeredIt != triggerIt->second.receivers.end(); ++triggeredIt) {
+          if(triggeredIt->element == element) ++count;
+        }
+        triggerIt->second.lock->unlock();
+      }
+      triggersLock.unlock();
+      return count;
+    }
+
     unsigned long DataBroker::createId() {
       MutexLocker locker(&idMutex);
       return next_id++;
@@ -142,6 +142,19 @@ namespace mars {
       const ReceiverInterface *lastProducer;
       std::list<DataItemConnection> connections;
     };
+
+    /**
+     * Orders the DataElements by their id instead of their address, thus
+     * the connections and callbacks are processed in the same order in
+     * every run.
+     */
+    struct DataElementIdLess {
+      bool operator()(const DataElement *a, const DataElement *b) const {
+        return a->info.dataId < b->info.dataId;
+      }
+    };
+
+    typedef std::set<DataElement*, DataElementIdLess> DataElementSet;
     /// \endcond
 
     /**
@@ -227,6 +240,9 @@ namespace mars {
 
       const std::vector<DataInfo> getDataList(PackageFlag flag) const;
 
+      int getReceiverCount(const std::string &groupName,
+                           const std::string &dataName);
+
     
       void connectDataItems(const std::string &fromGroupName,
                             const std::string &fromDataName,
@@ -291,8 +307,8 @@ namespace mars {
                              const std::string &dataName,
                              std::vector<DataElement*> *elements) const;
 
-      std::set<DataElement*> *updatedElementsBackBuffer;
-      std::set<DataElement*> *updatedElementsFrontBuffer;
+      DataElementSet *updatedElementsBackBuffer;
+      DataElementSet *updatedElementsFrontBuffer;
 
       unsigned long next_id;
       pthread_t theThread;
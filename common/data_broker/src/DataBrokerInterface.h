@@ -532,6 +532,20 @@ namespace mars {
        */
       virtual const std::vector<DataInfo> getDataList(PackageFlag flag=DATA_PACKAGE_NO_FLAG) const = 0;
 
+      /**
+       * \brief get the number of receivers of a DataPackage
+       *
+       * Counts the sync, async, timed and triggered receivers as well as
+       * the data item connections. Producers use it to skip expensive
+       * computations nobody is interested in. Must not be called from
+       * within a receiver or producer callback.
+       * \param groupName The \ref DataInfo::groupName of the DataPackage
+       * \param dataName The \ref DataInfo::dataName of the DataPackage
+       * \return The number of receivers, 0 if no such package exists.
+       */
+      virtual int getReceiverCount(const std::string &groupName,
+                                   const std::string &dataName) = 0;
+
       virtual void connectDataItems(const std::string &fromGroupName,
                                     const std::string &fromDataName,
                                     const std::string &fromItemName,
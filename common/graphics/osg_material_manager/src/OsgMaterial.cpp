@@ -525,7 +525,6 @@ namespace osg_material_manager {
     }
 
 
-    osg::Program *glslProgram;
     args.clear();
     if(!map.hasKey("shader")) {
       map["shader"]["PixelLightVertex"] = 1;
@@ -637,42 +636,41 @@ namespace osg_material_manager {
       }
     }
 
+    ProgramSources sources;
     if(map.hasKey("shaderSources")) {
       // load shader from text file
       // todo: handle uniforms in a way that we dont need to create the shader
       //       sources above
-      glslProgram = new osg::Program();
       { // load vertex shader
         string file = map["shaderSources"]["vertexShader"];
         std::ifstream t(file.c_str());
         std::stringstream buffer;
         buffer << t.rdbuf();
-        string source = buffer.str();
-        osg::Shader *shader = new osg::Shader(osg::Shader::VERTEX);
-        glslProgram->addShader(shader);
-        shader->setShaderSource( source );
+        sources.shaders.push_back(make_pair(osg::Shader::VERTEX,
+                                            buffer.str()));
       }
       { // load fragment shader
         string file = map["shaderSources"]["fragmentShader"];
         std::ifstream t(file.c_str());
         std::stringstream buffer;
         buffer << t.rdbuf();
-        string source = buffer.str();
-        osg::Shader *shader = new osg::Shader(osg::Shader::FRAGMENT);
-        glslProgram->addShader(shader);
-        shader->setShaderSource( source );
+        sources.shaders.push_back(make_pair(osg::Shader::FRAGMENT,
+                                            buffer.str()));
       }
     }
     else {
-      glslProgram = shaderGenerator.generate();
+      shaderGenerator.generateSources(&sources);
     }
     if(checkTexture("normalMap")) {
-      glslProgram->addBindAttribLocation( "vertexTangent", TANGENT_UNIT );
+      sources.attribLocations["vertexTangent"] = TANGENT_UNIT;
       stateSet->addUniform(bumpNorFacUniform.get());
     }
     else {
       stateSet->removeUniform(bumpNorFacUniform.get());
     }
+    // the bindings are part of the cache key, thus they have to be set
+    // before the program is shared
+    osg::ref_ptr<osg::Program> glslProgram = OsgMaterialManager::getProgram(sources);
     stateSet->addUniform(noiseMapUniform.get());
 
     if(hasTexture) {
@@ -684,11 +682,13 @@ namespace osg_material_manager {
       stateSet->removeUniform(texScaleUniform.get());
     }
 
-    if(lastProgram.valid()) {
-      stateSet->removeAttribute(lastProgram.get());
+    if(lastProgram.get() != glslProgram.get()) {
+      if(lastProgram.valid()) {
+        stateSet->removeAttribute(lastProgram.get());
+      }
+      stateSet->setAttributeAndModes(glslProgram.get(),
+                                     osg::StateAttribute::ON);
     }
-    stateSet->setAttributeAndModes(glslProgram,
-                                   osg::StateAttribute::ON);
 
     stateSet->removeUniform(shadowSamplesUniform.get());
     stateSet->removeUniform(invShadowSamplesUniform.get());
@@ -38,10 +38,13 @@
 #include "MaterialNode.h"
 #include <osgDB/ReadFile>
 
+#include <sstream>
+
 namespace osg_material_manager {
 
   std::vector<OsgMaterialManager::textureFileStruct> OsgMaterialManager::textureFiles;
   std::vector<OsgMaterialManager::imageFileStruct> OsgMaterialManager::imageFiles;
+  std::vector<OsgMaterialManager::programStruct> OsgMaterialManager::programs;
 
   OsgMaterialManager::OsgMaterialManager(lib_manager::LibManager *theManager) :
     lib_manager::LibInterface(theManager) {
@@ -118,6 +121,56 @@ namespace osg_material_manager {
     return newImageFile.image;
   }
 
+  osg::ref_ptr<osg::Program> OsgMaterialManager::getProgram(const ProgramSources &sources) {
+    std::stringstream key;
+    for(size_t i=0; i<sources.shaders.size(); ++i) {
+      key << sources.shaders[i].first << '\0' << sources.shaders[i].second
+          << '\0';
+    }
+    std::map<std::string, unsigned int>::const_iterator it;
+    for(it=sources.attribLocations.begin();
+        it!=sources.attribLocations.end(); ++it) {
+      key << it->first << '=' << it->second << '\0';
+    }
+    const std::string keyString = key.str();
+
+    // FNV-1a
+    unsigned long hash = 2166136261UL;
+    for(size_t i=0; i<keyString.size(); ++i) {
+      hash ^= (unsigned char)keyString[i];
+      hash *= 16777619UL;
+    }
+
+    std::vector<programStruct>::iterator iter;
+    for(iter = programs.begin(); iter != programs.end(); iter++) {
+      if((*iter).hash == hash && (*iter).key == keyString) {
+        return (*iter).program;
+      }
+    }
+
+    releaseUnusedPrograms();
+    OsgMaterialManager::programStruct newProgram;
+    newProgram.hash = hash;
+    newProgram.key = keyString;
+    newProgram.program = ShaderGenerator::createProgram(sources);
+    programs.push_back(newProgram);
+
+    return newProgram.program;
+  }
+
+  void OsgMaterialManager::releaseUnusedPrograms() {
+    std::vector<programStruct>::iterator iter = programs.begin();
+    while(iter != programs.end()) {
+      // the cache holds the only reference
+      if((*iter).program->referenceCount() == 1) {
+        iter = programs.erase(iter);
+      }
+      else {
+        ++iter;
+      }
+    }
+  }
+
   void OsgMaterialManager::updateShadowSamples() {
     static int count = 0;
     osg::Vec2 v;
@@ -32,6 +32,7 @@
 #endif
 
 #include "OsgMaterial.h"
+#include "shader/shader-generator.h"
 
 #include <lib_manager/LibInterface.hpp>
 #include <mars/cfg_manager/CFGManagerInterface.h>
@@ -53,6 +54,13 @@ namespace osg_material_manager {
       osg::ref_ptr<osg::Image> image;
     }; // end of struct imageFileStruct
 
+    struct programStruct {
+      unsigned long hash;
+      // all sources and bindings, compared on a hash match
+      std::string key;
+      osg::ref_ptr<osg::Program> program;
+    }; // end of struct programStruct
+
   public:
     OsgMaterialManager(lib_manager::LibManager *theManager);
     ~OsgMaterialManager();
@@ -99,6 +107,14 @@ namespace osg_material_manager {
 
     static osg::ref_ptr<osg::Texture2D> loadTexture(std::string filename);
     static osg::ref_ptr<osg::Image> loadImage(std::string filename);
+    /**
+     * Returns the program for \a sources. Materials that generate the same
+     * sources and bindings share one program that is compiled only once.
+     * Programs no longer used by any material are released when a new
+     * program is created.
+     */
+    static osg::ref_ptr<osg::Program> getProgram(const ProgramSources &sources);
+    static size_t getNumPrograms() {return programs.size();}
 
   private:
     mars::cfg_manager::CFGManagerInterface *cfg;
@@ -119,6 +135,9 @@ namespace osg_material_manager {
 
     static std::vector<textureFileStruct> textureFiles;
     static std::vector<imageFileStruct> imageFiles;
+    static std::vector<programStruct> programs;
+
+    static void releaseUnusedPrograms();
 
   };
 
@@ -124,25 +124,41 @@ namespace osg_material_manager {
     }
   }
 
-  osg::Program* ShaderGenerator::generate() {
-    osg::Program *prog = new osg::Program();
-
+  void ShaderGenerator::generateSources(ProgramSources *sources) {
     if(functions.find(SHADER_TYPE_GEOMETRY) != functions.end()) {
-      osg::Shader *shader = new osg::Shader(osg::Shader::GEOMETRY);
-      prog->addShader(shader);
-      shader->setShaderSource( generateSource(SHADER_TYPE_GEOMETRY) );
+      sources->shaders.push_back(make_pair(osg::Shader::GEOMETRY,
+                                           generateSource(SHADER_TYPE_GEOMETRY)));
     }
     if(functions.find(SHADER_TYPE_VERTEX) != functions.end()) {
-      osg::Shader *shader = new osg::Shader(osg::Shader::VERTEX);
-      prog->addShader(shader);
-      shader->setShaderSource( generateSource(SHADER_TYPE_VERTEX) );
-      //printSource( shader->getShaderSource() );
+      sources->shaders.push_back(make_pair(osg::Shader::VERTEX,
+                                           generateSource(SHADER_TYPE_VERTEX)));
+      //printSource( sources->shaders.back().second );
     }
     if(functions.find(SHADER_TYPE_FRAGMENT) != functions.end()) {
-      osg::Shader *shader = new osg::Shader(osg::Shader::FRAGMENT);
+      sources->shaders.push_back(make_pair(osg::Shader::FRAGMENT,
+                                           generateSource(SHADER_TYPE_FRAGMENT)));
+      //printSource( sources->shaders.back().second );
+    }
+  }
+
+  osg::Program* ShaderGenerator::generate() {
+    ProgramSources sources;
+    generateSources(&sources);
+    return createProgram(sources);
+  }
+
+  osg::Program* ShaderGenerator::createProgram(const ProgramSources &sources) {
+    osg::Program *prog = new osg::Program();
+
+    for(size_t i=0; i<sources.shaders.size(); ++i) {
+      osg::Shader *shader = new osg::Shader(sources.shaders[i].first);
       prog->addShader(shader);
-      shader->setShaderSource( generateSource(SHADER_TYPE_FRAGMENT) );
-      //printSource( shader->getShaderSource() );
+      shader->setShaderSource( sources.shaders[i].second );
+    }
+    map<string, unsigned int>::const_iterator it;
+    for(it=sources.attribLocations.begin();
+        it!=sources.attribLocations.end(); ++it) {
+      prog->addBindAttribLocation( it->first, it->second );
     }
 
     return prog;
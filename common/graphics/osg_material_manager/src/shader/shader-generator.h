@@ -31,6 +31,9 @@
 #include <osg/Program>
 
 #include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace osg_material_manager {
 
@@ -41,6 +44,17 @@ namespace osg_material_manager {
     SHADER_TYPE_FFP
   };
   
+  /**
+   * \brief The sources and attribute bindings that define one program.
+   *
+   * Two materials with equal ProgramSources can share the same
+   * osg::Program, see OsgMaterialManager::getProgram.
+   */
+  struct ProgramSources {
+    std::vector<std::pair<osg::Shader::Type, std::string> > shaders;
+    std::map<std::string, unsigned int> attribLocations;
+  };
+
   class ShaderGenerator {
   public:
     ShaderGenerator() {};
@@ -48,8 +62,11 @@ namespace osg_material_manager {
     void addShaderFunction(ShaderFunc *func, ShaderType shaderType);
 
     std::string generateSource(ShaderType shaderType);
+    void generateSources(ProgramSources *sources);
     osg::Program* generate();
 
+    static osg::Program* createProgram(const ProgramSources &sources);
+
   private:
     std::map<ShaderType, ShaderFunc* > functions;
   }; // end of class ShaderGenerator
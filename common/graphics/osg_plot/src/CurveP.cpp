@@ -34,7 +34,7 @@
 
 namespace osg_plot {
   
-  CurveP::CurveP(int c) : maxPoints(500), color(c), yPos(0.0),
+  CurveP::CurveP(int c) : series(500), color(c), yPos(0.0),
                           boundsSet(false) {
 
     defColors[0] = (Color){0.7, 0.0, 0.0, 1.0};
@@ -117,39 +117,20 @@ namespace osg_plot {
   }
 
   void CurveP::appendData(double x, double y) {
-    if(points->back().x() > x) {
-      points->clear();
-      points->push_back(osg::Vec3(0.0, 0.00, 0.0));
-      points->push_back(osg::Vec3(0.00001, 0.0, 0.0));
+    if(!series.empty() && series.backX() > x) {
+      series.clear();
     }
-    points->push_back(osg::Vec3(x, y, 0.0));
-  }
-
-  void CurveP::crop(void) {
-    long count;
-    if( (count = (long)points->size() - (long)maxPoints) > 0) {
-      points->erase(points->begin(), points->begin()+count);
-    }
-    drawArray->setFirst(0);
-    drawArray->setCount(points->size());
+    series.append(x, y);
   }
 
   void CurveP::getBounds(double *minX, double *maxX,
                          double *minY, double *maxY) {
-    osg::Vec3Array::iterator it = points->begin();
-    for(; it!=points->end(); ++it) {
-      if(it->x() < *minX) {
-        *minX = it->x();
-      }
-      if(it->x() > *maxX) {
-        *maxX = it->x();
-      }
-      if(it->y() < *minY) {
-        *minY = it->y();
-      }
-      if(it->y() > *maxY) {
-        *maxY = it->y();
-      }
+    double x0, x1, y0, y1;
+    if(series.getBounds(&x0, &x1, &y0, &y1)) {
+      if(x0 < *minX) *minX = x0;
+      if(x1 > *maxX) *maxX = x1;
+      if(y0 < *minY) *minY = y0;
+      if(y1 > *maxY) *maxY = y1;
     }
     if(boundsSet) {
       //if(yMin < *minY) {
@@ -162,9 +143,10 @@ namespace osg_plot {
   }
 
   void CurveP::rescale(double minX, double maxX,
-                       double minY, double maxY) {
+                       double minY, double maxY, int numColumns) {
     char xLabel[56];
-    sprintf(xLabel, "%10s: %6.3f", title.c_str(), points->back().y());
+    double y = series.empty() ? 0.0 : series.backY();
+    sprintf(xLabel, "%10s: %6.3f", title.c_str(), y);
     xLabelText->setText(xLabel);
     //xLabelText->setPosition(osg::Vec3((points->back().x()-minX)/(maxX-minX), 0.0f,
     //                                  (points->back().z()-minY)/(maxY-minY)));
@@ -173,9 +155,20 @@ namespace osg_plot {
     curveTransform->setMatrix(osg::Matrix::translate(-minX, -minY, 0)*
                               osg::Matrix::scale(1/(maxX-minX),
                                                  1/(maxY-minY), 1.0));
+
+    // only the decimated curve is uploaded, at most four vertices per
+    // column independent of the number of stored samples
+    series.decimate(minX, maxX, numColumns, &xDecimated, &yDecimated);
+    points->clear();
+    for(size_t i=0; i<xDecimated.size(); ++i) {
+      points->push_back(osg::Vec3(xDecimated[i], yDecimated[i], 0.0));
+    }
+    drawArray->setFirst(0);
+    drawArray->setCount(points->size());
   }
 
   void CurveP::dirty(void) {
+    points->dirty();
     linesGeom->dirtyDisplayList();
     linesGeom->dirtyBound();   
   }
@@ -33,10 +33,14 @@
 
 #include "Curve.h"
 
+#include <mars/utils/PlotSeries.h>
+
 #include <osg/MatrixTransform>
 #include <osg/Geometry>
 #include <osgText/Text>
 
+#include <vector>
+
 namespace osg_plot {
 
   struct Color {
@@ -50,13 +54,14 @@ namespace osg_plot {
     CurveP(int c);
     ~CurveP();
 
-    void setMaxNumPoints(unsigned long n) {maxPoints = n;}
+    void setMaxNumPoints(unsigned long n) {series.setCapacity(n);}
     void setTitle(std::string s) {title = s.c_str();}
 
     void appendData(double x, double y);
-    void crop(void);
     void getBounds(double *minX, double *maxX, double *minY, double *maxY);
-    void rescale(double minX, double maxX, double minY, double maxY);
+    /** \a numColumns is the number of columns the curve is decimated to */
+    void rescale(double minX, double maxX, double minY, double maxY,
+                 int numColumns);
     void setYBounds(double yMin, double yMax) {
       this->yMin = yMin;
       this->yMax = yMax;
@@ -65,7 +70,8 @@ namespace osg_plot {
     void dirty(void);
 
   private:
-    unsigned long maxPoints;
+    mars::utils::PlotSeries series;
+    std::vector<double> xDecimated, yDecimated;
     int color;
     float yPos;
     float yMin, yMax;
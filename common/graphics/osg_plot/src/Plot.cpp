@@ -31,11 +31,12 @@
 
 #include <osg/Geode>
 #include <osg/LineWidth>
+#include <cfloat>
 #include <cstdio>
 
 namespace osg_plot {
 
-  Plot::Plot() : numXTicks(2), numYTicks(10) {
+  Plot::Plot() : numXTicks(2), numYTicks(10), viewportWidth(1024) {
 
     osg::ref_ptr<osg::Geode> xNode = new osg::Geode;
     xGeom = new osg::Geometry;
@@ -157,17 +158,20 @@ namespace osg_plot {
     std::list< osg::ref_ptr<osgText::Text> >::iterator itT = xLabels.begin();
 
     double minX = DBL_MAX;
-    double maxX = DBL_MIN;
+    double maxX = -DBL_MAX;
     double minY = DBL_MAX;
-    double maxY = DBL_MIN;
+    double maxY = -DBL_MAX;
 
     for(; it!=curves.end(); ++it) {
-      (*it)->crop();
       (*it)->getBounds(&minX, &maxX, &minY, &maxY);
     }
+    if(minX > maxX) return;
+    // a single sample or a constant curve would give a singular scale
+    if(maxX - minX < 0.000001) maxX = minX + 0.000001;
+    if(maxY - minY < 0.000001) maxY = minY + 0.000001;
 
     for(it=curves.begin(); it!=curves.end(); ++it) {
-      (*it)->rescale(minX, maxX, minY, maxY);
+      (*it)->rescale(minX, maxX, minY, maxY, viewportWidth);
       (*it)->dirty();
     }
 
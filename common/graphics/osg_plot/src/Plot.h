@@ -52,10 +52,16 @@ namespace osg_plot {
     Curve* createCurve(void);
     void removeCurve(Curve*);
 
+    /**
+     * The curves are decimated to one column per pixel of the viewport
+     * they are drawn in.
+     */
+    void setViewportWidth(int width) {viewportWidth = width;}
     void update(void);
 
   private:
     int numXTicks, numYTicks;
+    int viewportWidth;
     float xTicksDiff, yTicksDiff;
 
     osg::ref_ptr<osg::Vec3Array> xLines;
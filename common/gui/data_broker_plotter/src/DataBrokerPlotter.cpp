@@ -3,6 +3,8 @@
 
 #include<QVBoxLayout>
 
+#include <algorithm>
+
 namespace data_broker_plotter {
   
   DataBrokerPlotter::DataBrokerPlotter(DataBrokerPlotterLib *_mainLib,
@@ -55,7 +57,6 @@ namespace data_broker_plotter {
     Plot *p;
     double x;
     int ix;
-    double xmin;
     double sTime, xRange;
 
     // first handle panding dataPackages
@@ -76,21 +77,27 @@ namespace data_broker_plotter {
 
           if(callbackParam % 10) {
             x = x*p->yScale.dValue+p->yOffset.dValue;
-            p->yValues.push_back(x);
-            p->gotNewData |= 1;
+            p->pendingY.push_back(x);
           }
           else {
-            p->xValues.push_back(x);
+            p->pendingX.push_back(x);
+          }
+          // a channel without partner must not grow without limit
+          if(p->pendingX.size() > p->series.getCapacity())
+            p->pendingX.pop_front();
+          if(p->pendingY.size() > p->series.getCapacity())
+            p->pendingY.pop_front();
+          while(!p->pendingX.empty() && !p->pendingY.empty()) {
+            x = p->pendingX.front();
+            p->series.append(x, p->pendingY.front());
+            p->pendingX.pop_front();
+            p->pendingY.pop_front();
             if((xRange = fabs(p->xRange.dValue)) < 0.000001)
               xRange = fabs(plots[0]->xRange.dValue);
             if(xRange > 0.0000001) {
-              xmin = x-xRange;
-              while(!p->xValues.empty() && p->xValues.front() < xmin) {
-                p->xValues.pop_front();
-                p->yValues.pop_front();
-              }
+              p->series.dropBefore(x-xRange);
             }
-            p->gotNewData |= 2;
+            p->gotNewData = 3;
           }
           /*
           if((sTime = fabs(p->sTime.dValue)) < 0.000001) {
@@ -116,16 +123,51 @@ namespace data_broker_plotter {
       packageList.pop_front();
     }
 
-    bool onlyEnlarge = false;
+    // Only the decimated curves are handed to QCustomPlot. The bounds are
+    // tracked by the series, thus neither the update nor the replot
+    // depend on the number of stored samples.
+    bool haveBounds = false;
+    double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+    double x0, x1, y0, y1;
+    for(it=plots.begin(); it!=plots.end(); ++it) {
+      if((*it)->series.getBounds(&x0, &x1, &y0, &y1)) {
+        if(!haveBounds || x0 < minX) minX = x0;
+        if(!haveBounds || x1 > maxX) maxX = x1;
+        if(!haveBounds || y0 < minY) minY = y0;
+        if(!haveBounds || y1 > maxY) maxY = y1;
+        haveBounds = true;
+      }
+    }
+    bool changed = false;
+    int columns = qcPlot->axisRect()->width();
     for(it=plots.begin(); it!=plots.end(); ++it) {
-      if((*it)->gotNewData == 3) {
-        (*it)->curve->setData((*it)->xValues, (*it)->yValues);
-        (*it)->curve->rescaleAxes(onlyEnlarge);
-        onlyEnlarge = true;
-        (*it)->gotNewData = 0;
+      p = *it;
+      size_t capacity = (size_t)std::max(1.0, p->bufferSize.dValue);
+      if(p->series.getCapacity() != capacity) {
+        p->series.setCapacity(capacity);
+        p->gotNewData = 3;
+      }
+      if(p->gotNewData == 3) {
+        p->series.decimate(minX, maxX, columns,
+                           &p->xDecimated, &p->yDecimated);
+        p->xValues.resize(p->xDecimated.size());
+        p->yValues.resize(p->yDecimated.size());
+        for(size_t i=0; i<p->xDecimated.size(); ++i) {
+          p->xValues[i] = p->xDecimated[i];
+          p->yValues[i] = p->yDecimated[i];
+        }
+        p->curve->setData(p->xValues, p->yValues);
+        p->gotNewData = 0;
+        changed = true;
       }
     }
-    qcPlot->replot();
+    if(changed) {
+      if(haveBounds) {
+        qcPlot->xAxis->setRange(minX, maxX);
+        qcPlot->yAxis->setRange(minY, maxY);
+      }
+      qcPlot->replot();
+    }
     dataLock.unlock();
   }
 
@@ -212,15 +254,23 @@ namespace data_broker_plotter {
     newPlot->yOffset = cfg->getOrCreateProperty("DataBrokerPlotter",
                                                 tmpString.c_str(),
                                                 (double)0.0, this);
+    tmpString = cfgName;
+    tmpString.append("bufferSize");
+    newPlot->bufferSize = cfg->getOrCreateProperty("DataBrokerPlotter",
+                                                   tmpString.c_str(),
+                                                   (double)100000.0, this);
+    newPlot->series.setCapacity((size_t)newPlot->bufferSize.dValue);
 
     cfgParamIdToPlot[newPlot->sTime.paramId] = newPlot;
     cfgParamIdToPlot[newPlot->xRange.paramId] = newPlot;
     cfgParamIdToPlot[newPlot->yScale.paramId] = newPlot;
     cfgParamIdToPlot[newPlot->yOffset.paramId] = newPlot;
+    cfgParamIdToPlot[newPlot->bufferSize.paramId] = newPlot;
     newPlot->cfgParamIdProp[newPlot->sTime.paramId] = &newPlot->sTime;
     newPlot->cfgParamIdProp[newPlot->xRange.paramId] = &newPlot->xRange;
     newPlot->cfgParamIdProp[newPlot->yScale.paramId] = &newPlot->yScale;
     newPlot->cfgParamIdProp[newPlot->yOffset.paramId] = &newPlot->yOffset;
+    newPlot->cfgParamIdProp[newPlot->bufferSize.paramId] = &newPlot->bufferSize;
   }
 
   void DataBrokerPlotter::cfgUpdateProperty(mars::cfg_manager::cfgPropertyStruct _property) {
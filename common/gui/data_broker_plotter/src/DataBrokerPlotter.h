@@ -19,6 +19,8 @@
 #include <mars/data_broker/ReceiverInterface.h>
 #include <mars/data_broker/DataBrokerInterface.h>
 #include <mars/main_gui/BaseWidget.h>
+#include <mars/utils/PlotSeries.h>
+#include <deque>
 #include <vector>
 
 using namespace std;
@@ -31,6 +33,11 @@ namespace data_broker_plotter {
   public:
     std::string name;
     QCPGraph *curve;
+    // x and y arrive in separate packages and are paired in order
+    std::deque<double> pendingX, pendingY;
+    mars::utils::PlotSeries series;
+    // reused for the decimated curve handed to QCustomPlot
+    std::vector<double> xDecimated, yDecimated;
     QVector<double> xValues;
     QVector<double> yValues;
     mars::data_broker::DataPackage dpPackage;
@@ -38,6 +45,7 @@ namespace data_broker_plotter {
     bool gotData;
     QMutex mutex;
     mars::cfg_manager::cfgPropertyStruct xRange, yScale, sTime, yOffset;
+    mars::cfg_manager::cfgPropertyStruct bufferSize;
     std::map<mars::cfg_manager::cfgParamId, mars::cfg_manager::cfgPropertyStruct*> cfgParamIdProp;
   };
 
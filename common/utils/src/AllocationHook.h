@@ -0,0 +1,142 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file AllocationHook.h
+ * \brief Installs the allocation counting of the AllocationTracker.
+ *
+ * Include this header in exactly one source file of an executable that
+ * links mars_utils to enable the allocation tracking for the whole
+ * process, including all loaded libraries. With glibc malloc, calloc,
+ * realloc and posix_memalign are replaced, which also covers operator
+ * new. Otherwise only the global operator new is replaced and
+ * allocations with malloc are not counted.
+ */
+
+#ifndef MARS_UTILS_ALLOCATION_HOOK_H
+#define MARS_UTILS_ALLOCATION_HOOK_H
+
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <cerrno>
+#include <new>
+
+namespace mars {
+  namespace utils {
+    namespace {
+
+      struct AllocationHookInit {
+        AllocationHookInit() {
+          AllocationTracker::setEnabled(true);
+        }
+      } allocationHookInit;
+
+    }
+  } // end of namespace utils
+} // end of namespace mars
+
+#ifdef __GLIBC__
+
+extern "C" {
+
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t n, size_t size);
+  void* __libc_realloc(void *p, size_t size);
+  void* __libc_memalign(size_t alignment, size_t size);
+
+  void* malloc(size_t size) {
+    mars::utils::AllocationTracker::countAllocation(size);
+    return __libc_malloc(size);
+  }
+
+  void* calloc(size_t n, size_t size) {
+    mars::utils::AllocationTracker::countAllocation(n*size);
+    return __libc_calloc(n, size);
+  }
+
+  void* realloc(void *p, size_t size) {
+    mars::utils::AllocationTracker::countAllocation(size);
+    return __libc_realloc(p, size);
+  }
+
+  int posix_memalign(void **p, size_t alignment, size_t size) {
+    mars::utils::AllocationTracker::countAllocation(size);
+    *p = __libc_memalign(alignment, size);
+    return *p ? 0 : ENOMEM;
+  }
+
+}
+
+#else
+
+namespace mars {
+  namespace utils {
+    namespace {
+
+      inline void* trackedAlloc(std::size_t size) {
+        AllocationTracker::countAllocation(size);
+        // malloc(0) may return NULL, operator new has to return a pointer
+        return std::malloc(size ? size : 1);
+      }
+
+    }
+  } // end of namespace utils
+} // end of namespace mars
+
+void* operator new(std::size_t size) {
+  void *p = mars::utils::trackedAlloc(size);
+  if(!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t size) {
+  void *p = mars::utils::trackedAlloc(size);
+  if(!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return mars::utils::trackedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return mars::utils::trackedAlloc(size);
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t&) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t&) noexcept {
+  std::free(p);
+}
+
+#endif // __GLIBC__
+
+#endif /* MARS_UTILS_ALLOCATION_HOOK_H */
@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AllocationTracker.h"
+
+#include <atomic>
+
+namespace mars {
+  namespace utils {
+
+    namespace {
+      std::atomic<bool> enabled(false);
+      std::atomic<unsigned long long> tagCounts[ALLOCATION_TAG_COUNT];
+      std::atomic<unsigned long long> tagBytes[ALLOCATION_TAG_COUNT];
+      // a plain int does not allocate when the thread first accesses it
+      thread_local int currentTag = ALLOCATION_TAG_OTHER;
+
+      const char* tagNames[ALLOCATION_TAG_COUNT] = {
+        "other", "physics", "data_broker", "sensors", "plugins", "graphics"
+      };
+    }
+
+    AllocationStats::AllocationStats() {
+      for(int i=0; i<ALLOCATION_TAG_COUNT; ++i) {
+        count[i] = bytes[i] = 0;
+      }
+    }
+
+    unsigned long long AllocationStats::getTotalCount() const {
+      unsigned long long total = 0;
+      for(int i=0; i<ALLOCATION_TAG_COUNT; ++i) total += count[i];
+      return total;
+    }
+
+    unsigned long long AllocationStats::getTotalBytes() const {
+      unsigned long long total = 0;
+      for(int i=0; i<ALLOCATION_TAG_COUNT; ++i) total += bytes[i];
+      return total;
+    }
+
+    AllocationStats AllocationStats::operator-(const AllocationStats &before) const {
+      AllocationStats diff;
+      for(int i=0; i<ALLOCATION_TAG_COUNT; ++i) {
+        diff.count[i] = count[i] - before.count[i];
+        diff.bytes[i] = bytes[i] - before.bytes[i];
+      }
+      return diff;
+    }
+
+    bool AllocationTracker::isEnabled() {
+      return enabled.load(std::memory_order_relaxed);
+    }
+
+    void AllocationTracker::setEnabled(bool enabled_) {
+      enabled.store(enabled_);
+    }
+
+    void AllocationTracker::countAllocation(std::size_t size) {
+      int tag = currentTag;
+      tagCounts[tag].fetch_add(1, std::memory_order_relaxed);
+      tagBytes[tag].fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void AllocationTracker::getStats(AllocationStats *stats) {
+      for(int i=0; i<ALLOCATION_TAG_COUNT; ++i) {
+        stats->count[i] = tagCounts[i].load(std::memory_order_relaxed);
+        stats->bytes[i] = tagBytes[i].load(std::memory_order_relaxed);
+      }
+    }
+
+    const char* AllocationTracker::getTagName(AllocationTag tag) {
+      if(tag < 0 || tag >= ALLOCATION_TAG_COUNT) return "unknown";
+      return tagNames[tag];
+    }
+
+    AllocationTag AllocationTracker::getCurrentTag() {
+      return (AllocationTag)currentTag;
+    }
+
+    void AllocationTracker::setCurrentTag(AllocationTag tag) {
+      currentTag = tag;
+    }
+
+  } // end of namespace utils
+} // end of namespace mars
@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_UTILS_ALLOCATION_TRACKER_H
+#define MARS_UTILS_ALLOCATION_TRACKER_H
+
+#include <cstddef>
+
+namespace mars {
+  namespace utils {
+
+    /**
+     * The subsystems the allocations are counted for. Allocations outside
+     * of any AllocationScope are counted as ALLOCATION_TAG_OTHER.
+     */
+    enum AllocationTag {
+      ALLOCATION_TAG_OTHER = 0,
+      ALLOCATION_TAG_PHYSICS,
+      ALLOCATION_TAG_DATA_BROKER,
+      ALLOCATION_TAG_SENSORS,
+      ALLOCATION_TAG_PLUGINS,
+      ALLOCATION_TAG_GRAPHICS,
+      ALLOCATION_TAG_COUNT
+    };
+
+    struct AllocationStats {
+      AllocationStats();
+      unsigned long long count[ALLOCATION_TAG_COUNT];
+      unsigned long long bytes[ALLOCATION_TAG_COUNT];
+
+      unsigned long long getTotalCount() const;
+      unsigned long long getTotalBytes() const;
+      /** \return the allocations done between \a before and this */
+      AllocationStats operator-(const AllocationStats &before) const;
+    };
+
+    /**
+     * \brief Counts the heap allocations by AllocationTag.
+     *
+     * The tracker only counts if the executable installs the allocation
+     * hook by including <mars/utils/AllocationHook.h> in one of its
+     * source files. Otherwise the tracker is disabled and all counters
+     * stay zero, an AllocationScope then only costs setting a thread
+     * local variable.
+     */
+    class AllocationTracker {
+    public:
+      static bool isEnabled();
+      /** Called by the hook. */
+      static void setEnabled(bool enabled);
+      /** Called by the hook for every allocation. */
+      static void countAllocation(std::size_t bytes);
+      /** The counters since the start of the process. */
+      static void getStats(AllocationStats *stats);
+      static const char* getTagName(AllocationTag tag);
+      /** The tag of the calling thread. */
+      static AllocationTag getCurrentTag();
+      static void setCurrentTag(AllocationTag tag);
+    }; // end of class AllocationTracker
+
+    /**
+     * Counts the allocations of the calling thread for \a tag until the
+     * scope is left. Scopes can be nested, the innermost tag is counted.
+     */
+    class AllocationScope {
+    public:
+      explicit AllocationScope(AllocationTag tag)
+        : previous(AllocationTracker::getCurrentTag()) {
+        AllocationTracker::setCurrentTag(tag);
+      }
+
+      ~AllocationScope() {
+        AllocationTracker::setCurrentTag(previous);
+      }
+
+    private:
+      AllocationTag previous;
+
+      AllocationScope(const AllocationScope&);
+      AllocationScope& operator=(const AllocationScope&);
+    }; // end of class AllocationScope
+
+  } // end of namespace utils
+} // end of namespace mars
+
+#endif /* MARS_UTILS_ALLOCATION_TRACKER_H */
@@ -0,0 +1,179 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PlotSeries.h"
+
+namespace mars {
+  namespace utils {
+
+    PlotSeries::PlotSeries(size_t capacity) : head(0), count(0), first(0) {
+      lowX.isMax = lowY.isMax = false;
+      highX.isMax = highY.isMax = true;
+      lowX.isX = highX.isX = true;
+      lowY.isX = highY.isX = false;
+      setCapacity(capacity);
+    }
+
+    void PlotSeries::setCapacity(size_t capacity) {
+      if(capacity < 1) capacity = 1;
+      if(capacity == xValues.size()) return;
+
+      size_t keep = count < capacity ? count : capacity;
+      std::vector<double> x(capacity), y(capacity);
+      for(size_t i=0; i<keep; ++i) {
+        x[i] = getX(count-keep+i);
+        y[i] = getY(count-keep+i);
+      }
+      xValues.swap(x);
+      yValues.swap(y);
+      // rebuild the extrema from the kept samples
+      count = 0;
+      head = 0;
+      first = 0;
+      lowX.seq.clear();
+      highX.seq.clear();
+      lowY.seq.clear();
+      highY.seq.clear();
+      for(size_t i=0; i<keep; ++i) {
+        push(&lowX, i, xValues[i]);
+        push(&highX, i, xValues[i]);
+        push(&lowY, i, yValues[i]);
+        push(&highY, i, yValues[i]);
+        ++count;
+      }
+    }
+
+    void PlotSeries::clear() {
+      head = count = 0;
+      first = 0;
+      lowX.seq.clear();
+      highX.seq.clear();
+      lowY.seq.clear();
+      highY.seq.clear();
+    }
+
+    double PlotSeries::valueOf(const Extremum &e, unsigned long seq) const {
+      size_t i = index(seq - first);
+      return e.isX ? xValues[i] : yValues[i];
+    }
+
+    void PlotSeries::push(Extremum *e, unsigned long seq, double value) {
+      // samples that can never become the extremum again are dropped,
+      // thus every sample enters and leaves the queue once
+      while(!e->seq.empty()) {
+        double v = valueOf(*e, e->seq.back());
+        if(e->isMax ? v > value : v < value) break;
+        e->seq.pop_back();
+      }
+      e->seq.push_back(seq);
+    }
+
+    void PlotSeries::append(double x, double y) {
+      if(count == xValues.size()) popFront();
+      size_t i = index(count);
+      xValues[i] = x;
+      yValues[i] = y;
+      unsigned long seq = first + count;
+      // the sample has to be stored before valueOf can see it
+      ++count;
+      push(&lowX, seq, x);
+      push(&highX, seq, x);
+      push(&lowY, seq, y);
+      push(&highY, seq, y);
+    }
+
+    void PlotSeries::popFront() {
+      if(count == 0) return;
+      if(lowX.seq.front() == first) lowX.seq.pop_front();
+      if(highX.seq.front() == first) highX.seq.pop_front();
+      if(lowY.seq.front() == first) lowY.seq.pop_front();
+      if(highY.seq.front() == first) highY.seq.pop_front();
+      head = (head + 1) % xValues.size();
+      ++first;
+      --count;
+    }
+
+    void PlotSeries::dropBefore(double minX) {
+      while(count && getX(0) < minX) {
+        popFront();
+      }
+    }
+
+    bool PlotSeries::getBounds(double *minX, double *maxX,
+                               double *minY, double *maxY) const {
+      if(count == 0) return false;
+      *minX = valueOf(lowX, lowX.seq.front());
+      *maxX = valueOf(highX, highX.seq.front());
+      *minY = valueOf(lowY, lowY.seq.front());
+      *maxY = valueOf(highY, highY.seq.front());
+      return true;
+    }
+
+    void PlotSeries::decimate(double minX, double maxX, int columns,
+                              std::vector<double> *xOut,
+                              std::vector<double> *yOut) const {
+      xOut->clear();
+      yOut->clear();
+      if(count == 0) return;
+
+      if(columns < 1 || count <= (size_t)columns*4 || maxX <= minX) {
+        for(size_t i=0; i<count; ++i) {
+          xOut->push_back(getX(i));
+          yOut->push_back(getY(i));
+        }
+        return;
+      }
+
+      const double scale = columns / (maxX - minX);
+      long column = -1;
+      size_t firstI = 0, lastI = 0, minI = 0, maxI = 0;
+      for(size_t i=0; i<=count; ++i) {
+        long c = -1;
+        double y = 0.0;
+        if(i < count) {
+          double x = getX(i);
+          if(x < minX || x > maxX) continue;
+          c = (long)((x - minX) * scale);
+          if(c >= columns) c = columns-1;
+          y = getY(i);
+          if(c == column) {
+            lastI = i;
+            if(y < getY(minI)) minI = i;
+            if(y > getY(maxI)) maxI = i;
+            continue;
+          }
+        }
+        if(column >= 0) {
+          // emit the column in sample order without duplicates
+          size_t keep[4] = {firstI, minI < maxI ? minI : maxI,
+                            minI < maxI ? maxI : minI, lastI};
+          for(int k=0; k<4; ++k) {
+            if(k && keep[k] == keep[k-1]) continue;
+            xOut->push_back(getX(keep[k]));
+            yOut->push_back(getY(keep[k]));
+          }
+        }
+        column = c;
+        firstI = lastI = minI = maxI = i;
+      }
+    }
+
+  } // end of namespace utils
+} // end of namespace mars
@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_UTILS_PLOT_SERIES_H
+#define MARS_UTILS_PLOT_SERIES_H
+
+#ifdef _PRINT_HEADER_
+  #warning "PlotSeries.h"
+#endif
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace mars {
+  namespace utils {
+
+    /**
+     * \brief Fixed capacity ring buffer of (x, y) samples for plotting.
+     *
+     * Appending to a full series drops the oldest sample, thus the memory
+     * does not grow with the run time. The bounds are tracked while
+     * appending and dropping samples and are available in constant time.
+     * For drawing, decimate() reduces the series to at most four samples
+     * per screen column while keeping the extrema of each column.
+     */
+    class PlotSeries {
+    public:
+      explicit PlotSeries(size_t capacity = 100000);
+
+      /** Keeps the newest samples if the capacity shrinks. */
+      void setCapacity(size_t capacity);
+      size_t getCapacity() const {return xValues.size();}
+      size_t size() const {return count;}
+      bool empty() const {return count == 0;}
+      void clear();
+
+      void append(double x, double y);
+      /** Drops the oldest samples with an x value smaller than \a minX. */
+      void dropBefore(double minX);
+
+      /** \a i is counted from the oldest sample */
+      double getX(size_t i) const {return xValues[index(i)];}
+      double getY(size_t i) const {return yValues[index(i)];}
+      double backX() const {return getX(count-1);}
+      double backY() const {return getY(count-1);}
+
+      /** \return false if the series is empty */
+      bool getBounds(double *minX, double *maxX,
+                     double *minY, double *maxY) const;
+
+      /**
+       * Min/max decimation of the samples within [\a minX, \a maxX] onto
+       * \a columns columns. Per column the first, the smallest, the largest
+       * and the last sample are kept in their original order. The output
+       * vectors are cleared but keep their capacity.
+       */
+      void decimate(double minX, double maxX, int columns,
+                    std::vector<double> *xOut,
+                    std::vector<double> *yOut) const;
+
+    private:
+      // Sequence numbers of candidates for the minimum (or maximum) of
+      // the current window, the front is the current extremum.
+      struct Extremum {
+        std::deque<unsigned long> seq;
+        bool isMax, isX;
+      };
+
+      std::vector<double> xValues, yValues;
+      size_t head, count;
+      // sequence number of the oldest sample
+      unsigned long first;
+      Extremum lowX, highX, lowY, highY;
+
+      size_t index(size_t i) const {
+        return (head + i) % xValues.size();
+      }
+      double valueOf(const Extremum &e, unsigned long seq) const;
+      void push(Extremum *e, unsigned long seq, double value);
+      void popFront();
+    }; // end of class PlotSeries
+
+  } // end of namespace utils
+} // end of namespace mars
+
+#endif /* MARS_UTILS_PLOT_SERIES_H */
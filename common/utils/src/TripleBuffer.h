@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_UTILS_TRIPLE_BUFFER_H
+#define MARS_UTILS_TRIPLE_BUFFER_H
+
+#ifdef _PRINT_HEADER_
+  #warning "TripleBuffer.h"
+#endif
+
+#include <atomic>
+
+namespace mars {
+  namespace utils {
+
+    /**
+     * \brief Lock-free hand over of data from one writer to one reader.
+     *
+     * The writer fills the write buffer and publishes it, the reader picks
+     * up the latest published buffer. Neither side ever waits for the
+     * other; versions the reader did not pick up in time are overwritten.
+     * The buffers are reused, thus a writer that clears and refills
+     * containers does not allocate once their capacity is reached.
+     *
+     * Requires C++11.
+     */
+    template <typename T>
+    class TripleBuffer {
+    public:
+      TripleBuffer() : middle(1), writeIndex(0), readIndex(2) {}
+
+      /** Only to be used by the writer. */
+      T& getWriteBuffer() {
+        return buffers[writeIndex];
+      }
+
+      /** Makes the write buffer available to the reader. */
+      void publish() {
+        unsigned int old = middle.exchange(writeIndex | newData,
+                                           std::memory_order_acq_rel);
+        writeIndex = old & indexMask;
+      }
+
+      /**
+       * Switches the read buffer to the latest published one.
+       * \return false if nothing was published since the last call
+       */
+      bool update() {
+        if(!(middle.load(std::memory_order_acquire) & newData)) {
+          return false;
+        }
+        unsigned int old = middle.exchange(readIndex,
+                                           std::memory_order_acq_rel);
+        readIndex = old & indexMask;
+        return true;
+      }
+
+      /** Only to be used by the reader, stable until the next update(). */
+      T& getReadBuffer() {
+        return buffers[readIndex];
+      }
+
+    private:
+      static const unsigned int indexMask = 3;
+      static const unsigned int newData = 4;
+
+      T buffers[3];
+      // index of the buffer that is neither written nor read
+      std::atomic<unsigned int> middle;
+      unsigned int writeIndex, readIndex;
+
+      TripleBuffer(const TripleBuffer &);
+      TripleBuffer& operator=(const TripleBuffer &);
+    }; // end of class TripleBuffer
+
+  } // end of namespace utils
+} // end of namespace mars
+
+#endif /* MARS_UTILS_TRIPLE_BUFFER_H */
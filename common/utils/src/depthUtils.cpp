@@ -0,0 +1,141 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file depthUtils.cpp
+ * \brief Post-processing of depth images shared by the camera based sensors.
+ */
+
+#include "depthUtils.h"
+
+#include <cmath>
+#include <limits>
+
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+namespace mars {
+  namespace utils {
+
+    void linearizeDepth(const uint32_t *raw, int width, int height,
+                        double zNear, double zFar, float *depth,
+                        bool flipRows) {
+      // d = zNear*zFar / (zFar - dv*(zFar-zNear)) with dv = raw/max
+      const float a = (float)(zNear*zFar);
+      const float b = (float)(zFar);
+      const float c = (float)((zFar-zNear) /
+                              std::numeric_limits<uint32_t>::max());
+      const float nan = std::numeric_limits<float>::quiet_NaN();
+      // values that round to the max depth in float are at the far plane
+      const float far = (float)std::numeric_limits<uint32_t>::max();
+
+      for(int row=0; row<height; ++row) {
+        const uint32_t *src = raw + (size_t)(flipRows ? height-1-row : row)*width;
+        float *dst = depth + (size_t)row*width;
+        int k = 0;
+#ifdef __SSE2__
+        const __m128 va = _mm_set1_ps(a);
+        const __m128 vb = _mm_set1_ps(b);
+        const __m128 vc = _mm_set1_ps(c);
+        const __m128 vnan = _mm_set1_ps(nan);
+        const __m128 vhi = _mm_set1_ps(65536.f);
+        const __m128i vmask = _mm_set1_epi32(0xffff);
+        const __m128 vfar = _mm_set1_ps(far);
+        for(; k+4<=width; k+=4) {
+          __m128i di = _mm_loadu_si128((const __m128i*)(src+k));
+          // there is no unsigned conversion in SSE2, split into 16 bit halves
+          __m128 hi = _mm_cvtepi32_ps(_mm_srli_epi32(di, 16));
+          __m128 lo = _mm_cvtepi32_ps(_mm_and_si128(di, vmask));
+          __m128 dv = _mm_add_ps(_mm_mul_ps(hi, vhi), lo);
+          __m128 d = _mm_div_ps(va, _mm_sub_ps(vb, _mm_mul_ps(dv, vc)));
+          __m128 isFar = _mm_cmpge_ps(dv, vfar);
+          d = _mm_or_ps(_mm_and_ps(isFar, vnan), _mm_andnot_ps(isFar, d));
+          _mm_storeu_ps(dst+k, d);
+        }
+#endif
+        for(; k<width; ++k) {
+          const float dv = (float)src[k];
+          // the max depth is represented as a nan in the distance image
+          if(dv >= far) dst[k] = nan;
+          else dst[k] = a / (b - dv*c);
+        }
+      }
+    }
+
+    size_t binDepth(const float *depth, size_t count, double binWidth,
+                    float *bins, size_t numBins) {
+      const float scale = (float)(1.0 / binWidth);
+      const float maxBin = (float)numBins;
+      size_t counted = 0;
+      size_t i = 0;
+#ifdef __SSE2__
+      const __m128 vscale = _mm_set1_ps(scale);
+      const __m128 vzero = _mm_setzero_ps();
+      const __m128 vmax = _mm_set1_ps(maxBin);
+      int idx[4];
+      for(; i+4<=count; i+=4) {
+        __m128 f = _mm_mul_ps(_mm_loadu_ps(depth+i), vscale);
+        // comparisons with NaN are false, so NaNs fail the range check
+        int valid = _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(f, vzero),
+                                               _mm_cmplt_ps(f, vmax)));
+        if(!valid) continue;
+        _mm_storeu_si128((__m128i*)idx, _mm_cvttps_epi32(f));
+        for(int k=0; k<4; ++k) {
+          if(valid & (1 << k)) {
+            bins[idx[k]] += 1.f;
+            ++counted;
+          }
+        }
+      }
+#endif
+      for(; i<count; ++i) {
+        const float f = depth[i]*scale;
+        if(f >= 0.f && f < maxBin) {
+          bins[(size_t)f] += 1.f;
+          ++counted;
+        }
+      }
+      return counted;
+    }
+
+    void projectDepth(const float *depth, int width, int height,
+                      double fovx, double fovy, float *points) {
+      // inverse focal lengths in pixels
+      const float invFx = (float)(tan(0.5*fovx) / (0.5*width));
+      const float invFy = (float)(tan(0.5*fovy) / (0.5*height));
+      const float cx = 0.5f*(width-1);
+      const float cy = 0.5f*(height-1);
+
+      for(int row=0; row<height; ++row) {
+        const float *src = depth + (size_t)row*width;
+        float *dst = points + (size_t)row*width*3;
+        const float ry = (row - cy)*invFy;
+        for(int k=0; k<width; ++k) {
+          const float z = src[k];
+          dst[3*k] = (k - cx)*invFx*z;
+          dst[3*k+1] = ry*z;
+          dst[3*k+2] = z;
+        }
+      }
+    }
+
+  } // end of namespace utils
+} // end of namespace mars
@@ -0,0 +1,80 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file depthUtils.h
+ * \brief Post-processing of depth images shared by the camera based sensors.
+ *
+ * All functions write into buffers provided by the caller, so a sensor can
+ * keep its buffers between frames and no memory is allocated per frame.
+ * The inner loops use SSE2 if available and fall back to plain loops
+ * otherwise; both paths produce the same results.
+ */
+
+#ifndef MARS_UTILS_DEPTHUTILS_H
+#define MARS_UTILS_DEPTHUTILS_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace mars {
+  namespace utils {
+
+    /**
+     * \brief Converts a raw OpenGL depth buffer into metric depth.
+     *
+     * \param raw     Depth buffer as read by glReadPixels with
+     *                GL_UNSIGNED_INT, i.e. the last row first.
+     * \param zNear   Near plane of the perspective projection.
+     * \param zFar    Far plane of the perspective projection.
+     * \param depth   Output buffer of width*height floats. Pixels at the far
+     *                plane are set to NaN.
+     * \param flipRows If true, the rows are written top to bottom.
+     */
+    void linearizeDepth(const uint32_t *raw, int width, int height,
+                        double zNear, double zFar, float *depth,
+                        bool flipRows = true);
+
+    /**
+     * \brief Counts the depth values into \a numBins bins of \a binWidth.
+     *
+     * Values outside of [0, numBins*binWidth) and NaNs are ignored.
+     * \a bins is not cleared before counting.
+     * \return the number of values that were counted
+     */
+    size_t binDepth(const float *depth, size_t count, double binWidth,
+                    float *bins, size_t numBins);
+
+    /**
+     * \brief Projects a depth image into a point cloud in the camera frame.
+     *
+     * The camera looks along the positive z axis with x to the right and y
+     * down. \a points receives x,y,z triples for width*height pixels;
+     * invalid pixels produce NaN coordinates.
+     * \param fovx Horizontal field of view in radian.
+     * \param fovy Vertical field of view in radian.
+     */
+    void projectDepth(const float *depth, int width, int height,
+                      double fovx, double fovy, float *points);
+
+  } // end of namespace utils
+} // end of namespace mars
+
+#endif // MARS_UTILS_DEPTHUTILS_H
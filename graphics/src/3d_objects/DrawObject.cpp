@@ -223,6 +223,13 @@ namespace mars {
       quaternion_ = q;
     }
 
+    void DrawObject::setPose(const Vector &_pos, const Quaternion &q) {
+      position_ = _pos;
+      quaternion_ = q;
+      posTransform_->setPosition(osg::Vec3(position_.x(), position_.y(), position_.z()));
+      posTransform_->setAttitude(osg::Quat(q.x(), q.y(), q.z(), q.w()));
+    }
+
     void DrawObject::setScale(const Vector &scale) {
       scaleTransform_->setMatrix(osg::Matrix::scale(
                                                     scale.x(), scale.y(), scale.z()));
@@ -81,6 +81,9 @@ namespace mars {
 
       virtual void setPosition(const mars::utils::Vector &_pos);
       virtual void setQuaternion(const mars::utils::Quaternion &_q);
+      /** sets position and rotation with a single update of the transform */
+      void setPose(const mars::utils::Vector &_pos,
+                   const mars::utils::Quaternion &_q);
       virtual const mars::utils::Vector& getPosition()
       { return position_; }
       virtual const mars::utils::Quaternion& getQuaternion()
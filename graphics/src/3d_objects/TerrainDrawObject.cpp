@@ -34,6 +34,9 @@
 #include <osg/ComputeBoundsVisitor>
 #include <osg/CullFace>
 #include <osg/Geometry>
+#include <osg/NodeCallback>
+
+#include <algorithm>
 
 #ifdef HAVE_OSG_VERSION_H
   #include <osg/Version>
@@ -48,6 +51,30 @@ namespace mars {
     using mars::utils::Vector;
     using mars::interfaces::sReal;
 
+    // number of vertex rows per band of a deformable terrain
+    static const int bandRows = 32;
+
+    class TerrainUpdateCallback : public osg::NodeCallback {
+    public:
+      TerrainUpdateCallback(TerrainDrawObject *terrain) : terrain(terrain) {}
+      virtual void operator()(osg::Node *node, osg::NodeVisitor *nv) {
+        terrain->updateDirtyRegions();
+        traverse(node, nv);
+      }
+    private:
+      TerrainDrawObject *terrain;
+    }; // end of class TerrainUpdateCallback
+
+    static void setTangentArray(osg::Geometry *geom, osg::Vec4Array *tangents) {
+#if (OPENSCENEGRAPH_MAJOR_VERSION < 3 || ( OPENSCENEGRAPH_MAJOR_VERSION == 3 && OPENSCENEGRAPH_MINOR_VERSION < 2))
+      geom->setVertexAttribData(TANGENT_UNIT, osg::Geometry::ArrayData(tangents, osg::Geometry::BIND_PER_VERTEX ) );
+#elif (OPENSCENEGRAPH_MAJOR_VERSION > 3 || (OPENSCENEGRAPH_MAJOR_VERSION == 3 && OPENSCENEGRAPH_MINOR_VERSION >= 2))
+      geom->setVertexAttribArray(TANGENT_UNIT, tangents, osg::Array::BIND_PER_VERTEX );
+#else
+  #error Unknown OSG Version OPENSCENEGRAPH_MAJOR_VERSION
+#endif
+    }
+
     int TerrainDrawObject::countSubTiles = 0;
 
     TerrainDrawObject::TerrainDrawObject(GraphicsManager *g,
@@ -64,6 +91,7 @@ namespace mars {
     }
 
     TerrainDrawObject::~TerrainDrawObject() {
+      if(terrainGeode.valid()) terrainGeode->setUpdateCallback(NULL);
       if(height_data) {
         for(int i = 0; i < info.height + 1; ++i)
           delete height_data[i];
@@ -347,9 +375,15 @@ namespace mars {
         count = 0;
         y_off += num_y;
       }
-      geom->addPrimitiveSet(primitivSet.get());
-
-      geode->addDrawable(geom);
+      if(info.dirtyRegions) {
+        createBands(geode.get());
+        terrainGeode = geode;
+        geode->setUpdateCallback(new TerrainUpdateCallback(this));
+      }
+      else {
+        geom->addPrimitiveSet(primitivSet.get());
+        geode->addDrawable(geom);
+      }
       geodes.push_back(geode);
 
       normal_geode = new osg::Geode;
@@ -365,14 +399,149 @@ namespace mars {
       return;
 #endif
 
-#if (OPENSCENEGRAPH_MAJOR_VERSION < 3 || ( OPENSCENEGRAPH_MAJOR_VERSION == 3 && OPENSCENEGRAPH_MINOR_VERSION < 2))
-      geom->setVertexAttribData(TANGENT_UNIT, osg::Geometry::ArrayData(tangents.get(), osg::Geometry::BIND_PER_VERTEX ) );
-#elif (OPENSCENEGRAPH_MAJOR_VERSION > 3 || (OPENSCENEGRAPH_MAJOR_VERSION == 3 && OPENSCENEGRAPH_MINOR_VERSION >= 2))
-      geom->setVertexAttribArray(TANGENT_UNIT, tangents.get(), osg::Array::BIND_PER_VERTEX );
-#else
-  #error Unknown OSG Version OPENSCENEGRAPH_MAJOR_VERSION
-#endif
+      if(!bands.empty()) {
+        for(size_t i=0; i<bands.size(); ++i) {
+          setTangentArray(bands[i].geom.get(), bands[i].tangents.get());
+        }
+        return;
+      }
+      setTangentArray(geom.get(), tangents.get());
+    }
+
+    void TerrainDrawObject::createBands(osg::Geode *geode) {
+      const int rowSize = info.width+1;
+      for(int y0=0; y0<info.height; y0+=bandRows) {
+        TerrainBand band;
+        band.y0 = y0;
+        band.y1 = std::min(y0+bandRows, info.height);
+        band.dirty = false;
+        int begin = band.y0*rowSize, end = (band.y1+1)*rowSize;
+        band.vertices = new osg::Vec3Array(vertices->begin()+begin,
+                                           vertices->begin()+end);
+        band.normals = new osg::Vec3Array(normals->begin()+begin,
+                                          normals->begin()+end);
+        band.tangents = new osg::Vec4Array(tangents->begin()+begin,
+                                           tangents->begin()+end);
+        osg::ref_ptr<osg::Vec2Array> bandTexcoords;
+        bandTexcoords = new osg::Vec2Array(texcoords->begin()+begin,
+                                           texcoords->begin()+end);
+
+        band.geom = new osg::Geometry();
+        band.geom->setDataVariance(osg::Object::DYNAMIC);
+        band.geom->setUseDisplayList(false);
+        band.geom->setUseVertexBufferObjects(true);
+        band.geom->setVertexArray(band.vertices.get());
+        band.geom->setNormalArray(band.normals.get());
+        band.geom->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
+        band.geom->setTexCoordArray(DEFAULT_UV_UNIT, bandTexcoords.get());
+        band.geom->setTexCoordArray(1, bandTexcoords.get());
+
+        // same triangulation as the undeformable terrain
+        osg::ref_ptr<osg::DrawElementsUInt> pSet;
+        pSet = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, 0);
+        for(int y=0; y<band.y1-band.y0; ++y) {
+          unsigned int bottom = y*rowSize, top = (y+1)*rowSize;
+          for(int x=1; x<rowSize; ++x) {
+            pSet->push_back(top+x-1);
+            pSet->push_back(bottom+x-1);
+            pSet->push_back(top+x);
+            pSet->push_back(top+x);
+            pSet->push_back(bottom+x-1);
+            pSet->push_back(bottom+x);
+          }
+        }
+        band.geom->addPrimitiveSet(pSet.get());
+        geode->addDrawable(band.geom.get());
+        bands.push_back(band);
+      }
+    }
+
+    void TerrainDrawObject::updateDirtyRegions() {
+      if(!info.dirtyRegions || !height_data) return;
+      info.dirtyRegions->take(&dirtyRegions);
+      if(dirtyRegions.empty()) return;
+
+      {
+        // the physics deforms the buffer in its own thread
+        utils::MutexLocker locker(info.dirtyRegions->getBufferMutex());
+        for(size_t i=0; i<dirtyRegions.size(); ++i) {
+          updateRegion(dirtyRegions[i]);
+        }
+      }
+      for(size_t i=0; i<bands.size(); ++i) {
+        TerrainBand &band = bands[i];
+        if(!band.dirty) continue;
+        band.vertices->dirty();
+        band.normals->dirty();
+        band.tangents->dirty();
+        band.geom->dirtyBound();
+        band.dirty = false;
+      }
+      normal_debug->dirty();
+      normal_geom->dirtyBound();
+    }
+
+    void TerrainDrawObject::updateRegion(const mars::interfaces::TerrainRegion &r) {
+      const int rowSize = info.width+1;
+      int x0 = std::max(0, r.x0), x1 = std::min(info.width-1, r.x1);
+      int y0 = std::max(0, r.y0), y1 = std::min(info.height-1, r.y1);
+      if(x0 > x1 || y0 > y1) return;
 
+      // the heights are prepared as in createGeometry
+      for(int y=y0; y<=y1; ++y) {
+        for(int x=x0; x<=x1; ++x) {
+          height_data[y][x] = info.pixelData[(y*info.width)+x] * info.scale;
+          if(y<1 || x<1) height_data[y][x] -= 0.1;
+        }
+        if(x1 == info.width-1) {
+          height_data[y][info.width] = height_data[y][info.width-1] - 0.3;
+        }
+      }
+      if(y1 == info.height-1) {
+        for(int x=x0; x<=x1; ++x) {
+          height_data[info.height][x] = height_data[info.height-1][x] - 0.3;
+        }
+        if(x1 == info.width-1) {
+          height_data[info.height][info.width] = height_data[info.height-1][info.width-1] - 0.3;
+        }
+      }
+
+      // the normals of the neighbours change as well
+      x0 = std::max(0, x0-1);
+      y0 = std::max(0, y0-1);
+      x1 = std::min(info.width, x1+1);
+      y1 = std::min(info.height, y1+1);
+      Vector n;
+      osg::Vec3d t;
+      for(int y=y0; y<=y1; ++y) {
+        for(int x=x0; x<=x1; ++x) {
+          n = getNormal(x, y, info.width+1, info.height+1,
+                        x_step, y_step, height_data, &t, true);
+          int i = y*rowSize+x;
+          osg::Vec3 v(x*x_step, y*y_step, height_data[y][x]);
+          (*vertices)[i] = v;
+          (*normals)[i].set(n.x(), n.y(), n.z());
+          (*tangents)[i].set(t.x(), t.y(), t.z(), 0.0);
+          (*normal_debug)[2*i] = v;
+          (*normal_debug)[2*i+1] = v + osg::Vec3(n.x(), n.y(), n.z())*0.1;
+        }
+      }
+
+      // copy the changed rows into the vertex buffers of the bands
+      for(size_t b=0; b<bands.size(); ++b) {
+        TerrainBand &band = bands[b];
+        int by0 = std::max(y0, band.y0), by1 = std::min(y1, band.y1);
+        if(by0 > by1) continue;
+        for(int y=by0; y<=by1; ++y) {
+          int src = y*rowSize, dst = (y-band.y0)*rowSize;
+          for(int x=x0; x<=x1; ++x) {
+            (*band.vertices)[dst+x] = (*vertices)[src+x];
+            (*band.normals)[dst+x] = (*normals)[src+x];
+            (*band.tangents)[dst+x] = (*tangents)[src+x];
+          }
+        }
+        band.dirty = true;
+      }
     }
 
     void TerrainDrawObject::collideSphere(Vector pos, sReal radius) {
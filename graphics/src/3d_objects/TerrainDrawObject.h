@@ -35,6 +35,7 @@
 #include <mars/interfaces/MARSDefs.h>
 #include <mars/utils/Vector.h>
 #include <mars/interfaces/terrainStruct.h>
+#include <mars/interfaces/TerrainDirtyRegions.h>
 
 #include <string>
 #include <vector>
@@ -90,12 +91,33 @@ namespace mars {
                                  mars::interfaces::sReal radius);
       static int countSubTiles;
 
+      /**
+       * Updates the vertices of the regions a deformable terrain reports as
+       * changed. Called once per frame from the update traversal.
+       */
+      void updateDirtyRegions();
+
 #ifdef USE_VERTEX_BUFFER
       virtual void setSelected(bool val);
 #endif
 
     private:
 
+      /**
+       * A deformable terrain is split into bands of rows, each with its own
+       * vertex buffers. Only the bands touched by a deformation are
+       * uploaded again.
+       */
+      struct TerrainBand {
+        // first and last vertex row of the band
+        int y0, y1;
+        osg::ref_ptr<osg::Geometry> geom;
+        osg::ref_ptr<osg::Vec3Array> vertices;
+        osg::ref_ptr<osg::Vec3Array> normals;
+        osg::ref_ptr<osg::Vec4Array> tangents;
+        bool dirty;
+      }; // end of struct TerrainBand
+
 #ifdef USE_VERTEX_BUFFER
       osg::ref_ptr<VertexBufferTerrain> vbt;
 #endif
@@ -118,7 +140,12 @@ namespace mars {
       double x_step2, y_step2;
       double tex_scale_x, tex_scale_y;
       std::vector<std::vector<LoadDrawObjectPSetBox*>*> gridPSets;
+      std::vector<TerrainBand> bands;
+      std::vector<mars::interfaces::TerrainRegion> dirtyRegions;
+      osg::ref_ptr<osg::Geode> terrainGeode;
       virtual std::list< osg::ref_ptr< osg::Geode > > createGeometry();
+      void createBands(osg::Geode *geode);
+      void updateRegion(const mars::interfaces::TerrainRegion &r);
 
       std::map<int, SubTile*> subTiles;
       std::vector<SubTile*> vSubTiles;
@@ -0,0 +1,201 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* The prototypes are only declared in GL/glext.h if this is defined */
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES 1 //for glGenBuffers, glBindBuffer,
+                              //glMapBuffer
+#endif
+
+#include "CameraReadback.h"
+
+#include <mars/utils/MutexLocker.h>
+
+#ifdef WIN32
+#include <windows.h>
+#include <GL/glew.h>
+GLEW_FUN_EXPORT PFNGLGENBUFFERSPROC glGenBuffers;
+GLEW_FUN_EXPORT PFNGLBINDBUFFERPROC glBindBuffer;
+GLEW_FUN_EXPORT PFNGLBUFFERDATAPROC glBufferData;
+GLEW_FUN_EXPORT PFNGLMAPBUFFERPROC glMapBuffer;
+GLEW_FUN_EXPORT PFNGLUNMAPBUFFERPROC glUnmapBuffer;
+#endif
+
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+#include <cstring>
+
+namespace mars {
+  namespace graphics {
+
+    using namespace mars::utils;
+
+    CameraReadback::CameraReadback(osg::Texture2D *colorTexture,
+                                   osg::Texture2D *depthTexture,
+                                   int width, int height)
+      : colorTexture(colorTexture), depthTexture(depthTexture),
+        width(width), height(height), readbackOnly(false),
+        initialized(false), pending(false),
+        latest(-1), reading(-1), frameCount(0) {
+      pbo[0] = pbo[1] = 0;
+      for(int i=0; i<numSlots; ++i) {
+        colorSlots[i].resize(width*height*4);
+        depthSlots[i].resize(width*height);
+      }
+    }
+
+    CameraReadback::~CameraReadback() {
+      // the pixel buffers are released together with the graphics context,
+      // there is no current context when the callback is destroyed
+    }
+
+    void CameraReadback::setReadbackOnly(bool readbackOnly_) {
+      readbackOnly = readbackOnly_;
+    }
+
+    void CameraReadback::initialize() const {
+#ifdef WIN32
+      glGenBuffers = (PFNGLGENBUFFERSPROC) wglGetProcAddress("glGenBuffers");
+      glBindBuffer = (PFNGLBINDBUFFERPROC) wglGetProcAddress("glBindBuffer");
+      glBufferData = (PFNGLBUFFERDATAPROC) wglGetProcAddress("glBufferData");
+      glMapBuffer = (PFNGLMAPBUFFERPROC) wglGetProcAddress("glMapBuffer");
+      glUnmapBuffer = (PFNGLUNMAPBUFFERPROC) wglGetProcAddress("glUnmapBuffer");
+#endif
+      glGenBuffers(2, pbo);
+      for(int i=0; i<2; ++i) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, width*height*4, NULL,
+                     GL_STREAM_READ);
+      }
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      initialized = true;
+    }
+
+    void CameraReadback::operator () (osg::RenderInfo& renderInfo) const {
+      if(!initialized) initialize();
+      if(pending) finishTransfer();
+      // a deactivated camera did not draw anything new
+      if(readbackOnly || renderInfo.getCurrentCamera()->getNodeMask() == 0) {
+        return;
+      }
+      startTransfer(renderInfo);
+    }
+
+    void CameraReadback::startTransfer(osg::RenderInfo &renderInfo) const {
+      osg::State *state = renderInfo.getState();
+      unsigned int contextID = state->getContextID();
+      osg::Texture::TextureObject *colorObject;
+      osg::Texture::TextureObject *depthObject;
+      colorObject = colorTexture->getTextureObject(contextID);
+      depthObject = depthTexture->getTextureObject(contextID);
+      if(!colorObject || !depthObject) return;
+
+      // with a pack buffer bound glGetTexImage returns immediately, the
+      // copy is done by the driver while the next cameras are drawn
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[0]);
+      glBindTexture(GL_TEXTURE_2D, colorObject->id());
+      glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA,
+                    GL_UNSIGNED_INT_8_8_8_8_REV, 0);
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[1]);
+      glBindTexture(GL_TEXTURE_2D, depthObject->id());
+      glGetTexImage(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
+                    GL_UNSIGNED_INT, 0);
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      glBindTexture(GL_TEXTURE_2D, 0);
+      state->haveAppliedTextureAttribute(state->getActiveTextureUnit(),
+                                         osg::StateAttribute::TEXTURE);
+      pending = true;
+    }
+
+    void CameraReadback::finishTransfer() const {
+      int slot = acquireWriteSlot();
+      void *data;
+
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[0]);
+      data = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+      if(data) {
+        memcpy(colorSlots[slot].data(), data, width*height*4);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      }
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[1]);
+      data = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+      if(data) {
+        memcpy(depthSlots[slot].data(), data, width*height*sizeof(uint32_t));
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      }
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      pending = false;
+
+      MutexLocker locker(&slotMutex);
+      latest = slot;
+      ++frameCount;
+    }
+
+    int CameraReadback::acquireWriteSlot() const {
+      // with three slots there is always one that is neither the latest
+      // frame nor the one currently copied by a reader
+      MutexLocker locker(&slotMutex);
+      for(int i=0; i<numSlots; ++i) {
+        if(i != latest && i != reading) return i;
+      }
+      return 0;
+    }
+
+    bool CameraReadback::getImage(char *buffer) {
+      MutexLocker readLocker(&readMutex);
+      slotMutex.lock();
+      reading = latest;
+      slotMutex.unlock();
+      if(reading < 0) {
+        memset(buffer, 0, width*height*4);
+        return false;
+      }
+      memcpy(buffer, colorSlots[reading].data(), width*height*4);
+      slotMutex.lock();
+      reading = -1;
+      slotMutex.unlock();
+      return true;
+    }
+
+    bool CameraReadback::getDepth(uint32_t *buffer) {
+      MutexLocker readLocker(&readMutex);
+      slotMutex.lock();
+      reading = latest;
+      slotMutex.unlock();
+      if(reading < 0) {
+        memset(buffer, 0, width*height*sizeof(uint32_t));
+        return false;
+      }
+      memcpy(buffer, depthSlots[reading].data(),
+             width*height*sizeof(uint32_t));
+      slotMutex.lock();
+      reading = -1;
+      slotMutex.unlock();
+      return true;
+    }
+
+    unsigned long CameraReadback::getFrameCount() {
+      MutexLocker locker(&slotMutex);
+      return frameCount;
+    }
+
+  } // end of namespace graphics
+} // end of namespace mars
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_GRAPHICS_CAMERA_READBACK_H
+#define MARS_GRAPHICS_CAMERA_READBACK_H
+
+#ifdef _PRINT_HEADER_
+  #warning "CameraReadback.h"
+#endif
+
+#include <mars/utils/Mutex.h>
+
+#include <osg/Camera>
+#include <osg/Texture2D>
+
+#include <stdint.h>
+#include <vector>
+
+namespace mars {
+  namespace graphics {
+
+    /**
+     * \brief Asynchronous read back of the color and depth texture of a
+     * render to texture camera.
+     *
+     * Installed as post draw callback. In the frame the camera renders, the
+     * textures are copied into pixel buffer objects, which returns without
+     * waiting for the GPU. The next time the callback runs, the buffers are
+     * mapped and copied into a ring of three frames. Readers always get the
+     * latest complete frame and never block the graphics thread.
+     */
+    class CameraReadback : public osg::Camera::DrawCallback {
+    public:
+      CameraReadback(osg::Texture2D *colorTexture,
+                     osg::Texture2D *depthTexture,
+                     int width, int height);
+      ~CameraReadback();
+
+      virtual void operator () (osg::RenderInfo& renderInfo) const;
+
+      /**
+       * If set, the callback only finishes the pending transfer and does
+       * not start a new one. Used for the frame after a capture, in which
+       * the camera does not draw.
+       */
+      void setReadbackOnly(bool readbackOnly);
+
+      /** \return false if no frame was captured yet */
+      bool getImage(char *buffer);
+      /** Raw depth buffer values, see utils::linearizeDepth. */
+      bool getDepth(uint32_t *buffer);
+      /** \return the number of frames completed so far */
+      unsigned long getFrameCount();
+
+    private:
+      static const int numSlots = 3;
+
+      osg::ref_ptr<osg::Texture2D> colorTexture, depthTexture;
+      int width, height;
+      bool readbackOnly;
+
+      // the GL objects are created lazily in the graphics context
+      mutable unsigned int pbo[2];
+      mutable bool initialized, pending;
+
+      mutable std::vector<char> colorSlots[numSlots];
+      mutable std::vector<uint32_t> depthSlots[numSlots];
+      mutable int latest, reading;
+      mutable unsigned long frameCount;
+      mutable utils::Mutex slotMutex;
+      // serializes the readers, each one claims the reading slot
+      utils::Mutex readMutex;
+
+      void initialize() const;
+      void finishTransfer() const;
+      void startTransfer(osg::RenderInfo &renderInfo) const;
+      int acquireWriteSlot() const;
+    }; // end of class CameraReadback
+
+  } // end of namespace graphics
+} // end of namespace mars
+
+#endif /* MARS_GRAPHICS_CAMERA_READBACK_H */
@@ -51,6 +51,7 @@
 
 #include "wrapper/OSGLightStruct.h"
 #include "wrapper/OSGMaterialStruct.h"
+#include "wrapper/OSGDebugDraw.h"
 #include "wrapper/OSGDrawItem.h"
 #include "wrapper/OSGHudElementStruct.h"
 
@@ -60,6 +61,9 @@
 #include "wrapper/OSGNodeStruct.h"
 #include "QtOsgMixGraphicsWidget.h"
 
+#include <mars/utils/AllocationTracker.h>
+
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <stdexcept>
@@ -200,9 +204,13 @@ namespace mars {
           showSelectionProp = cfg->getOrCreateProperty("Graphics",
                                                        "showSelection",
                                                        true, this);
+          cameraBatchSize = cfg->getOrCreateProperty("Graphics",
+                                                     "camera_batch_size",
+                                                     0, this);
         }
         else {
           marsShadow.bValue = false;
+          cameraBatchSize.iValue = 0;
         }
         globalStateset->setGlobalDefaults();
 
@@ -260,6 +268,8 @@ namespace mars {
         scene->setStateSet(globalStateset.get());
         scene->addChild(lightGroup.get());
         scene->addChild(shadowedScene.get());
+        debugDrawNode = new OSGDebugDraw;
+        scene->addChild(debugDrawNode.get());
 
         // init light (osg can have only 8 lights enabled at a time)
         for (unsigned int i =0; i<8;i++) {
@@ -498,6 +508,15 @@ namespace mars {
         draws[i].nodes.clear();
         draws[i].nodes = tmp_nodes;
       }
+
+      // batched debug primitives, uploaded with one buffer per type
+      if(debugDrawNode.valid()) {
+        debugDrawBuffer.clear();
+        for(size_t i=0; i<debugDraws.size(); ++i) {
+          debugDraws[i]->fillDebugDraw(&debugDrawBuffer);
+        }
+        debugDrawNode->update(debugDrawBuffer);
+      }
     }
 
     const mars::interfaces::GraphicData GraphicsManager::getGraphicOptions(void) const {
@@ -630,6 +649,57 @@ namespace mars {
       gw->getCameraInterface()->activateCam();
     }
 
+    void GraphicsManager::requestRTTFrame(unsigned long id) {
+      if(std::find(rttRequests.begin(), rttRequests.end(), id) ==
+         rttRequests.end()) {
+        rttRequests.push_back(id);
+      }
+    }
+
+    /**
+     * All requested cameras are rendered in the same frame, thus the scene
+     * is traversed by the cameras back to back while the read back of the
+     * textures runs asynchronously. In the next frame the cameras only
+     * finish the read back and are deactivated afterwards.
+     */
+    void GraphicsManager::updateRTTFrames() {
+      std::vector<unsigned long>::iterator it;
+      GraphicsWidget *gw;
+
+      for(it=rttReadback.begin(); it!=rttReadback.end(); ++it) {
+        if((gw = getGraphicsWindow(*it))) {
+          gw->setRTTReadbackOnly(false);
+          deactivate3DWindow(*it);
+        }
+      }
+      rttReadback.clear();
+
+      for(it=rttCapturing.begin(); it!=rttCapturing.end(); ++it) {
+        if((gw = getGraphicsWindow(*it))) {
+          gw->setRTTReadbackOnly(true);
+          rttReadback.push_back(*it);
+        }
+      }
+      rttCapturing.clear();
+
+      size_t batchSize = rttRequests.size();
+      if(cameraBatchSize.iValue > 0 &&
+         batchSize > (size_t)cameraBatchSize.iValue) {
+        batchSize = cameraBatchSize.iValue;
+      }
+      for(size_t i=0; i<batchSize; ++i) {
+        unsigned long id = rttRequests.front();
+        rttRequests.pop_front();
+        if(!(gw = getGraphicsWindow(id))) continue;
+        // a new frame finishes the pending read back as well
+        it = std::find(rttReadback.begin(), rttReadback.end(), id);
+        if(it != rttReadback.end()) rttReadback.erase(it);
+        gw->setRTTReadbackOnly(false);
+        activate3DWindow(id);
+        rttCapturing.push_back(id);
+      }
+    }
+
     GraphicsWindowInterface* GraphicsManager::get3DWindow(unsigned long id) const {
       std::vector<GraphicsWidget*>::const_iterator iter;
 
@@ -697,6 +767,7 @@ namespace mars {
     }
 
     void GraphicsManager::draw() {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_GRAPHICS);
       std::list<interfaces::GraphicsUpdateInterface*>::iterator it;
       std::vector<GraphicsWidget*>::iterator iter;
 
@@ -706,6 +777,7 @@ namespace mars {
       }
 
       update();
+      updateRTTFrames();
       for(iter=graphicsWindows.begin(); iter!=graphicsWindows.end(); iter++) {
         (*iter)->updateView();
       }
@@ -824,10 +896,8 @@ namespace mars {
 
 
     OSGNodeStruct* GraphicsManager::findDrawObject(unsigned long id) const {
-      map<unsigned long, osg::ref_ptr<OSGNodeStruct> >::const_iterator needle;
-      needle = drawObjects_.find(id);
-      if(needle == drawObjects_.end()) return NULL;
-      else return needle->second.get();
+      if(id < drawObjectIndex_.size()) return drawObjectIndex_[id];
+      return NULL;
     }
 
     unsigned long GraphicsManager::addDrawObject(const mars::interfaces::NodeData &snode,
@@ -843,6 +913,8 @@ namespace mars {
 
       DrawCoreIds.insert(pair<unsigned long int, unsigned long int>(id, snode.index));
       drawObjects_[id] = drawObject;
+      if(id >= drawObjectIndex_.size()) drawObjectIndex_.resize(id+1, NULL);
+      drawObjectIndex_[id] = drawObject.get();
 
       if(snode.isShadowCaster) {
         mask |= CastsShadowTraversalMask;
@@ -922,6 +994,7 @@ namespace mars {
         delete drawObject;
       }
       drawObjects_.erase(id);
+      drawObjectIndex_[id] = NULL;
     }
 
     void GraphicsManager::exportDrawObject(unsigned long id,
@@ -974,6 +1047,15 @@ namespace mars {
       OSGNodeStruct *ns = findDrawObject(id);
       if(ns != NULL) ns->object()->setQuaternion(q);
     }
+    void GraphicsManager::setDrawObjectPoses(const DrawObjectPoseList &poses) {
+      const size_t numObjects = drawObjectIndex_.size();
+      DrawObjectPoseList::const_iterator it;
+      for(it=poses.begin(); it!=poses.end(); ++it) {
+        if(it->id >= numObjects) continue;
+        OSGNodeStruct *ns = drawObjectIndex_[it->id];
+        if(ns != NULL) ns->object()->setPose(it->pos, it->rot);
+      }
+    }
     void GraphicsManager::setDrawObjectScale(unsigned long id, const Vector &ext) {
       OSGNodeStruct *ns = findDrawObject(id);
       if(ns != NULL) ns->object()->setScaledSize(ext);
@@ -1089,6 +1171,18 @@ namespace mars {
       draws.clear();
     }
 
+    void GraphicsManager::addDebugDrawInterface(DebugDrawInterface *iface) {
+      if(std::find(debugDraws.begin(), debugDraws.end(), iface) ==
+         debugDraws.end()) {
+        debugDraws.push_back(iface);
+      }
+    }
+
+    void GraphicsManager::removeDebugDrawInterface(DebugDrawInterface *iface) {
+      debugDraws.erase(std::remove(debugDraws.begin(), debugDraws.end(), iface),
+                       debugDraws.end());
+    }
+
     ///// LIGHT
 
     void GraphicsManager::addLight(mars::interfaces::LightData &ls) {
@@ -1886,6 +1980,11 @@ namespace mars {
         return;
       }
 
+      if(_property.paramId == cameraBatchSize.paramId) {
+        cameraBatchSize.iValue = _property.iValue;
+        return;
+      }
+
       if(_property.paramId == backfaceCulling.paramId) {
         if((backfaceCulling.bValue = _property.bValue))
           globalStateset->setAttributeAndModes(cull, osg::StateAttribute::ON);
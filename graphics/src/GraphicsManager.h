@@ -41,6 +41,8 @@
 #include <osgViewer/CompositeViewer>
 #include <osg/CullFace>
 
+#include <deque>
+
 #include <osgShadow/ShadowedScene>
 #include <osgShadow/LightSpacePerspectiveShadowMap>
 #include <osgShadow/ParallelSplitShadowMap>
@@ -83,6 +85,7 @@ namespace mars {
     class DrawObject;
     class OSGNodeStruct;
     class OSGHudElementStruct;
+    class OSGDebugDraw;
     class HUDElement;
 
 
@@ -131,6 +134,8 @@ namespace mars {
       virtual void addDrawItems(interfaces::drawStruct *draw); ///< Adds drawStruct items to the graphics scene.
       virtual void removeDrawItems(interfaces::DrawInterface *iface);
       virtual void clearDrawItems(void);
+      virtual void addDebugDrawInterface(interfaces::DebugDrawInterface *iface);
+      virtual void removeDebugDrawInterface(interfaces::DebugDrawInterface *iface);
 
       virtual void addLight(mars::interfaces::LightData &ls); ///< adds a light to the scene
       virtual void removeLight(unsigned int index); ///< removes a light from the scene
@@ -145,6 +150,7 @@ namespace mars {
       virtual void removeDrawObject(unsigned long id);
       virtual void setDrawObjectPos(unsigned long id, const mars::utils::Vector &pos);
       virtual void setDrawObjectRot(unsigned long id, const mars::utils::Quaternion &q);
+      virtual void setDrawObjectPoses(const mars::interfaces::DrawObjectPoseList &poses);
       virtual void setDrawObjectScale(unsigned long id, const mars::utils::Vector &ext);
       virtual void setDrawObjectMaterial(unsigned long id,
                                          const mars::interfaces::MaterialData &material);
@@ -162,6 +168,7 @@ namespace mars {
                                     const std::string &name) const;
       virtual void deactivate3DWindow(unsigned long id);
       virtual void activate3DWindow(unsigned long id);
+      virtual void requestRTTFrame(unsigned long id);
       /** \brief creates a preview node */
       void preview(int action, bool resize, const std::vector<mars::interfaces::NodeData> &allNodes,
                    unsigned int num = 0, const mars::interfaces::MaterialData *mat = 0);
@@ -368,6 +375,8 @@ namespace mars {
       std::vector<nodemanager> myNodes;
       DrawObjects previewNodes_;
       DrawObjects drawObjects_;
+      // dense lookup by id; the ids are handed out sequentially
+      std::vector<OSGNodeStruct*> drawObjectIndex_;
       // object selection
       DrawObjectList selectedObjects_;
       std::list<interfaces::GraphicsUpdateInterface*> graphicsUpdateObjects;
@@ -377,7 +386,14 @@ namespace mars {
 
       // mapper vectors
       std::vector<drawMapper> draws; //drawStructs
+      std::vector<interfaces::DebugDrawInterface*> debugDraws;
+      interfaces::DebugDrawBuffer debugDrawBuffer;
+      osg::ref_ptr<OSGDebugDraw> debugDrawNode;
       std::vector<GraphicsWidget*> graphicsWindows;
+      // render to texture windows waiting for a frame, rendered in this
+      // frame and finishing their read back in this frame
+      std::deque<unsigned long> rttRequests;
+      std::vector<unsigned long> rttCapturing, rttReadback;
 
       osg::ref_ptr<ShadowMap> shadowMap;
 
@@ -399,6 +415,7 @@ namespace mars {
       cfg_manager::cfgPropertyStruct resources_path;
       cfg_manager::cfgPropertyStruct configPath;
       cfg_manager::cfgPropertyStruct shadowSamples;
+      cfg_manager::cfgPropertyStruct cameraBatchSize;
       int ignore_next_resize;
       bool set_window_prop;
       osg::ref_ptr<osg::CullFace> cull;
@@ -414,6 +431,7 @@ namespace mars {
       void setUseShader(bool val);
 
       void initDefaultLight();
+      void updateRTTFrames();
 
     }; // end of class GraphicsManager
 
@@ -24,6 +24,7 @@
 #include "GraphicsManager.h"
 
 #include <mars/utils/Color.h>
+#include <mars/utils/depthUtils.h>
 
 #include <iostream>
 #include <string>
@@ -893,17 +894,17 @@ namespace mars {
 
 
 
-        rttImage = new osg::Image();
-        rttImage->allocateImage(widgetWidth, widgetHeight,
-                                1, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV);
-        osgCamera->attach(osg::Camera::COLOR_BUFFER, rttImage.get());
-        rttTexture->setImage(rttImage);
+        // the cameras render directly into the textures, the HUD samples
+        // them on the GPU and the sensors get the pixels asynchronously
+        // by CameraReadback
+        osgCamera->attach(osg::Camera::COLOR_BUFFER, rttTexture.get());
 
         // depth component
         rttDepthTexture = new osg::Texture2D();
         rttDepthTexture->setResizeNonPowerOfTwoHint(false);
         rttDepthTexture->setDataVariance(osg::Object::DYNAMIC);
         rttDepthTexture->setTextureSize(widgetWidth, widgetHeight);
+        rttDepthTexture->setInternalFormat(GL_DEPTH_COMPONENT24);
         rttDepthTexture->setSourceType(GL_UNSIGNED_INT);
         rttDepthTexture->setSourceFormat(GL_DEPTH_COMPONENT);
         rttDepthTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::REPEAT);
@@ -912,15 +913,13 @@ namespace mars {
                                    osg::Texture2D::LINEAR);
         rttDepthTexture->setFilter(osg::Texture2D::MAG_FILTER,
                                    osg::Texture2D::LINEAR);
-        rttDepthImage = new osg::Image();
-        rttDepthImage->allocateImage(widgetWidth, widgetHeight,
-                                     1, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT);
+        osgCamera->attach(osg::Camera::DEPTH_BUFFER, rttDepthTexture.get());
 
-        osgCamera->attach(osg::Camera::DEPTH_BUFFER, rttDepthImage.get());
-        
-        std::fill(rttDepthImage->data(), rttDepthImage->data() + widgetWidth * widgetHeight * sizeof(GLuint), 0);
-        
-        rttDepthTexture->setImage(rttDepthImage);
+        rttReadback = new CameraReadback(rttTexture.get(),
+                                         rttDepthTexture.get(),
+                                         widgetWidth, widgetHeight);
+        osgCamera->setPostDrawCallback(rttReadback.get());
+        rttClearMask = osgCamera->getClearMask();
 
 
       }
@@ -1054,10 +1053,9 @@ namespace mars {
     void GraphicsWidget::getImageData(char* buffer, int& width, int& height)
     {
       if(isRTTWidget) {
-        osg::Image *image = rttImage;
-        width = image->s();
-        height = image->t();
-        memcpy(buffer, image->data(), width*height*4);
+        width = widgetWidth;
+        height = widgetHeight;
+        rttReadback->getImage(buffer);
       }
       else
       {
@@ -1071,8 +1069,8 @@ namespace mars {
 
     void GraphicsWidget::getImageData(void **data, int &width, int &height) {
       if(isRTTWidget) {
-        width = rttImage->s();
-        height = rttImage->t();
+        width = widgetWidth;
+        height = widgetHeight;
         *data = malloc(width*height*4);
         getImageData((char *) *data, width, height);
       }
@@ -1084,26 +1082,15 @@ namespace mars {
     void GraphicsWidget::getRTTDepthData(float* buffer, int& width, int& height)
     {
       if(isRTTWidget) {
-        GLuint* data2 = (GLuint *)rttDepthImage->data();
-        width = rttDepthImage->s();
-        height = rttDepthImage->t();
+        width = widgetWidth;
+        height = widgetHeight;
+        rttDepthBuffer.resize(width*height);
+        rttReadback->getDepth(rttDepthBuffer.data());
 
         double fovy, aspectRatio, Zn, Zf;
         graphicsCamera->getOSGCamera()->getProjectionMatrixAsPerspective( fovy, aspectRatio, Zn, Zf );
-        int d = 0;
-        for(int i=height-1; i>=0; --i) {
-          for(int k=0; k<width; ++k) {
-              GLuint di = data2[i*width+k];
-              
-            const float dv = ((float) di) / std::numeric_limits< GLuint >::max() ;
-            // 1.0 is the max depth in the depth buffer, and
-            // is represented as a nan in the distance image
-            if( dv >= 1.0 )
-              buffer[d++] = std::numeric_limits<float>::quiet_NaN();
-            else
-              buffer[d++] = Zn*Zf/(Zf-dv*(Zf-Zn));
-          }
-        }
+        utils::linearizeDepth(rttDepthBuffer.data(),
+                              width, height, Zn, Zf, buffer);
       } else {
         throw std::runtime_error("Depth image not supported on non RTT Widges");
       }
@@ -1111,15 +1098,24 @@ namespace mars {
 
     void GraphicsWidget::getRTTDepthData(float **data, int &width, int &height) {
       if(isRTTWidget) {
-        width = rttDepthImage->s();
-        height = rttDepthImage->t();
+        width = widgetWidth;
+        height = widgetHeight;
         *data = (float*)malloc(width*height*sizeof(float));
-        getRTTDepthData(data, width, height);
+        getRTTDepthData(*data, width, height);
       } else {
         throw std::runtime_error("Depth image not supported on non RTT Widges");
       }
     }
 
+    void GraphicsWidget::setRTTReadbackOnly(bool readbackOnly) {
+      if(!isRTTWidget) return;
+      osg::Camera *camera = graphicsCamera->getOSGCamera();
+      // keep the textures untouched, the HUD may still show them
+      camera->setCullMask(readbackOnly ? 0 : CULL_LAYER);
+      camera->setClearMask(readbackOnly ? 0 : rttClearMask);
+      rttReadback->setReadbackOnly(readbackOnly);
+    }
+
     bool GraphicsWidget::handle(
                                 const osgGA::GUIEventAdapter& ea,
                                 osgGA::GUIActionAdapter& aa)
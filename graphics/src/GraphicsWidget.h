@@ -28,6 +28,7 @@
 #include "gui_helper_functions.h"
 #include "GraphicsCamera.h"
 #include "PostDrawCallback.h"
+#include "CameraReadback.h"
 
 #include <mars/interfaces/MARSDefs.h>
 #include <mars/utils/Vector.h>
@@ -192,6 +193,13 @@ namespace mars {
        * */
       virtual void getRTTDepthData(float *buffer, int &width, int &height);
       virtual void getRTTDepthData(float **data, int &width, int &height);
+
+      /**
+       * Switches a render to texture window between a normal frame and a
+       * frame that only finishes the read back of the previous one without
+       * culling or drawing the scene.
+       */
+      void setRTTReadbackOnly(bool readbackOnly);
   
       virtual osg::Group* getScene(){
         return scene;
@@ -282,13 +290,15 @@ namespace mars {
 
       // destination texture if isRTTWidget==true
       osg::ref_ptr<osg::Texture2D> rttTexture;
-      // destination image if isRTTWidget==true
-      osg::ref_ptr<osg::Image> rttImage;
 
       // destination texture if isRTTWidget==true
       osg::ref_ptr<osg::Texture2D> rttDepthTexture;
-      // destination image if isRTTWidget==true
-      osg::ref_ptr<osg::Image> rttDepthImage;
+
+      // copies the textures to the cpu if isRTTWidget==true
+      osg::ref_ptr<CameraReadback> rttReadback;
+      // raw depth values before linearization
+      std::vector<uint32_t> rttDepthBuffer;
+      GLbitfield rttClearMask;
 
       // list of picked objects
       std::vector<osg::Node*> pickedObjects;
@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * OSGDebugDraw.cpp
+ *
+ *  Uploads the batched debug primitives of all DebugDrawInterfaces.
+ */
+
+#include "OSGDebugDraw.h"
+
+#include <osg/LineWidth>
+#include <osg/Point>
+
+#include <cstring>
+
+namespace mars {
+  namespace graphics {
+
+    using mars::interfaces::DebugDrawBuffer;
+
+    OSGDebugDraw::OSGDebugDraw(float lineWidth, float pointSize)
+      : osg::Geode() {
+
+      createBatch(&lines, osg::PrimitiveSet::LINES);
+      createBatch(&points, osg::PrimitiveSet::POINTS);
+
+      osg::StateSet *states = getOrCreateStateSet();
+      states->setAttributeAndModes(new osg::LineWidth(lineWidth),
+                                   osg::StateAttribute::ON);
+      states->setAttributeAndModes(new osg::Point(pointSize),
+                                   osg::StateAttribute::ON);
+      states->setMode(GL_LIGHTING,
+                      osg::StateAttribute::OFF | osg::StateAttribute::PROTECTED);
+      states->setMode(GL_FOG, osg::StateAttribute::OFF);
+      setDataVariance(osg::Object::DYNAMIC);
+    }
+
+    void OSGDebugDraw::createBatch(Batch *batch, GLenum mode) {
+      batch->geometry = new osg::Geometry;
+      batch->vertices = new osg::Vec3Array;
+      batch->colors = new osg::Vec4Array;
+      batch->primitives = new osg::DrawArrays(mode, 0, 0);
+
+      batch->geometry->setDataVariance(osg::Object::DYNAMIC);
+      batch->geometry->setUseDisplayList(false);
+      batch->geometry->setUseVertexBufferObjects(true);
+      batch->geometry->setVertexArray(batch->vertices.get());
+      batch->geometry->setColorArray(batch->colors.get());
+      batch->geometry->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+      batch->geometry->addPrimitiveSet(batch->primitives.get());
+      addDrawable(batch->geometry.get());
+    }
+
+    void OSGDebugDraw::updateBatch(Batch *batch,
+                                   const std::vector<float> &vertices,
+                                   const std::vector<float> &colors) {
+      const size_t count = vertices.size() / 3;
+      if(count == 0 && batch->primitives->getCount() == 0) return;
+
+      // osg::Vec3Array and osg::Vec4Array are tightly packed floats
+      batch->vertices->resize(count);
+      batch->colors->resize(count);
+      if(count) {
+        memcpy(&(*batch->vertices)[0], &vertices[0], count*3*sizeof(float));
+        memcpy(&(*batch->colors)[0], &colors[0], count*4*sizeof(float));
+      }
+      batch->vertices->dirty();
+      batch->colors->dirty();
+      batch->primitives->setCount(count);
+      batch->primitives->dirty();
+      batch->geometry->dirtyBound();
+    }
+
+    void OSGDebugDraw::update(const DebugDrawBuffer &buffer) {
+      updateBatch(&lines, buffer.lineVertices, buffer.lineColors);
+      updateBatch(&points, buffer.pointVertices, buffer.pointColors);
+    }
+
+  } // end of namespace graphics
+} // end of namespace mars
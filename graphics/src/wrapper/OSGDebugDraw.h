@@ -0,0 +1,74 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * OSGDebugDraw.h
+ *
+ *  Uploads the batched debug primitives of all DebugDrawInterfaces.
+ */
+
+#ifndef MARS_GRAPHICS_OSGDEBUGDRAW_H
+#define MARS_GRAPHICS_OSGDEBUGDRAW_H
+
+#include <mars/interfaces/graphics/DebugDrawInterface.h>
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/PrimitiveSet>
+
+namespace mars {
+  namespace graphics {
+
+    /**
+     * Wraps DebugDrawBuffer in osg::Geode.
+     *
+     * There is one geometry with a dynamic vertex buffer per primitive type.
+     * The arrays are resized in place every frame, so the scene graph does
+     * not change and no memory is allocated once the capacity is reached.
+     */
+    class OSGDebugDraw : public osg::Geode
+    {
+    public:
+      OSGDebugDraw(float lineWidth = 2.0f, float pointSize = 5.0f);
+
+      /**
+       * copies the vertices of \a buffer into the vertex buffers
+       */
+      void update(const interfaces::DebugDrawBuffer &buffer);
+
+    private:
+      struct Batch {
+        osg::ref_ptr<osg::Geometry> geometry;
+        osg::ref_ptr<osg::Vec3Array> vertices;
+        osg::ref_ptr<osg::Vec4Array> colors;
+        osg::ref_ptr<osg::DrawArrays> primitives;
+      };
+
+      Batch lines, points;
+
+      void createBatch(Batch *batch, GLenum mode);
+      static void updateBatch(Batch *batch, const std::vector<float> &vertices,
+                              const std::vector<float> &colors);
+    };
+
+  } // end of namespace graphics
+} // end of namespace mars
+
+#endif /* MARS_GRAPHICS_OSGDEBUGDRAW_H */
@@ -0,0 +1,111 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_INTERFACES_TERRAIN_DIRTY_REGIONS_H
+#define MARS_INTERFACES_TERRAIN_DIRTY_REGIONS_H
+
+#ifdef _PRINT_HEADER_
+  #warning "TerrainDirtyRegions.h"
+#endif
+
+#include <mars/utils/Mutex.h>
+#include <mars/utils/MutexLocker.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace mars {
+  namespace interfaces {
+
+    /**
+     * A rectangle of height map pixels, the bounds are inclusive.
+     * x is the column and y the row in terrainStruct::pixelData.
+     */
+    struct TerrainRegion {
+      int x0, y0, x1, y1;
+
+      bool touches(const TerrainRegion &r) const {
+        return (x0 <= r.x1+1 && r.x0 <= x1+1 &&
+                y0 <= r.y1+1 && r.y0 <= y1+1);
+      }
+
+      void merge(const TerrainRegion &r) {
+        x0 = std::min(x0, r.x0);
+        y0 = std::min(y0, r.y0);
+        x1 = std::max(x1, r.x1);
+        y1 = std::max(y1, r.y1);
+      }
+    }; // end of struct TerrainRegion
+
+    /**
+     * \brief Collects the regions of a deformable height map that changed.
+     *
+     * The physics adds a region whenever it writes to the height buffer,
+     * the graphics takes all regions once per frame and updates only the
+     * affected vertices. Touching regions are merged, thus several wheels
+     * on the same track produce a single rectangle.
+     * Both sides access terrainStruct::pixelData only while they hold the
+     * buffer mutex.
+     */
+    class TerrainDirtyRegions {
+    public:
+      void add(int x0, int y0, int x1, int y1) {
+        TerrainRegion r = {x0, y0, x1, y1};
+        utils::MutexLocker locker(&mutex);
+        for(size_t i=0; i<regions.size(); ++i) {
+          if(regions[i].touches(r)) {
+            regions[i].merge(r);
+            return;
+          }
+        }
+        if(regions.size() >= maxRegions) {
+          // too many scattered updates, one bounding rectangle is cheaper
+          for(size_t i=1; i<regions.size(); ++i) {
+            regions[0].merge(regions[i]);
+          }
+          regions.resize(1);
+          regions[0].merge(r);
+          return;
+        }
+        regions.push_back(r);
+      }
+
+      utils::Mutex* getBufferMutex() {
+        return &bufferMutex;
+      }
+
+      /** Moves all collected regions into \a out. */
+      void take(std::vector<TerrainRegion> *out) {
+        out->clear();
+        utils::MutexLocker locker(&mutex);
+        out->swap(regions);
+      }
+
+    private:
+      static const size_t maxRegions = 16;
+      utils::Mutex mutex;
+      std::vector<TerrainRegion> regions;
+      utils::Mutex bufferMutex;
+    }; // end of class TerrainDirtyRegions
+
+  } // end of namespace interfaces
+} // end of namespace mars
+
+#endif  /* MARS_INTERFACES_TERRAIN_DIRTY_REGIONS_H */
@@ -0,0 +1,117 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_INTERFACES_GRAPHICS_DEBUG_DRAW_INTERFACE_H
+#define MARS_INTERFACES_GRAPHICS_DEBUG_DRAW_INTERFACE_H
+
+#ifdef _PRINT_HEADER_
+  #warning "DebugDrawInterface.h"
+#endif
+
+#include <mars/utils/Color.h>
+#include <mars/utils/Vector.h>
+
+#include <vector>
+
+namespace mars {
+  namespace interfaces {
+
+    /**
+     * \brief Vertex data of all debug primitives of one frame.
+     *
+     * The buffer is cleared but not freed at the beginning of every frame,
+     * thus filling it does not allocate once the capacity is reached.
+     */
+    struct DebugDrawBuffer {
+      // x, y, z per vertex; two vertices per line
+      std::vector<float> lineVertices;
+      // r, g, b, a per vertex
+      std::vector<float> lineColors;
+      std::vector<float> pointVertices;
+      std::vector<float> pointColors;
+
+      void clear() {
+        lineVertices.clear();
+        lineColors.clear();
+        pointVertices.clear();
+        pointColors.clear();
+      }
+
+      void addLine(const utils::Vector &start, const utils::Vector &end,
+                   const utils::Color &color) {
+        addVertex(&lineVertices, &lineColors, start, color);
+        addVertex(&lineVertices, &lineColors, end, color);
+      }
+
+      void addPoint(const utils::Vector &pos, const utils::Color &color) {
+        addVertex(&pointVertices, &pointColors, pos, color);
+      }
+
+      void append(const DebugDrawBuffer &other) {
+        lineVertices.insert(lineVertices.end(), other.lineVertices.begin(),
+                            other.lineVertices.end());
+        lineColors.insert(lineColors.end(), other.lineColors.begin(),
+                          other.lineColors.end());
+        pointVertices.insert(pointVertices.end(), other.pointVertices.begin(),
+                             other.pointVertices.end());
+        pointColors.insert(pointColors.end(), other.pointColors.begin(),
+                           other.pointColors.end());
+      }
+
+      size_t getNumLines() const { return lineVertices.size() / 6; }
+      size_t getNumPoints() const { return pointVertices.size() / 3; }
+
+    private:
+      static void addVertex(std::vector<float> *vertices,
+                            std::vector<float> *colors,
+                            const utils::Vector &v, const utils::Color &c) {
+        vertices->push_back(v.x());
+        vertices->push_back(v.y());
+        vertices->push_back(v.z());
+        colors->push_back(c.r);
+        colors->push_back(c.g);
+        colors->push_back(c.b);
+        colors->push_back(c.a);
+      }
+    }; // end of struct DebugDrawBuffer
+
+    /**
+     * The interface DebugDrawInterface is used for batched debug drawing.
+     * In contrast to DrawInterface the producers do not own scene nodes.
+     * Every frame they append their primitives to a shared buffer that is
+     * uploaded to the graphics card at once.
+     */
+    class DebugDrawInterface {
+
+    public:
+      /**
+       * Called once per frame from the graphics thread. Append the
+       * primitives of the current state to \a buffer. Producers registered
+       * with SimulatorInterface::addPhysicsDebugDrawInterface are called
+       * after each simulation step in the physics thread instead.
+       */
+      virtual void fillDebugDraw(DebugDrawBuffer *buffer) = 0;
+      virtual ~DebugDrawInterface(){}
+    }; // end of class DebugDrawInterface
+
+  } // end of namespace interfaces
+} // end of namespace mars
+
+#endif  /* MARS_INTERFACES_GRAPHICS_DEBUG_DRAW_INTERFACE_H */
@@ -31,6 +31,7 @@
 #include "GuiEventInterface.h"
 #include "GraphicsEventClient.h"
 #include "draw_structs.h"
+#include "DebugDrawInterface.h"
 #include "../NodeData.h"
 #include "../GraphicData.h"
 #include "../LightData.h"
@@ -73,6 +74,9 @@ namespace mars {
       virtual void addDrawItems(drawStruct *draw) = 0; ///< Adds \c drawStruct items to the graphics scene
       virtual void removeDrawItems(DrawInterface *iface) = 0;
       virtual void clearDrawItems(void) = 0;
+      /** Registers \c iface to fill the batched debug draw buffer every frame. */
+      virtual void addDebugDrawInterface(DebugDrawInterface *iface) = 0;
+      virtual void removeDebugDrawInterface(DebugDrawInterface *iface) = 0;
 
       virtual void addLight(LightData &ls) = 0; ///< Adds a light to the scene.
 
@@ -85,6 +89,8 @@ namespace mars {
                                     const mars::utils::Vector &pos) = 0;
       virtual void setDrawObjectRot(unsigned long id,
                                     const mars::utils::Quaternion &q) = 0;
+      /** Sets position and rotation of all draw objects in \c poses at once. */
+      virtual void setDrawObjectPoses(const DrawObjectPoseList &poses) = 0;
       virtual void setDrawObjectScale(unsigned long id,
                                       const mars::utils::Vector &ext) = 0;
       virtual void setDrawObjectMaterial(unsigned long id, 
@@ -218,6 +224,14 @@ namespace mars {
       virtual void setExperimentalLineLaser(utils::Vector pos, utils::Vector normal, utils::Vector color, utils::Vector laserAngle, float openingAngle) = 0;
       virtual void deactivate3DWindow(unsigned long id) = 0;
       virtual void activate3DWindow(unsigned long id) = 0;
+      /**
+       * Requests one frame of a render to texture window. The window is
+       * activated for a single frame together with all other requested
+       * windows and the result is read back asynchronously in the frame
+       * after. At most "Graphics/camera_batch_size" windows are rendered
+       * per frame, further requests are delayed to the next frames.
+       */
+      virtual void requestRTTFrame(unsigned long id) = 0;
 
       // be carful with this method, only add a valid pointer osg::Node*
       virtual void addOSGNode(void* node) = 0;
@@ -35,9 +35,11 @@
 
 #include <mars/utils/Color.h>
 #include <mars/utils/Vector.h>
+#include <mars/utils/Quaternion.h>
 
 #include <string>
 #include <vector>
+#include <Eigen/StdVector>
 
 
 #define DRAW_STATE_CREATE    1
@@ -113,6 +115,22 @@ namespace mars {
     }; // end of struct drawStruct
 
 
+    /**
+     * \brief position and orientation of one draw object, used to update
+     * many draw objects with one call of
+     * GraphicsManagerInterface::setDrawObjectPoses
+     */
+    struct DrawObjectPose {
+      unsigned long id;
+      mars::utils::Vector pos;
+      mars::utils::Quaternion rot;
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    }; // end of struct DrawObjectPose
+
+    // the quaternion is a fixed-size vectorizable Eigen type
+    typedef std::vector<DrawObjectPose,
+                        Eigen::aligned_allocator<DrawObjectPose> > DrawObjectPoseList;
+
     struct hudElementStruct {
       int id;
       int type;
@@ -31,6 +31,8 @@
 #include <mars/utils/Quaternion.h>
 #include <mars/utils/Vector.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <limits>
 
@@ -53,9 +55,27 @@ namespace mars {
       envire::core::FrameId frame;
     }; // end of class BaseConfig
 
+    /**
+     * Activity and cost counters of a sensor, see
+     * SensorManagerInterface::getSensorStats.
+     */
+    struct SensorStats {
+      SensorStats() : active(true), consumers(0), updates(0), skipped(0),
+                      reads(0), updateTime(0) {}
+      bool active;
+      //! number of registered consumers like controllers
+      int consumers;
+      //! updates done while active and skipped while inactive
+      unsigned long updates, skipped;
+      //! reads through the SensorManager
+      unsigned long reads;
+      //! time spent in ray casting in microseconds
+      long long updateTime;
+    }; // end of struct SensorStats
+
     class BaseSensor {
     public:
-      BaseSensor()
+      BaseSensor() : demandDriven(false), active(true)
       {
         id = 0;
         name = "UNKNOWN";
@@ -65,7 +85,9 @@ namespace mars {
 
       BaseSensor(unsigned long id, std::string name):
         id(id),
-        name(name)
+        name(name),
+        demandDriven(false),
+        active(true)
       {
       }
 
@@ -87,14 +109,122 @@ namespace mars {
         return this->frame;
       }
       
+      /**
+       * Allocating read of the sensor values, the caller has to free() the
+       * returned array. Kept for compatibility; sensors implement
+       * readSensorData and callers should use it or appendSensorData.
+       */
       virtual int getSensorData(double **data) const{
-        return 0;
+        countRead();
+        *data = 0;
+        int size = readSensorData(0, 0);
+        if(size <= 0) return 0;
+        *data = (double*)malloc(size*sizeof(double));
+        int n = readSensorData(*data, size);
+        // the number of values changed between the two calls
+        return n <= size ? n : 0;
       };
 
+      /**
+       * Copies the current sensor values into the caller owned \a data
+       * without allocating. Nothing is written if the values do not fit
+       * into \a size, thus readSensorData(0, 0) queries their number.
+       * \return the number of values of the sensor, or -1 if the sensor
+       *         only implements getSensorData
+       */
+      virtual int readSensorData(double *data, int size) const{
+        return -1;
+      }
+
+      /**
+       * Appends the current sensor values to \a values. A vector that is
+       * reused for every read does not allocate once its capacity fits.
+       * \return the number of appended values
+       */
+      int appendSensorData(std::vector<double> *values) const{
+        countRead();
+        size_t offset = values->size();
+        double *data;
+        int n;
+        while(true) {
+          values->resize(values->capacity());
+          data = values->empty() ? 0 : &(*values)[0];
+          n = readSensorData(data+offset, values->size()-offset);
+          if(n < 0 || (size_t)n <= values->size()-offset) break;
+          values->reserve(offset+n);
+        }
+        if(n < 0) {
+          // sensors that only implement the allocating interface
+          data = 0;
+          values->resize(offset);
+          n = getSensorData(&data);
+          if(n > 0) values->insert(values->end(), data, data+n);
+          free(data);
+          return n > 0 ? n : 0;
+        }
+        values->resize(offset+n);
+        return n;
+      }
+
       virtual int getAsciiData(char *data) const{
         return 0;
       }
 
+      /**
+       * Demand driven sensors skip their update while they are inactive.
+       * The SensorManager decides about the activity once per step, based
+       * on consumers, reads and data broker receivers.
+       */
+      bool isDemandDriven() const{
+        return demandDriven;
+      }
+
+      bool isActive() const{
+        return active;
+      }
+
+      void setActive(bool active_){
+        active = active_;
+      }
+
+      /**
+       * Called at the beginning of an update.
+       * \return false if the sensor is inactive and the update is skipped
+       */
+      bool beginUpdate(){
+        if(!active) {
+          ++stats.skipped;
+          return false;
+        }
+        ++stats.updates;
+        return true;
+      }
+
+      void addUpdateTime(long long microseconds){
+        stats.updateTime += microseconds;
+      }
+
+      /**
+       * Keeps a demand driven sensor active, see
+       * SensorManager::updateSensorActivity. Called by all read paths.
+       */
+      void countRead() const{
+        ++stats.reads;
+      }
+
+      const SensorStats& getStats() const{
+        return stats;
+      }
+
+      /** The data broker item the sensor produces, empty if none. */
+      const std::string& getProducedGroupName() const{
+        return producedGroupName;
+      }
+
+      const std::string& getProducedDataName() const{
+        return producedDataName;
+      }
+
       void getCoreExchange(core_objects_exchange* obj) const{
         obj->index = id;
         obj->name = name;
@@ -124,6 +254,10 @@ namespace mars {
       envire::core::FrameId frame;
       
     protected:
+      bool demandDriven, active;
+      // the reads are counted by const accessors
+      mutable SensorStats stats;
+      std::string producedGroupName, producedDataName;
 
     }; // end of class BaseSensor
 
@@ -259,10 +393,12 @@ namespace mars {
       }
       virtual ~BasePolarIntersectionSensor(){}
 
-      virtual int getSensorData(double **data) const{
-        (*data) = (new double[this->data.size()]);
-        memcpy((*data),&this->data[0],sizeof(double)*this->data.size());
-        return this->data.size();
+      virtual int readSensorData(double *data, int size) const{
+        int n = this->data.size();
+        if(n <= size) {
+          memcpy(data, &this->data[0], sizeof(double)*n);
+        }
+        return n;
       };
 
 
@@ -183,6 +183,13 @@ namespace mars {
        */
       virtual unsigned long getID(const std::string &joint_name) const = 0;
 
+      /**
+       * Retrieve the ids of several joints by name
+       * \param joint_names Names of the joints to get the ids for
+       * \return Ids in the order of \a joint_names, 0 for unknown names
+       */
+      virtual std::vector<unsigned long> getIDs(const std::vector<std::string> &joint_names) const = 0;
+
       /**
        * Retrieves the \a groupName and \a dataName under which the joint with the
        * specified \a id publishes its data in the DataBroker
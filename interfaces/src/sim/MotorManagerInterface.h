@@ -298,6 +298,15 @@ namespace mars {
        * \return Id of the motor if it exists, otherwise 0
        */
       virtual unsigned long getID(const std::string& motor_name) const = 0;
+
+      /**
+       * \brief Retrieves the ids of several motors by name
+       *
+       * \param motor_names Names of the motors to get the ids for
+       *
+       * \return Ids in the order of \c motor_names, 0 for unknown names
+       */
+      virtual std::vector<unsigned long> getIDs(const std::vector<std::string> &motor_names) const = 0;
   
       /**
        * \brief Detaches the joint with the given index from all motors that act on
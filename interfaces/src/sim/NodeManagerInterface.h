@@ -38,6 +38,7 @@
 #include "../sensor_bases.h"
 #include "../NodeData.h"
 #include "../nodeState.h"
+#include "../graphics/draw_structs.h"
 
 #include <mars/utils/Vector.h>
 #include <mars/utils/Quaternion.h>
@@ -724,6 +725,16 @@ namespace mars {
 
       /** \todo write docs */
       virtual void updateRay(NodeId id) = 0;
+      /**
+       * Appends the draw object poses for a world snapshot to \a poses.
+       * Called in the physics thread. Moving nodes are always added, static
+       * nodes only if they changed after snapshot \a consumedVersion, the
+       * last one the renderer applied.
+       * \param version The version of the snapshot that is filled.
+       */
+      virtual void fillDrawPoses(DrawObjectPoseList *poses,
+                                 unsigned long version,
+                                 unsigned long consumedVersion) = 0;
       /** \todo write docs */
       virtual NodeId getDrawID(NodeId id) const = 0;
       /** \todo write docs */
@@ -737,6 +748,12 @@ namespace mars {
        * \return Id of the node if it exists, otherwise 0
        */
       virtual NodeId getID(const std::string& node_name) const = 0;
+      /**
+       * Retrieve the ids of several nodes by name
+       * \param node_names Names of the nodes to get the ids for
+       * \return Ids in the order of \a node_names, 0 for unknown names
+       */
+      virtual std::vector<NodeId> getIDs(const std::vector<std::string> &node_names) const = 0;
       /** \todo write docs */
       virtual double getCollisionDepth(NodeId id) const = 0;
 
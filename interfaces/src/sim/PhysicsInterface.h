@@ -34,6 +34,7 @@
 #include "../MARSDefs.h"
 
 #include <mars/utils/Vector.h>
+#include <mars/utils/Quaternion.h>
 
 #include <vector>
 
@@ -55,9 +56,37 @@ namespace mars {
       sReal ground_friction, ground_cfm, ground_erp;
       sReal step_size; /**< Step size in seconds */
       utils::Vector world_gravity;
+      /** Use the iterative dWorldQuickStep instead of dWorldStep. */
       bool fast_step;
+      /**
+       * Parameters of the iterative solver. With adaptive_iterations the
+       * number of iterations is chosen per step between a lower bound and
+       * max_iterations, such that the joint constraint error (the largest
+       * separation of two joint anchors in m) stays below
+       * max_constraint_error.
+       */
+      int quickstep_iterations, max_iterations;
+      sReal quickstep_sor;
+      bool adaptive_iterations;
+      sReal max_constraint_error;
       bool draw_contact_points;
       sReal world_cfm, world_erp;
+      /**
+       * Bodies whose linear and angular velocity stay below the thresholds
+       * (m/s, rad/s) for sleep_time seconds are put to sleep. Sleeping
+       * bodies are neither integrated nor collided with each other and
+       * wake up on contact with an awake body, applied forces, motor
+       * commands and when they are moved.
+       */
+      bool body_sleeping;
+      sReal sleep_linear_threshold, sleep_angular_threshold, sleep_time;
+      /**
+       * In deterministic mode the random generator of the solver is seeded
+       * with random_seed whenever the world is created, thus a reset
+       * simulation repeats a fresh one. Has to be set before initTheWorld.
+       */
+      bool deterministic;
+      unsigned long random_seed;
 
       virtual ~PhysicsInterface() {}
       virtual void initTheWorld(void) = 0;
@@ -67,6 +96,32 @@ namespace mars {
       virtual const utils::Vector getCenterOfMass(const std::vector<NodeInterface*> &nodes) const = 0;
       virtual int checkCollisions(void) = 0;
       virtual sReal getVectorCollision(const utils::Vector &pos, const utils::Vector &ray) const = 0;
+      /** The number of iterations the iterative solver used last step. */
+      virtual int getSolverIterations(void) const = 0;
+      /** The current joint constraint error, see max_constraint_error. */
+      virtual sReal getConstraintError(void) const = 0;
+      /**
+       * Returns the largest contact penetration (m) of the last step and
+       * the largest linear velocity (m/s) of the awake bodies. Used to
+       * adapt the step size.
+       */
+      virtual void getStepStatistics(sReal *maxPenetration,
+                                     sReal *maxVelocity) const = 0;
+      /**
+       * \brief Casts a bundle of rays against the collision geometry.
+       *
+       * The rays start at \a origin and point into the unit vectors
+       * \a directions rotated by \a orientation. For every ray the distance
+       * to the closest hit within [\a minDistance, \a maxDistance] is
+       * written to \a distances, rays without a hit get NaN. Ray sensor
+       * geoms are ignored. The rays are split into \a numThreads ranges
+       * that are cast in parallel.
+       */
+      virtual void castRays(const utils::Vector &origin,
+                            const utils::Quaternion &orientation,
+                            const std::vector<utils::Vector> &directions,
+                            sReal minDistance, sReal maxDistance,
+                            float *distances, int numThreads = 1) const = 0;
     };
 
   } // end of namespace interfaces
@@ -35,6 +35,7 @@
 #include <mars/interfaces/MARSDefs.h> // for sReal
 
 #include <string>
+#include <vector>
 
 namespace mars {
   namespace interfaces {
@@ -71,6 +72,25 @@ namespace mars {
       int t_count, t_count_gui;
     };
 
+    /**
+     * Scheduling hints of a plugin, see
+     * SimulatorInterface::setPluginSchedule.
+     *
+     * Resources are free names for the data a plugin touches, e.g.
+     * "envire_graph" or "joints". "physics" stands for the ODE world and
+     * its collision space. Two plugins may be updated concurrently
+     * if neither writes a resource the other one reads or writes.
+     */
+    struct PluginSchedule {
+      PluginSchedule() : updatePeriod(0.0) {}
+      //! in ms, 0 updates the plugin every step
+      double updatePeriod;
+      //! names of plugins that have to be updated before this one
+      std::vector<std::string> dependencies;
+      std::vector<std::string> reads;
+      std::vector<std::string> writes;
+    };
+
     void destroy_plugin(PluginInterface *sp);
 
   } // end of namespace interfaces
@@ -110,6 +110,7 @@ namespace mars {
        */
       virtual const BaseSensor* getFullSensor(unsigned long index) const = 0;
       virtual unsigned long getSensorID(std::string name) const = 0; 
+      virtual std::vector<unsigned long> getSensorIDs(const std::vector<std::string> &names) const = 0;
   
       /**
        * \brief Removes a sensor from the simulation.
@@ -154,6 +155,41 @@ namespace mars {
        * \param index The index of the sensor to get the data 
        */
       virtual int getSensorData(unsigned long id, sReal **data) const = 0;
+
+      /**
+       * \brief Copies the sensor data into the caller owned \a data
+       * without allocating, see BaseSensor::readSensorData.
+       *
+       * \returns The number of values of the sensor, nothing is written if
+       *          it exceeds \a size. 0 if the sensor is not found.
+       */
+      virtual int readSensorData(unsigned long id, sReal *data,
+                                 int size) const = 0;
+
+      /**
+       * \brief Registers a permanent consumer of the sensor, like a
+       * controller that reads it every step.
+       *
+       * Demand driven sensors are only updated while they have consumers,
+       * data broker receivers or were read recently. Code that holds the
+       * pointer returned by getSimSensor has to register as consumer.
+       */
+      virtual void addSensorConsumer(unsigned long id) = 0;
+      virtual void removeSensorConsumer(unsigned long id) = 0;
+
+      /**
+       * \brief Decides which sensors are updated in the next step.
+       * Called by the simulator before every step.
+       */
+      virtual void updateSensorActivity(sReal calc_ms) = 0;
+
+      /**
+       * \brief Provides the activity and cost counters of a sensor.
+       *
+       * \returns false if the sensor is not found.
+       */
+      virtual bool getSensorStats(unsigned long id,
+                                  SensorStats *stats) const = 0;
   
       /**
        *\brief Returns the number of sensors that are currently present in the simulation.
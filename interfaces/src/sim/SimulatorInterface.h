@@ -37,6 +37,7 @@
 #include "PluginInterface.h"
 #include "../sim_common.h"
 #include "../graphics/draw_structs.h"
+#include "../graphics/DebugDrawInterface.h"
 #include "../LightData.h"
 
 namespace lib_manager {
@@ -47,6 +48,23 @@ namespace mars {
 
   namespace interfaces {
 
+    /**
+     * Time spent in the stages of SimulatorInterface::step in microseconds,
+     * accumulated over \a steps steps.
+     */
+    struct StepTimes {
+      StepTimes() {clear();}
+      void clear() {
+        steps = 0;
+        sensors = physics = joints = motors = controllers = 0;
+        dataBroker = plugins = graphics = total = 0;
+      }
+      unsigned long steps;
+      long long sensors, physics, joints, motors, controllers;
+      //! graphics covers the world snapshot and the post physics trigger
+      long long dataBroker, plugins, graphics, total;
+    }; // end of struct StepTimes
+
     class SimulatorInterface {
     public:
 
@@ -109,11 +127,26 @@ namespace mars {
       virtual void allowDraw(void) = 0;
       virtual bool getAllowDraw(void) = 0;
       virtual bool getSyncGraphics(void) = 0;
+      /**
+       * Debug draw producers that are filled in the physics thread after
+       * each step. Their primitives reach the renderer with the world
+       * snapshot, thus the graphics thread never reads physics data.
+       */
+      virtual void addPhysicsDebugDrawInterface(DebugDrawInterface *iface) = 0;
+      virtual void removePhysicsDebugDrawInterface(DebugDrawInterface *iface) = 0;
 
       //plugins
       virtual void addPlugin(const pluginStruct& plugin) = 0;
       virtual void removePlugin(PluginInterface *pl) = 0;
       virtual void switchPluginUpdateMode(int mode, PluginInterface *pl) = 0;
+      /**
+       * Declares the update period and the dependencies of a plugin.
+       * Plugins without a schedule are updated every step and never
+       * concurrently with another plugin. The plugins are updated in
+       * parallel only if "Simulator/plugin threads" is greater than 0.
+       */
+      virtual void setPluginSchedule(PluginInterface *pl,
+                                     const PluginSchedule &schedule) = 0;
       virtual void sendDataToPlugin(int plugin_index, void* data) = 0;
 
       /*
@@ -123,6 +156,20 @@ namespace mars {
 
       virtual double getCalcMs() = 0;
 
+      /**
+       * Copies the stage times accumulated since the last reset into
+       * \a times and restarts the accumulation if \a reset is set.
+       */
+      virtual void getStepTimes(StepTimes *times, bool reset = false) = 0;
+
+      /**
+       * In deterministic mode ("Simulator/deterministic") two runs of the
+       * same scene produce the same state bit by bit, also with plugin
+       * threads. Components with a timing dependent fast path use the
+       * deterministic one instead.
+       */
+      virtual bool isDeterministic() const = 0;
+
     };
 
 
@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_INTERFACES_WORLD_SNAPSHOT_H
+#define MARS_INTERFACES_WORLD_SNAPSHOT_H
+
+#ifdef _PRINT_HEADER_
+  #warning "WorldSnapshot.h"
+#endif
+
+#include "../MARSDefs.h"
+#include "../graphics/draw_structs.h"
+#include "../graphics/DebugDrawInterface.h"
+
+#include <vector>
+
+namespace mars {
+  namespace interfaces {
+
+    /**
+     * \brief Everything the renderer needs from one simulation step.
+     *
+     * Written by the physics thread after each step and handed to the
+     * graphics thread through a utils::TripleBuffer. The renderer applies
+     * the latest complete snapshot and never waits for the physics.
+     */
+    struct WorldSnapshot {
+      WorldSnapshot() : version(0), simTime(0.0) {}
+
+      // increases with every published snapshot
+      unsigned long version;
+      // simulation time in ms
+      sReal simTime;
+      // poses of the moving nodes and of the static nodes that changed
+      // since the last snapshot the renderer consumed
+      DrawObjectPoseList poses;
+      // contact points, sensor rays and other physics side debug lines
+      DebugDrawBuffer debugDraw;
+    }; // end of struct WorldSnapshot
+
+  } // end of namespace interfaces
+} // end of namespace mars
+
+#endif  /* MARS_INTERFACES_WORLD_SNAPSHOT_H */
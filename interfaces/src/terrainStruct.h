@@ -28,6 +28,8 @@ namespace mars {
 
   namespace interfaces {
 
+    class TerrainDirtyRegions;
+
     /**
      * terrainStruct is a struct to exchange height maps between the GUI and the simulation
      */
@@ -39,7 +41,8 @@ namespace mars {
           texScaleX(0.1),
           texScaleY(0.1),
           pixelData(NULL),
-          mesh(0) {}
+          mesh(0),
+          dirtyRegions(NULL) {}
 
       std::string name; //the joints name
       std::string srcname;
@@ -52,6 +55,9 @@ namespace mars {
       double texScaleX, texScaleY; // texture scaling - a value of 0 will fit the complete terrain
       double *pixelData;
       int mesh;
+      // Only set for deformable terrains. Like pixelData it is shared by
+      // all copies of the struct and released together with it.
+      TerrainDirtyRegions *dirtyRegions;
 
     }; // end of struct terrainStruct
 
@@ -121,6 +121,10 @@ namespace mars {
           dataVector[i].data.clear();
         }
         if(updateData) {
+          int top = 0, left = 0, width = 0, height = 0;
+          c->graphics->getGraphicsWindowGeometry(1, &top, &left,
+                                                 &width, &height);
+          if(width > 0) plot->setViewportWidth(width);
           plot->update();
         }
         mutex.unlock();
@@ -98,6 +98,10 @@ namespace mars {
       void MotorPlot::preGraphicsUpdate() {
         if(haveNewData == 7) {
           curve->appendData(time*0.001, current);
+          int top = 0, left = 0, width = 0, height = 0;
+          c->graphics->getGraphicsWindowGeometry(1, &top, &left,
+                                                 &width, &height);
+          if(width > 0) plot->setViewportWidth(width);
           plot->update();
           posTransform->setPosition(osg::Vec3(plotPos.x(), plotPos.y(), plotPos.z()+0.2));
           haveNewData = 0;
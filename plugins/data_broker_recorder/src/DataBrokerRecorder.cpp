@@ -0,0 +1,151 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file DataBrokerRecorder.cpp
+ * \brief Records DataBroker streams to disk and replays them.
+ *
+ * Version 0.1
+ */
+
+
+#include "DataBrokerRecorder.h"
+#include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/misc.h>
+
+namespace mars {
+  namespace plugins {
+    namespace data_broker_recorder {
+
+      using namespace mars::utils;
+      using namespace mars::interfaces;
+
+      DataBrokerRecorder::DataBrokerRecorder(lib_manager::LibManager *theManager)
+        : MarsPluginTemplate(theManager, "DataBrokerRecorder"),
+          recorder(NULL), replayer(NULL) {
+      }
+
+      DataBrokerRecorder::~DataBrokerRecorder() {
+        if(control && control->cfg) {
+          control->cfg->unregisterFromCFG(this);
+        }
+        delete recorder;
+        delete replayer;
+      }
+
+      void DataBrokerRecorder::init() {
+        if(!control->dataBroker) return;
+        recorder = new Recorder(control->dataBroker);
+        replayer = new Replayer(control->dataBroker);
+
+        if(control->cfg) {
+          cfgRecord = control->cfg->getOrCreateProperty("DataBrokerRecorder", "record", false, this);
+          cfgStreams = control->cfg->getOrCreateProperty("DataBrokerRecorder", "streams", std::string("mars_sim/*"), this);
+          cfgLogDir = control->cfg->getOrCreateProperty("DataBrokerRecorder", "log_dir", std::string("data_broker_log"), this);
+          cfgChunkRows = control->cfg->getOrCreateProperty("DataBrokerRecorder", "chunk_rows", 256, this);
+          cfgReplay = control->cfg->getOrCreateProperty("DataBrokerRecorder", "replay", false, this);
+          cfgReplaySpeed = control->cfg->getOrCreateProperty("DataBrokerRecorder", "replay_speed", 1.0, this);
+          cfgReplayPrefix = control->cfg->getOrCreateProperty("DataBrokerRecorder", "replay_prefix", std::string("replay/"), this);
+        }
+        else {
+          cfgRecord.bValue = false;
+          cfgStreams.sValue = "mars_sim/*";
+          cfgLogDir.sValue = "data_broker_log";
+          cfgChunkRows.iValue = 256;
+          cfgReplay.bValue = false;
+          cfgReplaySpeed.dValue = 1.0;
+          cfgReplayPrefix.sValue = "replay/";
+        }
+        if(cfgRecord.bValue) startRecording();
+        if(cfgReplay.bValue) startReplay();
+      }
+
+      void DataBrokerRecorder::reset() {
+      }
+
+      void DataBrokerRecorder::update(sReal time_ms) {
+      }
+
+      void DataBrokerRecorder::startRecording() {
+        if(!recorder) return;
+        std::vector<std::string> patterns;
+        std::vector<std::string> tokens = explodeString(',', cfgStreams.sValue);
+        for(size_t i=0; i<tokens.size(); ++i) {
+          std::string pattern = trim(tokens[i]);
+          if(!pattern.empty()) patterns.push_back(pattern);
+        }
+        int chunkRows = cfgChunkRows.iValue > 0 ? cfgChunkRows.iValue : 1;
+        size_t n = recorder->start(cfgLogDir.sValue, patterns, chunkRows);
+        if(n == 0) {
+          control->dataBroker->pushWarning("DataBrokerRecorder: no stream matches \"%s\"",
+                                           cfgStreams.sValue.c_str());
+        }
+      }
+
+      void DataBrokerRecorder::stopRecording() {
+        if(recorder) recorder->stop();
+      }
+
+      void DataBrokerRecorder::startReplay() {
+        if(!replayer) return;
+        if(!replayer->open(cfgLogDir.sValue)) {
+          control->dataBroker->pushError("DataBrokerRecorder: no log found in \"%s\"",
+                                         cfgLogDir.sValue.c_str());
+          return;
+        }
+        replayer->start(cfgReplaySpeed.dValue, cfgReplayPrefix.sValue);
+      }
+
+      void DataBrokerRecorder::stopReplay() {
+        if(replayer) replayer->stop();
+      }
+
+      void DataBrokerRecorder::cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property) {
+        if(_property.paramId == cfgRecord.paramId) {
+          if(_property.bValue != cfgRecord.bValue) {
+            cfgRecord.bValue = _property.bValue;
+            if(cfgRecord.bValue) startRecording();
+            else stopRecording();
+          }
+        } else if(_property.paramId == cfgStreams.paramId) {
+          cfgStreams.sValue = _property.sValue;
+        } else if(_property.paramId == cfgLogDir.paramId) {
+          cfgLogDir.sValue = _property.sValue;
+        } else if(_property.paramId == cfgChunkRows.paramId) {
+          cfgChunkRows.iValue = _property.iValue;
+        } else if(_property.paramId == cfgReplay.paramId) {
+          if(_property.bValue != cfgReplay.bValue) {
+            cfgReplay.bValue = _property.bValue;
+            if(cfgReplay.bValue) startReplay();
+            else stopReplay();
+          }
+        } else if(_property.paramId == cfgReplaySpeed.paramId) {
+          cfgReplaySpeed.dValue = _property.dValue;
+        } else if(_property.paramId == cfgReplayPrefix.paramId) {
+          cfgReplayPrefix.sValue = _property.sValue;
+        }
+      }
+
+    } // end of namespace data_broker_recorder
+  } // end of namespace plugins
+} // end of namespace mars
+
+DESTROY_LIB(mars::plugins::data_broker_recorder::DataBrokerRecorder);
+CREATE_LIB(mars::plugins::data_broker_recorder::DataBrokerRecorder);
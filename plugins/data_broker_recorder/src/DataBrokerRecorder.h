@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file DataBrokerRecorder.h
+ * \brief Records DataBroker streams to disk and replays them.
+ *
+ * The plugin is controlled via the cfg_manager group "DataBrokerRecorder":
+ *   - record:        starts/stops recording all streams matching "streams"
+ *   - streams:       comma separated "group/data" patterns
+ *   - log_dir:       directory of the log files
+ *   - chunk_rows:    rows buffered per stream before they are written
+ *   - replay:        starts/stops replaying the log in log_dir
+ *   - replay_speed:  replay speed, <= 0 replays as fast as possible
+ *   - replay_prefix: prepended to the group names of replayed streams
+ *
+ * Only streams that exist when the recording is started are recorded.
+ *
+ * Version 0.1
+ */
+
+#ifndef MARS_PLUGINS_DATA_BROKER_RECORDER_H
+#define MARS_PLUGINS_DATA_BROKER_RECORDER_H
+
+#ifdef _PRINT_HEADER_
+  #warning "DataBrokerRecorder.h"
+#endif
+
+#include "Recorder.h"
+#include "Replayer.h"
+
+#include <mars/interfaces/sim/MarsPluginTemplate.h>
+#include <mars/cfg_manager/CFGManagerInterface.h>
+
+#include <string>
+
+namespace mars {
+
+  namespace plugins {
+    namespace data_broker_recorder {
+
+      class DataBrokerRecorder: public mars::interfaces::MarsPluginTemplate,
+                                public mars::cfg_manager::CFGClient {
+
+      public:
+        DataBrokerRecorder(lib_manager::LibManager *theManager);
+        ~DataBrokerRecorder();
+
+        // LibInterface methods
+        int getLibVersion() const
+        { return 1; }
+        const std::string getLibName() const
+        { return std::string("data_broker_recorder"); }
+        CREATE_MODULE_INFO();
+
+        // MarsPlugin methods
+        void init();
+        void reset();
+        void update(mars::interfaces::sReal time_ms);
+
+        // CFGClient methods
+        virtual void cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property);
+
+        // DataBrokerRecorder methods
+        void startRecording();
+        void stopRecording();
+        void startReplay();
+        void stopReplay();
+
+      private:
+        Recorder *recorder;
+        Replayer *replayer;
+        cfg_manager::cfgPropertyStruct cfgRecord, cfgStreams, cfgLogDir;
+        cfg_manager::cfgPropertyStruct cfgChunkRows, cfgReplay;
+        cfg_manager::cfgPropertyStruct cfgReplaySpeed, cfgReplayPrefix;
+
+      }; // end of class definition DataBrokerRecorder
+
+    } // end of namespace data_broker_recorder
+  } // end of namespace plugins
+} // end of namespace mars
+
+#endif // MARS_PLUGINS_DATA_BROKER_RECORDER_H
@@ -0,0 +1,251 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file Recorder.cpp
+ * \brief Records DataBroker streams into StreamLog files.
+ */
+
+#include "Recorder.h"
+
+#include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/data_broker/DataPackage.h>
+#include <mars/utils/MutexLocker.h>
+#include <mars/utils/misc.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace mars {
+  namespace plugins {
+    namespace data_broker_recorder {
+
+      using namespace mars::utils;
+      using namespace mars::data_broker;
+
+      // callbackParam of the registration for the time stream
+      static const int timeCallback = -1;
+
+      static inline LogValue toLogValue(const DataItem &item) {
+        LogValue v;
+        switch(item.type) {
+        case INT_TYPE:    v.l = item.i; break;
+        case LONG_TYPE:   v.l = item.l; break;
+        case UINT_TYPE:   v.ul = item.ui; break;
+        case ULONG_TYPE:  v.ul = item.ul; break;
+        case FLOAT_TYPE:  v.d = item.f; break;
+        case DOUBLE_TYPE: v.d = item.d; break;
+        case BOOL_TYPE:   v.l = item.b; break;
+        default:          v.ul = 0; break;
+        }
+        return v;
+      }
+
+      Recorder::Recorder(DataBrokerInterface *dataBroker)
+        : dataBroker(dataBroker), timeGroup("mars_sim"), timeData("simTime"),
+          currentTime(0.), chunkRows(256), recording(false),
+          overflowCount(0), stopRequested(false) {
+      }
+
+      Recorder::~Recorder() {
+        stop();
+      }
+
+      void Recorder::setTimeStream(const std::string &groupName,
+                                   const std::string &dataName) {
+        timeGroup = groupName;
+        timeData = dataName;
+      }
+
+      size_t Recorder::start(const std::string &logDir,
+                             const std::vector<std::string> &patterns,
+                             unsigned int chunkRows_) {
+        if(recording) stop();
+        chunkRows = chunkRows_ > 0 ? chunkRows_ : 1;
+        overflowCount = 0;
+        currentTime = 0.;
+        createDirectory(logDir);
+        std::ofstream index((logDir + "/index.txt").c_str());
+
+        std::vector<DataInfo> infos = dataBroker->getDataList();
+        std::vector<DataInfo>::iterator it;
+        for(it = infos.begin(); it != infos.end(); ++it) {
+          const std::string name = it->groupName + "/" + it->dataName;
+          bool selected = false;
+          for(size_t i=0; i<patterns.size() && !selected; ++i) {
+            selected = matchPattern(patterns[i], name);
+          }
+          if(!selected) continue;
+
+          Stream *stream = new Stream;
+          stream->schema.groupName = it->groupName;
+          stream->schema.dataName = it->dataName;
+          DataPackage package = dataBroker->getDataPackage(it->dataId);
+          for(size_t i=0; i<package.size(); ++i) {
+            stream->schema.itemNames.push_back(package[i].getName());
+            stream->schema.itemTypes.push_back(package[i].type);
+          }
+          char filename[32];
+          sprintf(filename, "stream_%05lu.mlog", (unsigned long)streams.size());
+          if(!stream->writer.open(logDir + "/" + filename, stream->schema,
+                                  chunkRows)) {
+            dataBroker->pushError("DataBrokerRecorder: cannot open %s/%s",
+                                  logDir.c_str(), filename);
+            delete stream;
+            continue;
+          }
+          index << filename << "\n";
+          streams.push_back(stream);
+          // double buffered; more chunks are only allocated on overflow
+          stream->current = newChunk(streams.size()-1);
+          stream->freeChunks.push_back(newChunk(streams.size()-1));
+        }
+        index.close();
+
+        if(streams.empty()) return 0;
+
+        stopRequested = false;
+        Thread::start();
+        recording = true;
+        dataBroker->registerSyncReceiver(this, timeGroup, timeData,
+                                         timeCallback);
+        for(size_t i=0; i<streams.size(); ++i) {
+          dataBroker->registerSyncReceiver(this, streams[i]->schema.groupName,
+                                           streams[i]->schema.dataName,
+                                           (int)i);
+        }
+        return streams.size();
+      }
+
+      void Recorder::stop() {
+        if(!recording) return;
+        dataBroker->unregisterSyncReceiver(this, timeGroup, timeData);
+        for(size_t i=0; i<streams.size(); ++i) {
+          dataBroker->unregisterSyncReceiver(this, streams[i]->schema.groupName,
+                                             streams[i]->schema.dataName);
+        }
+        recording = false;
+
+        queueMutex.lock();
+        for(size_t i=0; i<streams.size(); ++i) {
+          if(streams[i]->current->rows > 0) {
+            fullChunks.push_back(streams[i]->current);
+          }
+        }
+        stopRequested = true;
+        queueCondition.wakeAll();
+        queueMutex.unlock();
+        Thread::wait();
+
+        for(size_t i=0; i<streams.size(); ++i) {
+          streams[i]->writer.close();
+          for(size_t k=0; k<streams[i]->allChunks.size(); ++k) {
+            delete streams[i]->allChunks[k];
+          }
+          delete streams[i];
+        }
+        streams.clear();
+        fullChunks.clear();
+        if(overflowCount) {
+          dataBroker->pushWarning("DataBrokerRecorder: writer thread fell "
+                                  "behind %lu times", overflowCount);
+        }
+      }
+
+      LogChunk* Recorder::newChunk(size_t stream) {
+        LogChunk *chunk = new LogChunk;
+        chunk->stream = stream;
+        chunk->rows = 0;
+        chunk->values.resize(streams[stream]->writer.getChunkValues());
+        streams[stream]->allChunks.push_back(chunk);
+        return chunk;
+      }
+
+      void Recorder::handOff(Stream *stream) {
+        MutexLocker locker(&queueMutex);
+        fullChunks.push_back(stream->current);
+        if(stream->freeChunks.empty()) {
+          ++overflowCount;
+          stream->current = newChunk(stream->current->stream);
+        }
+        else {
+          stream->current = stream->freeChunks.back();
+          stream->freeChunks.pop_back();
+        }
+        queueCondition.wakeOne();
+      }
+
+      void Recorder::receiveData(const DataInfo &info,
+                                 const DataPackage &package,
+                                 int callbackParam) {
+        if(callbackParam == timeCallback) {
+          if(package.size()) {
+            const DataItem &item = package[0];
+            currentTime = (item.type == DOUBLE_TYPE ? item.d :
+                           (double)toLogValue(item).l);
+          }
+          return;
+        }
+        if(callbackParam < 0 || callbackParam >= (int)streams.size()) return;
+
+        Stream *stream = streams[callbackParam];
+        LogChunk *chunk = stream->current;
+        const size_t row = chunk->rows;
+        LogValue *values = &chunk->values[0];
+        values[row].d = currentTime;
+        size_t items = stream->schema.itemNames.size();
+        if(package.size() < items) items = package.size();
+        for(size_t i=0; i<items; ++i) {
+          values[(i+1)*chunkRows + row] = toLogValue(package[i]);
+        }
+        if(++chunk->rows == chunkRows) {
+          handOff(stream);
+        }
+      }
+
+      void Recorder::run() {
+        std::deque<LogChunk*> work;
+        queueMutex.lock();
+        while(true) {
+          while(fullChunks.empty() && !stopRequested) {
+            queueCondition.wait(&queueMutex);
+          }
+          if(fullChunks.empty()) break;
+          work.swap(fullChunks);
+          queueMutex.unlock();
+
+          std::deque<LogChunk*>::iterator it;
+          for(it = work.begin(); it != work.end(); ++it) {
+            streams[(*it)->stream]->writer.append(**it);
+            (*it)->rows = 0;
+          }
+
+          queueMutex.lock();
+          for(it = work.begin(); it != work.end(); ++it) {
+            streams[(*it)->stream]->freeChunks.push_back(*it);
+          }
+          work.clear();
+        }
+        queueMutex.unlock();
+      }
+
+    } // end of namespace data_broker_recorder
+  } // end of namespace plugins
+} // end of namespace mars
@@ -0,0 +1,134 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file Recorder.h
+ * \brief Records DataBroker streams into StreamLog files.
+ *
+ * The Recorder registers itself as sync receiver for all DataBroker streams
+ * whose "group/data" name matches one of the given patterns. receiveData
+ * only copies the values into a preallocated chunk; full chunks are handed
+ * to a background thread that appends them to the memory-mapped logs. Thus
+ * the thread pushing the data (usually the physics thread) never touches
+ * the file system.
+ */
+
+#ifndef MARS_PLUGINS_DATA_BROKER_RECORDER_RECORDER_H
+#define MARS_PLUGINS_DATA_BROKER_RECORDER_RECORDER_H
+
+#ifdef _PRINT_HEADER_
+  #warning "Recorder.h"
+#endif
+
+#include "StreamLog.h"
+
+#include <mars/data_broker/ReceiverInterface.h>
+#include <mars/utils/Thread.h>
+#include <mars/utils/Mutex.h>
+#include <mars/utils/WaitCondition.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace mars {
+
+  namespace data_broker {
+    class DataBrokerInterface;
+  }
+
+  namespace plugins {
+    namespace data_broker_recorder {
+
+      class Recorder : public data_broker::ReceiverInterface,
+                       public utils::Thread {
+
+      public:
+        Recorder(data_broker::DataBrokerInterface *dataBroker);
+        ~Recorder();
+
+        /**
+         * \brief starts recording into the directory \a logDir
+         * \param patterns "group/data" patterns as understood by
+         *                 utils::matchPattern, e.g. "mars_sim/Joints*".
+         * \param chunkRows Number of rows that are buffered per stream
+         *                  before they are handed to the writer thread.
+         * \return the number of recorded streams
+         */
+        size_t start(const std::string &logDir,
+                     const std::vector<std::string> &patterns,
+                     unsigned int chunkRows = 256);
+        /** \brief stops recording and flushes all buffered rows */
+        void stop();
+        bool isRecording() const { return recording; }
+
+        /**
+         * \brief sets the stream whose first item is used as time stamp.
+         *        Defaults to mars_sim/simTime.
+         */
+        void setTimeStream(const std::string &groupName,
+                           const std::string &dataName);
+
+        /** \brief number of chunks that had to be allocated because the
+         *         writer thread could not keep up */
+        unsigned long getOverflowCount() const { return overflowCount; }
+
+        // DataBrokerReceiver methods
+        virtual void receiveData(const data_broker::DataInfo &info,
+                                 const data_broker::DataPackage &package,
+                                 int callbackParam);
+
+      protected:
+        // Thread methods
+        void run();
+
+      private:
+        struct Stream {
+          StreamSchema schema;
+          StreamLogWriter writer;
+          LogChunk *current;
+          std::vector<LogChunk*> freeChunks;
+          std::vector<LogChunk*> allChunks;
+        };
+
+        data_broker::DataBrokerInterface *dataBroker;
+        std::vector<Stream*> streams;
+        std::string timeGroup, timeData;
+        double currentTime;
+        unsigned int chunkRows;
+        bool recording;
+        unsigned long overflowCount;
+
+        // protects fullChunks, freeChunks and stopRequested
+        utils::Mutex queueMutex;
+        utils::WaitCondition queueCondition;
+        std::deque<LogChunk*> fullChunks;
+        bool stopRequested;
+
+        LogChunk* newChunk(size_t stream);
+        void handOff(Stream *stream);
+
+      }; // end of class Recorder
+
+    } // end of namespace data_broker_recorder
+  } // end of namespace plugins
+} // end of namespace mars
+
+#endif // MARS_PLUGINS_DATA_BROKER_RECORDER_RECORDER_H
@@ -0,0 +1,185 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file Replayer.cpp
+ * \brief Pushes the streams of a Recorder log back into a DataBroker.
+ */
+
+#include "Replayer.h"
+
+#include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/MutexLocker.h>
+#include <mars/utils/misc.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace mars {
+  namespace plugins {
+    namespace data_broker_recorder {
+
+      using namespace mars::utils;
+      using namespace mars::data_broker;
+
+      Replayer::Replayer(DataBrokerInterface *dataBroker)
+        : dataBroker(dataBroker), speed(1.0), stopRequested(false) {
+      }
+
+      Replayer::~Replayer() {
+        stop();
+        close();
+      }
+
+      bool Replayer::open(const std::string &logDir) {
+        stop();
+        close();
+        std::ifstream index((logDir + "/index.txt").c_str());
+        std::string filename;
+        while(std::getline(index, filename)) {
+          filename = trim(filename);
+          if(filename.empty()) continue;
+          Stream *stream = new Stream;
+          if(!stream->reader.open(logDir + "/" + filename)) {
+            dataBroker->pushError("DataBrokerRecorder: cannot read %s/%s",
+                                  logDir.c_str(), filename.c_str());
+            delete stream;
+            continue;
+          }
+          const StreamSchema &schema = stream->reader.getSchema();
+          for(size_t i=0; i<schema.itemNames.size(); ++i) {
+            const std::string &name = schema.itemNames[i];
+            switch(schema.itemTypes[i]) {
+            case INT_TYPE:    stream->package.add(name, (int)0); break;
+            case LONG_TYPE:   stream->package.add(name, (long)0); break;
+            case UINT_TYPE:   stream->package.add(name, (unsigned int)0); break;
+            case ULONG_TYPE:  stream->package.add(name, (unsigned long)0); break;
+            case FLOAT_TYPE:  stream->package.add(name, 0.f); break;
+            case DOUBLE_TYPE: stream->package.add(name, 0.); break;
+            case BOOL_TYPE:   stream->package.add(name, false); break;
+            default:          stream->package.add(name, std::string()); break;
+            }
+          }
+          stream->dataId = 0;
+          stream->row = 0;
+          streams.push_back(stream);
+        }
+        return !streams.empty();
+      }
+
+      void Replayer::close() {
+        // the replay thread reads the streams
+        stop();
+        for(size_t i=0; i<streams.size(); ++i) {
+          delete streams[i];
+        }
+        streams.clear();
+      }
+
+      void Replayer::start(double speed_, const std::string &groupPrefix_) {
+        stop();
+        speed = speed_;
+        groupPrefix = groupPrefix_;
+        for(size_t i=0; i<streams.size(); ++i) {
+          streams[i]->row = 0;
+        }
+        stopRequested = false;
+        Thread::start();
+      }
+
+      void Replayer::stop() {
+        if(!isRunning()) return;
+        stopMutex.lock();
+        stopRequested = true;
+        stopMutex.unlock();
+        Thread::wait();
+      }
+
+      bool Replayer::shouldStop() {
+        MutexLocker locker(&stopMutex);
+        return stopRequested;
+      }
+
+      void Replayer::push(Stream *stream) {
+        const StreamSchema &schema = stream->reader.getSchema();
+        for(size_t i=0; i<schema.itemNames.size(); ++i) {
+          const LogValue v = stream->reader.getValue(stream->row, i);
+          DataItem &item = stream->package[i];
+          switch(item.type) {
+          case INT_TYPE:    item.i = (int)v.l; break;
+          case LONG_TYPE:   item.l = (long)v.l; break;
+          case UINT_TYPE:   item.ui = (unsigned int)v.ul; break;
+          case ULONG_TYPE:  item.ul = (unsigned long)v.ul; break;
+          case FLOAT_TYPE:  item.f = (float)v.d; break;
+          case DOUBLE_TYPE: item.d = v.d; break;
+          case BOOL_TYPE:   item.b = (v.l != 0); break;
+          default: break;
+          }
+        }
+        if(stream->dataId) {
+          dataBroker->pushData(stream->dataId, stream->package);
+        }
+        else {
+          stream->dataId = dataBroker->pushData(groupPrefix + schema.groupName,
+                                                schema.dataName,
+                                                stream->package, NULL,
+                                                DATA_PACKAGE_READ_FLAG);
+        }
+      }
+
+      void Replayer::run() {
+        typedef std::pair<double, size_t> QueueEntry;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                            std::greater<QueueEntry> > queue;
+        for(size_t i=0; i<streams.size(); ++i) {
+          if(streams[i]->reader.getNumRows()) {
+            queue.push(QueueEntry(streams[i]->reader.getTime(0), i));
+          }
+        }
+        if(queue.empty()) return;
+
+        const double startTime = queue.top().first;
+        const long long startWallTime = getTime();
+        while(!queue.empty() && !shouldStop()) {
+          QueueEntry next = queue.top();
+          queue.pop();
+          if(speed > 0.) {
+            long long due = (long long)((next.first - startTime) / speed);
+            long long now = getTimeDiff(startWallTime);
+            while(now < due && !shouldStop()) {
+              msleep((unsigned int)std::min(due - now, 10LL));
+              now = getTimeDiff(startWallTime);
+            }
+          }
+          Stream *stream = streams[next.second];
+          push(stream);
+          if(++stream->row < stream->reader.getNumRows()) {
+            queue.push(QueueEntry(stream->reader.getTime(stream->row),
+                                  next.second));
+          }
+        }
+      }
+
+    } // end of namespace data_broker_recorder
+  } // end of namespace plugins
+} // end of namespace mars
@@ -0,0 +1,110 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file Replayer.h
+ * \brief Pushes the streams of a Recorder log back into a DataBroker.
+ *
+ * All streams of a log directory are merged by their time stamps and pushed
+ * from a separate thread. With a speed of 1 the original timing is
+ * reproduced, larger values replay faster and a speed <= 0 replays as fast
+ * as possible.
+ */
+
+#ifndef MARS_PLUGINS_DATA_BROKER_RECORDER_REPLAYER_H
+#define MARS_PLUGINS_DATA_BROKER_RECORDER_REPLAYER_H
+
+#ifdef _PRINT_HEADER_
+  #warning "Replayer.h"
+#endif
+
+#include "StreamLog.h"
+
+#include <mars/data_broker/DataPackage.h>
+#include <mars/utils/Thread.h>
+#include <mars/utils/Mutex.h>
+
+#include <string>
+#include <vector>
+
+namespace mars {
+
+  namespace data_broker {
+    class DataBrokerInterface;
+  }
+
+  namespace plugins {
+    namespace data_broker_recorder {
+
+      class Replayer : public utils::Thread {
+
+      public:
+        Replayer(data_broker::DataBrokerInterface *dataBroker);
+        ~Replayer();
+
+        /**
+         * \brief opens all streams listed in the index of \a logDir, a
+         *        running replay is stopped first
+         */
+        bool open(const std::string &logDir);
+        /** \brief stops a running replay and closes all streams */
+        void close();
+
+        /**
+         * \brief starts the replay thread
+         * \param speed Replay speed relative to the recorded time.
+         * \param groupPrefix Prepended to the recorded group names to avoid
+         *                    clashes with streams of a running simulation.
+         */
+        void start(double speed = 1.0, const std::string &groupPrefix = "");
+        void stop();
+
+        size_t getNumStreams() const { return streams.size(); }
+
+      protected:
+        // Thread methods
+        void run();
+
+      private:
+        struct Stream {
+          StreamLogReader reader;
+          data_broker::DataPackage package;
+          unsigned long dataId;
+          size_t row;
+        };
+
+        data_broker::DataBrokerInterface *dataBroker;
+        std::vector<Stream*> streams;
+        double speed;
+        std::string groupPrefix;
+
+        utils::Mutex stopMutex;
+        bool stopRequested;
+
+        bool shouldStop();
+        void push(Stream *stream);
+
+      }; // end of class Replayer
+
+    } // end of namespace data_broker_recorder
+  } // end of namespace plugins
+} // end of namespace mars
+
+#endif // MARS_PLUGINS_DATA_BROKER_RECORDER_REPLAYER_H
@@ -0,0 +1,300 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file StreamLog.cpp
+ * \brief Append-only, columnar, memory-mapped log of one DataBroker stream.
+ */
+
+#include "StreamLog.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace mars {
+  namespace plugins {
+    namespace data_broker_recorder {
+
+      static const char logMagic[8] = {'M', 'A', 'R', 'S', 'D', 'B', 'L', '1'};
+      static const size_t pageSize = 4096;
+      static const size_t chunkHeaderSize = 8;
+
+      static void writeUInt(std::vector<char> *buffer, uint32_t value) {
+        const char *p = (const char*)&value;
+        buffer->insert(buffer->end(), p, p+sizeof(value));
+      }
+
+      static void writeString(std::vector<char> *buffer, const std::string &s) {
+        writeUInt(buffer, (uint32_t)s.size());
+        buffer->insert(buffer->end(), s.begin(), s.end());
+      }
+
+      static bool readUInt(const char *data, size_t size, size_t *pos,
+                           uint32_t *value) {
+        if(*pos + sizeof(uint32_t) > size) return false;
+        memcpy(value, data + *pos, sizeof(uint32_t));
+        *pos += sizeof(uint32_t);
+        return true;
+      }
+
+      static bool readString(const char *data, size_t size, size_t *pos,
+                             std::string *s) {
+        uint32_t length;
+        if(!readUInt(data, size, pos, &length)) return false;
+        if(*pos + length > size) return false;
+        s->assign(data + *pos, length);
+        *pos += length;
+        return true;
+      }
+
+      static size_t alignToPage(size_t size) {
+        return (size + pageSize - 1) / pageSize * pageSize;
+      }
+
+      MappedFile::MappedFile() : fd(-1), writable(false), mapping(NULL),
+                                 mappedSize(0), usedSize(0) {
+      }
+
+      MappedFile::~MappedFile() {
+        close();
+      }
+
+      bool MappedFile::open(const std::string &filename, bool writable_) {
+        close();
+        writable = writable_;
+        if(writable) {
+          fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        }
+        else {
+          fd = ::open(filename.c_str(), O_RDONLY);
+        }
+        if(fd < 0) return false;
+
+        struct stat st;
+        if(fstat(fd, &st) != 0) {
+          close();
+          return false;
+        }
+        usedSize = st.st_size;
+        if(st.st_size > 0) {
+          void *p = mmap(NULL, st.st_size,
+                         writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                         MAP_SHARED, fd, 0);
+          if(p == MAP_FAILED) {
+            close();
+            return false;
+          }
+          mapping = (char*)p;
+          mappedSize = st.st_size;
+        }
+        return true;
+      }
+
+      void MappedFile::close() {
+        if(mapping) {
+          munmap(mapping, mappedSize);
+          mapping = NULL;
+        }
+        if(fd >= 0) {
+          if(writable && usedSize != mappedSize) {
+            if(ftruncate(fd, usedSize) != 0) {
+              fprintf(stderr, "DataBrokerRecorder: could not truncate log\n");
+            }
+          }
+          ::close(fd);
+          fd = -1;
+        }
+        mappedSize = usedSize = 0;
+      }
+
+      bool MappedFile::reserve(size_t size) {
+        if(fd < 0 || !writable) return false;
+        if(size <= mappedSize) return true;
+        // grow in large steps to keep the number of remaps low
+        size_t newSize = std::max(alignToPage(size), mappedSize*2);
+        if(mapping) {
+          munmap(mapping, mappedSize);
+          mapping = NULL;
+        }
+        if(ftruncate(fd, newSize) != 0) return false;
+        void *p = mmap(NULL, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(p == MAP_FAILED) {
+          mappedSize = 0;
+          return false;
+        }
+        mapping = (char*)p;
+        mappedSize = newSize;
+        return true;
+      }
+
+
+      StreamLogWriter::StreamLogWriter() : chunkRows(0), headerSize(0),
+                                           chunkSize(0), numChunks(0) {
+      }
+
+      StreamLogWriter::~StreamLogWriter() {
+        close();
+      }
+
+      size_t StreamLogWriter::getChunkValues() const {
+        return (schema.itemNames.size() + 1) * chunkRows;
+      }
+
+      bool StreamLogWriter::open(const std::string &filename,
+                                 const StreamSchema &schema_,
+                                 uint32_t chunkRows_) {
+        schema = schema_;
+        chunkRows = chunkRows_;
+        numChunks = 0;
+
+        std::vector<char> header(logMagic, logMagic+sizeof(logMagic));
+        writeUInt(&header, 1); // version
+        writeUInt(&header, chunkRows);
+        writeUInt(&header, (uint32_t)schema.itemNames.size());
+        writeUInt(&header, 0);
+        writeString(&header, schema.groupName);
+        writeString(&header, schema.dataName);
+        for(size_t i=0; i<schema.itemNames.size(); ++i) {
+          writeUInt(&header, (uint32_t)schema.itemTypes[i]);
+          writeString(&header, schema.itemNames[i]);
+        }
+        headerSize = alignToPage(header.size());
+        chunkSize = chunkHeaderSize + getChunkValues()*sizeof(LogValue);
+
+        if(!file.open(filename, true)) return false;
+        if(!file.reserve(headerSize + 64*chunkSize)) {
+          file.close();
+          return false;
+        }
+        memcpy(file.data(), &header[0], header.size());
+        file.setUsedSize(headerSize);
+        return true;
+      }
+
+      bool StreamLogWriter::append(const LogChunk &chunk) {
+        if(!file.data() || chunk.rows == 0) return false;
+        if(chunk.values.size() != getChunkValues()) return false;
+        size_t offset = headerSize + numChunks*chunkSize;
+        if(!file.reserve(offset + chunkSize)) return false;
+        char *p = file.data() + offset;
+        memcpy(p + chunkHeaderSize, &chunk.values[0],
+               chunk.values.size()*sizeof(LogValue));
+        // the row count is written last, a chunk with zero rows marks the
+        // end of the log if the recorder did not close the file properly
+        memcpy(p, &chunk.rows, sizeof(chunk.rows));
+        ++numChunks;
+        file.setUsedSize(offset + chunkSize);
+        return true;
+      }
+
+      void StreamLogWriter::close() {
+        file.close();
+      }
+
+
+      StreamLogReader::StreamLogReader() : chunkRows(0), headerSize(0),
+                                           chunkSize(0), numRows(0) {
+      }
+
+      StreamLogReader::~StreamLogReader() {
+        close();
+      }
+
+      bool StreamLogReader::open(const std::string &filename) {
+        close();
+        if(!file.open(filename, false)) return false;
+        const char *data = file.data();
+        size_t size = file.size();
+        if(!data || size < sizeof(logMagic) ||
+           memcmp(data, logMagic, sizeof(logMagic)) != 0) {
+          close();
+          return false;
+        }
+
+        size_t pos = sizeof(logMagic);
+        uint32_t version, itemCount, reserved;
+        bool ok = (readUInt(data, size, &pos, &version) &&
+                   readUInt(data, size, &pos, &chunkRows) &&
+                   readUInt(data, size, &pos, &itemCount) &&
+                   readUInt(data, size, &pos, &reserved) &&
+                   readString(data, size, &pos, &schema.groupName) &&
+                   readString(data, size, &pos, &schema.dataName));
+        for(uint32_t i=0; ok && i<itemCount; ++i) {
+          uint32_t type;
+          std::string name;
+          ok = (readUInt(data, size, &pos, &type) &&
+                readString(data, size, &pos, &name));
+          if(!ok) break;
+          schema.itemTypes.push_back((data_broker::DataType)type);
+          schema.itemNames.push_back(name);
+        }
+        if(!ok || version != 1 || chunkRows == 0) {
+          close();
+          return false;
+        }
+
+        headerSize = alignToPage(pos);
+        chunkSize = chunkHeaderSize + (itemCount+1)*chunkRows*sizeof(LogValue);
+        numRows = 0;
+        for(size_t offset = headerSize; offset + chunkSize <= size;
+            offset += chunkSize) {
+          uint32_t rows;
+          memcpy(&rows, data + offset, sizeof(rows));
+          if(rows == 0 || rows > chunkRows) break;
+          chunkOffsets.push_back(numRows);
+          numRows += rows;
+        }
+        return true;
+      }
+
+      void StreamLogReader::close() {
+        file.close();
+        schema = StreamSchema();
+        chunkOffsets.clear();
+        numRows = 0;
+      }
+
+      const LogValue* StreamLogReader::column(size_t row, size_t col) const {
+        // chunks are full except for the ones written on a flush
+        std::vector<size_t>::const_iterator it;
+        it = std::upper_bound(chunkOffsets.begin(), chunkOffsets.end(), row);
+        size_t chunk = (it - chunkOffsets.begin()) - 1;
+        const char *p = (file.data() + headerSize + chunk*chunkSize +
+                         chunkHeaderSize);
+        return ((const LogValue*)p) + col*chunkRows + (row - chunkOffsets[chunk]);
+      }
+
+      double StreamLogReader::getTime(size_t row) const {
+        return column(row, 0)->d;
+      }
+
+      LogValue StreamLogReader::getValue(size_t row, size_t item) const {
+        return *column(row, item+1);
+      }
+
+    } // end of namespace data_broker_recorder
+  } // end of namespace plugins
+} // end of namespace mars
@@ -0,0 +1,162 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file StreamLog.h
+ * \brief Append-only, columnar, memory-mapped log of one DataBroker stream.
+ *
+ * A log file starts with a header that holds the stream schema: group and
+ * data name and the name and DataType of every DataItem. The header is
+ * followed by fixed size chunks. Each chunk stores a row count, the time
+ * column and one column per item, every value in an 8 byte slot:
+ *
+ *   | rows | pad | time[chunkRows] | item0[chunkRows] | item1[chunkRows] ...
+ *
+ * Integer types are stored as int64/uint64, float types as double and bools
+ * as int64. String items are not recorded; their column stays zero.
+ */
+
+#ifndef MARS_PLUGINS_DATA_BROKER_RECORDER_STREAM_LOG_H
+#define MARS_PLUGINS_DATA_BROKER_RECORDER_STREAM_LOG_H
+
+#ifdef _PRINT_HEADER_
+  #warning "StreamLog.h"
+#endif
+
+#include <mars/data_broker/DataItem.h>
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mars {
+  namespace plugins {
+    namespace data_broker_recorder {
+
+      struct StreamSchema {
+        std::string groupName;
+        std::string dataName;
+        std::vector<std::string> itemNames;
+        std::vector<data_broker::DataType> itemTypes;
+      };
+
+      /** \brief One 8 byte value slot of a column. */
+      union LogValue {
+        int64_t l;
+        uint64_t ul;
+        double d;
+      };
+
+      /**
+       * \brief A block of rows in columnar layout as it is stored in the log.
+       *
+       * values holds chunkRows time values followed by chunkRows values for
+       * every item.
+       */
+      struct LogChunk {
+        size_t stream;
+        uint32_t rows;
+        std::vector<LogValue> values;
+      };
+
+      /** \brief Minimal wrapper around a memory-mapped file. */
+      class MappedFile {
+      public:
+        MappedFile();
+        ~MappedFile();
+
+        bool open(const std::string &filename, bool writable);
+        void close();
+        /** \brief grows the file and the mapping to at least \a size bytes */
+        bool reserve(size_t size);
+        /** \brief truncates the file to \a size bytes on close */
+        void setUsedSize(size_t size) { usedSize = size; }
+
+        char* data() const { return mapping; }
+        size_t size() const { return mappedSize; }
+
+      private:
+        // disallow copying
+        MappedFile(const MappedFile &);
+        MappedFile &operator=(const MappedFile &);
+
+        int fd;
+        bool writable;
+        char *mapping;
+        size_t mappedSize;
+        size_t usedSize;
+      };
+
+      class StreamLogWriter {
+      public:
+        StreamLogWriter();
+        ~StreamLogWriter();
+
+        bool open(const std::string &filename, const StreamSchema &schema,
+                  uint32_t chunkRows);
+        /** \brief appends a (possibly partially filled) chunk */
+        bool append(const LogChunk &chunk);
+        void close();
+
+        uint32_t getChunkRows() const { return chunkRows; }
+        size_t getChunkValues() const;
+
+      private:
+        MappedFile file;
+        StreamSchema schema;
+        uint32_t chunkRows;
+        size_t headerSize;
+        size_t chunkSize;
+        size_t numChunks;
+      };
+
+      class StreamLogReader {
+      public:
+        StreamLogReader();
+        ~StreamLogReader();
+
+        bool open(const std::string &filename);
+        void close();
+
+        const StreamSchema& getSchema() const { return schema; }
+        size_t getNumRows() const { return numRows; }
+
+        double getTime(size_t row) const;
+        LogValue getValue(size_t row, size_t item) const;
+
+      private:
+        MappedFile file;
+        StreamSchema schema;
+        uint32_t chunkRows;
+        size_t headerSize;
+        size_t chunkSize;
+        size_t numRows;
+        // number of rows stored before each chunk
+        std::vector<size_t> chunkOffsets;
+
+        const LogValue* column(size_t row, size_t col) const;
+      };
+
+    } // end of namespace data_broker_recorder
+  } // end of namespace plugins
+} // end of namespace mars
+
+#endif // MARS_PLUGINS_DATA_BROKER_RECORDER_STREAM_LOG_H
@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file test_record_replay.cpp
+ * \brief Records a stream, replays it into a second DataBroker and compares
+ *        the replayed rows with the recorded ones.
+ */
+
+#include "Recorder.h"
+#include "Replayer.h"
+
+#include <mars/data_broker/DataBroker.h>
+#include <mars/data_broker/ReceiverInterface.h>
+#include <mars/utils/misc.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace mars::data_broker;
+using namespace mars::plugins::data_broker_recorder;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  if(!(cond)) { fprintf(stderr, "%s:%d: %s failed\n", __FILE__, __LINE__, #cond); ++failures; }
+
+struct Row {
+  int i;
+  double d;
+  bool b;
+};
+
+class RowCollector : public ReceiverInterface {
+public:
+  std::vector<Row> rows;
+
+  void receiveData(const DataInfo &info, const DataPackage &package,
+                   int callbackParam) {
+    Row row = {0, 0., false};
+    package.get("i", &row.i);
+    package.get("d", &row.d);
+    package.get("b", &row.b);
+    rows.push_back(row);
+  }
+};
+
+int main(int argc, char *argv[]) {
+  char tmpl[] = "/tmp/data_broker_recorder_XXXXXX";
+  if(!mkdtemp(tmpl)) {
+    fprintf(stderr, "cannot create a temporary directory\n");
+    return 1;
+  }
+  const std::string logDir = tmpl;
+  // more rows than fit into one chunk, the last chunk is partially filled
+  const int numRows = 10;
+  const unsigned int chunkRows = 4;
+
+  DataBroker recordBroker(NULL);
+  DataPackage time, values;
+  time.add("simTime", 0.);
+  values.add("i", (int)0);
+  values.add("d", 0.);
+  values.add("b", false);
+  unsigned long timeId = recordBroker.pushData("mars_sim", "simTime", time,
+                                               NULL, DATA_PACKAGE_READ_FLAG);
+  unsigned long valuesId = recordBroker.pushData("test", "values", values,
+                                                 NULL, DATA_PACKAGE_READ_FLAG);
+
+  std::vector<Row> recorded;
+  {
+    Recorder recorder(&recordBroker);
+    std::vector<std::string> patterns(1, "test/*");
+    CHECK(recorder.start(logDir, patterns, chunkRows) == 1);
+    for(int n=0; n<numRows; ++n) {
+      Row row = {n-3, n*0.25, n%2 == 0};
+      time.set(0, n*10.);
+      values.set(0, row.i);
+      values.set(1, row.d);
+      values.set(2, row.b);
+      recordBroker.pushData(timeId, time);
+      recordBroker.pushData(valuesId, values);
+      recorded.push_back(row);
+    }
+    recorder.stop();
+  }
+
+  DataBroker replayBroker(NULL);
+  RowCollector collector;
+  replayBroker.registerSyncReceiver(&collector, "replay_test", "values", 0);
+  Replayer replayer(&replayBroker);
+  CHECK(replayer.open(logDir));
+  CHECK(replayer.getNumStreams() == 1);
+
+  // reopening while the replay thread runs has to stop it first
+  replayer.start(0.001, "replay_");
+  CHECK(replayer.open(logDir));
+  collector.rows.clear();
+
+  replayer.start(0., "replay_");
+  while(replayer.isRunning()) {
+    mars::utils::msleep(1);
+  }
+  CHECK(collector.rows.size() == recorded.size());
+  for(size_t n=0; n<collector.rows.size() && n<recorded.size(); ++n) {
+    CHECK(collector.rows[n].i == recorded[n].i);
+    CHECK(collector.rows[n].d == recorded[n].d);
+    CHECK(collector.rows[n].b == recorded[n].b);
+  }
+  replayer.close();
+  replayBroker.unregisterSyncReceiver(&collector, "replay_test", "values");
+
+  std::ifstream index((logDir + "/index.txt").c_str());
+  std::string filename;
+  while(std::getline(index, filename)) {
+    if(!filename.empty()) remove((logDir + "/" + filename).c_str());
+  }
+  remove((logDir + "/index.txt").c_str());
+  remove(logDir.c_str());
+
+  if(failures) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  return 0;
+}
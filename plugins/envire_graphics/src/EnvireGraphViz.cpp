@@ -60,6 +60,13 @@ void EnvireGraphViz::init()
   GraphItemEventDispatcher<envire::core::Item<smurf::Frame>>::subscribe(control->graph.get());
   GraphItemEventDispatcher<envire::core::Item<smurf::Collidable>>::subscribe(control->graph.get());
   GraphItemEventDispatcher<envire::core::Item<::smurf::Joint>>::subscribe(control->graph.get());
+
+  // draws the poses envire_physics wrote into the graph
+  PluginSchedule schedule;
+  schedule.dependencies.push_back("EnvirePhysics");
+  schedule.reads.push_back("envire_graph");
+  schedule.writes.push_back("graphics");
+  control->sim->setPluginSchedule(this, schedule);
 }
 
 void EnvireGraphViz::reset() {
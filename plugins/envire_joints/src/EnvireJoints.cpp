@@ -67,6 +67,8 @@ namespace mars {
         GraphItemEventDispatcher<envire::core::Item<smurf::StaticTransformation>>::subscribe(control->graph.get());
         GraphItemEventDispatcher<envire::core::Item<std::shared_ptr<mars::sim::SimNode>>>::subscribe(control->graph.get());
         GraphItemEventDispatcher<envire::core::Item<smurf::Joint>>::subscribe(control->graph.get());
+        // the joints are created by graph events, the update does nothing
+        control->sim->setPluginSchedule(this, PluginSchedule());
       }
       
       void EnvireJoints::reset() {
@@ -21,15 +21,24 @@
 /**
  * \file EnvireMls.cpp
  * \author Raul (Raul.Dominguez@dfki.de)
- * \brief Provides
+ * \brief Provides MLS surfaces that are streamed in tiles around the robots.
  *
  * Version 0.1
  */
 
 
 #include "EnvireMls.hpp"
-#include <envire_collider_mls/MLSCollision.hpp>
 
+#include <mars/interfaces/Logging.hpp>
+#include <mars/sim/PhysicsMapper.h>
+#include <mars/utils/misc.h>
+#include <mars/utils/MutexLocker.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
 
 namespace mars {
   namespace plugins {
@@ -39,28 +48,281 @@ namespace mars {
       using namespace mars::interfaces;
 
       EnvireMls::EnvireMls(lib_manager::LibManager *theManager)
-        : MarsPluginTemplate(theManager, "EnvireMls") {
-		
-        envire::collision::MLSCollision* mls_collision = envire::collision::MLSCollision::getInstance();
+        : MarsPluginTemplate(theManager, "EnvireMls"), loader(NULL),
+          tiled(false), tileSize(0.), timeSinceUpdate(0.) {
       }
-  
+
       void EnvireMls::init() {
+        if(control->cfg) {
+          cfgTrackedFrames = control->cfg->getOrCreateProperty("EnvireMls", "tracked_frames", std::string(""), this);
+          cfgLoadRadius = control->cfg->getOrCreateProperty("EnvireMls", "load_radius", 50.0, this);
+          cfgUnloadRadius = control->cfg->getOrCreateProperty("EnvireMls", "unload_radius", 75.0, this);
+          cfgUpdatePeriod = control->cfg->getOrCreateProperty("EnvireMls", "update_period", 500.0, this);
+        }
+        else {
+          cfgTrackedFrames.sValue = "";
+          cfgLoadRadius.dValue = 50.0;
+          cfgUnloadRadius.dValue = 75.0;
+          cfgUpdatePeriod.dValue = 500.0;
+        }
+        setTrackedFrames(cfgTrackedFrames.sValue);
+        GraphEventDispatcher::subscribe(control->graph.get());
+        loader = new MlsTileLoader();
+
+        // adds and removes the tile geoms of the collision space
+        PluginSchedule schedule;
+        schedule.reads.push_back("envire_graph");
+        schedule.writes.push_back("physics");
+        control->sim->setPluginSchedule(this, schedule);
       }
 
       void EnvireMls::reset() {
       }
 
       EnvireMls::~EnvireMls() {
+        if(control && control->cfg) {
+          control->cfg->unregisterFromCFG(this);
+        }
+        // stop the loader first, it may still hold references to maps
+        delete loader;
+        loader = NULL;
+        clearTiles();
       }
 
+      void EnvireMls::cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property) {
+        if(_property.paramId == cfgTrackedFrames.paramId) {
+          cfgTrackedFrames.sValue = _property.sValue;
+          setTrackedFrames(cfgTrackedFrames.sValue);
+        } else if(_property.paramId == cfgLoadRadius.paramId) {
+          cfgLoadRadius.dValue = _property.dValue;
+        } else if(_property.paramId == cfgUnloadRadius.paramId) {
+          cfgUnloadRadius.dValue = _property.dValue;
+        } else if(_property.paramId == cfgUpdatePeriod.paramId) {
+          cfgUpdatePeriod.dValue = _property.dValue;
+        }
+      }
+
+      void EnvireMls::frameAdded(const envire::core::FrameAddedEvent& e) {
+        if(originId.empty()) {
+          originId = e.frame;
+        }
+      }
+
+      void EnvireMls::setTrackedFrames(const std::string &frames) {
+        trackedFrames.clear();
+        std::vector<std::string> tokens = explodeString(',', frames);
+        for(size_t i=0; i<tokens.size(); ++i) {
+          std::string frame = trim(tokens[i]);
+          if(!frame.empty()) trackedFrames.push_back(frame);
+        }
+        // check the tiles in the next update
+        timeSinceUpdate = cfgUpdatePeriod.dValue;
+      }
 
       void EnvireMls::update(sReal time_ms) {
+        if(!loader || tiles.empty()) return;
+
+        // The maps and their ODE geoms are created on the loader thread. The
+        // geoms are added to the space here, between two physics steps, so
+        // that a tile appears in the collision space atomically.
+        std::vector<LoadedTile> loaded;
+        loader->takeFinished(&loaded);
+        for(size_t i=0; i<loaded.size(); ++i) {
+          std::map<TileKey, Tile>::iterator it = tiles.find(loaded[i].key);
+          if(it == tiles.end() || it->second.state != TILE_LOADING) {
+            if(loaded[i].geom) dGeomDestroy(loaded[i].geom);
+            continue;
+          }
+          if(loaded[i].geom) {
+            activateTile(&it->second, loaded[i]);
+          }
+          else {
+            // keep the tile from being requested again in every period
+            it->second.state = TILE_ACTIVE;
+          }
+        }
+
+        if(!tiled) return;
+        timeSinceUpdate += time_ms;
+        if(timeSinceUpdate < cfgUpdatePeriod.dValue) return;
+        timeSinceUpdate = 0.;
+        updateTileRequests();
+      }
+
+      void EnvireMls::addMLS(envire::core::FrameId center_, const std::string & mlsPath){
+        if(!loader) {
+          LOG_ERROR("EnvireMls: addMLS called before init");
+          return;
+        }
+        clearTiles();
+        center = center_;
+
+        struct stat st;
+        if(stat(mlsPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+          tiled = readTileIndex(mlsPath);
+          if(!tiled) return;
+          timeSinceUpdate = 0.;
+          updateTileRequests();
+        }
+        else {
+          // a single map is one tile that is never unloaded
+          tiled = false;
+          Tile &tile = tiles[TileKey(0, 0)];
+          tile.filename = mlsPath;
+          tile.state = TILE_LOADING;
+          tile.geom = NULL;
+          loader->request(TileKey(0, 0), mlsPath);
+        }
       }
 
-      void EnvireMls::addMLS(envire::core::FrameId center, const std::string & mlsPath){
+      bool EnvireMls::isLoading() const {
+        std::map<TileKey, Tile>::const_iterator it;
+        for(it=tiles.begin(); it!=tiles.end(); ++it) {
+          if(it->second.state == TILE_LOADING) return true;
+        }
+        return false;
+      }
+
+      bool EnvireMls::readTileIndex(const std::string &path) {
+        std::ifstream index((path + "/tiles.txt").c_str());
+        std::string line, keyword;
+        if(!std::getline(index, line)) {
+          LOG_ERROR("EnvireMls: cannot read %s/tiles.txt", path.c_str());
+          return false;
+        }
+        std::istringstream header(line);
+        if(!(header >> keyword >> tileSize) || keyword != "tile_size" ||
+           tileSize <= 0.) {
+          LOG_ERROR("EnvireMls: %s/tiles.txt has to start with \"tile_size <m>\"",
+                    path.c_str());
+          return false;
+        }
+        while(std::getline(index, line)) {
+          std::istringstream entry(line);
+          int ix, iy;
+          std::string filename;
+          if(!(entry >> ix >> iy >> filename)) continue;
+          Tile &tile = tiles[TileKey(ix, iy)];
+          tile.filename = path + "/" + filename;
+          tile.state = TILE_UNLOADED;
+          tile.geom = NULL;
+        }
+        return !tiles.empty();
+      }
 
+      double EnvireMls::tileDistance(const TileKey &key,
+                                     const std::vector<base::Vector3d> &positions) const {
+        double minDistance = -1.;
+        for(size_t i=0; i<positions.size(); ++i) {
+          // distance to the closest point of the tile rectangle
+          double x0 = key.first*tileSize, y0 = key.second*tileSize;
+          double dx = std::max(std::max(x0 - positions[i].x(), 0.),
+                               positions[i].x() - (x0 + tileSize));
+          double dy = std::max(std::max(y0 - positions[i].y(), 0.),
+                               positions[i].y() - (y0 + tileSize));
+          double d = std::sqrt(dx*dx + dy*dy);
+          if(minDistance < 0. || d < minDistance) minDistance = d;
+        }
+        return minDistance;
       }
 
+      void EnvireMls::updateTileRequests() {
+        std::vector<base::Vector3d> positions;
+        for(size_t i=0; i<trackedFrames.size(); ++i) {
+          try {
+            envire::core::Transform tf = control->graph->getTransform(center, trackedFrames[i]);
+            positions.push_back(tf.transform.translation);
+          } catch(const std::exception &e) {
+            // the frame may not be loaded yet
+          }
+        }
+        if(positions.empty()) {
+          positions.push_back(base::Vector3d::Zero());
+        }
+
+        std::map<TileKey, Tile>::iterator it;
+        for(it=tiles.begin(); it!=tiles.end(); ++it) {
+          Tile &tile = it->second;
+          double distance = tileDistance(it->first, positions);
+          if(tile.state == TILE_UNLOADED) {
+            if(distance <= cfgLoadRadius.dValue) {
+              tile.state = TILE_LOADING;
+              loader->request(it->first, tile.filename);
+            }
+          }
+          else if(distance > cfgUnloadRadius.dValue) {
+            if(tile.state == TILE_LOADING) {
+              loader->cancel(it->first);
+            }
+            unloadTile(&tile);
+          }
+        }
+      }
+
+      void EnvireMls::activateTile(Tile *tile, const LoadedTile &loaded) {
+        tile->map = loaded.map;
+        dGeomID geom = loaded.geom;
+
+        // the grid of the tile is placed by its local frame in the map and
+        // the map is given in the center frame
+        base::Transform3d originToCenter = base::Transform3d::Identity();
+        if(!originId.empty() && originId != center) {
+          try {
+            originToCenter = control->graph->getTransform(originId, center).transform.getTransform();
+          } catch(const std::exception &e) {
+            LOG_WARN("EnvireMls: no transform from %s to %s, using the origin",
+                     originId.c_str(), center.c_str());
+          }
+        }
+        base::Transform3d pose = originToCenter * loaded.map->getLocalFrame().inverse();
+        base::Quaterniond q(pose.rotation());
+        dQuaternion dq = {q.w(), q.x(), q.y(), q.z()};
+        sim::WorldPhysics *theWorld = (sim::WorldPhysics*)control->sim->getPhysics();
+        // the ray casts and other plugin threads walk the space
+        MutexLocker locker(&(theWorld->iMutex));
+        dGeomSetQuaternion(geom, dq);
+        dGeomSetPosition(geom, pose.translation().x(), pose.translation().y(),
+                         pose.translation().z());
+
+        sim::geom_data* gd = new sim::geom_data;
+        gd->setZero();
+        gd->sense_contact_force = 0;
+        gd->parent_geom = 0;
+        gd->c_params.cfm = 0.001;
+        gd->c_params.erp = 0.001;
+        gd->c_params.bounce = 0.0;
+        dGeomSetData(geom, gd);
+        dSpaceAdd(theWorld->getSpace(), geom);
+        tile->geom = (void*)geom;
+        tile->state = TILE_ACTIVE;
+      }
+
+      void EnvireMls::unloadTile(Tile *tile) {
+        if(tile->geom) {
+          dGeomID geom = (dGeomID)tile->geom;
+          sim::WorldPhysics *theWorld = (sim::WorldPhysics*)control->sim->getPhysics();
+          MutexLocker locker(&(theWorld->iMutex));
+          theWorld->removeContactPairs(geom);
+          dSpaceID space = dGeomGetSpace(geom);
+          if(space) dSpaceRemove(space, geom);
+          delete (sim::geom_data*)dGeomGetData(geom);
+          dGeomDestroy(geom);
+          tile->geom = NULL;
+        }
+        tile->map.reset();
+        tile->state = TILE_UNLOADED;
+      }
+
+      void EnvireMls::clearTiles() {
+        std::map<TileKey, Tile>::iterator it;
+        for(it=tiles.begin(); it!=tiles.end(); ++it) {
+          if(loader && it->second.state == TILE_LOADING) {
+            loader->cancel(it->first);
+          }
+          unloadTile(&it->second);
+        }
+        tiles.clear();
+      }
 
     } // end of namespace envire_mls
   } // end of namespace plugins
@@ -21,19 +21,35 @@
 /**
  * \file EnvireMls.h
  * \author Raul (Raul.Dominguez@dfki.de)
- * \brief Provides
+ * \brief Provides MLS surfaces that are streamed in tiles around the robots.
+ *
+ * A map is either a single serialized MLSMapKalman or a directory with a
+ * "tiles.txt" index. The index starts with "tile_size <meter>" followed by
+ * one "<ix> <iy> <file>" line per tile; tile (ix, iy) covers
+ * [ix*size, (ix+1)*size) x [iy*size, (iy+1)*size) in the center frame.
+ * Only tiles within "load_radius" of one of the "tracked_frames" are kept
+ * in the physics space, tiles farther than "unload_radius" are dropped.
+ * The geom of a tile is placed at the map's local frame in the center frame
+ * which is looked up in the graph relative to the simulation origin.
  *
  * Version 0.1
  */
 
 #pragma once
 
+#include "MlsTileLoader.hpp"
+
 #include <mars/interfaces/sim/MarsPluginTemplate.h>
 #include <mars/interfaces/MARSDefs.h>
+#include <mars/cfg_manager/CFGManagerInterface.h>
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <base/Eigen.hpp>
 
 namespace mars {
 
@@ -41,7 +57,9 @@ namespace mars {
     namespace envire_mls {
 
       // inherit from MarsPluginTemplateGUI for extending the gui
-      class EnvireMls: public mars::interfaces::MarsPluginTemplate {
+      class EnvireMls: public mars::interfaces::MarsPluginTemplate,
+                       public mars::cfg_manager::CFGClient,
+                       public envire::core::GraphEventDispatcher {
 
       public:
         EnvireMls(lib_manager::LibManager *theManager);
@@ -59,15 +77,52 @@ namespace mars {
         void reset();
         void update(mars::interfaces::sReal time_ms);
 
+        // CFGClient methods
+        virtual void cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property);
+
+        // GraphEventDispatcher methods
+        virtual void frameAdded(const envire::core::FrameAddedEvent& e);
+
         // EnvireMls methods
         void addMLS(envire::core::FrameId center, const std::string & mlsPath);
+        /** \return true while a requested tile is not yet in the simulation */
+        bool isLoading() const;
 
       private:
-
+        enum TileState {TILE_UNLOADED, TILE_LOADING, TILE_ACTIVE};
+
+        struct Tile {
+          std::string filename;
+          TileState state;
+          MlsMapPtr map;
+          void *geom;
+        };
+
+        MlsTileLoader *loader;
+        // the first frame added to the graph, as in envire_physics
+        envire::core::FrameId originId;
+        envire::core::FrameId center;
+        std::map<TileKey, Tile> tiles;
+        // tiles are streamed only if the map was given as tile index
+        bool tiled;
+        double tileSize;
+        std::vector<std::string> trackedFrames;
+        double timeSinceUpdate;
+
+        cfg_manager::cfgPropertyStruct cfgTrackedFrames, cfgLoadRadius;
+        cfg_manager::cfgPropertyStruct cfgUnloadRadius, cfgUpdatePeriod;
+
+        void setTrackedFrames(const std::string &frames);
+        bool readTileIndex(const std::string &indexFile);
+        void updateTileRequests();
+        void activateTile(Tile *tile, const LoadedTile &loaded);
+        void unloadTile(Tile *tile);
+        void clearTiles();
+        double tileDistance(const TileKey &key,
+                            const std::vector<base::Vector3d> &positions) const;
 
       }; // end of class definition EnvireMls
 
     } // end of namespace envire_mls
   } // end of namespace plugins
 } // end of namespace mars
-
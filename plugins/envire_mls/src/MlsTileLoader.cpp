@@ -0,0 +1,147 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file MlsTileLoader.cpp
+ * \brief Deserializes MLS map tiles and creates their collision geoms on a
+ *        background thread.
+ *
+ * Version 0.1
+ */
+
+#include "MlsTileLoader.hpp"
+
+#include <mars/utils/MutexLocker.h>
+#include <mars/interfaces/Logging.hpp>
+#include <envire_collider_mls/MLSCollision.hpp>
+
+#include <fstream>
+#include <boost/archive/polymorphic_binary_iarchive.hpp>
+
+namespace mars {
+  namespace plugins {
+    namespace envire_mls {
+
+      using namespace mars::utils;
+
+      MlsTileLoader::MlsTileLoader() : stopRequested(false) {
+        mlsCollision = envire::collision::MLSCollision::getInstance();
+        start();
+      }
+
+      MlsTileLoader::~MlsTileLoader() {
+        stop();
+        for(size_t i=0; i<finished.size(); ++i) {
+          if(finished[i].geom) dGeomDestroy(finished[i].geom);
+        }
+      }
+
+      void MlsTileLoader::request(const TileKey &key,
+                                  const std::string &filename) {
+        MutexLocker locker(&mutex);
+        cancelled.erase(key);
+        requests.push_back(std::make_pair(key, filename));
+        condition.wakeAll();
+      }
+
+      void MlsTileLoader::cancel(const TileKey &key) {
+        MutexLocker locker(&mutex);
+        std::deque<std::pair<TileKey, std::string> >::iterator it;
+        for(it=requests.begin(); it!=requests.end(); ++it) {
+          if(it->first == key) {
+            requests.erase(it);
+            return;
+          }
+        }
+        std::vector<LoadedTile>::iterator it2;
+        for(it2=finished.begin(); it2!=finished.end(); ++it2) {
+          if(it2->key == key) {
+            if(it2->geom) dGeomDestroy(it2->geom);
+            finished.erase(it2);
+            return;
+          }
+        }
+        // neither queued nor finished, thus it is loading right now
+        cancelled.insert(key);
+      }
+
+      void MlsTileLoader::takeFinished(std::vector<LoadedTile> *tiles) {
+        MutexLocker locker(&mutex);
+        tiles->insert(tiles->end(), finished.begin(), finished.end());
+        finished.clear();
+      }
+
+      void MlsTileLoader::stop() {
+        if(!isRunning()) return;
+        mutex.lock();
+        stopRequested = true;
+        condition.wakeAll();
+        mutex.unlock();
+        wait();
+      }
+
+      void MlsTileLoader::run() {
+        dAllocateODEDataForThread(dAllocateMaskAll);
+        mutex.lock();
+        while(!stopRequested) {
+          if(requests.empty()) {
+            condition.wait(&mutex);
+            continue;
+          }
+          std::pair<TileKey, std::string> job = requests.front();
+          requests.pop_front();
+          mutex.unlock();
+
+          LoadedTile tile;
+          tile.key = job.first;
+          tile.geom = 0;
+          std::ifstream input(job.second.c_str(), std::ios::binary);
+          if(input.good()) {
+            try {
+              MlsMapPtr map(new maps::grid::MLSMapKalman);
+              boost::archive::polymorphic_binary_iarchive ia(input);
+              ia >> *map;
+              tile.map = map;
+              // the geom is only added to the space by the simulation thread
+              tile.geom = (dGeomID)mlsCollision->createNewCollisionObject(map);
+            } catch(std::exception &e) {
+              LOG_ERROR("EnvireMls: cannot read tile %s: %s",
+                        job.second.c_str(), e.what());
+            }
+          }
+          else {
+            LOG_ERROR("EnvireMls: cannot open tile %s", job.second.c_str());
+          }
+
+          mutex.lock();
+          if(cancelled.erase(job.first) == 0) {
+            finished.push_back(tile);
+          }
+          else if(tile.geom) {
+            dGeomDestroy(tile.geom);
+          }
+        }
+        mutex.unlock();
+        dCleanupODEAllDataForThread();
+      }
+
+    } // end of namespace envire_mls
+  } // end of namespace plugins
+} // end of namespace mars
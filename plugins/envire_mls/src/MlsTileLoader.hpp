@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file MlsTileLoader.hpp
+ * \brief Deserializes MLS map tiles and creates their collision geoms on a
+ *        background thread.
+ *
+ * Version 0.1
+ */
+
+#pragma once
+
+#include <mars/utils/Thread.h>
+#include <mars/utils/Mutex.h>
+#include <mars/utils/WaitCondition.h>
+
+#include <maps/grid/MLSMap.hpp>
+#include <boost/shared_ptr.hpp>
+#include <ode/ode.h>
+
+#include <deque>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace envire {
+  namespace collision {
+    class MLSCollision;
+  }
+}
+
+namespace mars {
+
+  namespace plugins {
+    namespace envire_mls {
+
+      typedef std::pair<int, int> TileKey;
+      typedef boost::shared_ptr<maps::grid::MLSMapKalman> MlsMapPtr;
+
+      struct LoadedTile {
+        TileKey key;
+        MlsMapPtr map;  // empty if the file could not be read
+        dGeomID geom;   // not yet placed and in no space
+      };
+
+      class MlsTileLoader : public utils::Thread {
+
+      public:
+        MlsTileLoader();
+        ~MlsTileLoader();
+
+        /** \brief queues \a filename to be loaded for tile \a key */
+        void request(const TileKey &key, const std::string &filename);
+        /** \brief drops a queued request; a tile being loaded is discarded */
+        void cancel(const TileKey &key);
+        /**
+         * \brief moves all tiles that finished loading into \a tiles, the
+         *        caller takes the ownership of their geoms
+         */
+        void takeFinished(std::vector<LoadedTile> *tiles);
+        void stop();
+
+      protected:
+        // Thread methods
+        void run();
+
+      private:
+        envire::collision::MLSCollision *mlsCollision;
+        // protects all members below
+        utils::Mutex mutex;
+        utils::WaitCondition condition;
+        std::deque<std::pair<TileKey, std::string> > requests;
+        std::set<TileKey> cancelled;
+        std::vector<LoadedTile> finished;
+        bool stopRequested;
+
+      }; // end of class MlsTileLoader
+
+    } // end of namespace envire_mls
+  } // end of namespace plugins
+} // end of namespace mars
@@ -56,6 +56,8 @@ void EnvireMotors::init() {
     GraphEventDispatcher::subscribe(control->graph.get());
     GraphItemEventDispatcher<Item<smurf::Motor>>::subscribe(control->graph.get());
     motorIndex = 1;
+    // the motors are created by graph events, the update does nothing
+    control->sim->setPluginSchedule(this, PluginSchedule());
 }
 
 void EnvireMotors::reset() {
@@ -50,7 +50,9 @@ using namespace std;
 using namespace base;
 
 EnvirePhysics::EnvirePhysics(lib_manager::LibManager *theManager)
-  : MarsPluginTemplate(theManager, "EnvirePhysics"){
+  : MarsPluginTemplate(theManager, "EnvirePhysics"),
+    treeDirty(true), writingTransforms(false),
+    rootToRoot(TransformWithCovariance::Identity()){
 }
 
 void EnvirePhysics::init() {
@@ -64,6 +66,14 @@ void EnvirePhysics::init() {
   GraphItemEventDispatcher<Item<smurf::Collidable>>::subscribe(control->graph.get());
   GraphItemEventDispatcher<Item<smurf::Inertial>>::subscribe(control->graph.get());
   GraphItemEventDispatcher<Item<NodeData>>::subscribe(control->graph.get());
+  GraphItemEventDispatcher<Item<std::shared_ptr<SimNode>>>::subscribe(control->graph.get());
+
+  // copies the node poses into the graph
+  PluginSchedule schedule;
+  schedule.reads.push_back("nodes");
+  schedule.reads.push_back("physics");
+  schedule.writes.push_back("envire_graph");
+  control->sim->setPluginSchedule(this, schedule);
 #ifdef DEBUG
   LOG_DEBUG("[EnvirePhysics::init] ");
 #endif
@@ -91,6 +101,7 @@ void EnvirePhysics::frameRemoved(const FrameRemovedEvent& e)
 #endif      
   //FIXME do something intelligent of the origin gets removed
   assert(e.frame != originId); 
+  treeDirty = true;
 }
 
 void EnvirePhysics::edgeRemoved(const envire::core::EdgeRemovedEvent& e)
@@ -99,9 +110,9 @@ void EnvirePhysics::edgeRemoved(const envire::core::EdgeRemovedEvent& e)
   LOG_DEBUG("[EnvirePhysics::edgeRemoved] EdgeRemovedEvent");
 #endif    
   //Removing a transform can lead to non trivial changes in the tree.
-  //Instead of thinking about them we just recalculate the tree.
-  //This is fast enough for now.
-  updateTree();
+  //Instead of thinking about them we just recalculate the tree on the
+  //next update. Loading a robot removes and adds many edges in a row.
+  treeDirty = true;
 }
 
 void EnvirePhysics::edgeAdded(const envire::core::EdgeAddedEvent& e)
@@ -109,8 +120,8 @@ void EnvirePhysics::edgeAdded(const envire::core::EdgeAddedEvent& e)
 #ifdef DEBUG
   LOG_DEBUG("[EnvirePhysics::edgeAdded] EdgeAddedEvent");
 #endif  
-  //dont give a shit about performance for the first iteration
-  updateTree();
+  //the tree is rebuilt once on the next update instead of once per edge
+  treeDirty = true;
 }
 
 void EnvirePhysics::edgeModified(const envire::core::EdgeModifiedEvent& e)
@@ -118,7 +129,20 @@ void EnvirePhysics::edgeModified(const envire::core::EdgeModifiedEvent& e)
 #ifdef DEBUG
   LOG_DEBUG("[EnvirePhysics::edgeModified] EdgeModifiedEvent");
 #endif
-  //for the first iteration we ignore transformation changes from outside this plugin
+  //our own writes are already in the traversal cache
+  if(writingTransforms || treeDirty)
+    return;
+  //transformation changes from outside this plugin move the subtree
+  std::map<std::pair<FrameId, FrameId>, size_t>::const_iterator it;
+  it = traversalIndex.find(std::make_pair(e.origin, e.target));
+  if(it == traversalIndex.end())
+    it = traversalIndex.find(std::make_pair(e.target, e.origin));
+  if(it != traversalIndex.end())
+  {
+    TraversalEntry &entry = traversal[it->second];
+    entry.originToTarget = control->graph->getTransform(entry.origin, entry.target);
+    entry.dirty = true;
+  }
 }
 
 void EnvirePhysics::itemAdded(const TypedItemAddedEvent<Item<smurf::Frame>>& e)
@@ -299,9 +323,24 @@ void EnvirePhysics::itemAdded(const TypedItemAddedEvent<Item<NodeData>>& e)
 
 }
 
+void EnvirePhysics::itemAdded(const TypedItemAddedEvent<Item<std::shared_ptr<SimNode>>>& e)
+{
+  treeDirty = true;
+}
+
+void EnvirePhysics::itemRemoved(const TypedItemRemovedEvent<Item<std::shared_ptr<SimNode>>>& e)
+{
+  //the traversal still references the SimNode, it is released when the
+  //traversal is rebuilt on the next update
+  treeDirty = true;
+}
+
 void EnvirePhysics::update(sReal time_ms) 
 {
-  const GraphTraits::vertex_descriptor originDesc = control->graph->vertex(originId);
+  if(treeDirty)
+  {
+    updateTraversal();
+  }
   if(printGraph)
   {
     envire::core::GraphViz viz;
@@ -309,7 +348,50 @@ void EnvirePhysics::update(sReal time_ms)
     std::string name = "BeforeUpdatePhysics" + timeStamp + ".dot";
     viz.write(*(control->graph), name);
   }
-  updateChildPositions(originDesc, TransformWithCovariance::Identity()); 
+  const double calc_ms = control->sim->getCalcMs();
+  for(size_t i = 0; i < traversal.size(); ++i)
+  {
+    TraversalEntry &entry = traversal[i];
+    const TransformWithCovariance &originToRoot =
+      entry.parent < 0 ? rootToRoot : traversal[entry.parent].targetToRoot;
+    bool moved = entry.dirty || (entry.parent >= 0 && traversal[entry.parent].moved);
+    entry.dirty = false;
+
+    if(!entry.simNodes.empty())
+    {
+      for(const std::shared_ptr<mars::sim::SimNode> &sim_node : entry.simNodes)
+      {
+        sim_node->update(calc_ms);
+      }
+      // as before, the last SimNode of the frame defines the transform
+      const std::shared_ptr<mars::sim::SimNode> &sim_node = entry.simNodes.back();
+      const mars::utils::Vector pos = sim_node->getPosition();
+      const mars::utils::Quaternion rot = sim_node->getRotation();
+      if(!entry.hasPose || pos != entry.lastPos ||
+         rot.coeffs() != entry.lastRot.coeffs())
+      {
+        entry.lastPos = pos;
+        entry.lastRot = rot;
+        entry.hasPose = true;
+        moved = true;
+      }
+      if(moved)
+      {
+        TransformWithCovariance absolutTransform;
+        absolutTransform.translation = pos;
+        absolutTransform.orientation = rot;
+        entry.originToTarget.setTransform(originToRoot * absolutTransform);
+        pendingWrites.push_back(i);
+      }
+    }
+
+    if(moved)
+    {
+      entry.targetToRoot = entry.originToTarget.transform.inverse() * originToRoot;
+    }
+    entry.moved = moved;
+  }
+  flushTransforms();
   if(printGraph)
   {
     envire::core::GraphViz viz;
@@ -351,6 +433,85 @@ void EnvirePhysics::updateTree()
   }
 }
 
+void EnvirePhysics::updateTraversal()
+{
+  using simNodeType = envire::core::Item<std::shared_ptr<mars::sim::SimNode>>;
+  using IteratorSimNode = EnvireGraph::ItemIterator<simNodeType>;
+
+  traversal.clear();
+  traversalIndex.clear();
+  pendingWrites.clear();
+  treeDirty = false;
+  if(originId.empty())
+    return;
+
+  updateTree();
+
+  // breadth first, so that every parent is stored before its children
+  std::vector<std::pair<GraphTraits::vertex_descriptor, int>> open;
+  open.push_back(std::make_pair(control->graph->vertex(originId), -1));
+  for(size_t k = 0; k < open.size(); ++k)
+  {
+    const GraphTraits::vertex_descriptor vertex = open[k].first;
+    if(treeView.tree.find(vertex) == treeView.tree.end())
+      continue;
+    // the children are an unordered set of vertex descriptors, they are
+    // sorted by frame id so that the traversal and thus the order of the
+    // SimNode updates and graph writes does not depend on the addresses
+    const unordered_set<GraphTraits::vertex_descriptor>& childSet = treeView.tree[vertex].children;
+    std::vector<std::pair<FrameId, GraphTraits::vertex_descriptor>> children;
+    children.reserve(childSet.size());
+    for(const GraphTraits::vertex_descriptor child : childSet)
+    {
+      children.push_back(std::make_pair(control->graph->getFrameId(child), child));
+    }
+    std::sort(children.begin(), children.end(),
+              [](const std::pair<FrameId, GraphTraits::vertex_descriptor> &a,
+                 const std::pair<FrameId, GraphTraits::vertex_descriptor> &b)
+              { return a.first < b.first; });
+    for(const auto &sortedChild : children)
+    {
+      const GraphTraits::vertex_descriptor child = sortedChild.second;
+      TraversalEntry entry;
+      entry.origin = vertex;
+      entry.target = child;
+      entry.parent = open[k].second;
+      entry.originToTarget = control->graph->getTransform(vertex, child);
+      entry.hasPose = false;
+      entry.dirty = true;
+      entry.moved = false;
+      if(control->graph->containsItems<simNodeType>(child))
+      {
+        IteratorSimNode begin_sim, end_sim;
+        boost::tie(begin_sim, end_sim) = control->graph->getItems<simNodeType>(child);
+        for(; begin_sim != end_sim; ++begin_sim)
+        {
+          entry.simNodes.push_back(begin_sim->getData());
+        }
+      }
+      const size_t index = traversal.size();
+      traversalIndex[std::make_pair(control->graph->getFrameId(vertex),
+                                    control->graph->getFrameId(child))] = index;
+      traversal.push_back(entry);
+      open.push_back(std::make_pair(child, (int)index));
+    }
+  }
+}
+
+void EnvirePhysics::flushTransforms()
+{
+  // the graph events of all writes are dispatched after the whole tree
+  // was updated instead of in between the single SimNode updates
+  writingTransforms = true;
+  for(const size_t i : pendingWrites)
+  {
+    const TraversalEntry &entry = traversal[i];
+    control->graph->updateTransform(entry.origin, entry.target, entry.originToTarget);
+  }
+  writingTransforms = false;
+  pendingWrites.clear();
+}
+
 std::shared_ptr<NodeData> EnvirePhysics::getCollidableNode(const smurf::Collidable& collidable, const envire::core::FrameId& frame) {
   NodeData * node = new NodeData;
   std::shared_ptr<NodeData> nodePtr(node);
@@ -431,6 +592,7 @@ bool EnvirePhysics::instantiateNode(const std::shared_ptr<NodeData> &node, const
     using SimNodeItemPtr = envire::core::Item<std::shared_ptr<mars::sim::SimNode>>::Ptr;
     using SimNodeItem =  envire::core::Item<std::shared_ptr<mars::sim::SimNode>>;
     SimNodeItemPtr simNodeItem( new SimNodeItem(simNodePtr));        
+    //the item added event marks the traversal dirty
     control->graph->addItemToFrame(frame, simNodeItem);
 #ifdef DEBUG
     LOG_DEBUG("[EnvirePhysics::InstantiateNode] The SimNode is created and added to the graph");
@@ -471,55 +633,6 @@ void EnvirePhysics::setPos(const envire::core::FrameId& frame, const std::shared
   node->rot = fromOrigin.transform.orientation;
 }   
 
-void EnvirePhysics::updateChildPositions(const GraphTraits::vertex_descriptor vertex,
-                                        const TransformWithCovariance& frameToRoot)
-{
-  if(treeView.tree.find(vertex) != treeView.tree.end())
-  {
-    const unordered_set<GraphTraits::vertex_descriptor>& children = treeView.tree[vertex].children;
-    for(const GraphTraits::vertex_descriptor child : children)
-    {
-      updatePositions(vertex, child, frameToRoot);
-    }
-  } 
-}
-
-void EnvirePhysics::updatePositions( const GraphTraits::vertex_descriptor origin,
-                                    const GraphTraits::vertex_descriptor target,
-                                    const TransformWithCovariance& originToRoot)
-{
-#ifdef DEBUG  
-  LOG_DEBUG("EnvirePhysics::updatePositions");
-#endif
-
-  Transform tf = control->graph->getTransform(origin, target);
-
-  if (control->graph->containsItems<envire::core::Item<std::shared_ptr<mars::sim::SimNode>>>(target))
-  {
-    // Update simulation node
-    using simNodeType = envire::core::Item<std::shared_ptr<mars::sim::SimNode>>;
-    using IteratorSimNode = EnvireGraph::ItemIterator<simNodeType>;
-    IteratorSimNode begin_sim, end_sim;
-    boost::tie(begin_sim, end_sim) = control->graph->getItems<simNodeType>(target);
-    double calc_ms = control->sim->getCalcMs();
-    for (;begin_sim!=end_sim; begin_sim++)
-    {
-      const std::shared_ptr<mars::sim::SimNode> sim_node = begin_sim->getData();
-      sim_node->update(calc_ms);
-
-      TransformWithCovariance absolutTransform;
-      absolutTransform.translation = sim_node->getPosition();
-      absolutTransform.orientation = sim_node->getRotation();    
-
-      tf.setTransform(originToRoot * absolutTransform); 
-      control->graph->updateTransform(origin, target, tf);
-    }
-  }
-
-  const Transform invTf = control->graph->getTransform(target, origin);
-  updateChildPositions(target, invTf.transform * originToRoot);
-}
-
 DESTROY_LIB(mars::plugins::envire_physics::EnvirePhysics);
 CREATE_LIB(mars::plugins::envire_physics::EnvirePhysics);
 
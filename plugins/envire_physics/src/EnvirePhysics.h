@@ -6,6 +6,8 @@
 #include <mars/cfg_manager/CFGManagerInterface.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <map>
 #include <boost/functional/hash.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <mars/sim/ConfigMapItem.h>
@@ -16,6 +18,9 @@
 #include <urdf_model/model.h>
 #include <smurf/Collidable.hpp>
 #include <base/TransformWithCovariance.hpp>
+#include <mars/utils/Vector.h>
+#include <mars/utils/Quaternion.h>
+#include <Eigen/StdVector>
 
 #include <envire_core/events/GraphEventDispatcher.hpp>
 #include <envire_core/events/GraphItemEventDispatcher.hpp>
@@ -31,6 +36,10 @@ namespace mars {
     class NodeInterface;
     class JointInterface;
   }
+
+  namespace sim {
+    class SimNode;
+  }
   
   namespace plugins {
     namespace envire_physics {
@@ -47,7 +56,8 @@ namespace mars {
                            public envire::core::GraphItemEventDispatcher<envire::core::Item<smurf::Collidable>>,
                            public envire::core::GraphItemEventDispatcher<envire::core::Item<urdf::Collision>>,
                            public envire::core::GraphItemEventDispatcher<envire::core::Item<smurf::Inertial>>,
-                           public envire::core::GraphItemEventDispatcher<envire::core::Item<mars::interfaces::NodeData>>
+                           public envire::core::GraphItemEventDispatcher<envire::core::Item<mars::interfaces::NodeData>>,
+                           public envire::core::GraphItemEventDispatcher<envire::core::Item<std::shared_ptr<mars::sim::SimNode>>>
       {
       public:
         EnvirePhysics(lib_manager::LibManager *theManager);
@@ -109,20 +119,61 @@ namespace mars {
         void itemAdded(const envire::core::TypedItemAddedEvent<envire::core::Item<configmaps::ConfigMap>>& e);
         void itemAdded(const envire::core::TypedItemAddedEvent<mars::sim::PhysicsConfigMapItem>& e);
 		void itemAdded(const envire::core::TypedItemAddedEvent<envire::core::Item<mars::interfaces::NodeData>>& e);
+        /**
+         * SimNodes can be added to or removed from a frame by any plugin.
+         * The traversal holds its own references to the SimNodes of each
+         * frame, thus it is rebuilt on the next update.
+         */
+        void itemAdded(const envire::core::TypedItemAddedEvent<envire::core::Item<std::shared_ptr<mars::sim::SimNode>>>& e);
+        void itemRemoved(const envire::core::TypedItemRemovedEvent<envire::core::Item<std::shared_ptr<mars::sim::SimNode>>>& e);
  
         /*
-         *  dfs visit the tree and update all positions.
+         *  Walk the flattened tree and update all positions.
          *  The transforms in the graph are relative to their parent while the
          *  transform from simulation is relative to the root.
-         *  The relative:w
-         * transformations are easy to calculate when dfs visiting the tree.
+         *  Only the edges below a SimNode that moved are recalculated and
+         *  written back into the graph at the end of the step.
          */
         void update(mars::interfaces::sReal time_ms);
 
         void cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property);
         
       private:
+        /**
+         * One edge of the physics tree in traversal order. Parents always
+         * come before their children, so a single forward pass over the
+         * vector visits the tree like the former recursive dfs.
+         */
+        struct TraversalEntry
+        {
+          envire::core::GraphTraits::vertex_descriptor origin;
+          envire::core::GraphTraits::vertex_descriptor target;
+          // index of the entry whose target is our origin, -1 for the root
+          int parent;
+          std::vector<std::shared_ptr<mars::sim::SimNode>> simNodes;
+          // cached copy of the graph transform origin -> target
+          envire::core::Transform originToTarget;
+          base::TransformWithCovariance targetToRoot;
+          mars::utils::Vector lastPos;
+          mars::utils::Quaternion lastRot;
+          bool hasPose;
+          // set when the edge was changed from outside of this plugin
+          bool dirty;
+          // set when targetToRoot changed during the current step
+          bool moved;
+
+          EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+        };
+
         void updateTree();
+        /**
+         * Rebuilds the flattened traversal from the tree view. Called lazily
+         * from update() after the graph structure or the SimNode items
+         * changed.
+         */
+        void updateTraversal();
+        /** Writes all transforms that changed in this step into the graph. */
+        void flushTransforms();
         /**
          * Returns a Nodedata with the configuration provided by the smurf collidable and positioned according to the frame
          */
@@ -140,18 +191,18 @@ namespace mars {
          * Sets to the nodeData the position that corresponds to the given frame id
          */
         void setPos(const envire::core::FrameId& frame, const std::shared_ptr<mars::interfaces::NodeData>& node);
-
-        /*
-         *  Perform updatePositions for each of your childs
-         */
-        void updateChildPositions(const envire::core::GraphTraits::vertex_descriptor vertex,
-                                  const base::TransformWithCovariance& frameToRoot);
-        void updatePositions(const envire::core::GraphTraits::vertex_descriptor origin,
-                             const envire::core::GraphTraits::vertex_descriptor target,
-                             const base::TransformWithCovariance& originToRoot);
         
         envire::core::FrameId originId;
         envire::core::TreeView treeView;
+        bool treeDirty;
+
+        std::vector<TraversalEntry, Eigen::aligned_allocator<TraversalEntry>> traversal;
+        // (origin, target) -> index in traversal
+        std::map<std::pair<envire::core::FrameId, envire::core::FrameId>, size_t> traversalIndex;
+        std::vector<size_t> pendingWrites;
+        // true while we write our own transforms into the graph
+        bool writingTransforms;
+        const base::TransformWithCovariance rootToRoot;
         
         const bool printGraph = false;
         const bool debugUpdatePos = false;
@@ -63,6 +63,14 @@ namespace mars {
         assert(control->graph != nullptr);
         GraphEventDispatcher::subscribe(control->graph.get());
         GraphItemEventDispatcher<Item<smurf::Sensor>>::subscribe(control->graph.get());
+
+        // updates the nodes and sensors of the velodyne and 6dof frames
+        PluginSchedule schedule;
+        schedule.reads.push_back("envire_graph");
+        schedule.writes.push_back("nodes");
+        schedule.writes.push_back("physics");
+        schedule.writes.push_back("sensors");
+        control->sim->setPluginSchedule(this, schedule);
       }
 
       void EnvireSensors::reset() {
@@ -248,8 +256,8 @@ CREATE_LIB(mars::plugins::envire_sensors::EnvireSensors);
         posSensor = dynamic_cast<mars::sim::NodePositionSensor*>(sensorPtr.get());
         LOG_DEBUG(("[EnvireSensor::display_position_data] We have the position sensor with name: " + posSensor->getName()).c_str());
         
-        sReal *sens_val;
-        int count_val = posSensor->getSensorData(&sens_val);
+        sReal sens_val[3];
+        int count_val = posSensor->readSensorData(sens_val, 3);
         
         //char * data;
         //int dimensions = posSensor-> getAsciiData(data);
@@ -293,8 +301,8 @@ CREATE_LIB(mars::plugins::envire_sensors::EnvireSensors);
         mars::sim::NodeCOMSensor * comSensor;
         comSensor = dynamic_cast<mars::sim::NodeCOMSensor* >(sensorPtr.get());
         
-        sReal *sens_val;
-        int count_val = comSensor->getSensorData(&sens_val);
+        sReal sens_val[3];
+        int count_val = comSensor->readSensorData(sens_val, 3);
         
         LOG_DEBUG("[enviresensor::display_contact_data] dimensions of the sensor data: , %d ", count_val);
         LOG_DEBUG("[enviresensor::display_contact_data] data 1: , %6.2f", ((double)sens_val[0]));
@@ -44,6 +44,8 @@ namespace mars {
       void EnvireVisualDebug::init() {
 
         gui->addGenericMenuAction("../EnvireVisualDebug/showEnvireGraph", 1, this);
+        // the graph is only shown from the menu, the update does nothing
+        control->sim->setPluginSchedule(this, PluginSchedule());
 
       }
 
@@ -1,5 +1,5 @@
 /** dMlsfield Collider
- * \file mlsfield.h
+ * \file mlsfield.cpp
  * \author Yong-Ho Yoo
  * \brief mlsfield is based on the heightfield grid structure. 
  *        Heightfield triangles have been replaced by rectangulars and boxs. 
@@ -7,31 +7,20 @@
  */
 
 
-#include <ode/common.h>
-#include <ode/collision.h>
-#include <ode/rotation.h>
-#include "config.h"
-#include <ode/matrix.h>
-#include <ode/odemath.h>
-#include "collision_kernel.h"
-#include "collision_std.h"
-#include "collision_util.h"
 #include "mlsfield.h"
-#include <iostream>
+#include <cstring>
 
 
 #define dMIN(A,B)  ((A)>(B) ? (B) : (A))
 #define dMAX(A,B)  ((A)>(B) ? (A) : (B))
 
+// the contact count in the collider flags, the mask is not part of the
+// public ODE headers
+#ifndef NUMC_MASK
+#define NUMC_MASK (0xffff)
+#endif
 
-// Three-way MIN and MAX
-#define dMIN3(A,B,C)	( (A)<(B) ? dMIN((A),(C)) : dMIN((B),(C)) )
-#define dMAX3(A,B,C)	( (A)>(B) ? dMAX((A),(C)) : dMAX((B),(C)) )
-
-#define dOPESIGN(a, op1, op2,b) \
-    (a)[0] op1 op2 ((b)[0]); \
-    (a)[1] op1 op2 ((b)[1]); \
-    (a)[2] op1 op2 ((b)[2]);
+#define CONTACT(p, skip) ((dContactGeom*) (((char*)(p)) + (skip)))
 
 
 dxMlsfieldData::dxMlsfieldData():
@@ -61,9 +50,11 @@ dxMlsfieldData::dxMlsfieldData():
     m_pHeightData( NULL ),
     m_pUserData( NULL ),
 
-    m_pGetHeightCallback( NULL )
+    m_pGetHeightCallback( NULL ),
+
+    m_pPatchTop( NULL ),
+    m_fPatchThickness( MLSFIELDPATCHTHICKNESS )
 {
-    memset( m_contacts, 0, sizeof( m_contacts ) );
 }
 
 void dxMlsfieldData::SetData( int nWidthSamples, int nDepthSamples,
@@ -294,8 +285,35 @@ dReal dxMlsfieldData::GetHeight( dReal x, dReal z )
     return y;
 }
 
+// caches the patch heights of the whole map
+void dxMlsfieldData::BuildPatchCache()
+{
+    ResetPatchCache();
+
+    m_fPatchThickness = ( m_fThickness > REAL( 0.0 ) ) ?
+        m_fThickness : REAL( MLSFIELDPATCHTHICKNESS );
+
+    const int numSamples = m_nWidthSamples * m_nDepthSamples;
+    m_pPatchTop = new dReal[ numSamples ];
+    for ( int z = 0; z < m_nDepthSamples; z++ )
+    {
+        for ( int x = 0; x < m_nWidthSamples; x++ )
+        {
+            m_pPatchTop[ x + z * m_nWidthSamples ] = GetHeight( x, z );
+        }
+    }
+}
+
+void dxMlsfieldData::ResetPatchCache()
+{
+    delete [] m_pPatchTop;
+    m_pPatchTop = NULL;
+}
+
 dxMlsfieldData::~dxMlsfieldData()
 {
+    ResetPatchCache();
+
     unsigned char *data_byte;
     short *data_short;
     float *data_float;
@@ -344,212 +362,6 @@ dxMlsfieldData::~dxMlsfieldData()
 }
 
 
-// here we define new collider() functions according to the class numbers
-dColliderFn * setColliders(int num){     	
-	
-	printf("dxGeom type num = %d\n", num);
-	
-	dColliderFn *fn;
-	//if(num == 0 || num == 4) {		//dSphereClass  or dRayClass
-	if(num == 0) {		 				//dSphereClass  	
-		fn = &dCollideMlsfield;
-		return fn;
-	} 
-	else return NULL;
-}
-
-dxMlsfield::dxMlsfield( dSpaceID space,
-                             dMlsfieldDataID data,
-                             int bPlaceable )			:
-    dxGeom( space, bPlaceable ),
-    tempRectangularBuffer(0),
-    tempRectangularBufferSize(0),
-    tempHeightBuffer(0),
-    tempHeightInstances(0),
-    tempHeightBufferSizeX(0),
-    tempHeightBufferSizeZ(0)
-{
-    //to create the function pointer of the dColliderFnFn which uses for dCollideUserGeomWithGeom   
-    dGeomClass mls_colliders;	
-    mls_colliders.collider = setColliders;   
-    type = dCreateGeomClass(&mls_colliders);
- 	printf("dxMlsfield type= %d\n", type);   
-    this->m_p_data = data;
-    
-}
-
-
-// compute axis aligned bounding box
-void dxMlsfield::computeAABB()
-{
-    const dxMlsfieldData *d = m_p_data;
-
-    if ( d->m_bWrapMode == 0 )
-    {
-        // Finite
-        if ( gflags & GEOM_PLACEABLE )
-        {
-            dReal dx[6], dy[6], dz[6];
-
-            // Y-axis
-            if (d->m_fMinHeight != -dInfinity)
-            {
-                dy[0] = ( final_posr->R[ 1] * d->m_fMinHeight );
-                dy[1] = ( final_posr->R[ 5] * d->m_fMinHeight );
-                dy[2] = ( final_posr->R[ 9] * d->m_fMinHeight );
-            }
-            else
-            {
-                // Multiplication is performed to obtain infinity of correct sign
-                dy[0] = ( final_posr->R[ 1] ? final_posr->R[ 1] * -dInfinity : REAL(0.0) );
-                dy[1] = ( final_posr->R[ 5] ? final_posr->R[ 5] * -dInfinity : REAL(0.0) );
-                dy[2] = ( final_posr->R[ 9] ? final_posr->R[ 9] * -dInfinity : REAL(0.0) );
-            }
-
-            if (d->m_fMaxHeight != dInfinity)
-            {
-                dy[3] = ( final_posr->R[ 1] * d->m_fMaxHeight );
-                dy[4] = ( final_posr->R[ 5] * d->m_fMaxHeight );
-                dy[5] = ( final_posr->R[ 9] * d->m_fMaxHeight );
-            }
-            else
-            {
-                dy[3] = ( final_posr->R[ 1] ? final_posr->R[ 1] * dInfinity : REAL(0.0) );
-                dy[4] = ( final_posr->R[ 5] ? final_posr->R[ 5] * dInfinity : REAL(0.0) );
-                dy[5] = ( final_posr->R[ 9] ? final_posr->R[ 9] * dInfinity : REAL(0.0) );
-            }
-
-#ifdef DHEIGHTFIELD_CORNER_ORIGIN
-
-            // X-axis
-            dx[0] = 0;	dx[3] = ( final_posr->R[ 0] * d->m_fWidth );
-            dx[1] = 0;	dx[4] = ( final_posr->R[ 4] * d->m_fWidth );
-            dx[2] = 0;	dx[5] = ( final_posr->R[ 8] * d->m_fWidth );
-
-            // Z-axis
-            dz[0] = 0;	dz[3] = ( final_posr->R[ 2] * d->m_fDepth );
-            dz[1] = 0;	dz[4] = ( final_posr->R[ 6] * d->m_fDepth );
-            dz[2] = 0;	dz[5] = ( final_posr->R[10] * d->m_fDepth );
-
-#else // DHEIGHTFIELD_CORNER_ORIGIN
-
-            // X-axis
-            dx[0] = ( final_posr->R[ 0] * -d->m_fHalfWidth );
-            dx[1] = ( final_posr->R[ 4] * -d->m_fHalfWidth );
-            dx[2] = ( final_posr->R[ 8] * -d->m_fHalfWidth );
-            dx[3] = ( final_posr->R[ 0] * d->m_fHalfWidth );
-            dx[4] = ( final_posr->R[ 4] * d->m_fHalfWidth );
-            dx[5] = ( final_posr->R[ 8] * d->m_fHalfWidth );
-
-            // Z-axis
-            dz[0] = ( final_posr->R[ 2] * -d->m_fHalfDepth );
-            dz[1] = ( final_posr->R[ 6] * -d->m_fHalfDepth );
-            dz[2] = ( final_posr->R[10] * -d->m_fHalfDepth );
-            dz[3] = ( final_posr->R[ 2] * d->m_fHalfDepth );
-            dz[4] = ( final_posr->R[ 6] * d->m_fHalfDepth );
-            dz[5] = ( final_posr->R[10] * d->m_fHalfDepth );
-
-#endif // DHEIGHTFIELD_CORNER_ORIGIN
-
-            // X extents
-            aabb[0] = final_posr->pos[0] +
-                dMIN3( dMIN( dx[0], dx[3] ), dMIN( dy[0], dy[3] ), dMIN( dz[0], dz[3] ) );
-            aabb[1] = final_posr->pos[0] +
-                dMAX3( dMAX( dx[0], dx[3] ), dMAX( dy[0], dy[3] ), dMAX( dz[0], dz[3] ) );
-
-            // Y extents
-            aabb[2] = final_posr->pos[1] +
-                dMIN3( dMIN( dx[1], dx[4] ), dMIN( dy[1], dy[4] ), dMIN( dz[1], dz[4] ) );
-            aabb[3] = final_posr->pos[1] +
-                dMAX3( dMAX( dx[1], dx[4] ), dMAX( dy[1], dy[4] ), dMAX( dz[1], dz[4] ) );
-
-            // Z extents
-            aabb[4] = final_posr->pos[2] +
-                dMIN3( dMIN( dx[2], dx[5] ), dMIN( dy[2], dy[5] ), dMIN( dz[2], dz[5] ) );
-            aabb[5] = final_posr->pos[2] +
-                dMAX3( dMAX( dx[2], dx[5] ), dMAX( dy[2], dy[5] ), dMAX( dz[2], dz[5] ) );
-        }
-        else
-        {
-
-#ifdef DHEIGHTFIELD_CORNER_ORIGIN
-
-            aabb[0] = 0;					aabb[1] = d->m_fWidth;
-            aabb[2] = d->m_fMinHeight;		aabb[3] = d->m_fMaxHeight;
-            aabb[4] = 0;					aabb[5] = d->m_fDepth;
-
-#else // DHEIGHTFIELD_CORNER_ORIGIN
-
-            aabb[0] = -d->m_fHalfWidth;		aabb[1] = +d->m_fHalfWidth;
-            aabb[2] = d->m_fMinHeight;		aabb[3] = d->m_fMaxHeight;
-            aabb[4] = -d->m_fHalfDepth;		aabb[5] = +d->m_fHalfDepth;
-
-#endif // DHEIGHTFIELD_CORNER_ORIGIN
-
-        }
-    }
-    else
-    {
-        // Infinite
-        if ( gflags & GEOM_PLACEABLE )
-        {
-            aabb[0] = -dInfinity;			aabb[1] = +dInfinity;
-            aabb[2] = -dInfinity;			aabb[3] = +dInfinity;
-            aabb[4] = -dInfinity;			aabb[5] = +dInfinity;
-        }
-        else
-        {
-            aabb[0] = -dInfinity;			aabb[1] = +dInfinity;
-            aabb[2] = d->m_fMinHeight;		aabb[3] = d->m_fMaxHeight;
-            aabb[4] = -dInfinity;			aabb[5] = +dInfinity;
-        }
-    }
-
-}
-
-
-// dxMlsfield destructor
-dxMlsfield::~dxMlsfield()
-{	
-	resetRectangularBuffer();
-}
-
-void dxMlsfield::allocateRectangularBuffer(size_t numRect)
-{
-    size_t alignedNumRect = AlignBufferSize(numRect, TEMP_RECTANGULAR_BUFFER_ELEMENT_COUNT_ALIGNMENT);
-    tempRectangularBufferSize = alignedNumRect;
-    tempRectangularBuffer = new MlsFieldRectangular[alignedNumRect];
-}
-void dxMlsfield::resetRectangularBuffer()
-{
-    delete[] tempRectangularBuffer;
-}
-
-
-void dxMlsfield::resetHeightBuffer()
-{
-    delete[] tempHeightInstances;
-    delete[] tempHeightBuffer;
-}
-
-
-void dxMlsfield::allocateHeightBuffer(size_t numX, size_t numZ)
-{
-    size_t alignedNumX = AlignBufferSize(numX, TEMP_HEIGHT_BUFFER_ELEMENT_COUNT_ALIGNMENT_X);
-    size_t alignedNumZ = AlignBufferSize(numZ, TEMP_HEIGHT_BUFFER_ELEMENT_COUNT_ALIGNMENT_Z);
-    tempHeightBufferSizeX = alignedNumX;
-    tempHeightBufferSizeZ = alignedNumZ;
-    tempHeightBuffer = new MlsFieldVertex *[alignedNumX];
-    size_t numCells = alignedNumX * alignedNumZ;
-    tempHeightInstances = new MlsFieldVertex [numCells];
-
-    MlsFieldVertex *ptrHeightMatrix = tempHeightInstances;
-    for (size_t indexX = 0; indexX != alignedNumX; indexX++)
-    {
-        tempHeightBuffer[indexX] = ptrHeightMatrix;
-        ptrHeightMatrix += alignedNumZ;
-    }
-}
 
 dMlsfieldDataID dGeomMlsfieldDataCreate()
 {
@@ -578,6 +390,8 @@ void dGeomMlsfieldDataBuildCallback( dMlsfieldDataID d,
     // default bounds
     d->m_fMinHeight = -dInfinity;
     d->m_fMaxHeight = dInfinity;
+
+    d->BuildPatchCache();
 }
 
 
@@ -614,6 +428,7 @@ void dGeomMlsfieldDataBuildByte( dMlsfieldDataID d,
 
     // Find height bounds
     d->ComputeHeightBounds();
+    d->BuildPatchCache();
 }
 
 
@@ -650,6 +465,7 @@ void dGeomMlsfieldDataBuildShort( dMlsfieldDataID d,
 
     // Find height bounds
     d->ComputeHeightBounds();
+    d->BuildPatchCache();
 }
 
 
@@ -686,6 +502,7 @@ void dGeomMlsfieldDataBuildSingle( dMlsfieldDataID d,
 
     // Find height bounds
     d->ComputeHeightBounds();
+    d->BuildPatchCache();
 }
 
 void dGeomMlsfieldDataBuildDouble( dMlsfieldDataID d,
@@ -721,6 +538,7 @@ void dGeomMlsfieldDataBuildDouble( dMlsfieldDataID d,
 
     // Find height bounds
     d->ComputeHeightBounds();
+    d->BuildPatchCache();
 }
 
 
@@ -734,6 +552,13 @@ void dGeomMlsfieldDataSetBounds( dMlsfieldDataID d, dReal minHeight, dReal maxHe
 }
 
 
+void dGeomMlsfieldDataUpdateCache( dMlsfieldDataID d )
+{
+    dUASSERT(d, "argument not Mlsfield data");
+    d->BuildPatchCache();
+}
+
+
 void dGeomMlsfieldDataDestroy( dMlsfieldDataID d )
 {
     dUASSERT(d, "argument not Mlsfield data");
@@ -743,425 +568,277 @@ void dGeomMlsfieldDataDestroy( dMlsfieldDataID d )
 
 //////// Mlsfield geom interface ////////////////////////////////////////////////////
 
+static int dMlsfieldClass = -1;
 
-dGeomID dCreateMlsfield( dSpaceID space, dMlsfieldDataID data, int bPlaceable )
+static const dReal *mlsfieldIdentityPos()
 {
-    return new dxMlsfield( space, data, bPlaceable );
+    static const dVector3 pos = { 0, 0, 0, 0 };
+    return pos;
 }
 
-
-void dGeomMlsfieldSetMlsfieldData( dGeomID g, dMlsfieldDataID d )
+static const dReal *mlsfieldIdentityRot()
 {
-    dxMlsfield* geom = (dxMlsfield*) g;
-    geom->m_p_data = d;
+    static const dMatrix3 R = { 1, 0, 0, 0,
+                                0, 1, 0, 0,
+                                0, 0, 1, 0 };
+    return R;
 }
 
-
-dMlsfieldDataID dGeomMlsfieldGetMlsfieldData( dGeomID g )
+// pose of the field, the origin if the geom is not placeable
+static void getMlsfieldPose( dGeomID g, const dxMlsfield *terrain,
+                             const dReal **pos, const dReal **R )
 {
-    dxMlsfield* geom = (dxMlsfield*) g;
-    return geom->m_p_data;
+    if ( terrain->m_bPlaceable )
+    {
+        *pos = dGeomGetPosition( g );
+        *R = dGeomGetRotation( g );
+    }
+    else
+    {
+        *pos = mlsfieldIdentityPos();
+        *R = mlsfieldIdentityRot();
+    }
 }
 
-//////// dxMlsfield /////////////////////////////////////////////////////////////////
-
-
-// Typedef for generic 'get point depth' function
-typedef dReal dGetDepthFn( dGeomID g, dReal x, dReal y, dReal z );
-
-
-#define DMESS(A)	\
-    dMessage(0,"Contact Plane (%d %d %d) %.5e %.5e (%.5e %.5e %.5e)(%.5e %.5e %.5e)).",	\
-    x,z,(A),	\
-    pContact->depth,	\
-    dGeomSphereGetRadius(o2),		\
-    pContact->pos[0],	\
-    pContact->pos[1],	\
-    pContact->pos[2],	\
-    pContact->normal[0],	\
-    pContact->normal[1],	\
-    pContact->normal[2]);
-
-//static inline bool DescendingRectangularSort(const MlsFieldRectangular * const A, const MlsFieldRectangular * const B)
-//{
-    //return ((A->maxAAAB - B->maxAAAB) > dEpsilon);
-//}
-
-
+// r*v that stays 0 for r == 0 also if v is infinite
+static inline dReal scaleExtent( dReal r, dReal v )
+{
+    return ( r == 0 ) ? REAL(0.0) : r * v;
+}
 
-int dxMlsfield::dCollideMlsfieldZone( const int minX, const int maxX, const int minZ, const int maxZ, 
-                                           dxGeom* o2, const int numMaxContactsPossible,
-                                           int flags, dContactGeom* contact, 
-                                           int skip )
+// all classes that ODE can collide with a box
+static dColliderFn *getMlsfieldCollider( int num )
 {
-    dContactGeom *pContact = 0;
-    int  x, z;
-    // check if not above or inside terrain first
-    // while filling a Mlsmap partial temporary buffer
-    const unsigned int numX = (maxX - minX) + 1;
-    const unsigned int numZ = (maxZ - minZ) + 1;
-    const dReal minO2Height = o2->aabb[2];
-    const dReal maxO2Height = o2->aabb[3];
-    unsigned int x_local, z_local;
-    dReal maxY = - dInfinity;
-    dReal minY = dInfinity;
-    
-    int numTerrainContacts = 0;
-    // localize and const for faster access
-    
-    const dReal cfSampleWidth = m_p_data->m_fSampleWidth;
-    const dReal cfSampleDepth = m_p_data->m_fSampleDepth;
+    switch ( num )
     {
-        if (tempHeightBufferSizeX < numX || tempHeightBufferSizeZ < numZ)
-        {
-            resetHeightBuffer();
-            allocateHeightBuffer(numX, numZ);
-        }
-
-        dReal Xpos, Ypos;
-
-        for ( x = minX, x_local = 0; x_local < numX; x++, x_local++)
-        {
-            Xpos = x * cfSampleWidth; // Always calculate pos via multiplication to avoid computational error accumulation during multiple additions
-
-            const dReal c_Xpos = Xpos;
-            MlsFieldVertex *MlsFieldRow = tempHeightBuffer[x_local];
-            for ( z = minZ, z_local = 0; z_local < numZ; z++, z_local++)       //[x_local][z_local]...YH
-            {
-                Ypos = z * cfSampleDepth; // Always calculate pos via multiplication to avoid computational error accumulation during multiple additions
-
-                const dReal h = m_p_data->GetHeight(x, z);
-                MlsFieldRow[z_local].vertex[0] = c_Xpos;
-                MlsFieldRow[z_local].vertex[1] = h;
-                MlsFieldRow[z_local].vertex[2] = Ypos;
+    case dSphereClass:
+    case dBoxClass:
+    case dCapsuleClass:
+    case dCylinderClass:
+    case dConvexClass:
+        return &dCollideMlsfield;
+    default:
+        return NULL;
+    }
+}
 
-                maxY = dMAX(maxY, h);
-                minY = dMIN(minY, h);
-            }
-        }
+// compute axis aligned bounding box
+static void computeMlsfieldAABB( dGeomID g, dReal aabb[6] )
+{
+    const dxMlsfield *terrain = (const dxMlsfield*)dGeomGetClassData( g );
+    const dxMlsfieldData *d = terrain->m_p_data;
 
+    dReal lower[3], upper[3];
+    if ( d->m_bWrapMode == 0 )
+    {
+        lower[0] = -d->m_fHalfWidth;    upper[0] = d->m_fHalfWidth;
+        lower[2] = -d->m_fHalfDepth;    upper[2] = d->m_fHalfDepth;
+    }
+    else
+    {
+        lower[0] = -dInfinity;          upper[0] = dInfinity;
+        lower[2] = -dInfinity;          upper[2] = dInfinity;
+    }
+    lower[1] = d->m_fMinHeight;         upper[1] = d->m_fMaxHeight;
 
-        if (minO2Height - maxY > -dEpsilon )    //TODO: make clear!!
+    const dReal *pos, *R;
+    getMlsfieldPose( g, terrain, &pos, &R );
+    for ( int i = 0; i < 3; i++ )
+    {
+        aabb[i*2] = pos[i];
+        aabb[i*2+1] = pos[i];
+        for ( int j = 0; j < 3; j++ )
         {
-            //totally above Mlsfield
-            return 0;
+            const dReal a = scaleExtent( R[i*4+j], lower[j] );
+            const dReal b = scaleExtent( R[i*4+j], upper[j] );
+            aabb[i*2] += dMIN( a, b );
+            aabb[i*2+1] += dMAX( a, b );
         }
-        
-        if (minY - maxO2Height > -dEpsilon )
-        {
-            // totally under Mlsfield
-            pContact = CONTACT(contact, 0);			//set pointer of dContactGeom....YH
-
-            pContact->pos[0] = o2->final_posr->pos[0];
-            pContact->pos[1] = minY;
-            pContact->pos[2] = o2->final_posr->pos[2];
-
-            pContact->normal[0] = 0;
-            pContact->normal[1] = -1;
-            pContact->normal[2] = 0;
-
-            pContact->depth =  minY - maxO2Height;
-
-            pContact->side1 = -1;
-            pContact->side2 = -1;
-printf(".totally under Mlsfield...\n");
-            return 1;
-//			return numTerrainContacts++;
-        }
-        
     }
+}
 
+static void destroyMlsfield( dGeomID g )
+{
+    dxMlsfield *terrain = (dxMlsfield*)dGeomGetClassData( g );
+    dGeomDestroy( terrain->m_pPatchBox );
+}
 
-
-
-    dContactGeom *BoxContact = m_p_data->m_contacts;  
-
-    const unsigned int numRectMax = (maxX - minX) * (maxZ - minZ);
-    if (tempRectangularBufferSize < numRectMax)
+dGeomID dCreateMlsfield( dSpaceID space, dMlsfieldDataID data, int bPlaceable )
+{
+    if ( dMlsfieldClass == -1 )
     {
-        resetRectangularBuffer();
-        allocateRectangularBuffer(numRectMax);
+        dGeomClass c;
+        c.bytes = sizeof( dxMlsfield );
+        c.collider = &getMlsfieldCollider;
+        c.aabb = &computeMlsfieldAABB;
+        c.aabb_test = NULL;
+        c.dtor = &destroyMlsfield;
+        dMlsfieldClass = dCreateGeomClass( &c );
     }
 
+    dGeomID g = dCreateGeom( dMlsfieldClass );
+    dxMlsfield *terrain = (dxMlsfield*)dGeomGetClassData( g );
+    terrain->m_p_data = data;
+    terrain->m_pPatchBox = dCreateBox( 0, 1, 1, 1 );
+    terrain->m_bPlaceable = bPlaceable;
+    if ( space ) dSpaceAdd( space, g );
+    return g;
+}
 
-    unsigned int numRect = 0;
-    MlsFieldVertex *A, *B, *C, *D;
-    /*    (y is up)
-         A--------B-...x
-         |        |
-         |        |
-         |        |
-         C--------D   
-         .
-         .
-         .
-         z
-    */  
-
-    // keep only rectangular that does intersect geom
-    const unsigned int maxX_local = maxX - minX;
-    const unsigned int maxZ_local = maxZ - minZ;
-
-    for ( x_local = 0; x_local < maxX_local; x_local++)
-    {
-        MlsFieldVertex *MlsFieldRow      = tempHeightBuffer[x_local];
-        MlsFieldVertex *MlsFieldNextRow  = tempHeightBuffer[x_local + 1];
-
-        // First A
-        C = &MlsFieldRow    [0];
-        // First B
-        D = &MlsFieldNextRow[0];
-
-        for ( z_local = 0; z_local < maxZ_local; z_local++)
-        {
-            A = C;
-            B = D;
-
-            C = &MlsFieldRow    [z_local + 1];
-            D = &MlsFieldNextRow[z_local + 1];
-
-            const dReal AHeight = A->vertex[1];
-            const dReal BHeight = B->vertex[1];
-            const dReal CHeight = C->vertex[1];
-            const dReal DHeight = D->vertex[1];
 
-            const bool isACollide = AHeight > minO2Height;
-            const bool isBCollide = BHeight > minO2Height;
-            const bool isCCollide = CHeight > minO2Height;
-            const bool isDCollide = DHeight > minO2Height;
+int dGetMlsfieldClass( void )
+{
+    return dMlsfieldClass;
+}
 
-            if (isACollide || isBCollide || isCCollide || isDCollide)
-            {
-                MlsFieldRectangular * const CurrRectUp = &tempRectangularBuffer[numRect++];
 
-              // changing point order here implies to change it in isOnHeightField
-                CurrRectUp->vertices[0] = A;
-                CurrRectUp->vertices[1] = B;
-                CurrRectUp->vertices[2] = C;
-                CurrRectUp->vertices[3] = D;
+void dGeomMlsfieldSetMlsfieldData( dGeomID g, dMlsfieldDataID d )
+{
+    dUASSERT( dGeomGetClass( g ) == dMlsfieldClass, "argument not a Mlsfield" );
+    dxMlsfield *terrain = (dxMlsfield*)dGeomGetClassData( g );
+    terrain->m_p_data = d;
+}
 
-            }
-        }
-    }
-    
-    //make dxBox[numRect] which have collided     
-    dIASSERT (numRect != 0);
-    int maxBoxNum = 4;
-    double boxlength = 0.5;
-    
-	dxBox* colliding_box[maxBoxNum];
-	for(int i=0; i<4; i++) colliding_box[i] = new dxBox (0,1,1,1);   //TODE space pointer has to be added
 
-    for (unsigned int k = 0; k < numRect; k++)
-    {
-		MlsFieldRectangular * const colRect = &tempRectangularBuffer[k];
-
-		for(unsigned int i=0;i<4;i++){   //we need to build 4 boxs per a rect
-		   //set positions and size of Boxs A,B,C,D from collision
-		   dVector3Copy(colRect->vertices[i]->vertex, colliding_box[i]->final_posr->pos); 
-		   colliding_box[i]->side[0] = colRect->vertices[1]->vertex[0]-colRect->vertices[0]->vertex[0];				   
-		   colliding_box[i]->side[1] = boxlength;	
-		   colliding_box[i]->side[2] = colRect->vertices[2]->vertex[2]-colRect->vertices[0]->vertex[2];	
-		   colliding_box[i]->final_posr->pos[0] -= (colliding_box[i]->side[0]/2);   
-		   colliding_box[i]->final_posr->pos[1] = colliding_box[i]->final_posr->pos[1] - boxlength/2;  	
-		   colliding_box[i]->final_posr->pos[2] -= (colliding_box[i]->side[2]/2); 			   		   	   
-		   int collided = dCollideSphereBox (o2, colliding_box[i], flags, BoxContact, skip);
-
-		   if(collided && numTerrainContacts < 4) {	   
-  		       pContact = CONTACT(contact, numTerrainContacts*skip);			   
-		       dVector3Copy(BoxContact->pos, pContact->pos);
-               //create contact using Plane Normal
-               dOPESIGN(pContact->normal, =, -, BoxContact->normal);	       
-		       pContact->depth = BoxContact->depth;	
-       
- 	           numTerrainContacts++;	
-		   }
-		}
-
-	}
-	for(int i=0; i<maxBoxNum; i++) delete colliding_box[i];   
-	return numTerrainContacts;  
+dMlsfieldDataID dGeomMlsfieldGetMlsfieldData( dGeomID g )
+{
+    dUASSERT( dGeomGetClass( g ) == dMlsfieldClass, "argument not a Mlsfield" );
+    const dxMlsfield *terrain = (const dxMlsfield*)dGeomGetClassData( g );
+    return terrain->m_p_data;
 }
 
-int dCollideMlsfield( dxGeom *o1, dxGeom *o2, int flags, dContactGeom* contact, int skip )
+//////// dxMlsfield /////////////////////////////////////////////////////////////////
+
+/**
+ * Collides o2 with the patches below its bounding box. The patch box is
+ * placed in world space, thus the contacts of dCollide are used as they
+ * are and only the geoms are set to the field and o2.
+ */
+int dCollideMlsfield( dGeomID o1, dGeomID o2, int flags, dContactGeom* contact, int skip )
 {
     dIASSERT( skip >= (int)sizeof(dContactGeom) );
-    //dIASSERT( o1->type == dMlsfieldClass );
-    dIASSERT((flags & NUMC_MASK) >= 1);
-    
-    int i;
-
-    // if ((flags & NUMC_MASK) == 0) -- An assertion check is made on entry
-    //	{ flags = (flags & ~NUMC_MASK) | 1; dIASSERT((1 & ~NUMC_MASK) == 0); }
-
-    int numMaxTerrainContacts = (flags & NUMC_MASK);
+    dIASSERT( dGeomGetClass( o1 ) == dMlsfieldClass );
 
- //int numMaxTerrainContacts = 30;
+    const int numMaxContacts = flags & NUMC_MASK;
+    if ( numMaxContacts < 1 ) return 0;
 
-    dxMlsfield *terrain = (dxMlsfield*) o1;
+    const dxMlsfield *terrain = (const dxMlsfield*)dGeomGetClassData( o1 );
+    const dxMlsfieldData *d = terrain->m_p_data;
+    dIASSERT( d->m_pPatchTop );
 
-    dVector3 posbak;
-    dMatrix3 Rbak;
-    dReal aabbbak[6];
-    int gflagsbak;
-    dVector3 pos0,pos1;
-    dMatrix3 R1;
-
-    int numTerrainContacts = 0;
-    int numTerrainOrigContacts = 0;
-
-    //@@ Should find a way to set reComputeAABB to false in default case
-    // aka DHEIGHTFIELD_CORNER_ORIGIN not defined and terrain not PLACEABLE
-    // so that we can free some memory and speed up things a bit
-    // while saving some precision loss 
-#ifndef DHEIGHTFIELD_CORNER_ORIGIN
-    const bool reComputeAABB = true;
-#else
-    const bool reComputeAABB = ( terrain->gflags & GEOM_PLACEABLE ) ? true : false;
-#endif //DHEIGHTFIELD_CORNER_ORIGIN
+    const dReal *pos, *R;
+    getMlsfieldPose( o1, terrain, &pos, &R );
 
     //
-    // Transform O2 into Heightfield Space
+    // Bounds of o2 in field space, the corner of the field is the origin
     //
-    
-    if (reComputeAABB)
+    dReal aabb[6];
+    dGeomGetAABB( o2, aabb );
+    dVector3 center, extent, local;
+    for ( int i = 0; i < 3; i++ )
     {
-        // Backup original o2 position, rotation and AABB.
-        dVector3Copy( o2->final_posr->pos, posbak );
-        dMatrix3Copy( o2->final_posr->R, Rbak );
-        memcpy( aabbbak, o2->aabb, sizeof( dReal ) * 6 );
-        gflagsbak = o2->gflags;
+        center[i] = ( aabb[i*2] + aabb[i*2+1] ) * REAL(0.5) - pos[i];
+        extent[i] = ( aabb[i*2+1] - aabb[i*2] ) * REAL(0.5);
     }
-
-    if ( terrain->gflags & GEOM_PLACEABLE )
+    dReal lower[3], upper[3];
+    for ( int j = 0; j < 3; j++ )
     {
-        // Transform o2 into Mlsfield space.
-        dSubtractVectors3( pos0, o2->final_posr->pos, terrain->final_posr->pos );
-        dMultiply1_331( pos1, terrain->final_posr->R, pos0 );
-        dMultiply1_333( R1, terrain->final_posr->R, o2->final_posr->R );
-
-        // Update o2 with transformed position and rotation.
-        dVector3Copy( pos1, o2->final_posr->pos );
-        dMatrix3Copy( R1, o2->final_posr->R );
+        // R^T * center and the extent of the rotated box
+        local[j] = R[j] * center[0] + R[4+j] * center[1] + R[8+j] * center[2];
+        const dReal e = dFabs( R[j] ) * extent[0] + dFabs( R[4+j] ) * extent[1] +
+            dFabs( R[8+j] ) * extent[2];
+        lower[j] = local[j] - e;
+        upper[j] = local[j] + e;
     }
+    lower[0] += d->m_fHalfWidth;    upper[0] += d->m_fHalfWidth;
+    lower[2] += d->m_fHalfDepth;    upper[2] += d->m_fHalfDepth;
 
-#ifndef DHEIGHTFIELD_CORNER_ORIGIN
-    o2->final_posr->pos[ 0 ] += terrain->m_p_data->m_fHalfWidth;
-    o2->final_posr->pos[ 2 ] += terrain->m_p_data->m_fHalfDepth;
-#endif // DHEIGHTFIELD_CORNER_ORIGIN
-
-
-    // Rebuild AABB for O2
-    if (reComputeAABB)
-        o2->computeAABB();
+    if ( lower[1] >= d->m_fMaxHeight || upper[1] <= d->m_fMinHeight ) return 0;
 
     //
-    // Collide
+    // Patches that overlap the bounds, patch x covers
+    // [ (x - 0.5) * sampleWidth, (x + 0.5) * sampleWidth ]
     //
-
-    //check if inside boundaries
-    // using O2 aabb
-    //  aabb[6] is (minx, maxx, miny, maxy, minz, maxz) 
-    const bool wrapped = terrain->m_p_data->m_bWrapMode != 0;
-
-    if ( !wrapped )
-    {
-        if (    o2->aabb[0] > terrain->m_p_data->m_fWidth //MinX
-            ||  o2->aabb[4] > terrain->m_p_data->m_fDepth)//MinZ
-            goto dCollideMlsfieldExit;
-
-        if (    o2->aabb[1] < 0 //MaxX
-            ||  o2->aabb[5] < 0)//MaxZ
-            goto dCollideMlsfieldExit;
-    }
-    { // To narrow scope of following variables
-        const dReal fInvSampleWidth = terrain->m_p_data->m_fInvSampleWidth;
-        int nMinX = (int)dFloor(dNextAfter(o2->aabb[0] * fInvSampleWidth, -dInfinity));
-        int nMaxX = (int)dCeil(dNextAfter(o2->aabb[1] * fInvSampleWidth, dInfinity));
-        const dReal fInvSampleDepth = terrain->m_p_data->m_fInvSampleDepth;
-        int nMinZ = (int)dFloor(dNextAfter(o2->aabb[4] * fInvSampleDepth, -dInfinity));
-        int nMaxZ = (int)dCeil(dNextAfter(o2->aabb[5] * fInvSampleDepth, dInfinity));
-
-        if ( !wrapped )
-        {
-            nMinX = dMAX( nMinX, 0 );
-            nMaxX = dMIN( nMaxX, terrain->m_p_data->m_nWidthSamples - 1);  //select overlabing area between o1 and o2
-            nMinZ = dMAX( nMinZ, 0 );
-            nMaxZ = dMIN( nMaxZ, terrain->m_p_data->m_nDepthSamples - 1);
-
-            dIASSERT ((nMinX < nMaxX) && (nMinZ < nMaxZ));
-        }
-
-        numTerrainOrigContacts = numTerrainContacts;
-        numTerrainContacts += terrain->dCollideMlsfieldZone(
-            nMinX,nMaxX,nMinZ,nMaxZ,o2,numMaxTerrainContacts - numTerrainContacts,
-            flags,CONTACT(contact,numTerrainContacts*skip),skip	);
-      
-        dIASSERT( numTerrainContacts <= numMaxTerrainContacts );
-    }
-    
-
-    dContactGeom *pContact;
-    for ( i = numTerrainOrigContacts; i != numTerrainContacts; ++i )
+    int nMinX = (int)dCeil( lower[0] * d->m_fInvSampleWidth - REAL(0.5) );
+    int nMaxX = (int)dFloor( upper[0] * d->m_fInvSampleWidth + REAL(0.5) );
+    int nMinZ = (int)dCeil( lower[2] * d->m_fInvSampleDepth - REAL(0.5) );
+    int nMaxZ = (int)dFloor( upper[2] * d->m_fInvSampleDepth + REAL(0.5) );
+    if ( d->m_bWrapMode == 0 )
     {
-        pContact = CONTACT(contact,i*skip);
-        pContact->g1 = o1;
-        pContact->g2 = o2;
-         pContact->side1 = -1; //-- Oleh_Derevenko: sides must not be erased here as they are set by respective colliders during ray/plane tests 
-         pContact->side2 = -1;
+        nMinX = dMAX( nMinX, 0 );
+        nMaxX = dMIN( nMaxX, d->m_nWidthSamples - 1 );
+        nMinZ = dMAX( nMinZ, 0 );
+        nMaxZ = dMIN( nMaxZ, d->m_nDepthSamples - 1 );
     }
+    if ( nMinX > nMaxX || nMinZ > nMaxZ ) return 0;
+
+    // all patches have the same size and orientation, only the position changes
+    const dReal cfSampleWidth = d->m_fSampleWidth;
+    const dReal cfSampleDepth = d->m_fSampleDepth;
+    const dReal cfThickness = d->m_fPatchThickness;
+    dGeomID box = terrain->m_pPatchBox;
+    dGeomBoxSetLengths( box, cfSampleWidth, cfThickness, cfSampleDepth );
+    dGeomSetRotation( box, R );
+
+    const int numPatchContacts = dMIN( numMaxContacts, MLSFIELDMAXCONTACTPERCELL );
+    const int patchFlags = ( flags & ~NUMC_MASK ) | numPatchContacts;
+    const bool unimportant = ( flags & CONTACTS_UNIMPORTANT ) != 0;
+    dContactGeom patchContacts[ MLSFIELDMAXCONTACTPERCELL ];
+    int numTerrainContacts = 0;
 
-  
-    //------------------------------------------------------------------------------
-
-dCollideMlsfieldExit:
-
-    if (reComputeAABB)
+    for ( int z = nMinZ; z <= nMaxZ; z++ )
     {
-        // Restore o2 position, rotation and AABB
-        dVector3Copy( posbak, o2->final_posr->pos );
-        dMatrix3Copy( Rbak, o2->final_posr->R );
-        memcpy( o2->aabb, aabbbak, sizeof(dReal)*6 );
-        o2->gflags = gflagsbak;
-
-        //
-        // Transform Contacts to World Space
-        //
-        if ( terrain->gflags & GEOM_PLACEABLE )
+        const dReal Zpos = z * cfSampleDepth - d->m_fHalfDepth;
+        for ( int x = nMinX; x <= nMaxX; x++ )
         {
-            for ( i = 0; i < numTerrainContacts; ++i )
-            {
-                pContact = CONTACT(contact,i*skip);
-                dCopyVector3( pos0, pContact->pos );
+            const dReal top = d->m_pPatchTop[ d->GetPatchIndex( x, z ) ];
 
-#ifndef DHEIGHTFIELD_CORNER_ORIGIN
-                pos0[ 0 ] -= terrain->m_p_data->m_fHalfWidth;
-                pos0[ 2 ] -= terrain->m_p_data->m_fHalfDepth;
-#endif // !DHEIGHTFIELD_CORNER_ORIGIN
+            // patch height against the geom bounds
+            if ( top <= lower[1] || top - cfThickness >= upper[1] ) continue;
 
-                dMultiply0_331( pContact->pos, terrain->final_posr->R, pos0 );
+            const dReal Xpos = x * cfSampleWidth - d->m_fHalfWidth;
+            const dReal Ypos = top - cfThickness * REAL(0.5);
+            dGeomSetPosition( box,
+                pos[0] + R[0] * Xpos + R[1] * Ypos + R[ 2] * Zpos,
+                pos[1] + R[4] * Xpos + R[5] * Ypos + R[ 6] * Zpos,
+                pos[2] + R[8] * Xpos + R[9] * Ypos + R[10] * Zpos );
 
-                dAddVectors3( pContact->pos, pContact->pos, terrain->final_posr->pos );
-                dCopyVector3( pos0, pContact->normal );
+            const int collided = dCollide( box, o2, patchFlags, patchContacts,
+                                           sizeof( dContactGeom ) );
 
-                dMultiply0_331( pContact->normal, terrain->final_posr->R, pos0 );
+            for ( int i = 0; i < collided; i++ )
+            {
+                const dContactGeom * const c = patchContacts + i;
+                dContactGeom *pContact;
+                if ( numTerrainContacts < numMaxContacts )
+                {
+                    pContact = CONTACT( contact, numTerrainContacts*skip );
+                    numTerrainContacts++;
+                }
+                else
+                {
+                    // keep the deepest contacts if the buffer is full
+                    pContact = contact;
+                    for ( int k = 1; k < numTerrainContacts; k++ )
+                    {
+                        dContactGeom *other = CONTACT( contact, k*skip );
+                        if ( other->depth < pContact->depth ) pContact = other;
+                    }
+                    if ( pContact->depth >= c->depth ) continue;
+                }
+                *pContact = *c;
+                pContact->g1 = o1;
+                pContact->g2 = o2;
+                pContact->side1 = -1;
+                pContact->side2 = -1;
             }
-        }
-#ifndef DHEIGHTFIELD_CORNER_ORIGIN
-        else
-        {
-            for ( i = 0; i < numTerrainContacts; ++i )
+
+            if ( unimportant && numTerrainContacts == numMaxContacts )
             {
-                pContact = CONTACT(contact,i*skip);
-                pContact->pos[ 0 ] -= terrain->m_p_data->m_fHalfWidth;
-                pContact->pos[ 2 ] -= terrain->m_p_data->m_fHalfDepth;
+                return numTerrainContacts;
             }
         }
-#endif // !DHEIGHTFIELD_CORNER_ORIGIN
     }
-    // Return contact count.
+
     return numTerrainContacts;
 }
-
-
-
@@ -1,9 +1,13 @@
 /** dMlsfield Colliders
  * \file mlsfield.h
  * \author Yong-Ho Yoo
- * \brief mlsfield is based on the heightfield grid structure. 
- *        Heightfield triangles have been replaced by rectangulars and boxs. 
+ * \brief mlsfield is based on the heightfield grid structure.
+ *        Heightfield triangles have been replaced by rectangulars and boxs.
  *
+ *        The mlsfield is a user geom class and only uses the public ODE
+ *        API. Every sample is one box patch of cell size whose top is the
+ *        sample height. Spheres, boxes, capsules, cylinders and convex
+ *        geoms are collided with the patches below their bounding box.
  */
 
 #ifndef _DMLSFIELD_H_
@@ -11,12 +15,11 @@
 
 //------------------------------------------------------------------------------
 
-#include <ode/common.h>
-//#include "collision_kernel.h"
-#include <mars/sim/collision_kernel.h>
+#include <ode/ode.h>
 
 
-#define MLSFIELDMAXCONTACTPERCELL 4   // maximum contacts per object
+#define MLSFIELDMAXCONTACTPERCELL 4   // maximum contacts per object and patch
+#define MLSFIELDPATCHTHICKNESS 0.5    // patch height if no thickness is given
 
 
 struct dxMlsfieldData;
@@ -24,9 +27,17 @@ typedef struct dxMlsfieldData* dMlsfieldDataID;
 
 typedef dReal dMlsfieldGetHeight( void* p_user_data, int x, int z );
 
+/**
+ * Creates a mlsfield geom. The height is given along the local y axis.
+ * User geoms are always placeable in ODE, if \a bPlaceable is 0 the
+ * pose of the geom is ignored and the field stays at the origin.
+ */
 ODE_API dGeomID dCreateMlsfield( dSpaceID space,
 					dMlsfieldDataID data, int bPlaceable );
 
+/** \return the geom class of the mlsfield, -1 before the first geom */
+ODE_API int dGetMlsfieldClass( void );
+
 ODE_API dMlsfieldDataID dGeomMlsfieldDataCreate(void);
 
 ODE_API void dGeomMlsfieldDataDestroy( dMlsfieldDataID d );
@@ -59,10 +70,16 @@ ODE_API void dGeomMlsfieldDataBuildDouble( dMlsfieldDataID d,
 ODE_API void dGeomMlsfieldDataSetBounds( dMlsfieldDataID d,
 				dReal minHeight, dReal maxHeight );
 
-ODE_API dMlsfieldDataID dGeomMlsfieldGetMlsfieldData( dGeomID g );
+/**
+ * Reads all sample heights into the patch cache again. Needed if the
+ * referenced height data or the values of the callback changed.
+ */
+ODE_API void dGeomMlsfieldDataUpdateCache( dMlsfieldDataID d );
 
+ODE_API void dGeomMlsfieldSetMlsfieldData( dGeomID g, dMlsfieldDataID d );
+
+ODE_API dMlsfieldDataID dGeomMlsfieldGetMlsfieldData( dGeomID g );
 
-class MlsFieldVertex;
 
 //
 // dxMlsfieldData
@@ -93,15 +110,16 @@ struct dxMlsfieldData
     int	m_nDepthSamples;       // Vertex count on Z axis edge (number of samples)
     int m_bCopyHeightData;     // Do we own the sample data?
     int	m_bWrapMode;           // Heightfield wrapping mode (0=finite, 1=infinite)
-    int m_nGetHeightMode;      // GetHeight mode ( 0=callback, 1=byte, 2=short, 3=float )
+    int m_nGetHeightMode;      // GetHeight mode ( 0=callback, 1=byte, 2=short, 3=float, 4=double )
 
     const void* m_pHeightData; // Sample data array
     void* m_pUserData;         // Callback user data
 
-    dContactGeom            m_contacts[MLSFIELDMAXCONTACTPERCELL];
-
     dMlsfieldGetHeight* m_pGetHeightCallback;		// Callback pointer.
 
+    dReal* m_pPatchTop;        // Scaled and offset height of every sample
+    dReal m_fPatchThickness;   // Height of the patch boxes
+
     dxMlsfieldData();
     ~dxMlsfieldData();
 
@@ -112,73 +130,50 @@ struct dxMlsfieldData
 
     void ComputeHeightBounds();
 
+    void BuildPatchCache();
+    void ResetPatchCache();
+
     dReal GetHeight(int x, int z);
     dReal GetHeight(dReal x, dReal z);
 
-};
-
-class MlsFieldVertex
-{
-public:
-    MlsFieldVertex(){};
-
-    dVector3 vertex;
-};
-
-class MlsFieldRectangular
-{
-public:
-    MlsFieldRectangular(){};
+    // index of the sample in the patch cache, clamped or wrapped
+    inline int GetPatchIndex(int x, int z) const
+    {
+        if ( m_bWrapMode == 0 )
+        {
+            if ( x < 0 ) x = 0;
+            if ( z < 0 ) z = 0;
+            if ( x > m_nWidthSamples - 1 ) x = m_nWidthSamples - 1;
+            if ( z > m_nDepthSamples - 1 ) z = m_nDepthSamples - 1;
+        }
+        else
+        {
+            x %= m_nWidthSamples - 1;
+            z %= m_nDepthSamples - 1;
+            if ( x < 0 ) x += m_nWidthSamples - 1;
+            if ( z < 0 ) z += m_nDepthSamples - 1;
+        }
+        return x + z * m_nWidthSamples;
+    }
 
-    MlsFieldVertex   *vertices[4];
 };
 
 //
 // dxMlsfield
 //
-// Mlsfield geom structure
+// Class data of the mlsfield geoms
 //
 
-int dCollideMlsfield( dxGeom *o1, dxGeom *o2, int flags, dContactGeom* contact, int skip );
-
-struct dxMlsfield : public dxGeom
+struct dxMlsfield
 {
-
     dxMlsfieldData* m_p_data;
-    
-    int dMlsfieldClass;
-
-    dxMlsfield( dSpaceID space, dMlsfieldDataID data, int bPlaceable );
-    ~dxMlsfield();
-
-    void computeAABB();
-
-    int dCollideMlsfieldZone( const int minX, const int maxX, const int minZ, const int maxZ,  
-        dxGeom *o2, const int numMaxContacts,
-        int flags, dContactGeom *contact, int skip );
-    enum
-    {
-        TEMP_HEIGHT_BUFFER_ELEMENT_COUNT_ALIGNMENT_X = 4,
-        TEMP_HEIGHT_BUFFER_ELEMENT_COUNT_ALIGNMENT_Z = 4,
-        TEMP_RECTANGULAR_BUFFER_ELEMENT_COUNT_ALIGNMENT = 1 
-    };
-
-    static inline size_t AlignBufferSize(size_t value, size_t alignment) { dIASSERT((alignment & (alignment - 1)) == 0); return (value + (alignment - 1)) & ~(alignment - 1); }
-
-    void  allocateRectangularBuffer(size_t numRect);   
-    void  resetRectangularBuffer();    					
-    void  allocateHeightBuffer(size_t numX, size_t numZ);
-    void  resetHeightBuffer();
-    MlsFieldRectangular *tempRectangularBuffer;       
-    size_t				tempRectangularBufferSize; 
-
-    MlsFieldVertex   **tempHeightBuffer;
-    MlsFieldVertex   *tempHeightInstances;
-    size_t              tempHeightBufferSizeX;
-    size_t              tempHeightBufferSizeZ;
-
+    // one box that is moved to every patch that is tested
+    dGeomID m_pPatchBox;
+    int m_bPlaceable;
 };
 
+int dCollideMlsfield( dGeomID o1, dGeomID o2, int flags, dContactGeom* contact, int skip );
+
 
 //------------------------------------------------------------------------------
 #endif //_DMLSFIELD_H_
@@ -78,8 +78,11 @@ namespace mars {
 
       for(iter = motors.begin(); iter != motors.end(); iter++)
         sController.motors.push_back((*iter)->getIndex());
-      for(jter = sensors.begin(); jter != sensors.end(); jter++)
+      for(jter = sensors.begin(); jter != sensors.end(); jter++) {
         sController.sensors.push_back((*jter)->getID());
+        // keeps the demand driven sensors updated
+        control->sensors->addSensorConsumer((*jter)->getID());
+      }
       for(lter = sNodes.begin(); lter != sNodes.end(); lter++)
         sController.sNodes.push_back((*lter)->index);
       sController.dylib_path = "";
@@ -132,6 +135,11 @@ namespace mars {
       connected = false;
       while(!isFinished()) 
         msleep(10);
+      std::vector<unsigned long>::iterator iter;
+      for(iter = sController.sensors.begin();
+          iter != sController.sensors.end(); ++iter) {
+        control->sensors->removeSensorConsumer(*iter);
+      }
     }
     
     void Controller::setID(unsigned long id) {
@@ -157,12 +165,10 @@ namespace mars {
       char data[PACKAGE_SIZE];
       char *p = data;
       double value;
-      double t_sensors[255];
-      double *pt_sensors = t_sensors;
+      double t_sensors[maxSensorValues];
       double t_motors[100];
       double *pt_motors = t_motors;
-      int flags = 0, count_val, i, command;
-      sReal *sens_val;
+      int flags = 0, i, command;
       char *other_stuff = 0;
       char *pt_stuff;
       unsigned long command_id = 0;
@@ -173,11 +179,15 @@ namespace mars {
       if ((count_ms += time_ms) >= sController.rate) {
         count_ms -= sController.rate;
         if (dylibController) {
-          for (i=0; i<100; i++) t_sensors[i] = t_motors[i] = 0;
+          for (i=0; i<100; i++) t_motors[i] = 0;
+          // the buffer keeps its capacity, thus reading the sensors does
+          // not allocate once all values fit
+          sensorBuffer.clear();
           for (iter = sensors.begin(); iter != sensors.end(); iter++) {
-            count_val = (*iter)->getSensorData(&sens_val);
-            for(i=0; i<count_val; i++) *(pt_sensors++) = (double)sens_val[i];
-            free(sens_val);
+            (*iter)->appendSensorData(&sensorBuffer);
+          }
+          for (i=0; i<maxSensorValues; i++) {
+            t_sensors[i] = (i < (int)sensorBuffer.size()) ? sensorBuffer[i] : 0;
           }
           /*
           if (sParams.size()) {
@@ -812,9 +822,12 @@ namespace mars {
       BaseSensor *sensor;
       for(iter = sController.sensors.begin();
           iter != sController.sensors.end(); iter++) {
+        // drop the registration of the last reset before adding a new one
+        control->sensors->removeSensorConsumer(*iter);
         sensor = control->sensors->getSimSensor(*iter);
         if(sensor) {
           sensors.push_back(sensor);
+          control->sensors->addSensorConsumer(*iter);
         }
       }
     }
@@ -1046,17 +1059,12 @@ namespace mars {
 
     std::list<sReal> Controller::getSensorValues(void) {
       std::vector<BaseSensor*>::iterator iter;
-      sReal *sens_val;
-      std::list<sReal> sensorValues;
+      std::vector<double> values;
 
       for (iter=sensors.begin(); iter!=sensors.end(); ++iter) {
-        int count_val = (*iter)->getSensorData(&sens_val);
-        for(int i=0; i<count_val; i++) {
-          sensorValues.push_back(sens_val[i]);
-        }
-        free(sens_val);
+        (*iter)->appendSensorData(&values);
       }
-      return sensorValues;
+      return std::list<sReal>(values.begin(), values.end());
     }
 
 
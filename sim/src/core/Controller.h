@@ -120,6 +120,9 @@ namespace mars {
       std::vector<SimMotor*> motors;
       std::vector<interfaces::BaseSensor*> sensors;
       std::vector<interfaces::NodeData*> sNodes;
+      // size of the sensor array passed to the controller library
+      static const int maxSensorValues = 255;
+      std::vector<double> sensorBuffer;
       int initServer(int port);
       void getClient(void);
       int openClient(const char *host, int port);
@@ -46,6 +46,7 @@ namespace mars {
       unsigned long id = 0;
       MutexLocker locker(&iMutex);
       entities[id = getNextId()] = new SimEntity(control, name);
+      entityRegistry.add(id, name, entities[id]);
       notifySubscribers(entities[id]);
       return id;
     }
@@ -54,6 +55,7 @@ namespace mars {
       unsigned long id = 0;
       MutexLocker locker(&iMutex);
       entities[id = getNextId()] = entity;
+      entityRegistry.add(id, entity->getName(), entity);
       notifySubscribers(entity);
       return id;
     }
@@ -72,15 +74,7 @@ namespace mars {
 
     void EntityManager::addNode(const std::string& entityName, long unsigned int nodeId,
         const std::string& nodeName) {
-      SimEntity *entity = 0;
-      //iterate over all robots to find the robot with the given name
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == entityName) {
-          entity = iter->second;
-          break;
-        }
-      }
+      SimEntity *entity = entityRegistry.get(entityName);
       if (entity) {
         MutexLocker locker(&iMutex);
         entity->addNode(nodeId, nodeName);
@@ -89,40 +83,28 @@ namespace mars {
 
     void EntityManager::addMotor(const std::string& entityName, long unsigned int motorId,
         const std::string& motorName) {
-      //iterate over all robots to find the robot with the given name
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == entityName) {
-          MutexLocker locker(&iMutex);
-          iter->second->addMotor(motorId, motorName);
-          break;
-        }
+      SimEntity *entity = entityRegistry.get(entityName);
+      if (entity) {
+        MutexLocker locker(&iMutex);
+        entity->addMotor(motorId, motorName);
       }
     }
 
     void EntityManager::addJoint(const std::string& entityName, long unsigned int jointId,
         const std::string& jointName) {
-      //iterate over all robots to find the robot with the given name
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == entityName) {
-          MutexLocker locker(&iMutex);
-          iter->second->addJoint(jointId, jointName);
-          break;
-        }
+      SimEntity *entity = entityRegistry.get(entityName);
+      if (entity) {
+        MutexLocker locker(&iMutex);
+        entity->addJoint(jointId, jointName);
       }
     }
 
     void EntityManager::addController(const std::string& entityName,
         long unsigned int controllerId) {
-      //iterate over all robots to find the robot with the given name
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == entityName) {
-          MutexLocker locker(&iMutex);
-          iter->second->addController(controllerId);
-          break;
-        }
+      SimEntity *entity = entityRegistry.get(entityName);
+      if (entity) {
+        MutexLocker locker(&iMutex);
+        entity->addController(controllerId);
       }
     }
 
@@ -144,24 +126,11 @@ namespace mars {
     }
 
     SimEntity* EntityManager::getEntity(const std::string& name) {
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == name) {
-          return iter->second;
-        }
-      }
-      return 0;
+      return entityRegistry.get(name);
     }
 
     SimEntity* EntityManager::getEntity(long unsigned int id) {
-      //TODO replace with find
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->first == id) {
-          return iter->second;
-        }
-      }
-      return 0;
+      return entityRegistry.get(id);
     }
 
     long unsigned int EntityManager::getEntityNode(const std::string& entityName,
@@ -37,6 +37,7 @@
 #define ENTITY_MANAGER_H
 
 #include <map>
+#include "NameRegistry.h"
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/graphics/GraphicsEventClient.h>
 #include <mars/interfaces/sim/EntityManagerInterface.h>
@@ -113,6 +114,7 @@ namespace mars {
       /**the id assigned to the next created entity; use getNextId function*/
       unsigned long next_entity_id;
       std::map<unsigned long, SimEntity*> entities;
+      NameRegistry<SimEntity> entityRegistry;
 
       /**returns the id to be assigned to the next entity*/
       unsigned long getNextId() {
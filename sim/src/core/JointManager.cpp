@@ -119,6 +119,7 @@ namespace mars {
         //    newJoint->setSJoint(*jointS);
         newJoint->setPhysicalJoint(newJointInterface);
         simJoints[jointS->index] = newJoint;
+        jointRegistry.add(jointS->index, jointS->name, newJoint);
         iMutex.unlock();
         control->sim->sceneHasChanged(false);
         return jointS->index;
@@ -193,6 +194,7 @@ namespace mars {
       if (iter != simJoints.end()) {
         tmpJoint = iter->second;
         simJoints.erase(iter);
+        jointRegistry.remove(index);
       }
 
       control->motors->removeJointFromMotors(index);
@@ -274,6 +276,7 @@ namespace mars {
         delete simJoints.begin()->second;
         simJoints.erase(simJoints.begin());
       }
+      jointRegistry.clear();
       control->sim->sceneHasChanged(false);
 
       next_joint_id = 1;
@@ -376,14 +379,11 @@ namespace mars {
 
 
     unsigned long JointManager::getID(const std::string& joint_name) const {
-      map<unsigned long, SimJoint*>::const_iterator iter;
-      MutexLocker locker(&iMutex);
-      for(iter = simJoints.begin(); iter != simJoints.end(); iter++) {
-        JointData joint = iter->second->getSJoint();
-        if (joint.name == joint_name)
-          return joint.index;
-      }
-      return 0;
+      return jointRegistry.getID(joint_name);
+    }
+
+    std::vector<unsigned long> JointManager::getIDs(const std::vector<std::string> &joint_names) const {
+      return jointRegistry.getIDs(joint_names);
     }
 
     bool JointManager::getDataBrokerNames(unsigned long id, std::string *groupName,
@@ -33,6 +33,8 @@
   #warning "JointManager.h"
 #endif
 
+#include "NameRegistry.h"
+
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/sim/JointManagerInterface.h>
 #include <mars/utils/Mutex.h>
@@ -77,6 +79,7 @@ namespace mars {
                                  bool first_axis = 1);
 
       virtual unsigned long getID(const std::string &joint_name) const;
+      virtual std::vector<unsigned long> getIDs(const std::vector<std::string> &joint_names) const;
       virtual bool getDataBrokerNames(unsigned long id, std::string *groupName,
                                       std::string *dataName) const;
       virtual void setOfflineValue(unsigned long id, interfaces::sReal value);
@@ -93,6 +96,7 @@ namespace mars {
     private:
       unsigned long next_joint_id;
       std::map<unsigned long, SimJoint*> simJoints;
+      NameRegistry<SimJoint> jointRegistry;
       std::list<interfaces::JointData> simJointsReload;
       interfaces::ControlCenter *control;
       mutable utils::Mutex iMutex;
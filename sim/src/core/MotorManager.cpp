@@ -108,6 +108,7 @@ namespace mars {
       newMotor->setSMotor(*motorS);
       iMutex.lock();
       simMotors[newMotor->getIndex()] = newMotor.get();
+      motorRegistry.add(newMotor->getIndex(), motorS->name, newMotor.get());
       iMutex.unlock();
       control->sim->sceneHasChanged(false);
 
@@ -222,8 +223,12 @@ namespace mars {
     void MotorManager::editMotor(const MotorData &motorS) {
       MutexLocker locker(&iMutex);
       map<unsigned long, SimMotor*>::iterator iter = simMotors.find(motorS.index);
-      if (iter != simMotors.end())
+      if (iter != simMotors.end()) {
+        if(iter->second->getName() != motorS.name) {
+          motorRegistry.rename(motorS.index, motorS.name);
+        }
         iter->second->setSMotor(motorS);
+      }
     }
 
 
@@ -280,6 +285,7 @@ namespace mars {
       if (iter != simMotors.end()) {
         tmpMotor = iter->second;
         simMotors.erase(iter);
+        motorRegistry.remove(index);
         if (tmpMotor)
           delete tmpMotor;
       }
@@ -325,12 +331,7 @@ namespace mars {
      * \returns Returns a pointer to the corresponding motor object.
      */
     SimMotor* MotorManager::getSimMotorByName(const std::string &name) const {
-      MutexLocker locker(&iMutex);
-      std::map<unsigned long, SimMotor*>::const_iterator iter;
-      for (iter = simMotors.begin(); iter != simMotors.end(); iter++)
-        if (iter->second->getName() == name)
-          return iter->second;
-      return NULL;
+      return motorRegistry.get(name);
     }
 
 
@@ -440,14 +441,18 @@ namespace mars {
      * \return Id of the motor if it exists, otherwise 0
      */
     unsigned long MotorManager::getID(const std::string& name) const {
-      map<unsigned long, SimMotor*>::const_iterator iter;
-      MutexLocker locker(&iMutex);
+      return motorRegistry.getID(name);
+    }
 
-      for (iter = simMotors.begin(); iter != simMotors.end(); iter++) {
-        if (iter->second->getName() == name)
-          return iter->first;
-      }
-      return 0;
+    /**
+     * \brief Retrieves the ids of several motors by name
+     *
+     * \param names Names of the motors to get the ids for
+     *
+     * \return Ids of the motors in the order of \c names, 0 for unknown names
+     */
+    std::vector<unsigned long> MotorManager::getIDs(const std::vector<std::string> &names) const {
+      return motorRegistry.getIDs(names);
     }
 
 
@@ -485,6 +490,7 @@ namespace mars {
       for(iter = simMotors.begin(); iter != simMotors.end(); iter++)
         delete iter->second;
       simMotors.clear();
+      motorRegistry.clear();
       mimicmotors.clear();
       if(clear_all) simMotorsReload.clear();
       next_motor_id = 1;
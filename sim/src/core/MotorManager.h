@@ -38,6 +38,8 @@
   #warning "MotorManager.h"
 #endif
 
+#include "NameRegistry.h"
+
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/sim/MotorManagerInterface.h>
 #include <mars/utils/Mutex.h>
@@ -308,6 +310,7 @@ namespace mars {
        * \return Id of the motor if it exists, otherwise 0
        */
       virtual unsigned long getID(const std::string& motor_name) const;
+      virtual std::vector<unsigned long> getIDs(const std::vector<std::string> &motor_names) const;
 
       virtual void getDataBrokerNames(unsigned long jointId, 
                                       std::string *groupName, 
@@ -345,6 +348,9 @@ namespace mars {
       //! a container for all motors currently present in the simulation
       std::map<unsigned long, SimMotor*> simMotors;
 
+      //! hashed name and id indices of simMotors
+      NameRegistry<SimMotor> motorRegistry;
+
       //! a containter for all motors that are reloaded after a reset of the simulation
       std::list<interfaces::MotorData> simMotorsReload;
 
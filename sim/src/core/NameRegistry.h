@@ -0,0 +1,187 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file NameRegistry.h
+ * \brief "NameRegistry" keeps hashed name->id and id->object indices for
+ * the objects owned by one of the simulation managers.
+ *
+ * The managers still own their objects and keep their ordered maps for
+ * iteration. The registry only mirrors them so that lookups by name or id
+ * don't have to walk the whole map. Several objects may share a name; in
+ * that case the one with the lowest id is returned, which is the same
+ * result the former linear scans over the ordered maps produced.
+ */
+
+#ifndef NAME_REGISTRY_H
+#define NAME_REGISTRY_H
+
+#ifdef _PRINT_HEADER_
+  #warning "NameRegistry.h"
+#endif
+
+#include <mars/utils/ReadWriteLock.h>
+#include <mars/utils/ReadWriteLocker.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mars {
+  namespace sim {
+
+    template <typename T>
+    class NameRegistry {
+    public:
+      NameRegistry() {}
+
+      /**
+       * \brief Registers \a object under \a id and \a name.
+       *
+       * An object that is already registered with the same id is replaced.
+       */
+      void add(unsigned long id, const std::string &name, T *object) {
+        utils::ReadWriteLocker locker(&rwLock, utils::READWRITELOCK_MODE_WRITE);
+        removeUnlocked(id);
+        IdList &ids = names[name];
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+        objects[id] = Entry(name, object);
+      }
+
+      void remove(unsigned long id) {
+        utils::ReadWriteLocker locker(&rwLock, utils::READWRITELOCK_MODE_WRITE);
+        removeUnlocked(id);
+      }
+
+      void rename(unsigned long id, const std::string &name) {
+        utils::ReadWriteLocker locker(&rwLock, utils::READWRITELOCK_MODE_WRITE);
+        typename ObjectMap::iterator it = objects.find(id);
+        if(it == objects.end()) return;
+        T *object = it->second.object;
+        removeUnlocked(id);
+        IdList &ids = names[name];
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+        objects[id] = Entry(name, object);
+      }
+
+      void clear() {
+        utils::ReadWriteLocker locker(&rwLock, utils::READWRITELOCK_MODE_WRITE);
+        names.clear();
+        objects.clear();
+      }
+
+      /**
+       * \return The id registered for \a name or \a invalid if no object
+       *         with that name exists.
+       */
+      unsigned long getID(const std::string &name,
+                          unsigned long invalid = 0) const {
+        utils::ReadWriteLocker locker(&rwLock, utils::READWRITELOCK_MODE_READ);
+        typename NameMap::const_iterator it = names.find(name);
+        if(it == names.end() || it->second.empty()) return invalid;
+        return it->second.front();
+      }
+
+      /**
+       * \brief Resolves a list of names with a single lock.
+       *
+       * The result has the same size and order as \a names; unknown names
+       * are set to \a invalid.
+       */
+      std::vector<unsigned long> getIDs(const std::vector<std::string> &names_,
+                                        unsigned long invalid = 0) const {
+        std::vector<unsigned long> result;
+        result.reserve(names_.size());
+        utils::ReadWriteLocker locker(&rwLock, utils::READWRITELOCK_MODE_READ);
+        std::vector<std::string>::const_iterator it = names_.begin();
+        for(; it != names_.end(); ++it) {
+          typename NameMap::const_iterator jt = names.find(*it);
+          if(jt == names.end() || jt->second.empty()) {
+            result.push_back(invalid);
+          }
+          else {
+            result.push_back(jt->second.front());
+          }
+        }
+        return result;
+      }
+
+      T* get(unsigned long id) const {
+        utils::ReadWriteLocker locker(&rwLock, utils::READWRITELOCK_MODE_READ);
+        typename ObjectMap::const_iterator it = objects.find(id);
+        if(it == objects.end()) return 0;
+        return it->second.object;
+      }
+
+      T* get(const std::string &name) const {
+        utils::ReadWriteLocker locker(&rwLock, utils::READWRITELOCK_MODE_READ);
+        typename NameMap::const_iterator it = names.find(name);
+        if(it == names.end() || it->second.empty()) return 0;
+        typename ObjectMap::const_iterator jt = objects.find(it->second.front());
+        if(jt == objects.end()) return 0;
+        return jt->second.object;
+      }
+
+      size_t size() const {
+        utils::ReadWriteLocker locker(&rwLock, utils::READWRITELOCK_MODE_READ);
+        return objects.size();
+      }
+
+    private:
+      // disallow copying
+      NameRegistry(const NameRegistry &);
+      NameRegistry &operator=(const NameRegistry &);
+
+      struct Entry {
+        Entry() : object(0) {}
+        Entry(const std::string &name, T *object) : name(name), object(object) {}
+        std::string name;
+        T *object;
+      };
+
+      // ids are kept sorted so that front() is the lowest id for a name
+      typedef std::vector<unsigned long> IdList;
+      typedef std::unordered_map<std::string, IdList> NameMap;
+      typedef std::unordered_map<unsigned long, Entry> ObjectMap;
+
+      NameMap names;
+      ObjectMap objects;
+      mutable utils::ReadWriteLock rwLock;
+
+      void removeUnlocked(unsigned long id) {
+        typename ObjectMap::iterator it = objects.find(id);
+        if(it == objects.end()) return;
+        typename NameMap::iterator jt = names.find(it->second.name);
+        if(jt != names.end()) {
+          IdList &ids = jt->second;
+          IdList::iterator kt = std::lower_bound(ids.begin(), ids.end(), id);
+          if(kt != ids.end() && *kt == id) ids.erase(kt);
+          if(ids.empty()) names.erase(jt);
+        }
+        objects.erase(it);
+      }
+
+    }; // end of class NameRegistry
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif  // NAME_REGISTRY_H
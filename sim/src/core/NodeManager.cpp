@@ -66,15 +66,12 @@ namespace mars {
                              lib_manager::LibManager *theManager) :
                                                  next_node_id(1),
                                                  update_all_nodes(false),
+                                                 allNodesVersion(0),
                                                  visual_rep(1),
                                                  maxGroupID(0),
                                                  libManager(theManager),
                                                  control(c)
     {
-      if(control->graphics) {
-        GraphicsUpdateInterface *gui = static_cast<GraphicsUpdateInterface*>(this);
-        control->graphics->addGraphicsUpdateInterface(gui);
-      }
     }
 
 
@@ -251,6 +248,7 @@ namespace mars {
         simNodes[nodeS->index] = newNode;
         if (nodeS->movable)
           simNodesDyn[nodeS->index] = newNode;
+        nodeRegistry.add(nodeS->index, nodeS->name, newNode);
         iMutex.unlock();
         control->sim->sceneHasChanged(false);
         NodeId id;
@@ -308,6 +306,7 @@ namespace mars {
         simNodes[nodeS->index] = newNode;
         if (nodeS->movable)
           simNodesDyn[nodeS->index] = newNode;
+        nodeRegistry.add(nodeS->index, nodeS->name, newNode);
         iMutex.unlock();
         control->sim->sceneHasChanged(false);
         if(control->graphics) {
@@ -545,6 +544,9 @@ namespace mars {
           control->graphics->setDrawObjectScale(editedNode->getGraphicsID(), scale);
           control->graphics->setDrawObjectScale(editedNode->getGraphicsID2(), nodeS->ext);
         }
+        if(nodeS->name != sNode.name) {
+          nodeRegistry.rename(nodeS->index, nodeS->name);
+        }
         editedNode->changeNode(nodeS);
         if(nodeS->groupID > maxGroupID) {
           maxGroupID = nodeS->groupID;
@@ -659,12 +661,14 @@ namespace mars {
       if (iter != simNodes.end()) {
         tmpNode = iter->second; //iter->second is a pointer to the SimNode associated with the map
         simNodes.erase(iter);
+        nodeRegistry.remove(id);
       }
 
       iter = nodesToUpdate.find(id);
       if (iter != nodesToUpdate.end()) {
         nodesToUpdate.erase(iter);
       }
+      publishedNodes.erase(id);
 
       if (tmpNode && tmpNode->isMovable()) {
         iter = simNodesDyn.find(id);
@@ -1176,6 +1180,8 @@ namespace mars {
         if(tmp.terrain) {
           tmp.terrain = new(terrainStruct);
           *(tmp.terrain) = *(iter->terrain);
+          // the physics creates new regions for the new height buffer
+          tmp.terrain->dirtyRegions = NULL;
           tmp.terrain->pixelData = (double*)calloc((tmp.terrain->width*
                                                      tmp.terrain->height),
                                                     sizeof(double));
@@ -1252,50 +1258,55 @@ namespace mars {
       }
     }
 
-    void NodeManager::preGraphicsUpdate() {
-	//	printf("...preGraphicsUpdate...\n");
+    void NodeManager::addDrawPoses(const SimNode *node,
+                                   DrawObjectPoseList *poses) const {
+      DrawObjectPose pose;
+      pose.id = node->getGraphicsID();
+      pose.pos = node->getVisualPosition();
+      pose.rot = node->getVisualRotation();
+      poses->push_back(pose);
+      pose.id = node->getGraphicsID2();
+      pose.pos = node->getPosition();
+      pose.rot = node->getRotation();
+      poses->push_back(pose);
+    }
+
+    void NodeManager::fillDrawPoses(DrawObjectPoseList *poses,
+                                    unsigned long version,
+                                    unsigned long consumedVersion) {
+      MutexLocker locker(&iMutex);
       NodeMap::iterator iter;
-      if(!control->graphics)
-        return;
 
-      iMutex.lock();
       if(update_all_nodes) {
         update_all_nodes = false;
-        for(iter = simNodes.begin(); iter != simNodes.end(); iter++) {
-          control->graphics->setDrawObjectPos(iter->second->getGraphicsID(),
-                                              iter->second->getVisualPosition());
-          control->graphics->setDrawObjectRot(iter->second->getGraphicsID(),
-                                              iter->second->getVisualRotation());
-          control->graphics->setDrawObjectPos(iter->second->getGraphicsID2(),
-                                              iter->second->getPosition());
-          control->graphics->setDrawObjectRot(iter->second->getGraphicsID2(),
-                                              iter->second->getRotation());
-        }
+        allNodesVersion = version;
       }
-      else {
-        for(iter = simNodesDyn.begin(); iter != simNodesDyn.end(); iter++) {
-          control->graphics->setDrawObjectPos(iter->second->getGraphicsID(),
-                                              iter->second->getVisualPosition());
-          control->graphics->setDrawObjectRot(iter->second->getGraphicsID(),
-                                              iter->second->getVisualRotation());
-          control->graphics->setDrawObjectPos(iter->second->getGraphicsID2(),
-                                              iter->second->getPosition());
-          control->graphics->setDrawObjectRot(iter->second->getGraphicsID2(),
-                                              iter->second->getRotation());
+      for(iter = nodesToUpdate.begin(); iter != nodesToUpdate.end(); ++iter) {
+        publishedNodes[iter->first] = version;
+      }
+      nodesToUpdate.clear();
+
+      // the renderer may skip snapshots, thus static changes are repeated
+      // until a snapshot containing them was consumed
+      if(allNodesVersion > consumedVersion) {
+        for(iter = simNodes.begin(); iter != simNodes.end(); ++iter) {
+          addDrawPoses(iter->second, poses);
         }
-        for(iter = nodesToUpdate.begin(); iter != nodesToUpdate.end(); iter++) {
-          control->graphics->setDrawObjectPos(iter->second->getGraphicsID(),
-                                              iter->second->getVisualPosition());
-          control->graphics->setDrawObjectRot(iter->second->getGraphicsID(),
-                                              iter->second->getVisualRotation());
-          control->graphics->setDrawObjectPos(iter->second->getGraphicsID2(),
-                                              iter->second->getPosition());
-          control->graphics->setDrawObjectRot(iter->second->getGraphicsID2(),
-                                              iter->second->getRotation());
+        return;
+      }
+      for(iter = simNodesDyn.begin(); iter != simNodesDyn.end(); ++iter) {
+        addDrawPoses(iter->second, poses);
+      }
+      std::map<NodeId, unsigned long>::iterator it = publishedNodes.begin();
+      while(it != publishedNodes.end()) {
+        iter = simNodes.find(it->first);
+        if(it->second <= consumedVersion || iter == simNodes.end()) {
+          publishedNodes.erase(it++);
+          continue;
         }
-        nodesToUpdate.clear();
+        addDrawPoses(iter->second, poses);
+        ++it;
       }
-      iMutex.unlock();
     }
 
     /**
@@ -1308,6 +1319,7 @@ namespace mars {
         removeNode(simNodes.begin()->first, false, clearGraphics);
       simNodes.clear();
       simNodesDyn.clear();
+      nodeRegistry.clear();
       if(clear_all) simNodesReload.clear();
       next_node_id = 1;
       iMutex.unlock();
@@ -1534,17 +1546,11 @@ namespace mars {
     }
 
     NodeId NodeManager::getID(const std::string& node_name) const {
+      return nodeRegistry.getID(node_name, INVALID_ID);
+    }
 
-      iMutex.lock();
-      NodeMap::const_iterator iter;
-      for(iter = simNodes.begin(); iter != simNodes.end(); iter++) {
-        if (iter->second->getName() == node_name)  {
-          iMutex.unlock();
-          return iter->first;
-        }
-      }
-      iMutex.unlock();
-      return INVALID_ID;
+    std::vector<NodeId> NodeManager::getIDs(const std::vector<std::string> &node_names) const {
+      return nodeRegistry.getIDs(node_names, INVALID_ID);
     }
 
     void NodeManager::pushToUpdate(SimNode* node) {
@@ -32,8 +32,10 @@
   #warning "NodeManager.h"
 #endif
 
+#include "NameRegistry.h"
+
 #include <mars/utils/Mutex.h>
-#include <mars/interfaces/graphics/GraphicsUpdateInterface.h>
+#include <mars/interfaces/graphics/draw_structs.h>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/sim/NodeManagerInterface.h>
 
@@ -49,8 +51,7 @@ namespace mars {
      * The declaration of the NodeManager class.
      *
      */
-    class NodeManager : public interfaces::NodeManagerInterface,
-                        public interfaces::GraphicsUpdateInterface {
+    class NodeManager : public interfaces::NodeManagerInterface {
     public:
       NodeManager(interfaces::ControlCenter *c,
                   lib_manager::LibManager *theManager);
@@ -117,13 +118,15 @@ namespace mars {
       virtual void setAngularDamping(interfaces::NodeId id, interfaces::sReal damping);
       virtual void addRotation(interfaces::NodeId id, const utils::Quaternion &q);
       virtual void setReloadQuaternion(interfaces::NodeId id, const utils::Quaternion &q);
-      virtual void preGraphicsUpdate(void);
       virtual void exportGraphicNodesByID(const std::string &folder) const;
       virtual void getContactPoints(std::vector<interfaces::NodeId> *ids,
                                     std::vector<utils::Vector> *contact_points) const;
       virtual void getContactIDs(const interfaces::NodeId &id,
                                  std::list<interfaces::NodeId> *ids) const;
       virtual void updateRay(interfaces::NodeId id);
+      virtual void fillDrawPoses(interfaces::DrawObjectPoseList *poses,
+                                 unsigned long version,
+                                 unsigned long consumedVersion);
       virtual interfaces::NodeId getDrawID(interfaces::NodeId id) const;
       virtual void setVisualRep(interfaces::NodeId id, int val);
       virtual const utils::Vector getContactForce(interfaces::NodeId id) const;
@@ -140,6 +143,7 @@ namespace mars {
        * \return Id of the node if it exists, otherwise 0
        */
       virtual interfaces::NodeId getID(const std::string& node_name) const;
+      virtual std::vector<interfaces::NodeId> getIDs(const std::vector<std::string> &node_names) const;
       virtual double getCollisionDepth(interfaces::NodeId id) const;
       virtual bool getDataBrokerNames(interfaces::NodeId id, std::string *groupName,
                                       std::string *dataName) const;
@@ -166,6 +170,11 @@ namespace mars {
       NodeMap simNodes;
       NodeMap simNodesDyn;
       NodeMap nodesToUpdate;
+      // static nodes already published in a snapshot, with the snapshot
+      // version; kept until the renderer consumed that version
+      std::map<interfaces::NodeId, unsigned long> publishedNodes;
+      unsigned long allNodesVersion;
+      NameRegistry<SimNode> nodeRegistry;
       std::list<interfaces::NodeData> simNodesReload;
       unsigned long maxGroupID;
       lib_manager::LibManager *libManager;
@@ -174,6 +183,8 @@ namespace mars {
       interfaces::ControlCenter *control;
 
       std::list<interfaces::NodeData>::iterator getReloadNode(interfaces::NodeId id);
+      void addDrawPoses(const SimNode *node,
+                        interfaces::DrawObjectPoseList *poses) const;
 
       // interfaces::NodeInterface* getNodeInterface(NodeId node_id);
       struct Params; // see below.
@@ -0,0 +1,356 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file PluginScheduler.cpp
+ * \brief Implementation of the PluginScheduler.
+ */
+
+#include "PluginScheduler.h"
+
+#include <mars/utils/Thread.h>
+#include <mars/utils/MutexLocker.h>
+#include <mars/utils/misc.h>
+#include <mars/utils/AllocationTracker.h>
+#include <mars/interfaces/Logging.hpp>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace mars {
+  namespace sim {
+
+    using namespace interfaces;
+
+    class PluginWorker : public utils::Thread {
+    public:
+      PluginWorker(PluginScheduler *scheduler, int thread)
+        : scheduler(scheduler), thread(thread) {}
+
+    protected:
+      void run() {
+        scheduler->workerLoop(thread);
+      }
+
+    private:
+      PluginScheduler *scheduler;
+      int thread;
+    }; // end of class PluginWorker
+
+    namespace {
+      // orders the plugin indices by level and keeps the registration
+      // order within a level
+      struct LevelOrder {
+        const std::vector<int> *levelOf;
+        bool operator()(size_t a, size_t b) const {
+          if((*levelOf)[a] != (*levelOf)[b]) {
+            return (*levelOf)[a] < (*levelOf)[b];
+          }
+          return a < b;
+        }
+      };
+
+      bool intersects(const std::vector<std::string> &a,
+                      const std::vector<std::string> &b) {
+        for(size_t i=0; i<a.size(); ++i) {
+          if(std::find(b.begin(), b.end(), a[i]) != b.end()) return true;
+        }
+        return false;
+      }
+    }
+
+    PluginScheduler::PluginScheduler() : levelsValid(false),
+                                         pendingTasks(0),
+                                         stopWorkers(false),
+                                         showTime(false),
+                                         deterministic(false) {
+    }
+
+    PluginScheduler::~PluginScheduler() {
+      stopAllWorkers();
+    }
+
+    void PluginScheduler::setNumWorkers(int numWorkers) {
+      if(numWorkers < 0) numWorkers = 0;
+      if(numWorkers == (int)workers.size()) return;
+      stopAllWorkers();
+      for(int i=0; i<numWorkers; ++i) {
+        PluginWorker *worker = new PluginWorker(this, i+1);
+        worker->start();
+        workers.push_back(worker);
+      }
+      LOG_INFO("PluginScheduler: %d worker threads", numWorkers);
+    }
+
+    void PluginScheduler::stopAllWorkers() {
+      queueMutex.lock();
+      stopWorkers = true;
+      taskCondition.wakeAll();
+      queueMutex.unlock();
+      for(size_t i=0; i<workers.size(); ++i) {
+        workers[i]->wait();
+        delete workers[i];
+      }
+      workers.clear();
+      stopWorkers = false;
+    }
+
+    void PluginScheduler::setSchedule(PluginInterface *plugin,
+                                      const PluginSchedule &schedule) {
+      utils::MutexLocker locker(&scheduleMutex);
+      pendingSchedules[plugin] = schedule;
+    }
+
+    void PluginScheduler::removePlugin(PluginInterface *plugin) {
+      entries.erase(plugin);
+      scheduleMutex.lock();
+      pendingSchedules.erase(plugin);
+      scheduleMutex.unlock();
+      invalidate();
+    }
+
+    void PluginScheduler::invalidate() {
+      utils::MutexLocker locker(&queueMutex);
+      levelsValid = false;
+    }
+
+    void PluginScheduler::applySchedules() {
+      utils::MutexLocker locker(&scheduleMutex);
+      if(pendingSchedules.empty()) return;
+      std::map<PluginInterface*, PluginSchedule>::iterator it;
+      for(it=pendingSchedules.begin(); it!=pendingSchedules.end(); ++it) {
+        Entry &entry = entries[it->first];
+        entry.scheduled = true;
+        entry.schedule = it->second;
+      }
+      pendingSchedules.clear();
+      invalidate();
+    }
+
+    bool PluginScheduler::isDue(PluginInterface *plugin, sReal calc_ms,
+                                sReal *time_ms) {
+      Entry &entry = entries[plugin];
+      entry.elapsed += calc_ms;
+      // the tolerance avoids skipping a step due to rounding when the
+      // period is a multiple of the step size
+      if(entry.scheduled &&
+         entry.elapsed + 1e-6 < entry.schedule.updatePeriod) {
+        return false;
+      }
+      *time_ms = entry.elapsed;
+      entry.elapsed = 0.0;
+      return true;
+    }
+
+    bool PluginScheduler::conflicts(const Entry &a, const Entry &b) const {
+      if(!a.scheduled || !b.scheduled) return true;
+      return (intersects(a.schedule.writes, b.schedule.reads) ||
+              intersects(a.schedule.writes, b.schedule.writes) ||
+              intersects(b.schedule.writes, a.schedule.reads));
+    }
+
+    bool PluginScheduler::dependsOn(const Entry &a,
+                                    const std::string &name) const {
+      const std::vector<std::string> &deps = a.schedule.dependencies;
+      return std::find(deps.begin(), deps.end(), name) != deps.end();
+    }
+
+    void PluginScheduler::buildLevels(const std::vector<pluginStruct> &plugins) {
+      const size_t n = plugins.size();
+      std::vector<const Entry*> entry(n);
+      for(size_t i=0; i<n; ++i) {
+        entry[i] = &entries[plugins[i].p_interface];
+      }
+
+      // before[i] holds the plugins that have to be updated before plugin i;
+      // conflicting plugins keep their registration order
+      std::vector<std::vector<size_t> > before(n);
+      for(size_t i=0; i<n; ++i) {
+        for(size_t j=0; j<i; ++j) {
+          if(dependsOn(*entry[j], plugins[i].name)) {
+            before[j].push_back(i);
+          }
+          else if(dependsOn(*entry[i], plugins[j].name) ||
+                  conflicts(*entry[i], *entry[j])) {
+            before[i].push_back(j);
+          }
+        }
+      }
+
+      // longest path: the levels are settled after at most n passes,
+      // otherwise the dependencies contain a cycle
+      levelOf.assign(n, 0);
+      bool changed = true;
+      for(size_t pass=0; changed && pass<=n; ++pass) {
+        changed = false;
+        for(size_t i=0; i<n; ++i) {
+          for(size_t k=0; k<before[i].size(); ++k) {
+            int level = levelOf[before[i][k]] + 1;
+            if(levelOf[i] < level) {
+              levelOf[i] = level;
+              changed = true;
+            }
+          }
+        }
+      }
+      if(changed) {
+        LOG_WARN("PluginScheduler: cyclic plugin dependencies, the plugins are updated serially");
+        for(size_t i=0; i<n; ++i) levelOf[i] = (int)i;
+      }
+
+      std::vector<size_t> order(n);
+      for(size_t i=0; i<n; ++i) order[i] = i;
+      LevelOrder levelOrder = {&levelOf};
+      std::sort(order.begin(), order.end(), levelOrder);
+
+      std::vector<int> sortedLevels(n);
+      levelPlugins.resize(n);
+      for(size_t i=0; i<n; ++i) {
+        levelPlugins[i] = plugins[order[i]];
+        sortedLevels[i] = levelOf[order[i]];
+      }
+      levelOf.swap(sortedLevels);
+      queueMutex.lock();
+      levelsValid = true;
+      queueMutex.unlock();
+    }
+
+    void PluginScheduler::updateParallel(const std::vector<pluginStruct> &plugins,
+                                         sReal calc_ms, bool showTime) {
+      queueMutex.lock();
+      bool valid = levelsValid && levelPlugins.size() == plugins.size();
+      queueMutex.unlock();
+      if(!valid) {
+        buildLevels(plugins);
+      }
+      this->showTime = showTime;
+
+      size_t i = 0;
+      while(i < levelPlugins.size()) {
+        int level = levelOf[i];
+        dueTasks.clear();
+        for(; i < levelPlugins.size() && levelOf[i] == level; ++i) {
+          Task task;
+          if(!isDue(levelPlugins[i].p_interface, calc_ms, &task.time_ms)) {
+            continue;
+          }
+          task.plugin = levelPlugins[i].p_interface;
+          task.name = &levelPlugins[i].name;
+          task.thread = -1;
+          dueTasks.push_back(task);
+        }
+        runLevel();
+      }
+    }
+
+    void PluginScheduler::runLevel() {
+      if(dueTasks.empty()) return;
+      if(dueTasks.size() == 1 || workers.empty()) {
+        for(size_t i=0; i<dueTasks.size(); ++i) runTask(dueTasks[i]);
+        return;
+      }
+
+      const int numThreads = (int)workers.size() + 1;
+      queueMutex.lock();
+      // the calling thread takes the first task itself, in deterministic
+      // mode also the tasks assigned to thread 0
+      pendingTasks = 0;
+      for(size_t i=1; i<dueTasks.size(); ++i) {
+        dueTasks[i].thread = deterministic ? (int)(i % numThreads) : -1;
+        if(dueTasks[i].thread == 0) continue;
+        tasks.push_back(dueTasks[i]);
+        ++pendingTasks;
+      }
+      taskCondition.wakeAll();
+      queueMutex.unlock();
+
+      for(size_t i=0; i<dueTasks.size(); ++i) {
+        if(i == 0 || dueTasks[i].thread == 0) runTask(dueTasks[i]);
+      }
+
+      queueMutex.lock();
+      Task task;
+      while(takeTask(0, &task)) {
+        queueMutex.unlock();
+        runTask(task);
+        queueMutex.lock();
+        --pendingTasks;
+      }
+      while(pendingTasks > 0) {
+        doneCondition.wait(&queueMutex);
+      }
+      queueMutex.unlock();
+    }
+
+    void PluginScheduler::runTask(const Task &task) {
+      // the workers count their allocations for the plugins as well
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_PLUGINS);
+      long long time = 0;
+      if(showTime) time = utils::getTime();
+
+      task.plugin->update(task.time_ms);
+
+      if(showTime) {
+        std::map<PluginInterface*, Entry>::iterator it = entries.find(task.plugin);
+        if(it == entries.end()) return;
+        Entry &entry = it->second;
+        entry.timer += utils::getTimeDiff(time);
+        if(++entry.t_count > 20) {
+          entry.timer /= entry.t_count;
+          entry.t_count = 0;
+          fprintf(stderr, "debug_time: %s: %g\n", task.name->c_str(),
+                  entry.timer);
+          entry.timer = 0.0;
+        }
+      }
+    }
+
+    bool PluginScheduler::takeTask(int thread, Task *task) {
+      std::deque<Task>::iterator it;
+      for(it=tasks.begin(); it!=tasks.end(); ++it) {
+        if(it->thread == -1 || it->thread == thread) {
+          *task = *it;
+          tasks.erase(it);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void PluginScheduler::workerLoop(int thread) {
+      Task task;
+      queueMutex.lock();
+      while(!stopWorkers) {
+        if(!takeTask(thread, &task)) {
+          taskCondition.wait(&queueMutex);
+          continue;
+        }
+        queueMutex.unlock();
+        runTask(task);
+        queueMutex.lock();
+        if(--pendingTasks == 0) {
+          doneCondition.wakeAll();
+        }
+      }
+      queueMutex.unlock();
+    }
+
+  } // end of namespace sim
+} // end of namespace mars
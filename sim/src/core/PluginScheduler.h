@@ -0,0 +1,161 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file PluginScheduler.h
+ * \brief "PluginScheduler" decides when the simulation plugins are updated
+ * and runs independent plugins concurrently on a pool of worker threads.
+ */
+
+#ifndef PLUGIN_SCHEDULER_H
+#define PLUGIN_SCHEDULER_H
+
+#ifdef _PRINT_HEADER_
+  #warning "PluginScheduler.h"
+#endif
+
+#include <mars/interfaces/sim/PluginInterface.h>
+#include <mars/utils/Mutex.h>
+#include <mars/utils/WaitCondition.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace mars {
+  namespace sim {
+
+    class PluginWorker;
+
+    /**
+     * \brief Updates the plugins of the simulation.
+     *
+     * Plugins with an update period are updated with the accumulated time
+     * once the period elapsed. Without workers the due plugins are updated
+     * in the simulation thread in their registration order, which is the
+     * default. With workers the plugins are sorted into levels: a plugin
+     * is placed after every plugin it depends on or conflicts with, the
+     * plugins of one level are updated concurrently and a level starts
+     * once the previous one is finished. A plugin without schedule
+     * conflicts with all others and therefore keeps its serial position.
+     * In deterministic mode the plugins of a level are distributed over
+     * the threads in a fixed round robin order instead of being taken by
+     * the next idle thread, thus a plugin always runs on the same thread.
+     */
+    class PluginScheduler {
+    public:
+      PluginScheduler();
+      ~PluginScheduler();
+
+      /** 0 updates all plugins in the calling thread. */
+      void setNumWorkers(int numWorkers);
+      int getNumWorkers() const {return (int)workers.size();}
+
+      void setDeterministic(bool deterministic) {this->deterministic = deterministic;}
+
+      /**
+       * May be called from any thread, also from within a plugin update.
+       * The schedule takes effect with the next applySchedules call.
+       */
+      void setSchedule(interfaces::PluginInterface *plugin,
+                       const interfaces::PluginSchedule &schedule);
+      void removePlugin(interfaces::PluginInterface *plugin);
+      /** Called by the simulation thread before the plugins are updated. */
+      void applySchedules();
+
+      /**
+       * Has to be called whenever the active plugins change. May be called
+       * from a plugin update on a worker thread.
+       */
+      void invalidate();
+
+      /**
+       * Advances the time of the plugin by \a calc_ms.
+       * \return true if the plugin is due, \a time_ms is then set to the
+       *         time since its last update
+       */
+      bool isDue(interfaces::PluginInterface *plugin,
+                 interfaces::sReal calc_ms, interfaces::sReal *time_ms);
+
+      /**
+       * Updates the due plugins of \a plugins on the workers. The caller
+       * takes part in the update and returns when all plugins finished.
+       */
+      void updateParallel(const std::vector<interfaces::pluginStruct> &plugins,
+                          interfaces::sReal calc_ms, bool showTime);
+
+    private:
+      friend class PluginWorker;
+
+      struct Entry {
+        Entry() : scheduled(false), elapsed(0.0), timer(0.0), t_count(0) {}
+        bool scheduled;
+        interfaces::PluginSchedule schedule;
+        interfaces::sReal elapsed;
+        // update time statistics for "Simulator/debug time"
+        double timer;
+        int t_count;
+      };
+
+      struct Task {
+        interfaces::PluginInterface *plugin;
+        interfaces::sReal time_ms;
+        const std::string *name;
+        // 0 is the calling thread, workers start at 1; -1 for any thread
+        int thread;
+      };
+
+      std::map<interfaces::PluginInterface*, Entry> entries;
+      // schedules set since the last applySchedules
+      utils::Mutex scheduleMutex;
+      std::map<interfaces::PluginInterface*,
+               interfaces::PluginSchedule> pendingSchedules;
+      std::vector<PluginWorker*> workers;
+
+      // plugins of the last build sorted by level
+      std::vector<interfaces::pluginStruct> levelPlugins;
+      std::vector<int> levelOf;
+      // protected by queueMutex
+      bool levelsValid;
+
+      // the task queue of one level
+      utils::Mutex queueMutex;
+      utils::WaitCondition taskCondition, doneCondition;
+      std::deque<Task> tasks;
+      int pendingTasks;
+      bool stopWorkers, showTime, deterministic;
+      std::vector<Task> dueTasks;
+
+      void buildLevels(const std::vector<interfaces::pluginStruct> &plugins);
+      bool conflicts(const Entry &a, const Entry &b) const;
+      bool dependsOn(const Entry &a, const std::string &name) const;
+      void runLevel();
+      void runTask(const Task &task);
+      /** Takes the next queued task for \a thread, queueMutex is locked. */
+      bool takeTask(int thread, Task *task);
+      void workerLoop(int thread);
+      void stopAllWorkers();
+
+    }; // end of class PluginScheduler
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif  // PLUGIN_SCHEDULER_H
@@ -57,6 +57,7 @@
 #include "ScanningSonar.h"
 
 #include <mars/interfaces/sim/SimulatorInterface.h>
+#include <mars/data_broker/DataBrokerInterface.h>
 #include <mars/utils/MutexLocker.h>
 #include <mars/interfaces/Logging.hpp>
 
@@ -79,6 +80,21 @@ namespace mars {
     {
       control = c;
       next_sensor_id = 1;
+      // opt-in, plugins that hold a sensor pointer are only seen by the
+      // manager if the sensor counts its reads or they add a consumer
+      demandDriven = false;
+      idleTimeout = 1000.0;
+      receiverCheckTime = 0.0;
+      if(control->cfg) {
+        cfgDemandDriven = control->cfg->getOrCreateProperty("Simulator",
+                                                            "demand driven sensors",
+                                                            false, this);
+        cfgIdleTimeout = control->cfg->getOrCreateProperty("Simulator",
+                                                           "sensor idle time",
+                                                           idleTimeout, this);
+        demandDriven = cfgDemandDriven.bValue;
+        idleTimeout = cfgIdleTimeout.dValue;
+      }
       addSensorType("RaySensor",&RaySensor::instanciate);
       addSensorType("RotatingRaySensor",&RotatingRaySensor::instanciate);
       addSensorType("MultiLevelLaserRangeFinder",&MultiLevelLaserRangeFinder::instanciate);
@@ -125,6 +141,25 @@ namespace mars {
       //   RayGridSensor
     }
 
+    SensorManager::~SensorManager() {
+      if(control->cfg) {
+        control->cfg->unregisterFromParam(cfgDemandDriven.paramId, this);
+        control->cfg->unregisterFromParam(cfgIdleTimeout.paramId, this);
+      }
+    }
+
+    void SensorManager::cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property) {
+      MutexLocker locker(&iMutex);
+      if(_property.paramId == cfgDemandDriven.paramId) {
+        demandDriven = _property.bValue;
+        return;
+      }
+      if(_property.paramId == cfgIdleTimeout.paramId) {
+        idleTimeout = _property.dValue;
+        return;
+      }
+    }
+
 
     /**
      * \brief Gives information about core exchange data for sensors.
@@ -168,15 +203,15 @@ namespace mars {
     }
 
     unsigned long SensorManager::getSensorID(std::string name) const {
-      MutexLocker locker(&iMutex);
-      std::map<unsigned long, BaseSensor*>::const_iterator it;
-      for(it = simSensors.begin(); it != simSensors.end(); it++){
-        if(it->second->name.compare(name) == 0){
-          return it->first;
-        }
+      unsigned long id = sensorRegistry.getID(name);
+      if(!id) {
+        printf("Cannot find Sensor with name: \"%s\"\n",name.c_str());
       }
-      printf("Cannot find Sensor with name: \"%s\"\n",name.c_str());
-      return 0;
+      return id;
+    }
+
+    std::vector<unsigned long> SensorManager::getSensorIDs(const std::vector<std::string> &names) const {
+      return sensorRegistry.getIDs(names);
     }
 
     /**
@@ -191,6 +226,8 @@ namespace mars {
       if (iter != simSensors.end()) {
         tmpSensor = iter->second;
         simSensors.erase(iter);
+        sensorDemand.erase(index);
+        sensorRegistry.remove(index);
         if (tmpSensor)
           delete tmpSensor;
       }
@@ -229,13 +266,111 @@ namespace mars {
       map<unsigned long, BaseSensor*>::const_iterator iter;
 
       iter = simSensors.find(id);
-      if (iter != simSensors.end())
+      if (iter != simSensors.end()) {
+        iter->second->countRead();
+        sensorDemand[id].idleTime = 0.0;
         return iter->second->getSensorData(data);
+      }
 
       LOG_DEBUG("Cannot Find Sensor wirh id: %lu\n",id);
       return 0;
     }
 
+    int SensorManager::readSensorData(unsigned long id, sReal *data,
+                                      int size) const {
+      MutexLocker locker(&iMutex);
+      map<unsigned long, BaseSensor*>::const_iterator iter;
+
+      iter = simSensors.find(id);
+      if (iter == simSensors.end()) {
+        LOG_DEBUG("Cannot Find Sensor wirh id: %lu\n",id);
+        return 0;
+      }
+      iter->second->countRead();
+      sensorDemand[id].idleTime = 0.0;
+
+      int n = iter->second->readSensorData(data, size);
+      if(n >= 0) return n;
+      // the sensor only implements the allocating interface
+      sReal *tmp = 0;
+      n = iter->second->getSensorData(&tmp);
+      if(n > 0 && n <= size) memcpy(data, tmp, n*sizeof(sReal));
+      free(tmp);
+      return n > 0 ? n : 0;
+    }
+
+    void SensorManager::addSensorConsumer(unsigned long id) {
+      MutexLocker locker(&iMutex);
+      if(simSensors.find(id) != simSensors.end()) {
+        ++sensorDemand[id].consumers;
+      }
+    }
+
+    void SensorManager::removeSensorConsumer(unsigned long id) {
+      MutexLocker locker(&iMutex);
+      map<unsigned long, SensorDemand>::iterator iter = sensorDemand.find(id);
+      if(iter != sensorDemand.end() && iter->second.consumers > 0) {
+        --iter->second.consumers;
+      }
+    }
+
+    /**
+     * \brief Decides which sensors are updated in the next step.
+     *
+     * \details A demand driven sensor is active while it has consumers or
+     * data broker receivers, or was read within the last idle time. The
+     * first read of an inactive sensor returns its last values and keeps it
+     * active from then on. Sensors which are not demand driven are always
+     * updated.
+     */
+    void SensorManager::updateSensorActivity(sReal calc_ms) {
+      MutexLocker locker(&iMutex);
+      map<unsigned long, BaseSensor*>::iterator iter;
+      bool checkReceivers = false;
+
+      // counting the receivers walks all timers of the data broker
+      receiverCheckTime += calc_ms;
+      if(receiverCheckTime >= 100.0) {
+        receiverCheckTime = 0.0;
+        checkReceivers = (control->dataBroker != NULL);
+      }
+
+      for(iter = simSensors.begin(); iter != simSensors.end(); ++iter) {
+        BaseSensor *sensor = iter->second;
+        if(!demandDriven || !sensor->isDemandDriven()) {
+          sensor->setActive(true);
+          continue;
+        }
+        SensorDemand &demand = sensorDemand[iter->first];
+        // reads directly through the sensor pointer
+        if(sensor->getStats().reads != demand.reads) {
+          demand.reads = sensor->getStats().reads;
+          demand.idleTime = 0.0;
+        }
+        if(checkReceivers && !sensor->getProducedDataName().empty()) {
+          demand.receivers =
+            control->dataBroker->getReceiverCount(sensor->getProducedGroupName(),
+                                                  sensor->getProducedDataName());
+        }
+        demand.idleTime += calc_ms;
+        sensor->setActive(demand.consumers > 0 || demand.receivers > 0 ||
+                          demand.idleTime <= idleTimeout);
+      }
+    }
+
+    bool SensorManager::getSensorStats(unsigned long id,
+                                       SensorStats *stats) const {
+      MutexLocker locker(&iMutex);
+      map<unsigned long, BaseSensor*>::const_iterator iter;
+
+      iter = simSensors.find(id);
+      if(iter == simSensors.end()) return false;
+      *stats = iter->second->getStats();
+      stats->active = iter->second->isActive();
+      stats->consumers = sensorDemand[id].consumers;
+      return true;
+    }
+
 
     /**
      *\brief Returns the number of sensors that are currently present in the simulation.
@@ -266,6 +401,8 @@ namespace mars {
         delete sensor;
       }
       simSensors.clear();
+      sensorDemand.clear();
+      sensorRegistry.clear();
       if(clear_all) simSensorsReload.clear();
       next_sensor_id = 1;
     }
@@ -323,6 +460,7 @@ namespace mars {
       BaseSensor *sensor = ((*it).second)(this->control,config);
       iMutex.lock();
       simSensors[id] = sensor;
+      sensorRegistry.add(id, sensor->name, sensor);
       iMutex.unlock();
   
       if(!reload) {
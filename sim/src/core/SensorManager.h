@@ -38,9 +38,12 @@
   #warning "SensorManager.h"
 #endif
 
+#include "NameRegistry.h"
+
 #include <mars/interfaces/sim/SensorManagerInterface.h>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/utils/Mutex.h>
+#include <mars/cfg_manager/CFGManagerInterface.h>
 #include <configmaps/ConfigData.h>
 
 namespace mars {
@@ -66,7 +69,8 @@ namespace mars {
      * is only guaranteed by calling it within the main thread (update 
      * callback from \c gui_thread).
      */
-    class SensorManager : public interfaces::SensorManagerInterface {
+    class SensorManager : public interfaces::SensorManagerInterface,
+                          public cfg_manager::CFGClient {
     public:
 
       /**
@@ -79,7 +83,7 @@ namespace mars {
       /**
        * \brief Destructor.
        */
-      virtual ~SensorManager(){}
+      virtual ~SensorManager();
   
       /**
        * \brief Add a sensor to the simulation.
@@ -138,6 +142,7 @@ namespace mars {
        */
       virtual interfaces::BaseSensor* getSimSensor(unsigned long index) const;
       unsigned long getSensorID(std::string name) const; 
+      virtual std::vector<unsigned long> getSensorIDs(const std::vector<std::string> &names) const;
 #if 0 
 
       /**
@@ -168,6 +173,16 @@ namespace mars {
        * \param index The index of the sensor to get the data 
        */
       virtual int getSensorData(unsigned long id, interfaces::sReal **data) const;
+      virtual int readSensorData(unsigned long id, interfaces::sReal *data,
+                                 int size) const;
+
+      virtual void addSensorConsumer(unsigned long id);
+      virtual void removeSensorConsumer(unsigned long id);
+      virtual void updateSensorActivity(interfaces::sReal calc_ms);
+      virtual bool getSensorStats(unsigned long id,
+                                  interfaces::SensorStats *stats) const;
+
+      virtual void cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property);
 
       /**
        *\brief Returns the number of sensors that are currently present in the simulation.
@@ -210,12 +225,26 @@ namespace mars {
   
     private:
 
+      //! what keeps a demand driven sensor active
+      struct SensorDemand {
+        SensorDemand() : consumers(0), receivers(0), reads(0), idleTime(0.0) {}
+        int consumers;
+        int receivers;
+        //! read count of the sensor at the last activity update
+        unsigned long reads;
+        //! simulation time since the last read in ms
+        interfaces::sReal idleTime;
+      };
+
       //! the id of the next sensor added to the simulation
       unsigned long next_sensor_id;
 
       //! a containter for all sensors currently present in the simulation
       std::map<unsigned long, interfaces::BaseSensor*> simSensors;
 
+      //! hashed name and id indices of simSensors
+      NameRegistry<interfaces::BaseSensor> sensorRegistry;
+
       //! a containter for all sensors that are loaded after a reset of the simulation
       std::vector<SensorReloadHelper> simSensorsReload;
   
@@ -226,6 +255,15 @@ namespace mars {
       //! a mutex fot the sensor containters
       mutable utils::Mutex iMutex;
 
+      //! demand of all sensors, written by const reads as well
+      mutable std::map<unsigned long, SensorDemand> sensorDemand;
+      bool demandDriven;
+      //! time a sensor stays active after it was read in ms
+      interfaces::sReal idleTimeout;
+      //! querying the data broker receivers is done at a lower rate
+      interfaces::sReal receiverCheckTime;
+      cfg_manager::cfgPropertyStruct cfgDemandDriven, cfgIdleTimeout;
+
       //std::map<const std::string,BaseSensor* (*)(interfaces::ControlCenter*,const unsigned long int,const std::string,QDomElement*)> availibleSensors;
       //std::map<const std::string,BaseSensor* (*)(interfaces::ControlCenter*,const unsigned long int, const std::string, mars::ConfigMap*)> availableSensors2;
       std::map<const std::string, interfaces::BaseSensor* (*)(interfaces::ControlCenter*, interfaces::BaseConfig*)> availableSensors;
@@ -24,6 +24,7 @@
 #include <mars/utils/Color.h>
 #include <mars/utils/MutexLocker.h>
 #include <mars/interfaces/terrainStruct.h>
+#include <mars/interfaces/TerrainDirtyRegions.h>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
@@ -152,6 +153,7 @@ namespace mars {
       }
       if (sNode.terrain) {
         if(sNode.terrain->pixelData) free(sNode.terrain->pixelData);
+        delete sNode.terrain->dirtyRegions;
         delete sNode.terrain;
         sNode.terrain = 0;
       }
@@ -38,6 +38,8 @@
 #include "Controller.h"
 
 #include <mars/utils/misc.h>
+#include <mars/utils/MutexLocker.h>
+#include <mars/utils/AllocationTracker.h>
 #include <mars/interfaces/SceneParseException.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/sim/LoadCenter.h>
@@ -50,6 +52,7 @@
 #include <signal.h>
 #include <getopt.h>
 #include <stdexcept>
+#include <cstdlib>
 #include <algorithm>
 #include <cctype> // for tolower()
 
@@ -79,7 +82,8 @@ namespace mars {
     Simulator::Simulator(lib_manager::LibManager *theManager) :
       lib_manager::LibInterface(theManager),
       exit_sim(false), allow_draw(true),
-      sync_graphics(false), physics_mutex_count(0), physics(0) {
+      sync_graphics(false), snapshotVersion(0), consumedSnapshotVersion(0),
+      physics_mutex_count(0), physics(0) {
 
       config_dir = DEFAULT_CONFIG_DIR;
       calc_time = 0;
@@ -97,6 +101,16 @@ namespace mars {
       sim_fault = false;
       // set the calculation step size in ms
       calc_ms      = 10; //defaultCFG->getInt("physics", "calc_ms", 10);
+      physicsSubsteps = 1;
+      calmSteps = 0;
+      adaptive_substeps = false;
+      deterministic = false;
+      random_seed = 0;
+      max_substeps = 8;
+      max_penetration = 0.01;
+      max_step_motion = 0.05;
+      motor_period = 0.0;
+      motor_time = 0.0;
       my_real_time = 0;
       show_time = 0;
       // to synchronise drawing and physics
@@ -118,6 +132,17 @@ namespace mars {
       control->sim = (SimulatorInterface*)this;
       control->cfg = 0;//defaultCFG;
       dbSimTimePackage.add("simTime", 0.);
+      dbAllocationsId = 0;
+      if(AllocationTracker::isEnabled()) {
+        for(int i=0; i<ALLOCATION_TAG_COUNT; ++i) {
+          std::string tag = AllocationTracker::getTagName((AllocationTag)i);
+          dbAllocationsPackage.add(tag + "/count", 0ul);
+          dbAllocationsPackage.add(tag + "/bytes", 0ul);
+        }
+        dbAllocationsPackage.add("total/count", 0ul);
+        dbAllocationsPackage.add("total/bytes", 0ul);
+        AllocationTracker::getStats(&lastAllocations);
+      }
       // load optional libs
       checkOptionalDependency("data_broker");
       checkOptionalDependency("cfg_manager");
@@ -154,6 +179,8 @@ namespace mars {
         control->cfg->writeConfig(saveFile.c_str(), "Simulator");
       }
       // TODO: do we need to delete control?
+      if(control->graphics)
+        control->graphics->removeDebugDrawInterface(this);
       libManager->releaseLibrary("mars_graphics");
       libManager->releaseLibrary("cfg_manager");
       libManager->releaseLibrary("data_broker");
@@ -176,6 +203,12 @@ namespace mars {
                                                       NULL,
                                                       data_broker::DATA_PACKAGE_READ_FLAG);
           getTimeMutex.unlock();
+          if(AllocationTracker::isEnabled()) {
+            dbAllocationsId = control->dataBroker->pushData("mars_sim", "allocations",
+                                                            dbAllocationsPackage,
+                                                            NULL,
+                                                            data_broker::DATA_PACKAGE_READ_FLAG);
+          }
           control->dataBroker->createTimer("mars_sim/simTimer");
           control->dataBroker->createTrigger("mars_sim/prePhysicsUpdate");
           control->dataBroker->createTrigger("mars_sim/postPhysicsUpdate");
@@ -252,17 +285,30 @@ namespace mars {
 
       if (control->graphics) {
         control->graphics->addGraphicsUpdateInterface((GraphicsUpdateInterface*)this);
+        control->graphics->addDebugDrawInterface(this);
       }
       // init the physics-engine
       //Convention startPhysics function
       physics = PhysicsMapper::newWorldPhysics(control);
+      physics->deterministic = deterministic;
+      physics->random_seed = random_seed;
+      applySeed();
       physics->initTheWorld();
       // the physics step_size is in seconds
-      physics->step_size = calc_ms/1000.;
-      physics->fast_step = false;
+      physics->step_size = calc_ms/1000./physicsSubsteps;
+      physics->fast_step = cfgFaststep.bValue;
+      physics->quickstep_iterations = cfgIterations.iValue;
+      physics->quickstep_sor = cfgSor.dValue;
+      physics->adaptive_iterations = cfgAdaptiveIterations.bValue;
+      physics->max_iterations = cfgMaxIterations.iValue;
+      physics->max_constraint_error = cfgConstraintError.dValue;
 
       physics->world_erp = cfgWorldErp.dValue;
       physics->world_cfm = cfgWorldCfm.dValue;
+      physics->body_sleeping = cfgBodySleeping.bValue;
+      physics->sleep_linear_threshold = cfgSleepLinear.dValue;
+      physics->sleep_angular_threshold = cfgSleepAngular.dValue;
+      physics->sleep_time = cfgSleepTime.dValue;
 
       gravity.x() = cfgGX.dValue;
       gravity.y() = cfgGY.dValue;
@@ -283,6 +329,7 @@ namespace mars {
         newPlugins[i].p_interface->init();
       }
       newPlugins.clear();      
+      pluginScheduler.invalidate();
 
       // load scene
       while(arg_v_scene_name.size() > 0) {
@@ -377,6 +424,10 @@ namespace mars {
         simulationStatus = STEPPING;
       }
 
+      // stage times in microseconds, see getStepTimes
+      long long stageStart = utils::getTimeMicro(), stageEnd;
+      interfaces::StepTimes times;
+
 #ifdef DEBUG_TIME
       long startTime = utils::getTime();
 
@@ -384,14 +435,49 @@ namespace mars {
       if(control->dataBroker) {
         control->dataBroker->trigger("mars_sim/prePhysicsUpdate");
       }
-      physics->stepTheWorld();
+      {
+        AllocationScope allocationScope(ALLOCATION_TAG_SENSORS);
+        control->sensors->updateSensorActivity(calc_ms);
+      }
+      stageEnd = utils::getTimeMicro();
+      times.sensors = stageEnd - stageStart;
+      stageStart = stageEnd;
+      {
+        AllocationScope allocationScope(ALLOCATION_TAG_PHYSICS);
+        for(int i=0; i<physicsSubsteps; ++i) {
+          physics->stepTheWorld();
+        }
+        if(adaptive_substeps) adaptSubsteps();
+      }
+      stageEnd = utils::getTimeMicro();
+      times.physics = stageEnd - stageStart;
+      stageStart = stageEnd;
 #ifdef DEBUG_TIME
       LOG_DEBUG("Step World: %ld", getTimeDiff(startTime));
 #endif
 
-      control->joints->updateJoints(calc_ms);
-      control->motors->updateMotors(calc_ms);
+      {
+        AllocationScope allocationScope(ALLOCATION_TAG_PHYSICS);
+        control->joints->updateJoints(calc_ms);
+      }
+      stageEnd = utils::getTimeMicro();
+      times.joints = stageEnd - stageStart;
+      stageStart = stageEnd;
+      // the motors get the time since their last update
+      motor_time += calc_ms;
+      if(motor_time + 1e-6 >= motor_period) {
+        AllocationScope allocationScope(ALLOCATION_TAG_PHYSICS);
+        control->motors->updateMotors(motor_time);
+        motor_time = 0.0;
+      }
+      stageEnd = utils::getTimeMicro();
+      times.motors = stageEnd - stageStart;
+      stageStart = stageEnd;
+      // the controllers and sensors decimate with their own rates
       control->controllers->updateControllers(calc_ms);
+      stageEnd = utils::getTimeMicro();
+      times.controllers = stageEnd - stageStart;
+      stageStart = stageEnd;
 
       if(show_time)
         time = utils::getTime();
@@ -414,37 +500,62 @@ namespace mars {
           avg_log_time = 0.0;
         }
       }
+      stageEnd = utils::getTimeMicro();
+      times.dataBroker = stageEnd - stageStart;
+      stageStart = stageEnd;
 
       pluginLocker.lockForRead();
+      {
+        AllocationScope allocationScope(ALLOCATION_TAG_PLUGINS);
+        pluginScheduler.applySchedules();
 
-      // It is possible for plugins to call switchPluginUpdateMode during
-      // the update call and get removed from the activePlugins list there.
-      // We use erased_active to notify this loop about an erasure.
-      for(unsigned int i = 0; i < activePlugins.size();) {
-        erased_active = false;
-        if(show_time)
-          time = utils::getTime();
-        
-        activePlugins[i].p_interface->update(calc_ms);
-
-        if(!erased_active) {
-          if(show_time) {
-            time = getTimeDiff(time);
-            activePlugins[i].timer += time;
-            activePlugins[i].t_count++;
-            if(activePlugins[i].t_count > 20) {
-              activePlugins[i].timer /= activePlugins[i].t_count;
-              activePlugins[i].t_count = 0;
-              fprintf(stderr, "debug_time: %s: %g\n",
-                      activePlugins[i].name.c_str(),
-                      activePlugins[i].timer);
-              activePlugins[i].timer = 0.0;
+        if(pluginScheduler.getNumWorkers() > 0) {
+          // the scheduler updates its own copy of the plugin list
+          pluginScheduler.updateParallel(activePlugins, calc_ms, show_time);
+        } else {
+          // It is possible for plugins to call switchPluginUpdateMode during
+          // the update call and get removed from the activePlugins list there.
+          // We use erased_active to notify this loop about an erasure.
+          for(unsigned int i = 0; i < activePlugins.size();) {
+            erased_active = false;
+            sReal pluginTime;
+            if(!pluginScheduler.isDue(activePlugins[i].p_interface, calc_ms,
+                                      &pluginTime)) {
+              ++i;
+              continue;
+            }
+            if(show_time)
+              time = utils::getTime();
+
+            activePlugins[i].p_interface->update(pluginTime);
+
+            if(!erased_active) {
+              if(show_time) {
+                time = getTimeDiff(time);
+                activePlugins[i].timer += time;
+                activePlugins[i].t_count++;
+                if(activePlugins[i].t_count > 20) {
+                  activePlugins[i].timer /= activePlugins[i].t_count;
+                  activePlugins[i].t_count = 0;
+                  fprintf(stderr, "debug_time: %s: %g\n",
+                          activePlugins[i].name.c_str(),
+                          activePlugins[i].timer);
+                  activePlugins[i].timer = 0.0;
+                }
+              }
+              ++i;
             }
           }
-          ++i;
         }
       }
       pluginLocker.unlock();
+      stageEnd = utils::getTimeMicro();
+      times.plugins = stageEnd - stageStart;
+      stageStart = stageEnd;
+      if(control->graphics) {
+        AllocationScope allocationScope(ALLOCATION_TAG_GRAPHICS);
+        publishSnapshot();
+      }
       if (sync_graphics) {
         calc_time += calc_ms;
         if (calc_time >= sync_time) {
@@ -459,6 +570,27 @@ namespace mars {
       if(control->dataBroker) {
         control->dataBroker->trigger("mars_sim/postPhysicsUpdate");
       }
+      stageEnd = utils::getTimeMicro();
+      times.graphics = stageEnd - stageStart;
+
+      getTimeMutex.lock();
+      ++stepTimes.steps;
+      stepTimes.sensors += times.sensors;
+      stepTimes.physics += times.physics;
+      stepTimes.joints += times.joints;
+      stepTimes.motors += times.motors;
+      stepTimes.controllers += times.controllers;
+      stepTimes.dataBroker += times.dataBroker;
+      stepTimes.plugins += times.plugins;
+      stepTimes.graphics += times.graphics;
+      stepTimes.total += (times.sensors + times.physics + times.joints +
+                          times.motors + times.controllers +
+                          times.dataBroker + times.plugins + times.graphics);
+      getTimeMutex.unlock();
+
+      if(AllocationTracker::isEnabled()) {
+        publishAllocations();
+      }
 
       if(setState) {
         simulationStatus = oldState;
@@ -789,6 +921,7 @@ namespace mars {
         newPlugins[i].p_interface->init();
       }
       newPlugins.clear();
+      pluginScheduler.invalidate();
       pluginLocker.unlock();
 
 
@@ -836,6 +969,7 @@ namespace mars {
 
       sceneHasChanged(true);
       physics->freeTheWorld();
+      applySeed();
       physics->initTheWorld();
       physicsThreadUnlock();
     }
@@ -964,10 +1098,62 @@ namespace mars {
       return physics;
     }
 
+    void Simulator::publishSnapshot() {
+      WorldSnapshot &snapshot = snapshots.getWriteBuffer();
+      snapshot.version = ++snapshotVersion;
+      getTimeMutex.lock();
+      snapshot.simTime = dbSimTimePackage[0].d;
+      getTimeMutex.unlock();
+
+      snapshot.poses.clear();
+      control->nodes->fillDrawPoses(&snapshot.poses, snapshot.version,
+                                    consumedSnapshotVersion.load());
+      snapshot.debugDraw.clear();
+      physicsDebugDrawMutex.lock();
+      for(size_t i=0; i<physicsDebugDraws.size(); ++i) {
+        physicsDebugDraws[i]->fillDebugDraw(&snapshot.debugDraw);
+      }
+      physicsDebugDrawMutex.unlock();
+      snapshots.publish();
+    }
+
+    void Simulator::preGraphicsUpdate(void) {
+      // Without stepping nobody publishes the changes done while the
+      // simulation is paused. The graphics does it itself, but only if the
+      // physics lock is free; a frame never waits for the physics.
+      if(simulationStatus == STOPPED && control->nodes &&
+         physicsMutex.tryLock() == utils::MUTEX_ERROR_NO_ERROR) {
+        publishSnapshot();
+        physicsMutex.unlock();
+      }
+      if(snapshots.update()) {
+        const WorldSnapshot &snapshot = snapshots.getReadBuffer();
+        control->graphics->setDrawObjectPoses(snapshot.poses);
+        consumedSnapshotVersion.store(snapshot.version);
+      }
+    }
+
     void Simulator::postGraphicsUpdate(void) {
       finishedDraw();
     }
 
+    void Simulator::fillDebugDraw(DebugDrawBuffer *buffer) {
+      // the read buffer stays valid until the next preGraphicsUpdate
+      buffer->append(snapshots.getReadBuffer().debugDraw);
+    }
+
+    void Simulator::addPhysicsDebugDrawInterface(DebugDrawInterface *iface) {
+      MutexLocker locker(&physicsDebugDrawMutex);
+      physicsDebugDraws.push_back(iface);
+    }
+
+    void Simulator::removePhysicsDebugDrawInterface(DebugDrawInterface *iface) {
+      MutexLocker locker(&physicsDebugDrawMutex);
+      std::vector<DebugDrawInterface*>::iterator it;
+      it = std::find(physicsDebugDraws.begin(), physicsDebugDraws.end(), iface);
+      if(it != physicsDebugDraws.end()) physicsDebugDraws.erase(it);
+    }
+
     void Simulator::exitMars(void) {
       stepping_mutex.lock();
       kill_sim = 1;
@@ -1014,6 +1200,7 @@ namespace mars {
       std::vector<pluginStruct>::iterator p_iter;
       bool afound = false;
       bool gfound = false;
+      MutexLocker locker(&pluginModeMutex);
 
       for(p_iter=activePlugins.begin(); p_iter!=activePlugins.end();
           p_iter++) {
@@ -1047,6 +1234,53 @@ namespace mars {
           break;
         }
       }
+      pluginScheduler.invalidate();
+    }
+
+    /**
+     * Steps the physics \a substeps times per calc_ms. The joints derive
+     * their erp and cfm from the physics step size, therefore they are
+     * updated as well.
+     */
+    void Simulator::setPhysicsSubsteps(int substeps) {
+      physicsSubsteps = substeps;
+      calmSteps = 0;
+      // the physics step_size is defined in seconds
+      if(physics) physics->step_size = calc_ms*0.001/physicsSubsteps;
+      if(control->joints) control->joints->changeStepSize();
+    }
+
+    /**
+     * Doubles the number of physics sub-steps if a contact penetrates too
+     * deep or the fastest body moves too far within one sub-step. Halves
+     * them again once the scene stayed calm enough for the doubled step
+     * size for some steps. The change applies from the next step on.
+     */
+    void Simulator::adaptSubsteps(void) {
+      sReal penetration, velocity;
+      physics->getStepStatistics(&penetration, &velocity);
+      sReal motion = velocity*calc_ms*0.001/physicsSubsteps;
+      int substeps = physicsSubsteps;
+
+      if(penetration > max_penetration || motion > max_step_motion) {
+        calmSteps = 0;
+        if(substeps < max_substeps) substeps *= 2;
+      }
+      else if(substeps > 1 && penetration < 0.5*max_penetration &&
+              2*motion < 0.5*max_step_motion) {
+        if(++calmSteps >= 10) substeps /= 2;
+      }
+      else {
+        calmSteps = 0;
+      }
+
+      if(substeps > max_substeps) substeps = max_substeps;
+      if(substeps != physicsSubsteps) setPhysicsSubsteps(substeps);
+    }
+
+    void Simulator::setPluginSchedule(PluginInterface *pl,
+                                      const PluginSchedule &schedule) {
+      pluginScheduler.setSchedule(pl, schedule);
     }
 
     /**
@@ -1157,6 +1391,7 @@ namespace mars {
           break;
         }
       }
+      pluginScheduler.removePlugin(pl);
 
       pluginLocker.unlock();
     }
@@ -1259,8 +1494,34 @@ namespace mars {
                            printf("cfgUpdateProperty...\n");      
       if(_property.paramId == cfgCalcMs.paramId) {
         calc_ms = _property.dValue;
-        if(physics) physics->step_size = calc_ms*0.001; // The physics step_size is defined in seconds.
-        if(control->joints) control->joints->changeStepSize();
+        setPhysicsSubsteps(physicsSubsteps);
+        return;
+      }
+
+      if(_property.paramId == cfgAdaptiveSubsteps.paramId) {
+        adaptive_substeps = _property.bValue;
+        if(!adaptive_substeps) setPhysicsSubsteps(1);
+        return;
+      }
+
+      if(_property.paramId == cfgMaxSubsteps.paramId) {
+        max_substeps = _property.iValue < 1 ? 1 : _property.iValue;
+        if(physicsSubsteps > max_substeps) setPhysicsSubsteps(max_substeps);
+        return;
+      }
+
+      if(_property.paramId == cfgMaxPenetration.paramId) {
+        max_penetration = _property.dValue;
+        return;
+      }
+
+      if(_property.paramId == cfgMaxStepMotion.paramId) {
+        max_step_motion = _property.dValue;
+        return;
+      }
+
+      if(_property.paramId == cfgMotorPeriod.paramId) {
+        motor_period = _property.dValue;
         return;
       }
 
@@ -1279,6 +1540,29 @@ namespace mars {
         return;
       }
 
+      if(_property.paramId == cfgPluginThreads.paramId) {
+        pluginLocker.lockForWrite();
+        pluginScheduler.setNumWorkers(_property.iValue);
+        pluginLocker.unlock();
+        return;
+      }
+
+      // the seed takes effect with the next reset
+      if(_property.paramId == cfgDeterministic.paramId) {
+        pluginLocker.lockForWrite();
+        deterministic = _property.bValue;
+        pluginScheduler.setDeterministic(deterministic);
+        pluginLocker.unlock();
+        if(physics) physics->deterministic = deterministic;
+        return;
+      }
+
+      if(_property.paramId == cfgRandomSeed.paramId) {
+        random_seed = _property.iValue;
+        if(physics) physics->random_seed = random_seed;
+        return;
+      }
+
       if(_property.paramId == cfgSyncGui.paramId) {
         this->setSyncThreads(_property.bValue);
       
@@ -1323,6 +1607,51 @@ namespace mars {
         return;
       }
 
+      if(_property.paramId == cfgIterations.paramId) {
+        if(physics) physics->quickstep_iterations = _property.iValue;
+        return;
+      }
+
+      if(_property.paramId == cfgSor.paramId) {
+        if(physics) physics->quickstep_sor = _property.dValue;
+        return;
+      }
+
+      if(_property.paramId == cfgAdaptiveIterations.paramId) {
+        if(physics) physics->adaptive_iterations = _property.bValue;
+        return;
+      }
+
+      if(_property.paramId == cfgMaxIterations.paramId) {
+        if(physics) physics->max_iterations = _property.iValue;
+        return;
+      }
+
+      if(_property.paramId == cfgConstraintError.paramId) {
+        if(physics) physics->max_constraint_error = _property.dValue;
+        return;
+      }
+
+      if(_property.paramId == cfgBodySleeping.paramId) {
+        physics->body_sleeping = _property.bValue;
+        return;
+      }
+
+      if(_property.paramId == cfgSleepLinear.paramId) {
+        physics->sleep_linear_threshold = _property.dValue;
+        return;
+      }
+
+      if(_property.paramId == cfgSleepAngular.paramId) {
+        physics->sleep_angular_threshold = _property.dValue;
+        return;
+      }
+
+      if(_property.paramId == cfgSleepTime.paramId) {
+        physics->sleep_time = _property.dValue;
+        return;
+      }
+
       if(_property.paramId == cfgVisRep.paramId) {
         control->nodes->setVisualRep(0, _property.iValue);
         return;
@@ -1336,6 +1665,26 @@ namespace mars {
       cfgCalcMs = control->cfg->getOrCreateProperty("Simulator", "calc_ms",
                                                     calc_ms, this);
       calc_ms = cfgCalcMs.dValue;
+
+      cfgAdaptiveSubsteps = control->cfg->getOrCreateProperty("Simulator", "adaptive substeps",
+                                                              false, this);
+      adaptive_substeps = cfgAdaptiveSubsteps.bValue;
+
+      cfgMaxSubsteps = control->cfg->getOrCreateProperty("Simulator", "max substeps",
+                                                         (int)8, this);
+      max_substeps = cfgMaxSubsteps.iValue < 1 ? 1 : cfgMaxSubsteps.iValue;
+
+      cfgMaxPenetration = control->cfg->getOrCreateProperty("Simulator", "substep penetration",
+                                                            0.01, this);
+      max_penetration = cfgMaxPenetration.dValue;
+
+      cfgMaxStepMotion = control->cfg->getOrCreateProperty("Simulator", "substep motion",
+                                                           0.05, this);
+      max_step_motion = cfgMaxStepMotion.dValue;
+
+      cfgMotorPeriod = control->cfg->getOrCreateProperty("Simulator", "motor period",
+                                                         0.0, this);
+      motor_period = cfgMotorPeriod.dValue;
       cfgFaststep = control->cfg->getOrCreateProperty("Simulator", "faststep",
                                                       false, this);
       cfgRealtime = control->cfg->getOrCreateProperty("Simulator", "realtime calc",
@@ -1369,6 +1718,33 @@ namespace mars {
       cfgWorldCfm = control->cfg->getOrCreateProperty("Simulator", "world cfm",
                                                       1e-10, this);
 
+      cfgIterations = control->cfg->getOrCreateProperty("Simulator", "quickstep iterations",
+                                                        (int)20, this);
+
+      cfgSor = control->cfg->getOrCreateProperty("Simulator", "quickstep sor",
+                                                 1.3, this);
+
+      cfgAdaptiveIterations = control->cfg->getOrCreateProperty("Simulator", "adaptive iterations",
+                                                                false, this);
+
+      cfgMaxIterations = control->cfg->getOrCreateProperty("Simulator", "max iterations",
+                                                           (int)100, this);
+
+      cfgConstraintError = control->cfg->getOrCreateProperty("Simulator", "max constraint error",
+                                                             0.001, this);
+
+      cfgBodySleeping = control->cfg->getOrCreateProperty("Simulator", "body sleeping",
+                                                          false, this);
+
+      cfgSleepLinear = control->cfg->getOrCreateProperty("Simulator", "sleep linear threshold",
+                                                         0.01, this);
+
+      cfgSleepAngular = control->cfg->getOrCreateProperty("Simulator", "sleep angular threshold",
+                                                          0.01, this);
+
+      cfgSleepTime = control->cfg->getOrCreateProperty("Simulator", "sleep time",
+                                                       0.5, this);
+
       cfgVisRep = control->cfg->getOrCreateProperty("Simulator", "visual rep.",
                                                     (int)1, this);
 
@@ -1379,6 +1755,20 @@ namespace mars {
                                         "abort", this);
       show_time = cfgDebugTime.bValue;
 
+      // 0 keeps the serial plugin update
+      cfgPluginThreads = control->cfg->getOrCreateProperty("Simulator", "plugin threads",
+                                                           (int)0, this);
+      pluginScheduler.setNumWorkers(cfgPluginThreads.iValue);
+
+      // two runs of a scene give the same result, see isDeterministic
+      cfgDeterministic = control->cfg->getOrCreateProperty("Simulator", "deterministic",
+                                                           false, this);
+      deterministic = cfgDeterministic.bValue;
+      pluginScheduler.setDeterministic(deterministic);
+
+      cfgRandomSeed = control->cfg->getOrCreateProperty("Simulator", "random seed",
+                                                        (int)0, this);
+      random_seed = cfgRandomSeed.iValue;
     }
 
     void Simulator::receiveData(const data_broker::DataInfo &info,
@@ -1434,12 +1824,14 @@ namespace mars {
 
     unsigned long Simulator::getTime() {
       unsigned long returnTime;
+      // the time stamps of deterministic runs start at zero
+      unsigned long startTime = deterministic ? 0 : realStartTime;
       getTimeMutex.lock();
       if(cfgUseNow.bValue) {
-        returnTime = realStartTime+dbSimTimePackage[0].d;
+        returnTime = startTime+dbSimTimePackage[0].d;
       }
       else {
-        returnTime = realStartTime+dbSimTimePackage[0].d;
+        returnTime = startTime+dbSimTimePackage[0].d;
       }
       getTimeMutex.unlock();
       return returnTime;
@@ -1451,6 +1843,48 @@ namespace mars {
       return calc_ms;
     }
 
+    void Simulator::getStepTimes(StepTimes *times, bool reset) {
+      MutexLocker locker(&getTimeMutex);
+      *times = stepTimes;
+      if(reset) stepTimes.clear();
+    }
+
+    bool Simulator::isDeterministic() const {
+      return deterministic;
+    }
+
+    /**
+     * Seeds the C random generator used by plugins and scenes. The physics
+     * seeds its own generator when the world is created.
+     */
+    void Simulator::applySeed() {
+      if(!deterministic) return;
+      srand(random_seed);
+    }
+
+    /**
+     * Publishes the allocations of the last step by tag as
+     * "mars_sim/allocations". The allocations of the publishing itself
+     * are counted for the next step.
+     */
+    void Simulator::publishAllocations() {
+      AllocationStats stats, step;
+      AllocationTracker::getStats(&stats);
+      step = stats - lastAllocations;
+      lastAllocations = stats;
+      if(!control->dataBroker || !dbAllocationsId) return;
+
+      for(int i=0; i<ALLOCATION_TAG_COUNT; ++i) {
+        dbAllocationsPackage.set(2*i, (unsigned long)step.count[i]);
+        dbAllocationsPackage.set(2*i+1, (unsigned long)step.bytes[i]);
+      }
+      dbAllocationsPackage.set(2*ALLOCATION_TAG_COUNT,
+                               (unsigned long)step.getTotalCount());
+      dbAllocationsPackage.set(2*ALLOCATION_TAG_COUNT+1,
+                               (unsigned long)step.getTotalBytes());
+      control->dataBroker->pushData(dbAllocationsId, dbAllocationsPackage);
+    }
+
   } // end of namespace sim
 
   namespace interfaces {
@@ -39,12 +39,19 @@
 #include <mars/utils/Mutex.h>
 #include <mars/utils/WaitCondition.h>
 #include <mars/utils/ReadWriteLock.h>
+#include <mars/utils/TripleBuffer.h>
+#include <mars/utils/AllocationTracker.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
 #include <mars/interfaces/sim/PhysicsInterface.h>
 #include <mars/interfaces/sim/PluginInterface.h>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/graphics/GraphicsUpdateInterface.h>
+#include <mars/interfaces/graphics/DebugDrawInterface.h>
+#include <mars/interfaces/sim/WorldSnapshot.h>
 
+#include "PluginScheduler.h"
+
+#include <atomic>
 #include <iostream>
 
 
@@ -64,6 +71,7 @@ namespace mars {
     class Simulator : public utils::Thread,
                       public interfaces::SimulatorInterface,
                       public interfaces::GraphicsUpdateInterface,
+                      public interfaces::DebugDrawInterface,
                       public lib_manager::LibInterface,
                       public cfg_manager::CFGClient,
                       public data_broker::ReceiverInterface {
@@ -174,7 +182,11 @@ namespace mars {
       virtual bool hasSimFault() const; ///< Checks if the physic simulation thread has been stopped caused by an ODE error.
 
       //graphics
+      virtual void preGraphicsUpdate(void);
       virtual void postGraphicsUpdate(void);
+      virtual void fillDebugDraw(interfaces::DebugDrawBuffer *buffer);
+      virtual void addPhysicsDebugDrawInterface(interfaces::DebugDrawInterface *iface);
+      virtual void removePhysicsDebugDrawInterface(interfaces::DebugDrawInterface *iface);
       virtual void finishedDraw(void);
       void allowDraw(void); ///< Allows the osgWidget to draw a frame.
 
@@ -190,6 +202,8 @@ namespace mars {
       virtual void addPlugin(const interfaces::pluginStruct& plugin);
       virtual void removePlugin(interfaces::PluginInterface *pl);
       virtual void switchPluginUpdateMode(int mode, interfaces::PluginInterface *pl);
+      virtual void setPluginSchedule(interfaces::PluginInterface *pl,
+                                     const interfaces::PluginSchedule &schedule);
       virtual void sendDataToPlugin(int plugin_index, void* data);
 
       //  virtual double initTimer(void);
@@ -223,6 +237,11 @@ namespace mars {
 
       virtual double getCalcMs();
 
+      virtual void getStepTimes(interfaces::StepTimes *times,
+                                bool reset = false);
+
+      virtual bool isDeterministic() const;
+
     private:
 
       struct LoadOptions {
@@ -259,6 +278,16 @@ namespace mars {
       bool sync_graphics;
       int cameraMenuCheckedIndex;
 
+      // world snapshot handed from the physics to the graphics thread;
+      // the writer always holds physicsMutex
+      void publishSnapshot();
+      utils::TripleBuffer<interfaces::WorldSnapshot> snapshots;
+      unsigned long snapshotVersion;
+      // last version applied by the graphics thread
+      std::atomic<unsigned long> consumedSnapshotVersion;
+      std::vector<interfaces::DebugDrawInterface*> physicsDebugDraws;
+      utils::Mutex physicsDebugDrawMutex;
+
       // threads
       bool erased_active;
       utils::ReadWriteLock pluginLocker;
@@ -270,6 +299,8 @@ namespace mars {
       utils::Mutex stepping_mutex; ///< Used for preventing active waiting for a single step or start event.
       utils::WaitCondition stepping_wc; ///< Used for preventing active waiting for a single step or start event.
       utils::Mutex getTimeMutex;
+      // protected by getTimeMutex
+      interfaces::StepTimes stepTimes;
       int physics_mutex_count;
       double avg_log_time;
       int count;
@@ -278,11 +309,25 @@ namespace mars {
       // physics
       interfaces::PhysicsInterface *physics;
       double calc_ms;
+      // the physics is stepped physicsSubsteps times per calc_ms
+      int physicsSubsteps, calmSteps;
+      bool adaptive_substeps;
+      // seeds the random generators and fixes the update orders
+      bool deterministic;
+      unsigned long random_seed;
+      void applySeed(void);
+      int max_substeps;
+      interfaces::sReal max_penetration, max_step_motion;
+      // the motors are updated every motor_period ms
+      interfaces::sReal motor_period, motor_time;
+      void setPhysicsSubsteps(int substeps);
+      void adaptSubsteps(void);
       int load_option;
       int std_port; ///< Controller port (default value: 1600)
       utils::Vector gravity;
       unsigned long dbPhysicsUpdateId;
       unsigned long dbSimTimeId;
+      unsigned long dbAllocationsId;
       unsigned long realStartTime;
 
       // plugins
@@ -290,6 +335,9 @@ namespace mars {
       std::vector<interfaces::pluginStruct> newPlugins;
       std::vector<interfaces::pluginStruct> activePlugins;
       std::vector<interfaces::pluginStruct> guiPlugins;
+      PluginScheduler pluginScheduler;
+      // plugins may switch their update mode from worker threads
+      utils::Mutex pluginModeMutex;
 
       // scenes
       int loadScene_internal(const std::string &filename, bool wasrunning, const std::string &robotname);
@@ -310,14 +358,28 @@ namespace mars {
       cfg_manager::cfgPropertyStruct cfgSyncGui, cfgDrawContact;
       cfg_manager::cfgPropertyStruct cfgGX, cfgGY, cfgGZ;
       cfg_manager::cfgPropertyStruct cfgWorldErp, cfgWorldCfm;
+      cfg_manager::cfgPropertyStruct cfgAdaptiveSubsteps, cfgMaxSubsteps;
+      cfg_manager::cfgPropertyStruct cfgMaxPenetration, cfgMaxStepMotion;
+      cfg_manager::cfgPropertyStruct cfgMotorPeriod;
+      cfg_manager::cfgPropertyStruct cfgIterations, cfgSor;
+      cfg_manager::cfgPropertyStruct cfgAdaptiveIterations, cfgMaxIterations;
+      cfg_manager::cfgPropertyStruct cfgConstraintError;
+      cfg_manager::cfgPropertyStruct cfgBodySleeping, cfgSleepLinear;
+      cfg_manager::cfgPropertyStruct cfgSleepAngular, cfgSleepTime;
       cfg_manager::cfgPropertyStruct cfgVisRep;
       cfg_manager::cfgPropertyStruct cfgSyncTime;
       cfg_manager::cfgPropertyStruct configPath;
       cfg_manager::cfgPropertyStruct cfgUseNow;
+      cfg_manager::cfgPropertyStruct cfgPluginThreads;
+      cfg_manager::cfgPropertyStruct cfgDeterministic, cfgRandomSeed;
       
       // data
       data_broker::DataPackage dbPhysicsUpdatePackage;
       data_broker::DataPackage dbSimTimePackage;
+      // allocations of the last step by tag, only with allocation tracking
+      data_broker::DataPackage dbAllocationsPackage;
+      utils::AllocationStats lastAllocations;
+      void publishAllocations(void);
       
       // IceServer comServer;
 
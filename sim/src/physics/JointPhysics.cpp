@@ -54,6 +54,7 @@ namespace mars {
       spring = 0;
       body1 = 0;
       body2 = 0;
+      velocity1 = velocity2 = 0;
     }
 
     /**
@@ -68,6 +69,7 @@ namespace mars {
     JointPhysics::~JointPhysics(void) {
       MutexLocker locker(&(theWorld->iMutex));
       if (jointId) {
+        theWorld->removeAnchorJoint(jointId);
         dJointDestroy(jointId);
       }
     }
@@ -163,6 +165,9 @@ namespace mars {
         // of the forces the joint attached to the bodies
         // we need to set a feedback pointer for the joint (ode stuff)
         dJointSetFeedback(jointId, &feedback);
+        if(joint_type != JOINT_TYPE_SLIDER && joint_type != JOINT_TYPE_FIXED) {
+          theWorld->addAnchorJoint(jointId);
+        }
         return 1;
       }
       return 0;
@@ -237,6 +242,10 @@ namespace mars {
 
     void JointPhysics::setVelocity(sReal velocity) {
       MutexLocker locker(&(theWorld->iMutex));
+      if((dReal)velocity != velocity1) {
+        velocity1 = (dReal)velocity;
+        wakeBodies();
+      }
 
       switch(joint_type) {
       case  JOINT_TYPE_HINGE:
@@ -256,6 +265,10 @@ namespace mars {
 
     void JointPhysics::setVelocity2(sReal velocity) {
       MutexLocker locker(&(theWorld->iMutex));
+      if((dReal)velocity != velocity2) {
+        velocity2 = (dReal)velocity;
+        wakeBodies();
+      }
 
       switch(joint_type) {
       case  JOINT_TYPE_HINGE:
@@ -271,6 +284,17 @@ namespace mars {
       }
     }
 
+    /**
+     * \brief Wakes the bodies attached to the joint.
+     *
+     * Used for motor commands: a sleeping body would not follow a
+     * new command until something else touches it.
+     */
+    void JointPhysics::wakeBodies(void) {
+      if(body1) dBodyEnable(body1);
+      if(body2) dBodyEnable(body2);
+    }
+
     sReal JointPhysics::getPosition(void) const {
       MutexLocker locker(&(theWorld->iMutex));
 
@@ -1126,6 +1150,7 @@ namespace mars {
 
     void JointPhysics::setTorque(sReal torque) {
       MutexLocker locker(&(theWorld->iMutex));
+      if(torque != 0.0) wakeBodies();
       switch(joint_type) {
       case JOINT_TYPE_HINGE:
         dJointAddHingeTorque(jointId, torque);
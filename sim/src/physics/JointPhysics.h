@@ -98,7 +98,10 @@ namespace mars {
       dReal damping, spring;
       utils::Vector axis1_torque, axis2_torque, joint_load;
       dReal motor_torque;
+      // last motor commands, a changed command wakes the attached bodies
+      dReal velocity1, velocity2;
 
+      void wakeBodies(void);
       void calculateCfmErp(const interfaces::JointData *jointS);
 
       ///create a joint from type Hing
@@ -41,8 +41,11 @@
 #include <mars/interfaces/Logging.hpp>
 #include <mars/utils/MutexLocker.h>
 #include <mars/utils/mathUtils.h>
+#include <mars/utils/misc.h>
 #include <mars/interfaces/sensor_bases.h>
 #include <mars/interfaces/terrainStruct.h>
+#include <mars/interfaces/TerrainDirtyRegions.h>
+#include <algorithm>
 #include <cmath>
 #include <set>
 #include <iostream>
@@ -78,7 +81,8 @@ namespace mars {
       composite = false;
       //node_data.num_ground_collisions = 0;
       node_data.setZero();
-      height_data = 0;
+      terrain = 0;
+      heightfieldData = 0;
       dMassSetZero(&nMass);
     }
 
@@ -99,11 +103,15 @@ namespace mars {
 
       if(nBody) theWorld->destroyBody(nBody, this);
 
-      if(nGeom) dGeomDestroy(nGeom);
+      if(!soilRestHeights.empty()) theWorld->removeDeformableTerrain(nGeom);
+      if(nGeom) {
+        theWorld->removeContactPairs(nGeom);
+        dGeomDestroy(nGeom);
+      }
 
       if(myVertices) free(myVertices);
       if(myIndices) free(myIndices);
-      if(height_data) free(height_data);
+      if(heightfieldData) dGeomHeightfieldDataDestroy(heightfieldData);
 
       // TODO: how does this loop work? why doesn't it run forever?
       for(iter = sensor_list.begin(); iter != sensor_list.end();) {
@@ -277,6 +285,8 @@ namespace mars {
       dReal npos[3];
       Vector offset;
       MutexLocker locker(&(theWorld->iMutex));
+      // a moved body has to take part in the next step even if it slept
+      if(nBody) dBodyEnable(nBody);
 
       if(composite) {
         if(move_group) {
@@ -515,6 +525,7 @@ namespace mars {
       dMatrix3 R;
       dVector3 pos, new_pos, new2_pos;
       MutexLocker locker(&(theWorld->iMutex));
+      if(nBody) dBodyEnable(nBody);
 
       pos[0] = pos[1] = pos[2] = 0;
       tmp[1] = (dReal)q.x();
@@ -800,21 +811,15 @@ namespace mars {
 
     bool NodePhysics::createHeightfield(NodeData* node) {
       dMatrix3 R;
-      unsigned long size;
-      int x, y;
       terrain = node->terrain;
-      size = terrain->width*terrain->height;
-      if(!height_data) height_data = (dReal*)calloc(size, sizeof(dReal));
-      for(x=0; x<terrain->height; x++) {
-        for(y=0; y<terrain->width; y++) {
-          height_data[(terrain->height-(x+1))*terrain->width+y] = (dReal)terrain->pixelData[x*terrain->width+y];
-        }
-      }
       // build the ode representation
-      dHeightfieldDataID heightid = dGeomHeightfieldDataCreate();
+      // the callback reads terrain->pixelData directly, thus physics and
+      // graphics share one height buffer
+      heightfieldData = dGeomHeightfieldDataCreate();
 
       // Create an finite heightfield.
-      dGeomHeightfieldDataBuildCallback(heightid, this, heightfield_callback,
+      dGeomHeightfieldDataBuildCallback(heightfieldData, this,
+                                        heightfield_callback,
                                         terrain->targetWidth,
                                         terrain->targetHeight,
                                         terrain->width, terrain->height,
@@ -822,13 +827,29 @@ namespace mars {
                                         REAL(1.0), 0);
       // Give some very bounds which, while conservative,
       // makes AABB computation more accurate than +/-INF.
-      dGeomHeightfieldDataSetBounds(heightid, REAL(-terrain->scale*2.0),
-                                    REAL(terrain->scale*2.0));
+      heightfieldMin = REAL(-terrain->scale*2.0);
+      heightfieldMax = REAL(terrain->scale*2.0);
+      dGeomHeightfieldDataSetBounds(heightfieldData, heightfieldMin,
+                                    heightfieldMax);
       //dGeomHeightfieldDataSetBounds(heightid, -terrain->scale, terrain->scale);
-      nGeom = dCreateHeightfield(theWorld->getSpace(), heightid, 1);
+      nGeom = dCreateHeightfield(theWorld->getSpace(), heightfieldData, 1);
       dRSetIdentity(R);
       dRFromAxisAndAngle(R, 1, 0, 0, M_PI/2);
       dGeomSetRotation(nGeom, R);
+
+      if(node->map.hasKey("deformable") && (bool)node->map["deformable"]) {
+        // soil parameters in Pa/m^n, default is a loose sand
+        soilStiffness = node->map.get("soil_stiffness", 1.0e6);
+        soilExponent = node->map.get("soil_exponent", 1.0);
+        footprintRadius = node->map.get("footprint_radius", 0.05);
+        soilRestHeights.assign(terrain->pixelData,
+                               terrain->pixelData +
+                               terrain->width*terrain->height);
+        if(!terrain->dirtyRegions) {
+          terrain->dirtyRegions = new TerrainDirtyRegions();
+        }
+        theWorld->addDeformableTerrain(nGeom, this);
+      }
       return true;
     }
 
@@ -911,6 +932,7 @@ namespace mars {
       Vector npos;
       dMatrix3 R;
       MutexLocker locker(&(theWorld->iMutex));
+      if(nBody) dBodyEnable(nBody);
   
       tmp[1] = (dReal)rotation.x();
       tmp[2] = (dReal)rotation.y();
@@ -1051,6 +1073,7 @@ namespace mars {
           fprintf(stderr, "creation of body geometry failed.\n");
           return 0;
         }
+        theWorld->removeContactPairs(tmpGeomId);
         dGeomDestroy(tmpGeomId);
         // now the geom is rebuild and we have to reconnect it to the body
         // and reset the mass of the body
@@ -1097,8 +1120,11 @@ namespace mars {
      */
     void NodePhysics::setLinearVelocity(const Vector &velocity) {
       MutexLocker locker(&(theWorld->iMutex));
-      if(nBody) dBodySetLinearVel(nBody, (dReal)velocity.x(),
-                                  (dReal)velocity.y(), (dReal)velocity.z());
+      if(nBody) {
+        dBodyEnable(nBody);
+        dBodySetLinearVel(nBody, (dReal)velocity.x(),
+                          (dReal)velocity.y(), (dReal)velocity.z());
+      }
     }
 
     /**
@@ -1112,8 +1138,11 @@ namespace mars {
      */
     void NodePhysics::setAngularVelocity(const Vector &velocity) {
       MutexLocker locker(&(theWorld->iMutex));
-      if(nBody) dBodySetAngularVel(nBody, (dReal)velocity.x(),
-                                   (dReal)velocity.y(), (dReal)velocity.z());
+      if(nBody) {
+        dBodyEnable(nBody);
+        dBodySetAngularVel(nBody, (dReal)velocity.x(),
+                           (dReal)velocity.y(), (dReal)velocity.z());
+      }
     }
 
     /**
@@ -1127,8 +1156,11 @@ namespace mars {
      */
     void NodePhysics::setForce(const Vector &f) {
       MutexLocker locker(&(theWorld->iMutex));
-      if(nBody) dBodySetForce(nBody, (dReal)f.x(),
-                              (dReal)f.y(), (dReal)f.z());
+      if(nBody) {
+        // a vanishing force does not wake a sleeping body
+        if(f.squaredNorm() > 0.0) dBodyEnable(nBody);
+        dBodySetForce(nBody, (dReal)f.x(), (dReal)f.y(), (dReal)f.z());
+      }
     }
 
     /**
@@ -1142,8 +1174,10 @@ namespace mars {
      */
     void NodePhysics::setTorque(const Vector &t) {
       MutexLocker locker(&(theWorld->iMutex));
-      if(nBody) dBodySetTorque(nBody, (dReal)t.x(),
-                               (dReal)t.y(), (dReal)t.z());
+      if(nBody) {
+        if(t.squaredNorm() > 0.0) dBodyEnable(nBody);
+        dBodySetTorque(nBody, (dReal)t.x(), (dReal)t.y(), (dReal)t.z());
+      }
     }
 
     /**
@@ -1158,6 +1192,7 @@ namespace mars {
     void NodePhysics::addForce(const Vector &f, const Vector &p) {
       MutexLocker locker(&(theWorld->iMutex));
       if(nBody) {
+        if(f.squaredNorm() > 0.0) dBodyEnable(nBody);
         dBodyAddForceAtPos(nBody, 
                            (dReal)f.x(), (dReal)f.y(), (dReal)f.z(),
                            (dReal)p.x(), (dReal)p.y(), (dReal)p.z());
@@ -1175,6 +1210,7 @@ namespace mars {
     void NodePhysics::addForce(const Vector &f) {
       MutexLocker locker(&(theWorld->iMutex));
       if(nBody) {
+        if(f.squaredNorm() > 0.0) dBodyEnable(nBody);
         dBodyAddForce(nBody, (dReal)f.x(), (dReal)f.y(), (dReal)f.z());
       }
     }
@@ -1190,7 +1226,10 @@ namespace mars {
      */
     void NodePhysics::addTorque(const Vector &t) {
       MutexLocker locker(&(theWorld->iMutex));
-      if(nBody) dBodyAddTorque(nBody, (dReal)t.x(), (dReal)t.y(), (dReal)t.z());
+      if(nBody) {
+        if(t.squaredNorm() > 0.0) dBodyEnable(nBody);
+        dBodyAddTorque(nBody, (dReal)t.x(), (dReal)t.y(), (dReal)t.z());
+      }
     }
 
     bool NodePhysics::getGroundContact(void) const {
@@ -1309,13 +1348,81 @@ namespace mars {
     }
 
     dReal NodePhysics::heightCallback(int x, int y) {
+      // the rows of the pixel data are flipped compared to ode
+      return (dReal)terrain->pixelData[(terrain->height-(y+1))*terrain->width+x]*terrain->scale;
+    }
 
-      return (dReal)height_data[(y*terrain->width)+x]*terrain->scale;
+    void NodePhysics::deformTerrain(const Vector &pos, dReal normalForce) {
+      if(soilRestHeights.empty() || normalForce <= 0 ||
+         terrain->scale <= 0) return;
+
+      // sinkage from the pressure of the contact footprint
+      dReal area = M_PI*footprintRadius*footprintRadius;
+      dReal sinkage = pow(normalForce/(area*soilStiffness), 1./soilExponent);
+      if(sinkage <= 0) return;
+
+      // contact position in the heightfield frame, the samples are
+      // centered around the origin of the geom
+      const dReal *p = dGeomGetPosition(nGeom);
+      const dReal *R = dGeomGetRotation(nGeom);
+      dVector3 d = {pos.x()-p[0], pos.y()-p[1], pos.z()-p[2]};
+      dReal lx = R[0]*d[0] + R[4]*d[1] + R[8]*d[2];
+      dReal lz = R[2]*d[0] + R[6]*d[1] + R[10]*d[2];
+      dReal sampleWidth = terrain->targetWidth/(terrain->width-1);
+      dReal sampleDepth = terrain->targetHeight/(terrain->height-1);
+      dReal fx = (lx + terrain->targetWidth*0.5)/sampleWidth;
+      dReal fz = (lz + terrain->targetHeight*0.5)/sampleDepth;
+
+      int x0 = std::max(0, (int)floor(fx - footprintRadius/sampleWidth));
+      int x1 = std::min(terrain->width-1,
+                        (int)ceil(fx + footprintRadius/sampleWidth));
+      int z0 = std::max(0, (int)floor(fz - footprintRadius/sampleDepth));
+      int z1 = std::min(terrain->height-1,
+                        (int)ceil(fz + footprintRadius/sampleDepth));
+      if(x0 > x1 || z0 > z1) return;
+
+      dReal r2 = footprintRadius*footprintRadius;
+      dReal sinkagePixel = sinkage/terrain->scale;
+      int rowMin = terrain->height, rowMax = -1;
+      int colMin = terrain->width, colMax = -1;
+      double lowest = 0.0;
+      // the graphics reads the buffer in its own thread
+      MutexLocker bufferLocker(terrain->dirtyRegions->getBufferMutex());
+      for(int z=z0; z<=z1; ++z) {
+        dReal dz = (z-fz)*sampleDepth;
+        int row = terrain->height-(z+1);
+        for(int x=x0; x<=x1; ++x) {
+          dReal dx = (x-fx)*sampleWidth;
+          if(dx*dx + dz*dz > r2) continue;
+          int i = row*terrain->width+x;
+          double target = soilRestHeights[i] - sinkagePixel;
+          if(terrain->pixelData[i] <= target) continue;
+          terrain->pixelData[i] = target;
+          if(rowMax < 0 || target < lowest) lowest = target;
+          rowMin = std::min(rowMin, row);
+          rowMax = std::max(rowMax, row);
+          colMin = std::min(colMin, x);
+          colMax = std::max(colMax, x);
+        }
+      }
+      if(rowMax < 0) return;
+
+      terrain->dirtyRegions->add(colMin, rowMin, colMax, rowMax);
+      if(lowest*terrain->scale < heightfieldMin) {
+        // ode computes the aabb of the heightfield from these bounds
+        heightfieldMin = lowest*terrain->scale - terrain->scale;
+        dGeomHeightfieldDataSetBounds(heightfieldData, heightfieldMin,
+                                      heightfieldMax);
+      }
     }
 
     void NodePhysics::setContactParams(contact_params& c_params) {
+      static unsigned long version = 0;
       MutexLocker locker(&(theWorld->iMutex));
       node_data.c_params = c_params;
+      // unique over all nodes, thus a new node never matches a cached
+      // contact pair of a destroyed one
+      node_data.c_params_version = ++version;
       if(nGeom) {
         dGeomSetCollideBits(nGeom, c_params.coll_bitmask);
         dGeomSetCategoryBits(nGeom, c_params.coll_bitmask);
@@ -1553,16 +1660,20 @@ namespace mars {
       utils::Quaternion turnrotation;
       turnrotation.setIdentity();
       std::set<unsigned long> ids_rotating_ray_sensors;
+      long long castStart;
 
       //New Code
       int i=0;
       for(iter = sensor_list.begin(); iter != sensor_list.end(); iter++) {
         i+=1;
+        // nobody is interested in the values of this sensor
+        if(!iter->sensor->isActive()) continue;
         if((double)iter->sensor->updateRate * 0.001 > worldStep) {
           iter->updateTime += worldStep;
           if(iter->updateTime < 0.001*iter->sensor->updateRate) continue;
           iter->updateTime -= 0.001*iter->sensor->updateRate;
         }
+        castStart = utils::getTimeMicro();
         BasePolarIntersectionSensor *polarSensor = dynamic_cast<BasePolarIntersectionSensor*>((*iter).sensor);
         if(polarSensor){
           sensor_list_element elem = *iter;
@@ -1654,6 +1765,7 @@ namespace mars {
           (*polarGridSensor)[elem.index] = elem.gd->value;
           elem.gd->value = polarGridSensor->maxDistance;      
         }
+        iter->sensor->addUpdateTime(utils::getTimeMicro() - castStart);
       } // end for loop.
     }
 
@@ -1668,11 +1780,16 @@ namespace mars {
       MutexLocker locker(&(theWorld->iMutex));
       if(nBody) theWorld->destroyBody(nBody, this);
 
-      if(nGeom) dGeomDestroy(nGeom);
+      if(!soilRestHeights.empty()) theWorld->removeDeformableTerrain(nGeom);
+      if(nGeom) {
+        theWorld->removeContactPairs(nGeom);
+        dGeomDestroy(nGeom);
+      }
 
       if(myVertices) free(myVertices);
       if(myIndices) free(myIndices);
       if(myTriMeshData) dGeomTriMeshDataDestroy(myTriMeshData);
+      if(heightfieldData) dGeomHeightfieldDataDestroy(heightfieldData);
 
       nBody = 0;
       nGeom = 0;
@@ -1682,7 +1799,8 @@ namespace mars {
       composite = false;
       //node_data.num_ground_collisions = 0;
       node_data.setZero();
-      height_data = 0;
+      heightfieldData = 0;
+      soilRestHeights.clear();
     }
 
     void NodePhysics::setInertiaMass(NodeData* node) {
@@ -55,6 +55,7 @@ namespace mars {
         sense_contact_force = 1;
         value = 0;
         c_params.setZero();
+        c_params_version = 0;
       }
 
       geom_data(){
@@ -65,8 +66,13 @@ namespace mars {
       std::vector<utils::Vector> contact_points;
       std::list<unsigned long> contact_ids;
       std::vector<dJointFeedback*> ground_feedbacks;
+      // copies of the last feedbacks while the body sleeps, the feedbacks
+      // of WorldPhysics are reused in every step
+      std::vector<dJointFeedback> sleeping_feedbacks;
       bool node1;
       interfaces::contact_params c_params;
+      // changes with every setContactParams, see WorldPhysics::getContactPair
+      unsigned long c_params_version;
       bool ray_sensor;
       bool sense_contact_force;
       interfaces::sReal value;
@@ -133,6 +139,13 @@ namespace mars {
       void addMassToCompositeBody(dBodyID theBody, dMass *bodyMass);
       void getAbsMass(dMass *pMass) const;
       dReal heightCallback(int x, int y);
+      /**
+       * Lowers a deformable terrain around \a pos according to the
+       * pressure-sinkage relation p = k*z^n. The sinkage is measured from
+       * the undeformed surface, thus repeated contacts do not dig deeper
+       * than the load requires.
+       */
+      void deformTerrain(const utils::Vector &pos, dReal normalForce);
 
     protected:
       WorldPhysics *theWorld;
@@ -145,7 +158,11 @@ namespace mars {
       bool composite;
       geom_data node_data;
       interfaces::terrainStruct *terrain;
-      dReal *height_data;
+      dHeightfieldDataID heightfieldData;
+      // undeformed heights, only filled for deformable terrains
+      std::vector<double> soilRestHeights;
+      dReal soilStiffness, soilExponent, footprintRadius;
+      dReal heightfieldMin, heightfieldMax;
       std::vector<sensor_list_element> sensor_list;
       bool createMesh(interfaces::NodeData *node);
       bool createBox(interfaces::NodeData *node);
@@ -41,6 +41,7 @@
 
 
 #include <mars/utils/MutexLocker.h>
+#include <mars/utils/Thread.h>
 #include <mars/interfaces/graphics/draw_structs.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
@@ -50,6 +51,10 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/intrusive_ptr.hpp>	
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace mars {
   namespace sim {
 
@@ -93,6 +98,19 @@ namespace mars {
       fast_step = 0;
       world_cfm = 1e-10;
       world_erp = 0.1;
+      // the ode defaults
+      quickstep_iterations = 20;
+      quickstep_sor = 1.3;
+      adaptive_iterations = false;
+      max_iterations = 100;
+      max_constraint_error = 0.001;
+      current_iterations = quickstep_iterations;
+      body_sleeping = false;
+      sleep_linear_threshold = 0.01;
+      sleep_angular_threshold = 0.01;
+      sleep_time = 0.5;
+      deterministic = false;
+      random_seed = 0;
       world_gravity = Vector(0.0, 0.0, -9.81);
       ground_friction = 20;
       ground_cfm = 0.00000001;
@@ -102,6 +120,12 @@ namespace mars {
       contactgroup = 0;
       world_init = 0;
       num_contacts = 0;
+      max_contact_depth = 0;
+      used_feedbacks = 0;
+      step_count = 0;
+      ray_job = 0;
+      pending_ray_ranges = 0;
+      stop_ray_workers = false;
       create_contacts = 1;
       log_contacts = 0;
 
@@ -133,6 +157,7 @@ namespace mars {
      *
      */
     WorldPhysics::~WorldPhysics(void) {
+      stopRayWorkers();
       // free the ode objects
       freeTheWorld();
       // and close the ODE ...
@@ -157,6 +182,8 @@ namespace mars {
       // if world_init = true debug something
       if (!world_init) {
         //LOG_DEBUG("init physics world");
+        // quickstep reorders the constraints randomly
+        if(deterministic) dRandSetSeed(random_seed);
         world = dWorldCreate();
         space = dHashSpaceCreate(0);
         contactgroup = dJointGroupCreate(0);
@@ -169,14 +196,17 @@ namespace mars {
         dWorldSetCFM(world, (dReal)world_cfm);
         dWorldSetERP (world, (dReal)world_erp);
 
-        dWorldSetAutoDisableFlag (world,0);
+        old_iterations = current_iterations = quickstep_iterations;
+        old_sor = quickstep_sor;
+        dWorldSetQuickStepNumIterations(world, quickstep_iterations);
+        dWorldSetQuickStepW(world, (dReal)quickstep_sor);
+
+        setSleepParams();
         // if usefull for some tests a ground can be created here
         plane = 0; //dCreatePlane (space,0,0,1,0);
         world_init = 1;
-        drawStruct draw;
-        draw.ptr_draw = (DrawInterface*)this;
-        if(control->graphics)
-          control->graphics->addDrawItems(&draw);
+        if(control->sim)
+          control->sim->addPhysicsDebugDrawInterface(this);
       }
       //printf("initTheWorld..\n");
     }
@@ -195,6 +225,16 @@ namespace mars {
       MutexLocker locker(&iMutex);
       if(world_init) {
         //LOG_DEBUG("free physics world");
+        if(control->sim)
+          control->sim->removePhysicsDebugDrawInterface(this);
+        terrain_contacts.clear();
+        anchor_joints.clear();
+        contact_cache.clear();
+        for(size_t i=0; i<feedback_pool.size(); ++i) {
+          free(feedback_pool[i]);
+        }
+        feedback_pool.clear();
+        used_feedbacks = 0;
         dJointGroupDestroy(contactgroup);
         dSpaceDestroy(space);
         dWorldDestroy(world);
@@ -230,7 +270,6 @@ namespace mars {
      */
     void WorldPhysics::stepTheWorld(void) {
       MutexLocker locker(&iMutex);
-      std::vector<dJointFeedback*>::iterator iter;
       geom_data* data;
       int i;
       // if world_init = false or step_size <= 0 debug something
@@ -239,6 +278,15 @@ namespace mars {
           old_gravity = world_gravity;
           dWorldSetGravity(world, world_gravity.x(),
                            world_gravity.y(), world_gravity.z());
+          // resting bodies have to react on the new gravity
+          wakeAllBodies();
+        }
+
+        if(old_body_sleeping != body_sleeping ||
+           old_sleep_linear != sleep_linear_threshold ||
+           old_sleep_angular != sleep_angular_threshold ||
+           old_sleep_time != sleep_time) {
+          setSleepParams();
         }
 
         if(old_cfm != world_cfm) {
@@ -250,29 +298,47 @@ namespace mars {
           old_erp = world_erp;
           dWorldSetERP(world, (dReal)world_erp);
         }
+
+        if(old_iterations != quickstep_iterations) {
+          old_iterations = current_iterations = quickstep_iterations;
+          dWorldSetQuickStepNumIterations(world, quickstep_iterations);
+        }
+
+        if(old_sor != quickstep_sor) {
+          old_sor = quickstep_sor;
+          dWorldSetQuickStepW(world, (dReal)quickstep_sor);
+        }
 	//	printf("now WorldPhysics.cpp..stepTheWorld(void)....1 : dSpaceGetNumGeoms: %d\n",dSpaceGetNumGeoms(space)); 
         /// first clear the collision counters of all geoms
         for(i=0; i<dSpaceGetNumGeoms(space); i++) {
-          data = (geom_data*)dGeomGetData(dSpaceGetGeom(space, i));
+          dGeomID geom = dSpaceGetGeom(space, i);
+          data = (geom_data*)dGeomGetData(geom);
+          // sleeping bodies are not collided, they keep their contacts and
+          // the forces of the step they fell asleep in
+          dBodyID body = dGeomGetBody(geom);
+          if(body && !dBodyIsEnabled(body)) {
+            holdFeedbacks(data);
+            continue;
+          }
+          // the feedbacks are reused below
+          data->ground_feedbacks.clear();
+          data->sleeping_feedbacks.clear();
           data->num_ground_collisions = 0;
           data->contact_ids.clear();
           data->contact_points.clear();
-          data->ground_feedbacks.clear();
-        
         }
         
 
-        for(iter = contact_feedback_list.begin();
-            iter != contact_feedback_list.end(); iter++) {
-          free((*iter));
-        }
- 
-        contact_feedback_list.clear();
+        // the feedbacks of the last step are reused
+        used_feedbacks = 0;
+        if(++step_count % 100 == 0) evictContactPairs();
+        terrain_contacts.clear();
         draw_intern.clear();
         /// then we have to clear the contacts
         dJointGroupEmpty(contactgroup);
         /// first check for collisions
         num_contacts = log_contacts = 0;
+        max_contact_depth = 0;
         create_contacts = 1;
         
         dSpaceCollide(space,this, &WorldPhysics::callbackForward);
@@ -281,9 +347,21 @@ namespace mars {
         drawLock.unlock();
         // then calculate the next state for a time of step_size seconds
         try {
-          if(fast_step) dWorldQuickStep(world, step_size);
+          if(fast_step) {
+            dWorldQuickStep(world, step_size);
+            if(adaptive_iterations) adaptIterations();
+          }
           else dWorldStep(world, step_size);
 
+          // the soil yields under the contact forces of this step
+          for(i=0; i<(int)terrain_contacts.size(); ++i) {
+            const terrain_contact &tc = terrain_contacts[i];
+            dReal normalForce = fabs(tc.fb->f1[0]*tc.normal.x() +
+                                     tc.fb->f1[1]*tc.normal.y() +
+                                     tc.fb->f1[2]*tc.normal.z());
+            tc.terrain->deformTerrain(tc.pos, normalForce);
+          }
+
         } catch (...) {
           control->sim->handleError(PHYSICS_UNKNOWN);
         }
@@ -444,8 +522,7 @@ namespace mars {
       int numc;
       //up to MAX_CONTACTS contact per Box-box
       //dContact contact[MAX_CONTACTS];
-      dVector3 v1, v;
-      //dMatrix3 R;
+      dVector3 v;
       dReal dot;
   
       if (dGeomIsSpace(o1) || dGeomIsSpace(o2)) {
@@ -503,7 +580,13 @@ namespace mars {
 
       if(!b1 && !b2 && !geom_data1->ray_sensor && !geom_data2->ray_sensor) return;
 
-      int maxNumContacts = 0;
+      // nothing changes between sleeping or static bodies; a contact
+      // with an awake body wakes the sleeping one during the step
+      if((!b1 || !dBodyIsEnabled(b1)) && (!b2 || !dBodyIsEnabled(b2))) {
+        return;
+      }
+
+      int maxNumContacts;
       if(geom_data1->c_params.max_num_contacts <
          geom_data2->c_params.max_num_contacts) {
         maxNumContacts = geom_data1->c_params.max_num_contacts;
@@ -511,8 +594,11 @@ namespace mars {
       else {
         maxNumContacts = geom_data2->c_params.max_num_contacts;
       }
-      dContact *contact = new dContact[maxNumContacts];
-
+      if(maxNumContacts < 1) return;
+      if((int)contact_buffer.size() < maxNumContacts) {
+        contact_buffer.resize(maxNumContacts);
+      }
+      dContact *contact = &contact_buffer[0];
 
       //for granular test
       //if( (plane != o2) && (plane !=o1)) return ;
@@ -555,9 +641,282 @@ namespace mars {
      return;
      }
       */
-  
 
-  
+      numc=dCollide(o1,o2, maxNumContacts, &contact[0].geom,sizeof(dContact));
+      if(numc){ 
+        // only touching geoms get a cache entry; dCollide only fills the
+        // contact geometry
+        contact_pair &pair = getContactPair(o1, o2, geom_data1, geom_data2);
+        for (i=0;i<numc;i++){
+          contact[i].surface = pair.contact.surface;
+          memcpy(contact[i].fdir1, pair.contact.fdir1, sizeof(dVector3));
+        }
+		  
+	  
+        dJointFeedback *fb;
+        Vector contact_point;
+        NodePhysics *terrain = 0;
+
+        num_contacts++;
+        if(create_contacts) {
+          fb = 0;
+          if(!deformable_terrains.empty()) {
+            std::map<dGeomID, NodePhysics*>::iterator it;
+            it = deformable_terrains.find(o1);
+            if(it == deformable_terrains.end()) {
+              it = deformable_terrains.find(o2);
+            }
+            if(it != deformable_terrains.end()) terrain = it->second;
+          }
+
+          for(i=0;i<numc;i++){
+            if(contact[i].geom.depth > max_contact_depth) {
+              max_contact_depth = contact[i].geom.depth;
+            }
+            if(draw_contact_points) {
+              contact_point.x() = contact[i].geom.pos[0];
+              contact_point.y() = contact[i].geom.pos[1];
+              contact_point.z() = contact[i].geom.pos[2];
+              draw_intern.push_back(contact_point);
+              contact_point.x() += contact[i].geom.normal[0];
+              contact_point.y() += contact[i].geom.normal[1];
+              contact_point.z() += contact[i].geom.normal[2];
+              draw_intern.push_back(contact_point);
+            }
+            if(geom_data1->c_params.friction_direction1 ||
+               geom_data2->c_params.friction_direction1) {
+              v[0] = contact[i].geom.normal[0];
+              v[1] = contact[i].geom.normal[1];
+              v[2] = contact[i].geom.normal[2];
+              dot = dDOT(v, contact[i].fdir1);
+              dOPEC(v, *=, dot);
+              contact[i].fdir1[0] -= v[0];
+              contact[i].fdir1[1] -= v[1];
+              contact[i].fdir1[2] -= v[2];
+              dNormalize3(contact[0].fdir1);
+            }
+            contact[0].geom.depth += (geom_data1->c_params.depth_correction +
+                                      geom_data2->c_params.depth_correction);
+        
+            if(contact[0].geom.depth < 0.0) contact[0].geom.depth = 0.0;
+            dJointID c=dJointCreateContact(world,contactgroup,contact+i);
+
+            dJointAttach(c,b1,b2);
+
+            geom_data1->num_ground_collisions += numc;
+            geom_data2->num_ground_collisions += numc;
+
+            contact_point.x() = contact[i].geom.pos[0];
+            contact_point.y() = contact[i].geom.pos[1];
+            contact_point.z() = contact[i].geom.pos[2];
+
+            geom_data1->contact_ids.push_back(geom_data2->id);
+            geom_data2->contact_ids.push_back(geom_data1->id);
+            geom_data1->contact_points.push_back(contact_point);
+            geom_data2->contact_points.push_back(contact_point);
+            //if(dGeomGetClass(o1) == dPlaneClass) {
+            fb = 0;
+            if(geom_data2->sense_contact_force) {
+              fb = getContactFeedback();
+              dJointSetFeedback(c, fb);
+              geom_data2->ground_feedbacks.push_back(fb);
+              geom_data2->node1 = false;
+            } 
+            //else if(dGeomGetClass(o2) == dPlaneClass) {
+            if(geom_data1->sense_contact_force) {
+              if(!fb) {
+                fb = getContactFeedback();
+                dJointSetFeedback(c, fb);
+              }
+              geom_data1->ground_feedbacks.push_back(fb);
+              geom_data1->node1 = true;
+            }
+            if(terrain) {
+              if(!fb) {
+                fb = getContactFeedback();
+                dJointSetFeedback(c, fb);
+              }
+              terrain_contact tc;
+              tc.terrain = terrain;
+              tc.fb = fb;
+              tc.pos = contact_point;
+              tc.normal = Vector(contact[i].geom.normal[0],
+                                 contact[i].geom.normal[1],
+                                 contact[i].geom.normal[2]);
+              terrain_contacts.push_back(tc);
+            }
+          }
+        }  
+      }
+    }
+
+    /**
+     * \brief Chooses the number of iterations for the next step.
+     *
+     * The iterations are raised quickly while the constraint error exceeds
+     * the budget and lowered one by one while it stays below half of it.
+     * The configured quickstep_iterations are the lower bound.
+     */
+    void WorldPhysics::adaptIterations(void) {
+      sReal error = measureConstraintError();
+      int iterations = current_iterations;
+      if(error > max_constraint_error) {
+        iterations += iterations/4 + 1;
+        if(iterations > max_iterations) iterations = max_iterations;
+      }
+      else if(error < 0.5*max_constraint_error) {
+        --iterations;
+      }
+      if(iterations < quickstep_iterations) iterations = quickstep_iterations;
+      if(iterations != current_iterations) {
+        current_iterations = iterations;
+        dWorldSetQuickStepNumIterations(world, current_iterations);
+      }
+    }
+
+    sReal WorldPhysics::measureConstraintError(void) const {
+      dVector3 a1, a2;
+      dReal error = 0;
+      for(size_t i=0; i<anchor_joints.size(); ++i) {
+        dJointID joint = anchor_joints[i];
+        switch(dJointGetType(joint)) {
+        case dJointTypeHinge:
+          dJointGetHingeAnchor(joint, a1);
+          dJointGetHingeAnchor2(joint, a2);
+          break;
+        case dJointTypeHinge2:
+          dJointGetHinge2Anchor(joint, a1);
+          dJointGetHinge2Anchor2(joint, a2);
+          break;
+        case dJointTypeBall:
+          dJointGetBallAnchor(joint, a1);
+          dJointGetBallAnchor2(joint, a2);
+          break;
+        case dJointTypeUniversal:
+          dJointGetUniversalAnchor(joint, a1);
+          dJointGetUniversalAnchor2(joint, a2);
+          break;
+        default:
+          continue;
+        }
+        dReal d = sqrt((a1[0]-a2[0])*(a1[0]-a2[0]) +
+                       (a1[1]-a2[1])*(a1[1]-a2[1]) +
+                       (a1[2]-a2[2])*(a1[2]-a2[2]));
+        if(d > error) error = d;
+      }
+      return (sReal)error;
+    }
+
+    int WorldPhysics::getSolverIterations(void) const {
+      return fast_step ? current_iterations : 0;
+    }
+
+    sReal WorldPhysics::getConstraintError(void) const {
+      MutexLocker locker(&iMutex);
+      return measureConstraintError();
+    }
+
+    void WorldPhysics::getStepStatistics(sReal *maxPenetration,
+                                         sReal *maxVelocity) const {
+      MutexLocker locker(&iMutex);
+      dReal velocity = 0;
+      *maxPenetration = *maxVelocity = 0;
+      if(!world_init) return;
+      for(int i=0; i<dSpaceGetNumGeoms(space); i++) {
+        dBodyID body = dGeomGetBody(dSpaceGetGeom(space, i));
+        if(!body || !dBodyIsEnabled(body)) continue;
+        const dReal *v = dBodyGetLinearVel(body);
+        dReal v2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+        if(v2 > velocity) velocity = v2;
+      }
+      *maxPenetration = (sReal)max_contact_depth;
+      *maxVelocity = (sReal)sqrt(velocity);
+    }
+
+    void WorldPhysics::addAnchorJoint(dJointID joint) {
+      anchor_joints.push_back(joint);
+    }
+
+    void WorldPhysics::removeAnchorJoint(dJointID joint) {
+      std::vector<dJointID>::iterator it;
+      it = std::find(anchor_joints.begin(), anchor_joints.end(), joint);
+      if(it != anchor_joints.end()) anchor_joints.erase(it);
+    }
+
+    /**
+     * \brief Applies the body sleeping parameters to the ode world.
+     *
+     * ODE disables a body once its velocities stayed below the
+     * thresholds for the given time and re-enables the disabled bodies
+     * of an island that gets connected to an enabled body.
+     */
+    void WorldPhysics::setSleepParams(void) {
+      old_body_sleeping = body_sleeping;
+      old_sleep_linear = sleep_linear_threshold;
+      old_sleep_angular = sleep_angular_threshold;
+      old_sleep_time = sleep_time;
+
+      dWorldSetAutoDisableFlag(world, body_sleeping);
+      dWorldSetAutoDisableLinearThreshold(world, (dReal)sleep_linear_threshold);
+      dWorldSetAutoDisableAngularThreshold(world, (dReal)sleep_angular_threshold);
+      dWorldSetAutoDisableTime(world, (dReal)sleep_time);
+      // only the dwell time decides
+      dWorldSetAutoDisableSteps(world, 0);
+
+      // the bodies copy the world parameters when they are created
+      for(int i=0; i<dSpaceGetNumGeoms(space); i++) {
+        dBodyID body = dGeomGetBody(dSpaceGetGeom(space, i));
+        if(body) {
+          dBodySetAutoDisableDefaults(body);
+          if(!body_sleeping) dBodyEnable(body);
+        }
+      }
+    }
+
+    void WorldPhysics::wakeAllBodies(void) {
+      for(int i=0; i<dSpaceGetNumGeoms(space); i++) {
+        dBodyID body = dGeomGetBody(dSpaceGetGeom(space, i));
+        if(body) dBodyEnable(body);
+      }
+    }
+
+    /**
+     * \brief Returns the cached contact data of two geoms.
+     *
+     * The surface parameters only depend on the contact parameters of the
+     * geoms. They are computed when the geoms touch the first time or
+     * when their contact parameters changed and are reused as long as
+     * the geoms stay in contact.
+     */
+    WorldPhysics::contact_pair& WorldPhysics::getContactPair(dGeomID o1, dGeomID o2,
+                                                             geom_data *geom_data1,
+                                                             geom_data *geom_data2) {
+      // the callback may pass the geoms in either order; the pair is
+      // keyed and initialized in geom order so that it is stable
+      if(o2 < o1) {
+        std::swap(o1, o2);
+        std::swap(geom_data1, geom_data2);
+      }
+      contact_pair &pair = contact_cache[std::make_pair(o1, o2)];
+      pair.last_step = step_count;
+      if(pair.data1 != geom_data1 || pair.data2 != geom_data2 ||
+         pair.version1 != geom_data1->c_params_version ||
+         pair.version2 != geom_data2->c_params_version) {
+        pair.data1 = geom_data1;
+        pair.data2 = geom_data2;
+        pair.version1 = geom_data1->c_params_version;
+        pair.version2 = geom_data2->c_params_version;
+        initContactPair(&pair, geom_data1, geom_data2);
+      }
+      return pair;
+    }
+
+    void WorldPhysics::initContactPair(contact_pair *pair,
+                                       geom_data *geom_data1,
+                                       geom_data *geom_data2) {
+      dVector3 v1;
+      dContact *contact = &pair->contact;
+
       // frist we set the softness values:
       contact[0].surface.mode = dContactSoftERP | dContactSoftCFM;
       contact[0].surface.soft_cfm = (geom_data1->c_params.cfm +
@@ -658,100 +1017,46 @@ namespace mars {
         else
           contact[0].surface.bounce_vel = geom_data2->c_params.bounce_vel;      
       }
+    }
 
-      for (i=1;i<maxNumContacts;i++){
-        contact[i] = contact[0];
-     
+    /**
+     * Removes the pairs that were not in contact for a while.
+     */
+    void WorldPhysics::evictContactPairs(void) {
+      std::map<std::pair<dGeomID, dGeomID>, contact_pair>::iterator it;
+      for(it=contact_cache.begin(); it!=contact_cache.end();) {
+        if(step_count - it->second.last_step > 100) contact_cache.erase(it++);
+        else ++it;
       }
+    }
 
-      numc=dCollide(o1,o2, maxNumContacts, &contact[0].geom,sizeof(dContact));
-      if(numc){ 
-		  
-	  
-        dJointFeedback *fb;
-        draw_item item;
-        Vector contact_point;
-
-        num_contacts++;
-        if(create_contacts) {
-          fb = 0;
-          item.id = 0;
-          item.type = DRAW_LINE;
-          item.draw_state = DRAW_STATE_CREATE;
-          item.point_size = 10;
-          item.myColor.r = 1;
-          item.myColor.g = 0;
-          item.myColor.b = 0;
-          item.myColor.a = 1;
-          item.label = "";
-          item.t_width = item.t_height = 0;
-          item.texture = "";
-          item.get_light = 0;
-
-          for(i=0;i<numc;i++){
-            item.start.x() = contact[i].geom.pos[0];
-            item.start.y() = contact[i].geom.pos[1];
-            item.start.z() = contact[i].geom.pos[2];
-            item.end.x() = contact[i].geom.pos[0] + contact[i].geom.normal[0];
-            item.end.y() = contact[i].geom.pos[1] + contact[i].geom.normal[1];
-            item.end.z() = contact[i].geom.pos[2] + contact[i].geom.normal[2];
-            draw_intern.push_back(item);
-            if(geom_data1->c_params.friction_direction1 ||
-               geom_data2->c_params.friction_direction1) {
-              v[0] = contact[i].geom.normal[0];
-              v[1] = contact[i].geom.normal[1];
-              v[2] = contact[i].geom.normal[2];
-              dot = dDOT(v, contact[i].fdir1);
-              dOPEC(v, *=, dot);
-              contact[i].fdir1[0] -= v[0];
-              contact[i].fdir1[1] -= v[1];
-              contact[i].fdir1[2] -= v[2];
-              dNormalize3(contact[0].fdir1);
-            }
-            contact[0].geom.depth += (geom_data1->c_params.depth_correction +
-                                      geom_data2->c_params.depth_correction);
-        
-            if(contact[0].geom.depth < 0.0) contact[0].geom.depth = 0.0;
-            dJointID c=dJointCreateContact(world,contactgroup,contact+i);
-
-            dJointAttach(c,b1,b2);
-
-            geom_data1->num_ground_collisions += numc;
-            geom_data2->num_ground_collisions += numc;
-
-            contact_point.x() = contact[i].geom.pos[0];
-            contact_point.y() = contact[i].geom.pos[1];
-            contact_point.z() = contact[i].geom.pos[2];
+    dJointFeedback* WorldPhysics::getContactFeedback(void) {
+      if(used_feedbacks == feedback_pool.size()) {
+        feedback_pool.push_back((dJointFeedback*)malloc(sizeof(dJointFeedback)));
+      }
+      return feedback_pool[used_feedbacks++];
+    }
 
-            geom_data1->contact_ids.push_back(geom_data2->id);
-            geom_data2->contact_ids.push_back(geom_data1->id);
-            geom_data1->contact_points.push_back(contact_point);
-            geom_data2->contact_points.push_back(contact_point);
-            //if(dGeomGetClass(o1) == dPlaneClass) {
-            fb = 0;
-            if(geom_data2->sense_contact_force) {
-              fb = (dJointFeedback*)malloc(sizeof(dJointFeedback));
-              dJointSetFeedback(c, fb);
-           
-              contact_feedback_list.push_back(fb);
-              geom_data2->ground_feedbacks.push_back(fb);
-              geom_data2->node1 = false;
-            } 
-            //else if(dGeomGetClass(o2) == dPlaneClass) {
-            if(geom_data1->sense_contact_force) {
-              if(!fb) {
-                fb = (dJointFeedback*)malloc(sizeof(dJointFeedback));
-                dJointSetFeedback(c, fb);
-                  
-                contact_feedback_list.push_back(fb);
-              }
-              geom_data1->ground_feedbacks.push_back(fb);
-              geom_data1->node1 = true;
-            }
-          }
-        }  
+    /**
+     * Copies the ground feedbacks of a geom whose body fell asleep, the
+     * pool feedbacks they point to are handed out again in the next step.
+     */
+    void WorldPhysics::holdFeedbacks(geom_data *data) {
+      const size_t n = data->ground_feedbacks.size();
+      bool held = (data->sleeping_feedbacks.size() == n);
+      for(size_t i=0; held && i<n; ++i) {
+        held = (data->ground_feedbacks[i] == &data->sleeping_feedbacks[i]);
+      }
+      if(held) return;
+      // some of the feedbacks may already point into sleeping_feedbacks
+      std::vector<dJointFeedback> copies(n);
+      for(size_t i=0; i<n; ++i) {
+        copies[i] = *data->ground_feedbacks[i];
+      }
+      data->sleeping_feedbacks.swap(copies);
+      for(size_t i=0; i<n; ++i) {
+        data->ground_feedbacks[i] = &data->sleeping_feedbacks[i];
       }
-      delete[] contact;
     }
 
     /**
@@ -835,17 +1140,12 @@ namespace mars {
       return center;
     }
 
-    void WorldPhysics::update(std::vector<draw_item>* drawItems) {
+    void WorldPhysics::fillDebugDraw(DebugDrawBuffer *buffer) {
+      if(!draw_contact_points) return;
+      const Color color(1.0, 0.0, 0.0, 1.0);
       MutexLocker locker(&drawLock);
-      std::vector<draw_item>::iterator iter;
-  
-      for(iter=drawItems->begin(); iter!=drawItems->end(); iter++) {
-        iter->draw_state = DRAW_STATE_ERASE;
-      }
-      if(draw_contact_points) {
-        for(iter=draw_extern.begin(); iter!=draw_extern.end(); iter++) {
-          drawItems->push_back(*iter);
-        }
+      for(size_t i=0; i+1<draw_extern.size(); i+=2) {
+        buffer->addLine(draw_extern[i], draw_extern[i+1], color);
       }
     }
 
@@ -887,6 +1187,28 @@ namespace mars {
       return depth;
     }
 
+    void WorldPhysics::addDeformableTerrain(dGeomID theGeom,
+                                            NodePhysics *node) {
+      deformable_terrains[theGeom] = node;
+    }
+
+    void WorldPhysics::removeContactPairs(dGeomID theGeom) {
+      // a new geom may get the address of the destroyed one
+      std::map<std::pair<dGeomID, dGeomID>, contact_pair>::iterator it;
+      for(it=contact_cache.begin(); it!=contact_cache.end();) {
+        if(it->first.first == theGeom || it->first.second == theGeom) {
+          contact_cache.erase(it++);
+        }
+        else ++it;
+      }
+    }
+
+    void WorldPhysics::removeDeformableTerrain(dGeomID theGeom) {
+      // terrain_contacts are only used within stepTheWorld, thus they
+      // cannot refer to the removed node afterwards
+      deformable_terrains.erase(theGeom);
+    }
+
     int WorldPhysics::checkCollisions(void) {
       MutexLocker locker(&iMutex);
       num_contacts = log_contacts = 0;
@@ -924,5 +1246,226 @@ namespace mars {
       return depth;
     }
 
+    /**
+     * A geom that can be hit by castRays together with its bounding box.
+     * The bounding boxes are computed once before the rays are cast.
+     */
+    struct ray_target {
+      dGeomID geom;
+      dReal aabb[6];
+    };
+
+    static void collectRayTargets(dSpaceID theSpace,
+                                  std::vector<ray_target> *targets) {
+      for(int i=0; i<dSpaceGetNumGeoms(theSpace); i++) {
+        dGeomID theGeom = dSpaceGetGeom(theSpace, i);
+        if(dGeomIsSpace(theGeom)) {
+          collectRayTargets((dSpaceID)theGeom, targets);
+          continue;
+        }
+        if(!dGeomIsEnabled(theGeom) || dGeomGetClass(theGeom) == dRayClass) {
+          continue;
+        }
+        geom_data *gd = (geom_data*)dGeomGetData(theGeom);
+        if(gd && gd->ray_sensor) continue;
+        ray_target target;
+        target.geom = theGeom;
+        dGeomGetAABB(theGeom, target.aabb);
+        targets->push_back(target);
+      }
+    }
+
+    /**
+     * The parameters of one castRays call that are shared by all ranges.
+     */
+    struct ray_cast_job {
+      const std::vector<ray_target> *targets;
+      const std::vector<Vector> *directions;
+      Vector origin;
+      Quaternion orientation;
+      dReal minDistance, maxDistance;
+      float *distances;
+    };
+
+    /**
+     * Casts the rays [begin, end) of \a job with \a ray against the
+     * collected targets. Every thread uses its own ray geom and only reads
+     * the targets, thus several ranges can be cast in parallel while the
+     * world is locked.
+     */
+    static void castRayRange(const ray_cast_job &job, size_t begin,
+                             size_t end, dGeomID ray) {
+      const float noHit = std::numeric_limits<float>::quiet_NaN();
+      dContact contact[1];
+      dGeomRaySetLength(ray, job.maxDistance - job.minDistance);
+
+      for(size_t i=begin; i<end; ++i) {
+        Vector dir = job.orientation * (*job.directions)[i];
+        Vector start = job.origin + dir*job.minDistance;
+        Vector stop = job.origin + dir*job.maxDistance;
+        dGeomRaySet(ray, start.x(), start.y(), start.z(),
+                    dir.x(), dir.y(), dir.z());
+        dReal rayMin[3], rayMax[3];
+        for(int k=0; k<3; ++k) {
+          rayMin[k] = std::min(start[k], stop[k]);
+          rayMax[k] = std::max(start[k], stop[k]);
+        }
+
+        dReal depth = job.maxDistance - job.minDistance;
+        bool hit = false;
+        for(size_t t=0; t<job.targets->size(); ++t) {
+          const ray_target &target = (*job.targets)[t];
+          if(rayMax[0] < target.aabb[0] || rayMin[0] > target.aabb[1] ||
+             rayMax[1] < target.aabb[2] || rayMin[1] > target.aabb[3] ||
+             rayMax[2] < target.aabb[4] || rayMin[2] > target.aabb[5]) {
+            continue;
+          }
+          if(dCollide(ray, target.geom, 1 | CONTACTS_UNIMPORTANT,
+                      &(contact[0].geom), sizeof(dContact))) {
+            if(contact[0].geom.depth <= depth) {
+              depth = contact[0].geom.depth;
+              hit = true;
+            }
+          }
+        }
+        job.distances[i] = hit ? (float)(depth + job.minDistance) : noHit;
+      }
+    }
+
+    static dGeomID createCastRay(void) {
+      dGeomID ray = dCreateRay(0, 1);
+      dGeomRaySetClosestHit(ray, 1);
+      return ray;
+    }
+
+    /**
+     * A thread of the castRays pool, see WorldPhysics::rayWorkerLoop.
+     */
+    class RayCastWorker : public Thread {
+    public:
+      RayCastWorker(const WorldPhysics *world) : world(world) {}
+
+    protected:
+      void run() {
+#ifdef ODE11
+        dAllocateODEDataForThread(dAllocateMaskAll);
+#endif
+        world->rayWorkerLoop();
+#ifdef ODE11
+        dCleanupODEAllDataForThread();
+#endif
+      }
+
+    private:
+      const WorldPhysics *world;
+    };
+
+    void WorldPhysics::startRayWorkers(int numWorkers) const {
+      // the pool only grows, the threads wait while no rays are cast
+      while((int)ray_workers.size() < numWorkers) {
+        RayCastWorker *worker = new RayCastWorker(this);
+        worker->start();
+        ray_workers.push_back(worker);
+      }
+    }
+
+    void WorldPhysics::stopRayWorkers(void) {
+      ray_mutex.lock();
+      stop_ray_workers = true;
+      ray_condition.wakeAll();
+      ray_mutex.unlock();
+      for(size_t i=0; i<ray_workers.size(); ++i) {
+        ray_workers[i]->wait();
+        delete ray_workers[i];
+      }
+      ray_workers.clear();
+      stop_ray_workers = false;
+    }
+
+    void WorldPhysics::rayWorkerLoop(void) const {
+      dGeomID ray = createCastRay();
+      std::pair<size_t, size_t> range;
+      ray_mutex.lock();
+      while(!stop_ray_workers) {
+        if(ray_ranges.empty()) {
+          ray_condition.wait(&ray_mutex);
+          continue;
+        }
+        range = ray_ranges.front();
+        ray_ranges.pop_front();
+        const ray_cast_job *job = ray_job;
+        ray_mutex.unlock();
+        castRayRange(*job, range.first, range.second, ray);
+        ray_mutex.lock();
+        if(--pending_ray_ranges == 0) {
+          ray_done_condition.wakeAll();
+        }
+      }
+      ray_mutex.unlock();
+      dGeomDestroy(ray);
+    }
+
+    void WorldPhysics::castRays(const Vector &origin,
+                                const Quaternion &orientation,
+                                const std::vector<Vector> &directions,
+                                sReal minDistance, sReal maxDistance,
+                                float *distances, int numThreads) const {
+      MutexLocker locker(&iMutex);
+      if(!world_init || directions.empty()) return;
+
+      std::vector<ray_target> targets;
+      collectRayTargets(space, &targets);
+      ray_cast_job job;
+      job.targets = &targets;
+      job.directions = &directions;
+      job.origin = origin;
+      job.orientation = orientation;
+      job.minDistance = minDistance;
+      job.maxDistance = maxDistance;
+      job.distances = distances;
+
+      if(numThreads < 1) numThreads = 1;
+      if((size_t)numThreads > directions.size()) {
+        numThreads = directions.size();
+      }
+      const size_t chunk = (directions.size() + numThreads - 1) / numThreads;
+      if(numThreads > 1) {
+        startRayWorkers(numThreads-1);
+        ray_mutex.lock();
+        ray_job = &job;
+        for(int i=1; i<numThreads; ++i) {
+          size_t begin = std::min(i*chunk, directions.size());
+          size_t end = std::min((i+1)*chunk, directions.size());
+          ray_ranges.push_back(std::make_pair(begin, end));
+          ++pending_ray_ranges;
+        }
+        ray_condition.wakeAll();
+        ray_mutex.unlock();
+      }
+
+      // the calling thread takes the first range itself and helps with
+      // the ranges no worker took yet
+      dGeomID ray = createCastRay();
+      castRayRange(job, 0, std::min(chunk, directions.size()), ray);
+      if(numThreads > 1) {
+        std::pair<size_t, size_t> range;
+        ray_mutex.lock();
+        while(!ray_ranges.empty()) {
+          range = ray_ranges.front();
+          ray_ranges.pop_front();
+          ray_mutex.unlock();
+          castRayRange(job, range.first, range.second, ray);
+          ray_mutex.lock();
+          --pending_ray_ranges;
+        }
+        while(pending_ray_ranges > 0) {
+          ray_done_condition.wait(&ray_mutex);
+        }
+        ray_job = 0;
+        ray_mutex.unlock();
+      }
+      dGeomDestroy(ray);
+    }
+
   } // end of namespace sim
 } // end of namespace mars
@@ -36,12 +36,16 @@
 //#define _DEBUG_MASS_
 
 #include <mars/utils/Mutex.h>
+#include <mars/utils/WaitCondition.h>
 #include <mars/utils/Vector.h>
 #include <mars/interfaces/sim_common.h>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/sim/PhysicsInterface.h>
-#include <mars/interfaces/graphics/draw_structs.h>
+#include <mars/interfaces/graphics/DebugDrawInterface.h>
 
+#include <cstring>
+#include <deque>
+#include <map>
 #include <vector>
 
 #include <ode/ode.h>
@@ -50,6 +54,9 @@ namespace mars {
   namespace sim {
 
     class NodePhysics;
+    class RayCastWorker;
+    struct geom_data;
+    struct ray_cast_job;
 
     /**
      * The struct is used to handle some sensors in the physical
@@ -82,7 +89,7 @@ namespace mars {
      * Declaration of the physical class, that implements the
      * physics interface.
      */
-    class WorldPhysics : public interfaces::PhysicsInterface, interfaces::DrawInterface {
+    class WorldPhysics : public interfaces::PhysicsInterface, interfaces::DebugDrawInterface {
     public:
       WorldPhysics(interfaces::ControlCenter *control);
       virtual ~WorldPhysics(void);
@@ -91,9 +98,19 @@ namespace mars {
       virtual void stepTheWorld(void);
       virtual bool existsWorld(void) const;
       virtual const utils::Vector getCenterOfMass(const std::vector<interfaces::NodeInterface*> &nodes)const;
-      virtual void update(std::vector<interfaces::draw_item> *drawItems);
+      virtual void fillDebugDraw(interfaces::DebugDrawBuffer *buffer);
       virtual int checkCollisions(void);
       virtual interfaces::sReal getVectorCollision(const utils::Vector &pos, const utils::Vector &ray) const;
+      virtual int getSolverIterations(void) const;
+      virtual interfaces::sReal getConstraintError(void) const;
+      virtual void getStepStatistics(interfaces::sReal *maxPenetration,
+                                     interfaces::sReal *maxVelocity) const;
+      virtual void castRays(const utils::Vector &origin,
+                            const utils::Quaternion &orientation,
+                            const std::vector<utils::Vector> &directions,
+                            interfaces::sReal minDistance,
+                            interfaces::sReal maxDistance,
+                            float *distances, int numThreads = 1) const;
 
       // this functions are used by the other physical classes
       dWorldID getWorld(void) const;
@@ -105,6 +122,16 @@ namespace mars {
       void moveCompositeMassCenter(dBodyID theBody, dReal x, dReal y, dReal z);
       int handleCollision(dGeomID theGeom);
       interfaces::sReal getCollisionDepth(dGeomID theGeom);
+      // have to be called with iMutex locked
+      void addDeformableTerrain(dGeomID theGeom, NodePhysics *node);
+      void removeDeformableTerrain(dGeomID theGeom);
+      // drops the cached contact pairs of a geom before it is destroyed;
+      // has to be called with iMutex locked
+      void removeContactPairs(dGeomID theGeom);
+      // joints with two anchors that are checked for the constraint error;
+      // have to be called with iMutex locked
+      void addAnchorJoint(dJointID joint);
+      void removeAnchorJoint(dJointID joint);
       mutable utils::Mutex iMutex;
 
       static interfaces::PhysicsError error;
@@ -112,6 +139,27 @@ namespace mars {
 		
     private:
 
+      // contact data of two geoms that is kept while they touch
+      struct contact_pair {
+        contact_pair() : data1(0), data2(0),
+                         version1(0), version2(0), last_step(0) {
+          memset(&contact, 0, sizeof(dContact));
+        }
+        // surface parameters and friction direction of all contacts
+        dContact contact;
+        // the contact parameters the surface was computed from
+        geom_data *data1, *data2;
+        unsigned long version1, version2;
+        unsigned long last_step;
+      };
+
+      struct terrain_contact {
+        NodePhysics *terrain;
+        dJointFeedback *fb;
+        utils::Vector pos;
+        utils::Vector normal;
+      };
+
       utils::Mutex drawLock;
       dSpaceID space;
       dWorldID world;
@@ -121,14 +169,58 @@ namespace mars {
       interfaces::ControlCenter *control;
       utils::Vector old_gravity;
       interfaces::sReal old_cfm, old_erp;
+      bool old_body_sleeping;
+      int old_iterations;
+      interfaces::sReal old_sor;
+      // iterations used by the adaptive mode
+      int current_iterations;
+      std::vector<dJointID> anchor_joints;
+      interfaces::sReal old_sleep_linear, old_sleep_angular, old_sleep_time;
 
       std::vector<body_nbr_tupel> comp_body_list;
-      std::vector<interfaces::draw_item> draw_intern;
-      std::vector<interfaces::draw_item> draw_extern;
-      std::vector<dJointFeedback*> contact_feedback_list;
+      // start and end point of the contact normals of the last step
+      std::vector<utils::Vector> draw_intern;
+      std::vector<utils::Vector> draw_extern;
+      std::map<std::pair<dGeomID, dGeomID>, contact_pair> contact_cache;
+      std::vector<dContact> contact_buffer;
+      // the feedbacks are reused every step, the first used_feedbacks
+      // are handed out in the current step
+      std::vector<dJointFeedback*> feedback_pool;
+      size_t used_feedbacks;
+      unsigned long step_count;
+      std::map<dGeomID, NodePhysics*> deformable_terrains;
+      // contacts with deformable terrains of the current step
+      std::vector<terrain_contact> terrain_contacts;
       bool create_contacts, log_contacts;
       int num_contacts;
+      dReal max_contact_depth;
       int ray_collision;
+      void setSleepParams(void);
+      void adaptIterations(void);
+      contact_pair& getContactPair(dGeomID o1, dGeomID o2,
+                                   geom_data *geom_data1,
+                                   geom_data *geom_data2);
+      void initContactPair(contact_pair *pair, geom_data *geom_data1,
+                           geom_data *geom_data2);
+      void evictContactPairs(void);
+      dJointFeedback* getContactFeedback(void);
+      void holdFeedbacks(geom_data *data);
+      interfaces::sReal measureConstraintError(void) const;
+      void wakeAllBodies(void);
+
+      // persistent threads of castRays, they take the ranges of ray_job
+      friend class RayCastWorker;
+      mutable std::vector<RayCastWorker*> ray_workers;
+      mutable utils::Mutex ray_mutex;
+      mutable utils::WaitCondition ray_condition, ray_done_condition;
+      mutable const ray_cast_job *ray_job;
+      mutable std::deque<std::pair<size_t, size_t> > ray_ranges;
+      mutable int pending_ray_ranges;
+      bool stop_ray_workers;
+      void startRayWorkers(int numWorkers) const;
+      void stopRayWorkers(void);
+      void rayWorkerLoop(void) const;
+
       // this functions are for the collision implementation
       void nearCallback (dGeomID o1, dGeomID o2);
       static void callbackForward(void *data, dGeomID o1, dGeomID o2);
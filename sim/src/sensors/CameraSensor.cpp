@@ -22,12 +22,14 @@
 
 #include <mars/data_broker/DataBrokerInterface.h>
 #include <mars/utils/mathUtils.h>
+#include <mars/utils/depthUtils.h>
 #include <mars/interfaces/sim/LoadCenter.h>
 #include <mars/interfaces/sim/NodeManagerInterface.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/Logging.hpp>
+#include <mars/utils/AllocationTracker.h>
 
 #include <stdint.h>
 #include <cstring>
@@ -71,7 +73,19 @@ namespace mars {
 
 
       cam_id=0;
-      if(control->graphics) {
+      cam_window_id = 0;
+      gw = 0;
+      gc = 0;
+      // without graphics the ray casting is the only way to get depth
+      rayCast = (this->config.depthBackend == DEPTH_BACKEND_RAYCAST ||
+                 !control->graphics);
+      if(rayCast) {
+        rayCamera.setup(config.width, config.height,
+                        config.opening_width/180.0*M_PI,
+                        config.opening_height/180.0*M_PI, 0.5, 100,
+                        config.rayCastThreads);
+      }
+      else {
 
         //New
         interfaces::hudElementStruct hudCam;
@@ -107,7 +121,7 @@ namespace mars {
         }
       }
 
-      if(!this->config.enabled){
+      if(!this->config.enabled && cam_window_id){
         control->graphics->deactivate3DWindow(cam_window_id);
       }
 
@@ -139,6 +153,11 @@ namespace mars {
     void CameraSensor::getImage(std::vector< Pixel >& buffer)
     {
         assert(buffer.size() == (config.width * config.height));
+        if(rayCast) {
+          // the ray casting only provides depth
+          memset(buffer.data(), 0, buffer.size()*sizeof(Pixel));
+          return;
+        }
         int width;
         int height;
         gw->getImageData(reinterpret_cast<char *>(buffer.data()), width, height);
@@ -150,6 +169,15 @@ namespace mars {
     void CameraSensor::getDepthImage(std::vector< mars::sim::DistanceMeasurement >& buffer)
     {
         assert(buffer.size() == (config.width * config.height));
+        if(rayCast) {
+          mutex.lock();
+          Vector p = position;
+          Quaternion q = orientation;
+          mutex.unlock();
+          rayCamera.getDepthImage(control->sim->getPhysics(), p, q,
+                                  reinterpret_cast<float *>(buffer.data()));
+          return;
+        }
         int width;
         int height;
         gw->getRTTDepthData(reinterpret_cast<float *>(buffer.data()), width, height);
@@ -158,6 +186,17 @@ namespace mars {
         assert(config.height == height);
     }
 
+    void CameraSensor::getPointCloud(std::vector<float> &buffer)
+    {
+        const size_t size = config.width * config.height;
+        depthBuffer.resize(size);
+        getDepthImage(depthBuffer);
+        buffer.resize(size*3);
+        utils::projectDepth(depthBuffer.data(), config.width, config.height,
+                            config.opening_width/180.0*M_PI,
+                            config.opening_height/180.0*M_PI, buffer.data());
+    }
+
 
     // this function is a hack currently, it uses sReal* as byte buffer
     // NOTE: never use the cameraSensor in a controller list!!!!
@@ -234,11 +273,9 @@ namespace mars {
         if(config.enabled) {
           if(renderCam > 2) --renderCam;
           else if(renderCam == 2) {
-            control->graphics->activate3DWindow(cam_window_id);
-            renderCam = 1;
-          }
-          else if(renderCam == 1) {
-            control->graphics->deactivate3DWindow(cam_window_id);
+            // the graphics renders all requested cameras in one frame and
+            // deactivates the window again after the read back
+            control->graphics->requestRTTFrame(cam_window_id);
             renderCam = 0;
           }
         }
@@ -249,6 +286,7 @@ namespace mars {
     void CameraSensor::receiveData(const data_broker::DataInfo &info,
                                    const data_broker::DataPackage &package,
                                    int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
       CPP_UNUSED(info);
       mutex.lock();
       renderCam = 2+config.frameOffset;
@@ -353,6 +391,12 @@ namespace mars {
       else
         cfg->hud_height = cfg->hud_width * ((double)cfg->height / (double)cfg->width);
 
+      if((it = config->find("depth_backend")) != config->end())
+        cfg->depthBackend = depthBackendFromString((std::string)it->second);
+
+      if((it = config->find("raycast_threads")) != config->end())
+        cfg->rayCastThreads = it->second;
+
       if((it = config->find("position_offset")) != config->end()) {
         cfg->pos_offset[0] = it->second["x"];
         cfg->pos_offset[1] = it->second["y"];
@@ -398,6 +442,11 @@ namespace mars {
 //      cfg["enabled"] = config.enabled;
 
 
+      if(config.depthBackend != DEPTH_BACKEND_OPENGL) {
+        cfg["depth_backend"] = depthBackendToString(config.depthBackend);
+        cfg["raycast_threads"] = config.rayCastThreads;
+      }
+
       if(config.show_cam) {
         cfg["show_cam"] = true;
         cfg["show_cam"]["hud_idx"] = config.hud_pos;
@@ -35,6 +35,8 @@
 #include <mars/interfaces/graphics/GraphicsUpdateInterface.h>
 #include <mars/interfaces/graphics/GraphicsCameraInterface.h>
 
+#include "RayCastDepthCamera.h"
+
 #include <inttypes.h>
 typedef uint8_t  u_int8_t;
 
@@ -75,6 +77,8 @@ namespace mars {
         hud_height = -1;
         depthImage = false;
         frameOffset = 1;
+        depthBackend = DEPTH_BACKEND_OPENGL;
+        rayCastThreads = 0;
       }
 
       unsigned long attached_node;
@@ -91,6 +95,8 @@ namespace mars {
       int hud_height;
       bool depthImage;
       bool enabled;
+      DepthBackend depthBackend;
+      int rayCastThreads;
     };
 
     class CameraSensor : public interfaces::BaseNodeSensor,
@@ -107,6 +113,14 @@ namespace mars {
 
       void getImage(std::vector<Pixel> &buffer);
       void getDepthImage(std::vector<DistanceMeasurement> &buffer);
+      /**
+       * \brief Projects the depth image into x,y,z triples in the camera
+       *        frame (z along the view direction, x right, y down).
+       *
+       * \a buffer is resized to 3*width*height floats if needed and can be
+       * reused between calls.
+       */
+      void getPointCloud(std::vector<float> &buffer);
       
       virtual void receiveData(const data_broker::DataInfo &info,
                                const data_broker::DataPackage &package,
@@ -141,6 +155,10 @@ namespace mars {
       utils::Mutex mutex;
       int renderCam;
       unsigned long draw_id;
+      std::vector<DistanceMeasurement> depthBuffer;
+      // used instead of the graphics if config.depthBackend is raycast
+      bool rayCast;
+      RayCastDepthCamera rayCamera;
     };
 
   } // end of namespace sim
@@ -33,6 +33,7 @@
 #include <mars/interfaces/sim/PhysicsInterface.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -62,6 +63,7 @@ namespace mars {
             config) {
       attached_node = config.attached_node;
       updateRate = config.updateRate; // FIXME: is this already cared for?
+      demandDriven = true;
       contactForce = 0.0;
       contact = false;
       contactIndex = -1;
@@ -88,6 +90,8 @@ namespace mars {
       }
       char text[55];
       sprintf(text, "Sensors/HF_%05lu", config.id);
+      producedGroupName = "mars_sim";
+      producedDataName = text;
       dbPushId = control->dataBroker->pushData("mars_sim", text, dbPackage, NULL,
           data_broker::DATA_PACKAGE_READ_FLAG);
       control->dataBroker->registerTimedProducer(this, "mars_sim", text, "mars_sim/simTimer", 0);
@@ -153,21 +157,24 @@ namespace mars {
       return 10;
     }
 
-    int HapticFieldSensor::getSensorData(sReal** data) const {
+    int HapticFieldSensor::readSensorData(sReal* data, int size) const {
+      countRead();
       sReal contact = 0;
       std::vector<double>::const_iterator iter;
 
-      *data = (sReal*) malloc(sizeof(sReal));
+      if(size < 1) return 1;
       for (iter = forces.begin(); iter != forces.end(); iter++) {
         contact += *iter;
         ;
       }
-      **data = contact;
+      *data = contact;
       return 1;
     }
 
     void HapticFieldSensor::receiveData(const data_broker::DataInfo &info,
         const data_broker::DataPackage &package, int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if (contactForceIndex == -1) {
         contactForceIndex = package.getIndexByName("contactForce");
         contactIndex = package.getIndexByName("contact");
@@ -205,6 +212,7 @@ namespace mars {
 
     void HapticFieldSensor::produceData(const data_broker::DataInfo &info,
         data_broker::DataPackage *dbPackage, int callbackParam) {
+      if(!isActive()) return;
       Vector tmp;
       dbPackage->set(0, (long) id);
       fprintf(stderr, "  HapticFieldSensor: ");
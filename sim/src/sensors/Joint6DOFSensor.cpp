@@ -42,6 +42,7 @@
 #include <mars/interfaces/sim/LoadCenter.h>
 
 #include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <envire_core/graph/EnvireGraph.hpp>
 #include <envire_core/items/Item.hpp>
@@ -71,6 +72,7 @@ namespace mars {
 
       frame = config.frame;
       updateRate = config.updateRate;     
+      demandDriven = true;
 
       std::vector<unsigned long>::iterator iter;
       jointPackageId = nodePackageId = 0;
@@ -156,6 +158,8 @@ namespace mars {
 
         char text[55];
         sprintf(text, "Sensors/FT_%05lu", config.id);
+        producedGroupName = "mars_sim";
+        producedDataName = text;
 
         dbPushId = control->dataBroker->pushData("mars_sim", text,
                                            dbPackage, NULL,
@@ -188,31 +192,36 @@ namespace mars {
     }
 
 
-    int Joint6DOFSensor::getSensorData(sReal** data) const {
+    int Joint6DOFSensor::readSensorData(sReal* data, int size) const {
+      countRead();
       Vector tmp;
-  
-      *data = (sReal*)malloc(sizeof(sReal)*6);
+
+      if(size < 6) return 6;
       tmp = (sensor_data.body_q * sensor_data.force);
-      (*data)[0] = tmp.x();
-      (*data)[1] = tmp.y();
-      (*data)[2] = tmp.z();
+      data[0] = tmp.x();
+      data[1] = tmp.y();
+      data[2] = tmp.z();
       tmp = (sensor_data.body_q * sensor_data.torque);
-      (*data)[3] = tmp.x();
-      (*data)[4] = tmp.y();
-      (*data)[5] = tmp.z();
+      data[3] = tmp.x();
+      data[4] = tmp.y();
+      data[5] = tmp.z();
       return 6;
     }
 
     void Joint6DOFSensor::getForceData(utils::Vector *force){
+    	countRead();
     	*force = (sensor_data.body_q * sensor_data.force);
     }
     void Joint6DOFSensor::getTorqueData(utils::Vector *torque){
+    	countRead();
     	*torque = (sensor_data.body_q * sensor_data.torque);
     }
     void Joint6DOFSensor::getAnchor(utils::Vector *anchor){
+    	countRead();
     	*anchor = sensor_data.anchor;
     }
     void Joint6DOFSensor::getBodyQ(utils::Quaternion* body_q){
+    	countRead();
     	*body_q = sensor_data.body_q;
     }
 
@@ -220,6 +229,7 @@ namespace mars {
     void Joint6DOFSensor::produceData(const data_broker::DataInfo &info,
                                       data_broker::DataPackage *dbPackage,
                                       int callbackParam) {
+      if(!isActive()) return;
       Vector tmp;
       dbPackage->set(0, (long)id);
       tmp = (sensor_data.body_q * sensor_data.force);
@@ -236,6 +246,8 @@ namespace mars {
     void Joint6DOFSensor::receiveData(const data_broker::DataInfo &info,
                                       const data_broker::DataPackage &package,
                                       int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
 
         
       if(nodePackageId == info.dataId) {
@@ -28,6 +28,7 @@
 
 #include <cstdio>
 #include "JointAVGTorqueSensor.h"
+#include <mars/utils/AllocationTracker.h>
 
 namespace mars {
   namespace sim {
@@ -53,6 +54,8 @@ namespace mars {
       dbPackage.add("torque", 0.0);
       char text[55];
       sprintf(text, "Sensors/AVGTorque_%05lu", config.id);
+      producedGroupName = "mars_sim";
+      producedDataName = text;
       control->dataBroker->pushData("mars_sim", text,
                                     dbPackage, NULL,
                                     data_broker::DATA_PACKAGE_READ_FLAG);
@@ -82,16 +85,15 @@ namespace mars {
 
     }
 
-    int JointAVGTorqueSensor::getSensorData(sReal** data) const {
+    int JointAVGTorqueSensor::readSensorData(sReal* data, int size) const {
       std::vector<double>::const_iterator iter;
 
-      *data = (sReal*)malloc(sizeof(sReal));
-      **data = 0;
+      if(size < 1) return 1;
+      *data = 0;
       for(iter = doubleArray.begin(); iter != doubleArray.end(); iter++) {
-        **data += *iter;
+        *data += *iter;
       }
-      **data /= doubleArray.size();
-
+      *data /= doubleArray.size();
       return 1;
     }
 
@@ -99,6 +101,7 @@ namespace mars {
     void JointAVGTorqueSensor::produceData(const data_broker::DataInfo &info,
                                            data_broker::DataPackage *dbPackage,
                                            int callbackParam) {
+      if(!isActive()) return;
       (void)callbackParam;
       (void)info;
       sReal torque = 0;
@@ -120,6 +123,8 @@ namespace mars {
     void JointAVGTorqueSensor::receiveData(const data_broker::DataInfo &info,
                                            const data_broker::DataPackage &package,
                                            int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(torqueIndices[0] == -1) {
         torqueIndices[0] = package.getIndexByName("axis1/torque/x");
         torqueIndices[1] = package.getIndexByName("axis1/torque/y");
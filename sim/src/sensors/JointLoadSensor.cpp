@@ -29,6 +29,7 @@
 #include <cstdio>
 
 #include "JointLoadSensor.h"
+#include <mars/utils/AllocationTracker.h>
 
 namespace mars {
   namespace sim {
@@ -53,6 +54,8 @@ namespace mars {
       dbPackage.add("load", 0.0);
       char text[55];
       sprintf(text, "Sensors/Load_%05lu", config.id);
+      producedGroupName = "mars_sim";
+      producedDataName = text;
       control->dataBroker->pushData("mars_sim", text,
                                     dbPackage, NULL,
                                     data_broker::DATA_PACKAGE_READ_FLAG);
@@ -80,21 +83,22 @@ namespace mars {
       return 7;
     }
 
-    int JointLoadSensor::getSensorData(sReal** data) const {
+    int JointLoadSensor::readSensorData(sReal* data, int size) const {
       std::vector<double>::const_iterator iter;
 
-      *data = (sReal*)malloc(sizeof(sReal));
-      **data = 0;
+      if(size < 1) return 1;
+      *data = 0;
       for(iter = doubleArray.begin(); iter != doubleArray.end(); iter++) {
-        **data += *iter;
+        *data += *iter;
       }
-      **data /= doubleArray.size();
+      *data /= doubleArray.size();
       return 1;
     }
 
     void JointLoadSensor::produceData(const data_broker::DataInfo &info,
                                       data_broker::DataPackage *dbPackage,
                                       int callbackParam) {
+      if(!isActive()) return;
       (void)callbackParam;
       (void)info;
       sReal load = 0;
@@ -116,6 +120,8 @@ namespace mars {
     void JointLoadSensor::receiveData(const data_broker::DataInfo &info,
                                       const data_broker::DataPackage &package,
                                       int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(loadIndices[0] == -1) {
         loadIndices[0] = package.getIndexByName("jointLoad/x");
         loadIndices[1] = package.getIndexByName("jointLoad/y");
@@ -48,7 +48,7 @@ namespace mars {
       ~JointLoadSensor(void);
 
       virtual int getAsciiData(char* data) const ;
-      virtual int getSensorData(interfaces::sReal **data) const ;
+      virtual int readSensorData(interfaces::sReal *data, int size) const;
       virtual void produceData(const data_broker::DataInfo &info,
                                data_broker::DataPackage *package,
                                int callbackParam);
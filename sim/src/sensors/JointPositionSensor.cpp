@@ -29,6 +29,7 @@
 #include "JointPositionSensor.h"
 
 #include <cstdio>
+#include <mars/utils/AllocationTracker.h>
 
 namespace mars {
   namespace sim {
@@ -55,6 +56,8 @@ namespace mars {
     void JointPositionSensor::receiveData(const data_broker::DataInfo &info,
                                           const data_broker::DataPackage &package,
                                           int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(angleIndex == -1)
         angleIndex = package.getIndexByName("axis1/angle");
       package.get(angleIndex, &doubleArray[callbackParam]);
@@ -29,6 +29,7 @@
 #include <cstdio>
 
 #include "JointTorqueSensor.h"
+#include <mars/utils/AllocationTracker.h>
 
 namespace mars {
   namespace sim {
@@ -69,6 +70,8 @@ namespace mars {
     void JointTorqueSensor::receiveData(const data_broker::DataInfo &info,
                                         const data_broker::DataPackage &package,
                                         int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(motorTorqueIndex == -1) {
         motorTorqueIndex = package.getIndexByName("motorTorque");
       }
@@ -29,6 +29,7 @@
 #include "JointVelocitySensor.h"
 
 #include <cstdio>
+#include <mars/utils/AllocationTracker.h>
 
 namespace mars {
   namespace sim {
@@ -70,6 +71,8 @@ namespace mars {
     void JointVelocitySensor::receiveData(const data_broker::DataInfo &info,
                                           const data_broker::DataPackage &package,
                                           int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(speedIndex == -1) {
         speedIndex = package.getIndexByName("axis1/speed");
       }
@@ -29,6 +29,7 @@
 #include "MotorCurrentSensor.h"
 #include <mars/interfaces/sim/MotorManagerInterface.h>
 #include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -61,6 +62,7 @@ namespace mars {
       config(config), typeName("MotorCurrent") {
 
       updateRate = config.updateRate;
+      demandDriven = true;
 
       countIDs = 0;
       std::vector<unsigned long>::iterator it;
@@ -98,13 +100,14 @@ namespace mars {
       return num_char;
     }
 
-    int MotorCurrentSensor::getSensorData(sReal** data) const {
+    int MotorCurrentSensor::readSensorData(sReal* data, int size) const {
+      countRead();
       std::vector<double>::const_iterator iter;
       int i=0;
 
-      *data = (sReal*)calloc(doubleArray.size(), sizeof(sReal));
+      if(size < (int)doubleArray.size()) return doubleArray.size();
       for(iter = doubleArray.begin(); iter != doubleArray.end(); iter++) {
-        (*data)[i++] = *iter;
+        data[i++] = *iter;
       }
       return i;
     }
@@ -113,6 +116,8 @@ namespace mars {
     void MotorCurrentSensor::receiveData(const data_broker::DataInfo &info,
                                          const data_broker::DataPackage &package,
                                          int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(dbCurrentIndex == -1) {
         dbCurrentIndex = package.getIndexByName("current");
       }
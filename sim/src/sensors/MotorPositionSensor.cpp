@@ -29,6 +29,7 @@
 #include "MotorPositionSensor.h"
 #include <mars/interfaces/sim/MotorManagerInterface.h>
 #include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -109,6 +110,7 @@ namespace mars {
     void MotorPositionSensor::receiveData(const data_broker::DataInfo &info,
                                           const data_broker::DataPackage &package,
                                           int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
       if(positionIndex == -1) {
         positionIndex = package.getIndexByName("position");
       }
@@ -6,6 +6,7 @@
 
 #include <mars/data_broker/DataBrokerInterface.h>
 #include <mars/utils/mathUtils.h>
+#include <mars/utils/AllocationTracker.h>
 #include <base/Float.hpp>
 
 #include <cmath>
@@ -47,7 +48,11 @@ MultiLevelLaserRangeFinder::MultiLevelLaserRangeFinder(ControlCenter *control, M
     //register timer for caputuring the data
     control->dataBroker->registerTimedReceiver(this, groupName, dataName,"mars_sim/simTimer",updateRate);
 
-    if(control->graphics) {
+    // without graphics the ray casting is the only way to get depth
+    rayCast = (config.depthBackend == DEPTH_BACKEND_RAYCAST ||
+               !control->graphics);
+
+    if(!rayCast) {
         double anglePerCamera = M_PI /2.0;
         
         int numCameras = ceil(config.horizontalOpeningAngle / anglePerCamera); 
@@ -138,14 +143,17 @@ MultiLevelLaserRangeFinder::MultiLevelLaserRangeFinder(ControlCenter *control, M
     //register ourself here, or we won't get RTT images
     drawStruct draw;
     draw.ptr_draw = (DrawInterface*)this;
-    if(control->graphics)
+    if(!rayCast)
         control->graphics->addDrawItems(&draw);
     
-    calculateSamplingPixels();
+    if(rayCast)
+        calculateRayDirections();
+    else
+        calculateSamplingPixels();
 }
 
 MultiLevelLaserRangeFinder::~MultiLevelLaserRangeFinder(void) {
-  if(control->graphics)
+  if(!rayCast)
     control->graphics->removeDrawItems((DrawInterface*)this);
   control->dataBroker->unregisterTimedReceiver(this, "*", "*", "mars_sim/simTimer");
 }
@@ -176,6 +184,7 @@ int MultiLevelLaserRangeFinder::getSensorData(double** data) const
 void MultiLevelLaserRangeFinder::receiveData(const data_broker::DataInfo &info,
                             const data_broker::DataPackage &package,
                             int callbackParam) {
+    utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
     CPP_UNUSED(info);
     CPP_UNUSED(callbackParam);
     long id;
@@ -198,6 +207,53 @@ void MultiLevelLaserRangeFinder::receiveData(const data_broker::DataInfo &info,
     package.get(rotationIndices[2], &orientation.z());
     package.get(rotationIndices[3], &orientation.w());
 
+    if(rayCast) {
+        rayDistances.resize(directions.size());
+        control->sim->getPhysics()->castRays(position, orientation, directions,
+                                             0.5, config.maxDistance,
+                                             rayDistances.data(),
+                                             rayCastThreadCount(config.rayCastThreads));
+        // rays without hit are NaN, i.e. base::unset
+        for(size_t i = 0; i < rayDistances.size(); i++)
+            rayValues[i] = rayDistances[i];
+    }
+}
+
+void MultiLevelLaserRangeFinder::calculateRayDirections()
+{
+    // the same beams as sampled from the depth images of the sub cameras
+    // in calculateSamplingPixels, but given as unit vectors that are
+    // rotated by the sensor orientation
+    const double verticalStartAngle = -config.verticalOpeningAngle / 2.0;
+    const double stepHorizontal = config.horizontalOpeningAngle / (config.numRaysHorizontal - 1);
+    const double stepVertical = config.verticalOpeningAngle / (config.numRaysVertical - 1);
+    const int numCameras = ceil(config.horizontalOpeningAngle / (M_PI / 2.0));
+
+    double curHorAngle = 0;
+    int camera = 0;
+
+    directions.resize(config.numRaysHorizontal * config.numRaysVertical);
+
+    for(int h = 0; h < config.numRaysHorizontal; h++)
+    {
+        Quaternion cameraOrientation = Eigen::AngleAxisd(2*M_PI - camera * M_PI / 2.0, Eigen::Vector3d::UnitZ()) * eulerToQuaternion(Vector(90,0,-90));
+
+        for(int v = 0; v < config.numRaysVertical; v++)
+        {
+            double verAngle = verticalStartAngle + v * stepVertical;
+            // the camera looks along its negative z axis with y up
+            Vector dir(tan(curHorAngle), -tan(verAngle) / cos(curHorAngle), -1.0);
+            directions[v + (config.numRaysHorizontal - h - 1) * config.numRaysVertical] = (cameraOrientation * dir).normalized();
+        }
+
+        curHorAngle += stepHorizontal;
+
+        if(curHorAngle > M_PI/4.0)
+        {
+            curHorAngle -= M_PI/2.0;
+            camera = (camera + 1) % numCameras;
+        }
+    }
 }
 
 void MultiLevelLaserRangeFinder::calculateSamplingPixels()
@@ -346,6 +402,10 @@ BaseConfig* MultiLevelLaserRangeFinder::parseConfig(ControlCenter *control,
       cfg->horizontalOpeningAngle = it->second;
     if((it = config->find("maxDistance")) != config->end())
       cfg->maxDistance = it->second;
+    if((it = config->find("depth_backend")) != config->end())
+      cfg->depthBackend = depthBackendFromString((std::string)it->second);
+    if((it = config->find("raycast_threads")) != config->end())
+      cfg->rayCastThreads = it->second;
 
     return cfg;
 }
@@ -365,6 +425,10 @@ ConfigMap MultiLevelLaserRangeFinder::createConfig() const {
     cfg["horizontalOpeningAngle"] = config.horizontalOpeningAngle;
     cfg["rate"] = config.updateRate;
     cfg["maxDistance"] = config.maxDistance;
+    if(config.depthBackend != DEPTH_BACKEND_OPENGL) {
+      cfg["depth_backend"] = depthBackendToString(config.depthBackend);
+      cfg["raycast_threads"] = config.rayCastThreads;
+    }
     return cfg;
 }
 
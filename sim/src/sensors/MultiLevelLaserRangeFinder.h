@@ -11,6 +11,8 @@
 #include <mars/utils/Quaternion.h>
 #include <mars/interfaces/graphics/draw_structs.h>
 #include <mars/interfaces/graphics/GraphicsUpdateInterface.h>
+
+#include "RayCastDepthCamera.h"
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <base/samples/DistanceImage.hpp>
 
@@ -30,6 +32,8 @@ namespace mars {
         horizontalOpeningAngle= 2 * M_PI * (double (numRaysHorizontal - 1)) / numRaysHorizontal;
         attached_node = 0;
         maxDistance = 100.0;
+        depthBackend = DEPTH_BACKEND_OPENGL;
+        rayCastThreads = 0;
       }
 
       unsigned long attached_node;
@@ -40,6 +44,8 @@ namespace mars {
       double verticalOpeningAngle;
       double horizontalOpeningAngle;
       double maxDistance;
+      DepthBackend depthBackend;
+      int rayCastThreads;
     };
 
     class MultiLevelLaserRangeFinder : 
@@ -75,6 +81,7 @@ namespace mars {
     private:
         
         void calculateSamplingPixels();
+        void calculateRayDirections();
         
         MultiLevelLaserRangeFinderConfig config;
         struct RaySubSensor
@@ -106,7 +113,10 @@ namespace mars {
         
         std::vector<double> rayValues;
         
+        // beam directions in the sensor frame if rayCast is set
         std::vector<utils::Vector> directions;
+        std::vector<float> rayDistances;
+        bool rayCast;
         long positionIndices[3];
         long rotationIndices[4];
     };
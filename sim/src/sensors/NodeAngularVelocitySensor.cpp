@@ -23,6 +23,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <mars/data_broker/DataPackage.h>
+#include <mars/utils/AllocationTracker.h>
 
 namespace mars {
   namespace sim {
@@ -68,15 +69,15 @@ namespace mars {
       return num_char;
     }
 
-    int NodeAngularVelocitySensor::getSensorData(sReal** data) const {
+    int NodeAngularVelocitySensor::readSensorData(sReal* data, int size) const {
       std::vector<Vector>::const_iterator iter;
       int i=0;
 
-      *data = (sReal*)calloc(3*values.size(), sizeof(sReal));
+      if(size < 3*(int)values.size()) return 3*values.size();
       for(iter = values.begin(); iter != values.end(); iter++) {
-        (*data)[i++] = iter->x();
-        (*data)[i++] = iter->y();
-        (*data)[i++] = iter->z();
+        data[i++] = iter->x();
+        data[i++] = iter->y();
+        data[i++] = iter->z();
       }
       return i;
     }
@@ -84,6 +85,8 @@ namespace mars {
     void NodeAngularVelocitySensor::receiveData(const data_broker::DataInfo &info,
                                                 const data_broker::DataPackage &package,
                                                 int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(angularVelocityIndices[0] == -1) {
         angularVelocityIndices[0] = package.getIndexByName("angularVelocity/x");
         angularVelocityIndices[1] = package.getIndexByName("angularVelocity/y");
@@ -74,6 +74,7 @@ namespace mars {
       typeName("unknown type"), config(config) {
   
       updateRate = config.updateRate;
+      demandDriven = true;
       if(registerReceiver) {
         countIDs = 0;
         std::vector<unsigned long>::iterator it;
@@ -122,15 +123,15 @@ namespace mars {
       return num_char;
     }
 
-    int NodeArraySensor::getSensorData(sReal** data) const {
+    int NodeArraySensor::readSensorData(sReal* data, int size) const {
+      countRead();
       std::vector<double>::const_iterator iter;
       int i=0;
 
-      *data = (sReal*)calloc(doubleArray.size(), sizeof(sReal));
+      if(size < (int)doubleArray.size()) return doubleArray.size();
       for(iter = doubleArray.begin(); iter != doubleArray.end(); iter++) {
-        (*data)[i++] = *iter;
+        data[i++] = *iter;
       }
-
       return i;
     }
 
@@ -89,18 +89,18 @@ namespace mars {
       return 21;
     }
 
-    int NodeCOMSensor::getSensorData(sReal** data) const {
+    int NodeCOMSensor::readSensorData(sReal* data, int size) const {
       // NOTE In the current implementation, there could be more than one node physics in the frame. Can we restrict this? If they are used for the joints, why do we need more than one? Can't we have a same physics node being joined to multiple?
       
       // NOTE This is not working if the sensors are in various frames (usual case). For the case of CREX we only have one, therefore it will work fine.
       // FIXME This method should look accross all the frames not only in the one of the attribute frame
       
+      if(size < 3) return 3;
       Vector center = getCenterOfMass();
-  
-      *data = (sReal*)calloc(3, sizeof(sReal));
-      (*data)[0] = center.x();
-      (*data)[1] = center.y();
-      (*data)[2] = center.z();
+
+      data[0] = center.x();
+      data[1] = center.y();
+      data[2] = center.z();
       return 3;
     }
 
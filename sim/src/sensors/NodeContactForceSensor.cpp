@@ -28,6 +28,7 @@
 
 #include "NodeContactForceSensor.h"
 #include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -58,6 +59,8 @@ namespace mars {
       dbPackage.add("contactForce", 0.0);
       std::string groupName = "mars_sim";
       std::string dataName = "sensors/"+name;
+      producedGroupName = groupName;
+      producedDataName = dataName;
       control->dataBroker->pushData(groupName, dataName,
                                     dbPackage, NULL,
                                     data_broker::DATA_PACKAGE_READ_FLAG);
@@ -85,21 +88,23 @@ namespace mars {
       return 10;
     }
 
-    int NodeContactForceSensor::getSensorData(sReal** data) const {
+    int NodeContactForceSensor::readSensorData(sReal* data, int size) const {
       sReal contact = 0;
       std::vector<double>::const_iterator iter;
-  
-      *data = (sReal*)malloc(sizeof(sReal));
+
+      if(size < 1) return 1;
       for(iter = doubleArray.begin(); iter != doubleArray.end(); iter++) {
         contact += *iter;;
       }
-      **data = contact;
+      *data = contact;
       return 1;
     }
 
     void NodeContactForceSensor::receiveData(const data_broker::DataInfo &info,
                                              const data_broker::DataPackage &package,
                                              int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(contactForceIndex == -1) {
         contactForceIndex = package.getIndexByName("contactForce");
       }
@@ -109,6 +114,7 @@ namespace mars {
     void NodeContactForceSensor::produceData(const data_broker::DataInfo &info,
                                              data_broker::DataPackage *package,
                                              int callbackParam) {
+      if(!isActive()) return;
       sReal contact = 0;
       std::vector<double>::const_iterator iter;
 
@@ -28,6 +28,7 @@
 #include "NodeContactSensor.h"
 #include <mars/interfaces/sim/NodeManagerInterface.h>
 #include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -110,15 +111,15 @@ namespace mars {
       return 2;
     }
 
-    int NodeContactSensor::getSensorData(sReal** data) const {
+    int NodeContactSensor::readSensorData(sReal* data, int size) const {
       bool contact = 0;
       std::vector<bool>::const_iterator iter;
-  
-      *data = (sReal*)malloc(sizeof(sReal));
+
+      if(size < 1) return 1;
       for(iter = values.begin(); iter != values.end(); iter++) {
         contact |= *iter;
       }
-      **data = contact;
+      *data = contact;
       return 1;
     }
 
@@ -126,6 +127,8 @@ namespace mars {
     void NodeContactSensor::receiveData(const data_broker::DataInfo &info,
                                         const data_broker::DataPackage &package,
                                         int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(groundContactIndex == -1) {
         groundContactIndex = package.getIndexByName("contact");
       }
@@ -49,7 +49,7 @@ namespace mars {
       NodeContactSensor(interfaces::ControlCenter *control, IDListConfig config);
       ~NodeContactSensor(void);
       virtual int getAsciiData(char* data) const ;
-      virtual int getSensorData(interfaces::sReal** data) const;
+      virtual int readSensorData(interfaces::sReal *data, int size) const;
       virtual void receiveData(const data_broker::DataInfo &info,
                                const data_broker::DataPackage &package,
                                int callbackParam);
@@ -29,6 +29,7 @@
 #include "NodePositionSensor.h"
 
 #include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -74,15 +75,15 @@ namespace mars {
       return num_char;
     }
 
-    int NodePositionSensor::getSensorData(sReal** data) const {
+    int NodePositionSensor::readSensorData(sReal* data, int size) const {
       std::vector<Vector>::const_iterator iter;
       int i=0;
 
-      *data = (sReal*)calloc(3*values.size(), sizeof(sReal));
+      if(size < 3*(int)values.size()) return 3*values.size();
       for(iter = values.begin(); iter != values.end(); iter++) {
-        (*data)[i++] = iter->x();
-        (*data)[i++] = iter->y();
-        (*data)[i++] = iter->z();
+        data[i++] = iter->x();
+        data[i++] = iter->y();
+        data[i++] = iter->z();
       }
       return i;
     }
@@ -90,6 +91,8 @@ namespace mars {
     void NodePositionSensor::receiveData(const data_broker::DataInfo &info,
                                          const data_broker::DataPackage &package,
                                          int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(posIndices[0] == -1) {
         posIndices[0] = package.getIndexByName("position/x");
         posIndices[1] = package.getIndexByName("position/y");
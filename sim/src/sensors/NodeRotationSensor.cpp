@@ -29,6 +29,7 @@
 #include "NodeRotationSensor.h"
 #include <mars/data_broker/DataBrokerInterface.h>
 #include <mars/utils/mathUtils.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -77,14 +78,15 @@ namespace mars {
       return num_char;
     }
 
-    int NodeRotationSensor::getSensorData(sReal** data) const {
+    int NodeRotationSensor::readSensorData(sReal* data, int size) const {
       std::vector<sRotation>::const_iterator iter;
-  
-      *data = (sReal*)calloc(3, sizeof(sReal));
+
+      if(size < 3) return 3;
+      data[0] = data[1] = data[2] = 0.0;
       for(iter = values.begin(); iter != values.end(); iter++) {
-        (*data)[0] = iter->alpha;
-        (*data)[1] = iter->beta;
-        (*data)[2] = iter->gamma;
+        data[0] = iter->alpha;
+        data[1] = iter->beta;
+        data[2] = iter->gamma;
       }
       return 3;
     }
@@ -92,6 +94,8 @@ namespace mars {
     void NodeRotationSensor::receiveData(const data_broker::DataInfo &info,
                                          const data_broker::DataPackage &package,
                                          int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(rotationIndices[0] == -1) {
         rotationIndices[0] = package.getIndexByName("rotation/x");
         rotationIndices[1] = package.getIndexByName("rotation/y");
@@ -22,6 +22,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <mars/data_broker/DataPackage.h>
+#include <mars/utils/AllocationTracker.h>
 
 namespace mars {
   namespace sim {
@@ -67,15 +68,15 @@ namespace mars {
       return num_char;
     }
 
-    int NodeVelocitySensor::getSensorData(sReal** data) const {
+    int NodeVelocitySensor::readSensorData(sReal* data, int size) const {
       std::vector<Vector>::const_iterator iter;
       int i=0;
 
-      *data = (sReal*)calloc(3*values.size(), sizeof(sReal));
+      if(size < 3*(int)values.size()) return 3*values.size();
       for(iter = values.begin(); iter != values.end(); iter++) {
-        (*data)[i++] = iter->x();
-        (*data)[i++] = iter->y();
-        (*data)[i++] = iter->z();
+        data[i++] = iter->x();
+        data[i++] = iter->y();
+        data[i++] = iter->z();
       }
       return i;
     }
@@ -83,6 +84,8 @@ namespace mars {
     void NodeVelocitySensor::receiveData(const data_broker::DataInfo &info,
                                          const data_broker::DataPackage &package,
                                          int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
+      if(!beginUpdate()) return;
       if(velocityIndices[0] == -1) {
         velocityIndices[0] = package.getIndexByName("linearVelocity/x");
         velocityIndices[1] = package.getIndexByName("linearVelocity/y");
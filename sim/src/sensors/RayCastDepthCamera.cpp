@@ -0,0 +1,107 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RayCastDepthCamera.h"
+
+#include <mars/interfaces/sim/PhysicsInterface.h>
+
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace mars {
+  namespace sim {
+
+    using namespace utils;
+
+    DepthBackend depthBackendFromString(const std::string &name) {
+      if(name == "raycast") return DEPTH_BACKEND_RAYCAST;
+      return DEPTH_BACKEND_OPENGL;
+    }
+
+    std::string depthBackendToString(DepthBackend backend) {
+      if(backend == DEPTH_BACKEND_RAYCAST) return "raycast";
+      return "opengl";
+    }
+
+    int rayCastThreadCount(int requested) {
+      if(requested > 0) return requested;
+      int cores = std::thread::hardware_concurrency();
+      return cores > 0 ? cores : 1;
+    }
+
+    RayCastDepthCamera::RayCastDepthCamera()
+      : width(0), height(0), numThreads(1),
+        zNear(0.5), zFar(100.), maxDistance(100.) {
+    }
+
+    void RayCastDepthCamera::setup(int width_, int height_,
+                                   double fovx, double fovy,
+                                   double zNear_, double zFar_,
+                                   int numThreads_) {
+      width = width_;
+      height = height_;
+      zNear = zNear_;
+      zFar = zFar_;
+      numThreads = rayCastThreadCount(numThreads_);
+
+      // the same pixel geometry as utils::projectDepth
+      const double invFx = tan(0.5*fovx) / (0.5*width);
+      const double invFy = tan(0.5*fovy) / (0.5*height);
+      const double cx = 0.5*(width-1);
+      const double cy = 0.5*(height-1);
+      double minViewAxis = 1.0;
+
+      directions.resize((size_t)width*height);
+      viewAxis.resize(directions.size());
+      for(int row=0; row<height; ++row) {
+        for(int k=0; k<width; ++k) {
+          // x right, y up and the view along -z as in the OSG camera frame
+          Vector dir((k - cx)*invFx, -(row - cy)*invFy, -1.0);
+          dir.normalize();
+          const size_t i = (size_t)row*width + k;
+          directions[i] = dir;
+          viewAxis[i] = (float)-dir.z();
+          if(-dir.z() < minViewAxis) minViewAxis = -dir.z();
+        }
+      }
+      // the rays to the image corners reach the far plane last
+      maxDistance = zFar / minViewAxis;
+    }
+
+    void RayCastDepthCamera::getDepthImage(interfaces::PhysicsInterface *physics,
+                                           const Vector &position,
+                                           const Quaternion &orientation,
+                                           float *depth) {
+      const float nan = std::numeric_limits<float>::quiet_NaN();
+      const float far = (float)zFar;
+      const size_t size = directions.size();
+
+      physics->castRays(position, orientation, directions, zNear, maxDistance,
+                        depth, numThreads);
+      for(size_t i=0; i<size; ++i) {
+        // comparisons with NaN are false, rays without hit stay NaN
+        const float z = depth[i]*viewAxis[i];
+        depth[i] = (z <= far) ? z : nan;
+      }
+    }
+
+  } // end of namespace sim
+} // end of namespace mars
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RAY_CAST_DEPTH_CAMERA_H
+#define RAY_CAST_DEPTH_CAMERA_H
+
+#ifdef _PRINT_HEADER_
+#warning "RayCastDepthCamera.h"
+#endif
+
+#include <mars/utils/Vector.h>
+#include <mars/utils/Quaternion.h>
+
+#include <string>
+#include <vector>
+
+namespace mars {
+
+  namespace interfaces {
+    class PhysicsInterface;
+  }
+
+  namespace sim {
+
+    /**
+     * Selects how the depth sensors produce their depth images. With
+     * DEPTH_BACKEND_RAYCAST no graphics context is needed, thus it is
+     * used as well whenever the simulation runs without graphics.
+     */
+    enum DepthBackend {
+      DEPTH_BACKEND_OPENGL,
+      DEPTH_BACKEND_RAYCAST
+    };
+
+    /** "opengl" or "raycast", unknown names select the OpenGL backend. */
+    DepthBackend depthBackendFromString(const std::string &name);
+    std::string depthBackendToString(DepthBackend backend);
+    /** Resolves a configured thread count, 0 means one thread per core. */
+    int rayCastThreadCount(int requested);
+
+    /**
+     * \brief Produces the depth image of a camera by ray casting against
+     * the collision geometry.
+     *
+     * The image has the same layout as GraphicsWindowInterface::
+     * getRTTDepthData: rows from top to bottom, the depth along the view
+     * axis in meter and NaN for pixels without a hit before the far plane.
+     * The pose uses the convention of GraphicsCameraInterface::
+     * updateViewportQuat, i.e. the camera looks along its negative z axis.
+     */
+    class RayCastDepthCamera {
+    public:
+      RayCastDepthCamera();
+
+      /**
+       * \param fovx Horizontal opening angle in radian.
+       * \param fovy Vertical opening angle in radian.
+       * \param numThreads Number of threads the rows are split into,
+       *                   0 uses one thread per core.
+       */
+      void setup(int width, int height, double fovx, double fovy,
+                 double zNear, double zFar, int numThreads = 0);
+
+      void getDepthImage(interfaces::PhysicsInterface *physics,
+                         const utils::Vector &position,
+                         const utils::Quaternion &orientation,
+                         float *depth);
+
+      int getWidth() const {return width;}
+      int getHeight() const {return height;}
+
+    private:
+      int width, height, numThreads;
+      double zNear, zFar, maxDistance;
+      // unit view rays of all pixels and their component along the view axis
+      std::vector<utils::Vector> directions;
+      std::vector<float> viewAxis;
+    }; // end of class RayCastDepthCamera
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif
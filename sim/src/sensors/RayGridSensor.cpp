@@ -34,6 +34,7 @@
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 
 #include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cmath>
 
@@ -131,6 +132,7 @@ namespace mars {
     void RayGridSensor::receiveData(const data_broker::DataInfo &info,
                                     const data_broker::DataPackage &package,
                                     int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
       CPP_UNUSED(info);
       CPP_UNUSED(callbackParam);
       if(positionIndices[0] == -1) {
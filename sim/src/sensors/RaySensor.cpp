@@ -34,6 +34,7 @@
 
 #include <mars/data_broker/DataBrokerInterface.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <cmath>
 #include <cstdio>
@@ -59,13 +60,12 @@ namespace mars {
       SensorInterface(control), config(config) {
 
       updateRate = config.updateRate;
+      demandDriven = true;
       orientation.setIdentity();
       maxDistance = config.maxDistance;
       this->attached_node = config.attached_node;
 
       std::string groupName, dataName;
-      drawStruct draw;
-      draw_item item;
       int i;
       Vector tmp;
       have_update = false;
@@ -86,20 +86,6 @@ namespace mars {
 
       //Drawing Stuff
       if(config.draw_rays) {
-        draw.ptr_draw = (DrawInterface*)this;
-        item.id = 0;
-        item.type = DRAW_LINE;
-        item.draw_state = DRAW_STATE_CREATE;
-        item.point_size = 1;
-        item.myColor.r = 1;
-        item.myColor.g = 0;
-        item.myColor.b = 0;
-        item.myColor.a = 1;
-        item.texture = "";
-        item.t_width = item.t_height = 0;
-        item.get_light = 0.0;
-          
-    
         double rad_steps = getCols(); //rad_angle/(sReal)(sensor.resolution-1);
         double rad_start = -((rad_steps-1)/2.0)*stepX; //Starting to Left, because 0 is in front and rock convention posive CCW //(M_PI-rad_angle)/2;
         if(rad_steps == 1){
@@ -112,29 +98,24 @@ namespace mars {
           tmp = Vector(cos(rad_start+i*stepX),
                        sin(rad_start+i*stepX), 0);
           directions.push_back(tmp);
-          tmp = (orientation * tmp);
-          item.start = position;
-          item.end = (orientation * tmp);
-          item.end *= data[i];
-          draw.drawItems.push_back(item); // TEST
         }
-    
-        if(control->graphics)
-          control->graphics->addDrawItems(&draw);
-        
-    
+
+        if(control->sim)
+          control->sim->addPhysicsDebugDrawInterface(this);
+
         assert(rad_steps == data.size());
       }
     }
 
     RaySensor::~RaySensor(void) {
-      if(control->graphics)
-        control->graphics->removeDrawItems((DrawInterface*)this);
+      if(control->sim)
+        control->sim->removePhysicsDebugDrawInterface(this);
       control->dataBroker->unregisterTimedReceiver(this, "*", "*", 
                                                    "mars_sim/simTimer");
     }
 
     std::vector<double> RaySensor::getSensorData() const {
+      countRead();
       std::vector<double> result;
       result.resize(data.size());
       for(unsigned int i=0; i<data.size(); i++) {
@@ -143,10 +124,11 @@ namespace mars {
       return result;
     }
 
-    int RaySensor::getSensorData(double **data_) const {
-      *data_ = (double*)malloc(data.size()*sizeof(double));
+    int RaySensor::readSensorData(double *data_, int size) const {
+      countRead();
+      if(size < (int)data.size()) return data.size();
       for(unsigned int i=0; i<data.size(); i++) {
-        (*data_)[i] = data[i];
+        data_[i] = data[i];
       }
       return data.size();
     }
@@ -154,8 +136,10 @@ namespace mars {
     void RaySensor::receiveData(const data_broker::DataInfo &info,
                                 const data_broker::DataPackage &package,
                                 int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
       CPP_UNUSED(info);
       CPP_UNUSED(callbackParam);
+      if(!beginUpdate()) return;
       long id;
       package.get(0, &id);
 
@@ -181,24 +165,18 @@ namespace mars {
       have_update = true;
     }
 
-    void RaySensor::update(std::vector<draw_item>* drawItems) {
-      unsigned int i;
+    void RaySensor::fillDebugDraw(DebugDrawBuffer *buffer) {
       if(config.draw_rays) {
         if(have_update) {
           control->nodes->updateRay(attached_node);
           have_update = false;
         }
-    
-    
-        if(!(*drawItems)[0].draw_state) {
-          for(i=0; i<data.size(); i++) {
-            (*drawItems)[i].draw_state = DRAW_STATE_UPDATE;
-            (*drawItems)[i].start = position;
-            (*drawItems)[i].end = (orientation * directions[i]);
-            (*drawItems)[i].end *= data[i];
-            
-            (*drawItems)[i].end += (*drawItems)[i].start;
-          }
+
+        const Color color(1.0, 0.0, 0.0, 1.0);
+        for(unsigned int i=0; i<data.size(); i++) {
+          buffer->addLine(position,
+                          position + (orientation * directions[i]) * data[i],
+                          color);
         }
       }
     }
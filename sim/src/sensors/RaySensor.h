@@ -37,7 +37,7 @@
 #include <mars/data_broker/ReceiverInterface.h>
 #include <mars/utils/Vector.h>
 #include <mars/utils/Quaternion.h>
-#include <mars/interfaces/graphics/draw_structs.h>
+#include <mars/interfaces/graphics/DebugDrawInterface.h>
 
 namespace mars {
   namespace sim {
@@ -72,7 +72,7 @@ namespace mars {
       public interfaces::BasePolarIntersectionSensor , 
       public interfaces::SensorInterface, 
       public data_broker::ReceiverInterface,
-      public interfaces::DrawInterface {
+      public interfaces::DebugDrawInterface {
 
     public:
       static interfaces::BaseSensor* instanciate(interfaces::ControlCenter *control,
@@ -80,12 +80,13 @@ namespace mars {
       RaySensor(interfaces::ControlCenter *control, RayConfig config);
       ~RaySensor(void);
   
+      using interfaces::BaseSensor::getSensorData;
       std::vector<double> getSensorData() const; 
-      int getSensorData(double**) const; 
+      int readSensorData(double *data, int size) const;
       virtual void receiveData(const data_broker::DataInfo &info,
                                const data_broker::DataPackage &package,
                                int callbackParam);
-      virtual void update(std::vector<interfaces::draw_item>* drawItems);
+      virtual void fillDebugDraw(interfaces::DebugDrawBuffer *buffer);
 
       static interfaces::BaseConfig* parseConfig(interfaces::ControlCenter *control,
                                                  configmaps::ConfigMap *config);
@@ -37,6 +37,7 @@
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/cfg_manager/CFGManagerInterface.h>
 #include <mars/utils/MutexLocker.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include <envire_core/graph/EnvireGraph.hpp>
 #include <envire_core/items/Item.hpp>
@@ -67,6 +68,7 @@ namespace mars {
     SensorInterface(control),
     config(config){
       setFixedParameters();
+      demandDriven = true;
       validateConfigVals();
       setConfigBasedParameters();
       dataBrokerSetup();
@@ -168,7 +170,6 @@ namespace mars {
      double h_angle_cur = 0.0;
      double v_angle_cur = 0.0;
      utils::Vector tmp;
-     drawStruct draw;
      for(int b=0; b<config.bands; ++b) {
        h_angle_cur = b*hAngle - config.opening_width / 2.0 + config.horizontal_offset;
        for(int l=0; l<config.lasers; ++l) {
@@ -177,42 +178,18 @@ namespace mars {
            Eigen::AngleAxisd(v_angle_cur, Eigen::Vector3d::UnitY()) *
            Vector(1,0,0);
          directions.push_back(tmp);
-         // Add a drawing item for each ray regarding the initial sensor orientation.
-         if(config.draw_rays) {
-           pushDrawRayItem(tmp, draw);
-         }
        }
      }
-     // GraphicsManager crashes if default constructor drawStruct is passed.
      if(config.draw_rays) {
-       if(control->graphics) {
-         control->graphics->addDrawItems(&draw);
+       if(control->sim) {
+         control->sim->addPhysicsDebugDrawInterface(this);
        }
      }
    }
    
-   void RotatingRaySensor::pushDrawRayItem(const Vector &tmp, drawStruct &draw){
-     draw_item item;
-     draw.ptr_draw = (DrawInterface*)this;
-     item.id = 0;
-     item.type = DRAW_LINE;
-     item.draw_state = DRAW_STATE_CREATE;
-     item.point_size = 1;
-     item.myColor.r = 1;
-     item.myColor.g = 0;
-     item.myColor.b = 0;
-     item.myColor.a = 1;
-     item.texture = "";
-     item.t_width = item.t_height = 0;
-     item.get_light = 0.0;
-     // Initial vector length is set to 1.0
-     item.start = position;
-     item.end = orientation * tmp;
-     draw.drawItems.push_back(item);
-   }
-
     RotatingRaySensor::~RotatingRaySensor(void) {
-      control->graphics->removeDrawItems((DrawInterface*)this);
+      if(control->sim)
+        control->sim->removePhysicsDebugDrawInterface(this);
       control->dataBroker->unregisterTimedReceiver(this, "*", "*", "mars_sim/simTimer");
       closeThread = true;
       this->wait();
@@ -221,6 +198,7 @@ namespace mars {
     // This is the method that is used in the orogen task.
     // We may implement a similar one, or extend it to return also a DepthMap
     bool RotatingRaySensor::getPointcloud(std::vector<utils::Vector>& pcloud) {
+      countRead();
       mars::utils::MutexLocker lock(&mutex_pointcloud);
       bool result = false;
       if(full_scan) {
@@ -246,6 +224,7 @@ namespace mars {
 
 
     bool RotatingRaySensor::getDepthMap(base::samples::DepthMap &depthMap) {
+      countRead();
       mars::utils::MutexLocker lock(&mutex_pointcloud);
       if(full_scan) {
         if (!(config.provide_pointcloud))
@@ -274,15 +253,18 @@ namespace mars {
       }
     }
     
-    // Copies into data the full pointcloud. 
-    // I guess here what has to be copied now is the DepthMap
-    // TODO Ask Malte what this method is for
-    // Seems not to be executed in our use case. The trace is never shown
-    int RotatingRaySensor::getSensorData(double** data_) const {
-      LOG_DEBUG("Executing getSensorData");       
+    // Copies the last full pointcloud into data as x, y, z triples.
+    int RotatingRaySensor::readSensorData(double* data_, int size) const {
+      countRead();
       mars::utils::MutexLocker lock(&mutex_pointcloud);
-      *data_ = (double*)malloc(pointcloud_full.size()*3*sizeof(double));
-      return pointcloud_full.size();
+      int n = pointcloud_full.size()*3;
+      if(size < n) return n;
+      for(size_t i=0; i<pointcloud_full.size(); ++i) {
+        *(data_++) = pointcloud_full[i].x();
+        *(data_++) = pointcloud_full[i].y();
+        *(data_++) = pointcloud_full[i].z();
+      }
+      return n;
     }
       
     void RotatingRaySensor::getCurrentPose(const data_broker::DataPackage &package){
@@ -314,8 +296,10 @@ namespace mars {
     void RotatingRaySensor::receiveData(const data_broker::DataInfo &info,
                                 const data_broker::DataPackage &package,
                                 int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
       CPP_UNUSED(info);
       CPP_UNUSED(callbackParam);
+      if(!beginUpdate()) return;
       long id;
       package.get(0, &id);
       getCurrentPose(package);
@@ -368,24 +352,19 @@ namespace mars {
       update_available = true;
     }
 
-    void RotatingRaySensor::update(std::vector<draw_item>* drawItems) {
-
-      unsigned int i;
+    void RotatingRaySensor::fillDebugDraw(DebugDrawBuffer *buffer) {
 
       if(update_available) {
         control->nodes->updateRay(attached_node);
         update_available = false;
       }
       if(config.draw_rays) {
-        if(!(*drawItems)[0].draw_state) {
-          for(i=0; i<data.size(); i++) {
-              (*drawItems)[i].draw_state = DRAW_STATE_UPDATE;
-              // Updates the rays using the current sensor pose. 
-              (*drawItems)[i].start = position;
-              (*drawItems)[i].end = (orientation * orientation_offset * directions[i]);
-              (*drawItems)[i].end *= data[i];
-              (*drawItems)[i].end += (*drawItems)[i].start;
-          }
+        // Updates the rays using the current sensor pose.
+        const Color color(1.0, 0.0, 0.0, 1.0);
+        const utils::Quaternion rotation = orientation * orientation_offset;
+        for(unsigned int i=0; i<data.size(); i++) {
+          buffer->addLine(position, position + (rotation * directions[i]) * data[i],
+                          color);
         }
       }
     }
@@ -409,7 +388,13 @@ namespace mars {
           toDepthMap = &partialDepthMaps1;
           nextCloud = 2;
         }
-        convertPointCloud = true;
+        // the thread finishes the scan at an arbitrary step, deterministic
+        // runs convert it right away with the pose of this step
+        if(control->sim->isDeterministic()) {
+          convertFullScan();
+        } else {
+          convertPointCloud = true;
+        }
         turning_offset = 0;
       }
       orientation_offset = utils::angleAxisToQuaternion(turning_offset, utils::Vector(0.0, 0.0, 1.0));
@@ -481,19 +466,24 @@ namespace mars {
       finalDepthMap.horizontal_size = finalDepthMap.timestamps.size();
     }
 
+    void RotatingRaySensor::convertFullScan() {
+      if (config.provide_pointcloud)
+      {
+        prepareFinalPointcloud();
+      }
+      if (config.provide_depthmap)
+      {
+        prepareFinalDepthMap();
+      }
+      full_scan = true;
+    }
+
     void RotatingRaySensor::run() {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
       while(!closeThread) {
         if(convertPointCloud) { 
-          if (config.provide_pointcloud)
-          {
-            prepareFinalPointcloud();
-          }
-          if (config.provide_depthmap)
-          {
-            prepareFinalDepthMap();
-          }
+          convertFullScan();
           convertPointCloud = false;
-          full_scan = true;
         }
         else msleep(2);
       }
@@ -39,7 +39,7 @@
 #include <mars/utils/Thread.h>
 #include <mars/utils/mathUtils.h>
 #include <mars/utils/Mutex.h>
-#include <mars/interfaces/graphics/draw_structs.h>
+#include <mars/interfaces/graphics/DebugDrawInterface.h>
 
 #include <base/Pose.hpp>
 #include <base/samples/DepthMap.hpp>
@@ -95,7 +95,7 @@ namespace mars {
       public interfaces::BasePolarIntersectionSensor, //->BaseArraySensor ->BaseNodeSensor->BaseSensor
       public interfaces::SensorInterface, // Stores the ControlCenter* control pointer.
       public data_broker::ReceiverInterface,
-      public interfaces::DrawInterface,
+      public interfaces::DebugDrawInterface,
       utils::Thread {
 
     public:
@@ -124,7 +124,7 @@ namespace mars {
        * \warning Memory has to be freed manually!
        * Inherited from BaseSensor, implemented from BasePolarIntersectionSensor.
        */
-      int getSensorData(double**) const; 
+      int readSensorData(double *data, int size) const;
       
       /**
        * The position and rotation indices are used to access the package data
@@ -147,9 +147,9 @@ namespace mars {
       /**
        * Uses the current node pose and the current distances to draw 
        * the laser rays.
-       * Inherited from DrawInterface.
+       * Inherited from DebugDrawInterface.
        */
-      virtual void update(std::vector<interfaces::draw_item>* drawItems);
+      virtual void fillDebugDraw(interfaces::DebugDrawBuffer *buffer);
       
       /**
        * Config methods all part of BaseSensor.
@@ -166,7 +166,7 @@ namespace mars {
        * As soon as a full scan has been done (depends on the number of bands)
        * the pointcloud is copied to pointcloud_full and a new scan
        * is initiated. Runs in the same thread than receiveData, so only the use of 
-       * full_pointcloud (turn(), getPointcloud() and getSensorData()) has to be 
+       * full_pointcloud (turn(), getPointcloud() and readSensorData()) has to be 
        * synchronized.
        */
       utils::Quaternion turn();
@@ -191,9 +191,10 @@ namespace mars {
       void setSensorPos();
       void validateConfigVals();
       void computeRaysDirectionsAndPrepareDraw();
-      void pushDrawRayItem(const utils::Vector &tmp, mars::interfaces::drawStruct &draw);
       void prepareFinalPointcloud();
       void prepareFinalDepthMap();
+      /** Converts the last full scan and marks it as available. */
+      void convertFullScan();
 
     private:
       /** Contains the normalized scan directions. */ 
@@ -28,10 +28,12 @@
 #include <mars/interfaces/sim/MotorManagerInterface.h>
 #include <mars/interfaces/sim/SensorManagerInterface.h>
 #include <mars/utils/mathUtils.h>
+#include <mars/utils/depthUtils.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/sim/LoadCenter.h>
 
 #include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/AllocationTracker.h>
 
 #include "SimMotor.h"
 #include "SimNode.h"
@@ -75,6 +77,9 @@ namespace mars {
       jointID[1] = 0;
       rayID = 0;
       raySensor = 0;
+      gw = 0;
+      gc = 0;
+      cam_window_id = 0;
 
       config.extension -= Vector(0, 0, config.extension[2]/2.0); //Split the Sonar in two parts, to separate fixed and moving part
 
@@ -147,9 +152,18 @@ namespace mars {
         raySensor = dynamic_cast<RaySensor*>(control->sensors->createAndAddSensor("RaySensor",&cfg));
         assert(raySensor);
         rayID = raySensor->getID();
+        // the sonar reads the ray sensor directly
+        control->sensors->addSensorConsumer(rayID);
       }
 
-      if(control->graphics) {
+      // without graphics the ray casting is the only way to get depth
+      rayCast = (config.depthBackend == DEPTH_BACKEND_RAYCAST ||
+                 !control->graphics);
+      if(rayCast) {
+        rayCamera.setup(cols, rows, 3.0/180.0*M_PI, 30.0/180.0*M_PI, 0.5, 100,
+                        config.rayCastThreads);
+      }
+      else {
         hudElementStruct hudCam;
         hudCam.type            = HUD_ELEMENT_TEXTURE;
         hudCam.width           = 420;
@@ -192,8 +206,19 @@ namespace mars {
     }
 
 
-    int ScanningSonar::getSensorData(double ** data) const {
-      if(!gw) return 0;
+    int ScanningSonar::readSensorData(double *data, int size) const {
+      if(!gw && !rayCast) return 0;
+
+      int n;
+      if(raySensor) {
+        // size query, nothing is copied
+        n = raySensor->readSensorData(0, 0)+1;
+      }
+      else {
+        n = (int)(config.maxDist/config.resolution)+1;
+      }
+      // the bins are only computed if they fit into the buffer
+      if(size < n) return n;
 
       SimMotor *motor = control->motors->getSimMotor(motorID);
       //Quaternion q = motor->getJoint()->getAttachedNode2()->getRotation().inverse() * motor->getJoint()->getAttachedNode1()->getRotation();
@@ -203,39 +228,43 @@ namespace mars {
       double bearing = mars::utils::getYaw(q);
 
       if(raySensor){
-        std::vector<double> res = raySensor->getSensorData();
-        (*data) = new double[res.size()+1];
-        memcpy((*data)+1,&res[0],sizeof(double)*res.size());
-        (*data)[0] = bearing;
-        return res.size()+1;
+        raySensor->readSensorData(data+1, size-1);
+        data[0] = bearing;
+        return n;
       }
 
-      (*data) = new double[(int)(config.maxDist/config.resolution)+1];
-      double *res = (*data);
+      const int numBins = n-1;
+      double *res = data;
       int width, height;
-      float *img_data;
-      gw->getRTTDepthData(&img_data, width, height);
-
-
-      res[0] = bearing;
-      for(int i=0;i<config.maxDist/config.resolution;i++){
-        res[i+1] = 0;
+      if(rayCast) {
+        width = rayCamera.getWidth();
+        height = rayCamera.getHeight();
+        depthBuffer.resize(width*height);
+        rayCamera.getDepthImage(control->sim->getPhysics(), head_position,
+                                head_orientation, &depthBuffer[0]);
       }
-
-      for(int x = 0; x < width; x++){
-        for(int y = 0;y < height; y++){
-          double dist = img_data[y+(x*height)];
-          if((int)(dist/config.resolution)+1 < (int)(config.maxDist/config.resolution)+1)
-            res[(int)(dist/config.resolution)+1]++;
-        }
+      else if(depthBuffer.empty()) {
+        // the size of the render target is only known after the first read
+        float *img_data;
+        gw->getRTTDepthData(&img_data, width, height);
+        depthBuffer.assign(img_data, img_data+width*height);
+        free(img_data);
       }
+      else {
+        gw->getRTTDepthData(&depthBuffer[0], width, height);
+        assert((size_t)(width*height) == depthBuffer.size());
+      }
+
+      binBuffer.assign(numBins, 0.f);
+      utils::binDepth(&depthBuffer[0], depthBuffer.size(), config.resolution,
+                      &binBuffer[0], binBuffer.size());
 
-      static int wth = width*height;
-      for(int i=0;i<config.maxDist/config.resolution;i++){
-        res[i+1]= std::min((res[i+1]/wth)*255.0*config.gain,255.0);
+      res[0] = bearing;
+      const double scale = 255.0*config.gain/(width*height);
+      for(int i=0; i<numBins; ++i) {
+        res[i+1] = std::min(binBuffer[i]*scale, 255.0);
       }
-      free(img_data);
-      return config.maxDist/config.resolution;
+      return n;
     }
 
     void ScanningSonar::preGraphicsUpdate(void) {
@@ -244,6 +273,7 @@ namespace mars {
     void ScanningSonar::receiveData(const data_broker::DataInfo &info,
                                     const data_broker::DataPackage &package,
                                     int callbackParam) {
+      utils::AllocationScope allocationScope(utils::ALLOCATION_TAG_SENSORS);
       CPP_UNUSED(info);
       if(dbPosIndices[0] == -1) {
         dbPosIndices[0] = package.getIndexByName("position/x");
@@ -334,6 +364,12 @@ namespace mars {
       if((it = config->find("internal_height")) != config->end())
         cfg->height = it->second;
 
+      if((it = config->find("depth_backend")) != config->end())
+        cfg->depthBackend = depthBackendFromString((std::string)it->second);
+
+      if((it = config->find("raycast_threads")) != config->end())
+        cfg->rayCastThreads = it->second;
+
       if((it = config->find("position")) != config->end()) {
         cfg->position[0] = it->second["x"];
         cfg->position[1] = it->second["y"];
@@ -34,6 +34,10 @@
 #include <mars/interfaces/graphics/GraphicsWindowInterface.h>
 #include <mars/interfaces/graphics/GraphicsUpdateInterface.h>
 
+#include "RayCastDepthCamera.h"
+
+#include <vector>
+
 namespace mars {
 
   namespace graphics {
@@ -67,6 +71,8 @@ namespace mars {
         left_limit = M_PI;
         right_limit = -M_PI;
         ping_pong_mode = false;
+        depthBackend = DEPTH_BACKEND_OPENGL;
+        rayCastThreads = 0;
       }
       unsigned int updateRate;
       unsigned int width;
@@ -85,6 +91,8 @@ namespace mars {
       float left_limit;
       float right_limit;
       bool ping_pong_mode;
+      DepthBackend depthBackend;
+      int rayCastThreads;
     };
 
     class ScanningSonar : public interfaces::BaseCameraSensor<double>,
@@ -99,7 +107,7 @@ namespace mars {
       ScanningSonar(interfaces::ControlCenter *control, ScanningSonarConfig _config);
       ~ScanningSonar(void);
 
-      virtual int getSensorData(double** data) const;
+      virtual int readSensorData(double *data, int size) const;
       virtual void receiveData(const data_broker::DataInfo &info,
                                const data_broker::DataPackage &package,
                                int callbackParam);
@@ -130,6 +138,12 @@ namespace mars {
       utils::Vector head_position;
       unsigned int attached_motor;
       RaySensor *raySensor;
+      // reused between calls of readSensorData
+      mutable std::vector<float> depthBuffer;
+      mutable std::vector<float> binBuffer;
+      // used instead of the graphics if config.depthBackend is raycast
+      bool rayCast;
+      mutable RayCastDepthCamera rayCamera;
     };
 
   } // end of namespace sim
@@ -386,6 +386,26 @@ namespace mars {
             if (physicsmap["ode"].hasKey("stepsize")) {
               control->cfg->setPropertyValue("Simulator", "calc_ms", "value", (sReal)(physicsmap["ode"]["stepsize"]));
             }
+            // "step" or "quickstep"
+            if (physicsmap["ode"].hasKey("solver")) {
+              std::string solver = physicsmap["ode"]["solver"];
+              control->cfg->setPropertyValue("Simulator", "faststep", "value", solver == "quickstep");
+            }
+            if (physicsmap["ode"].hasKey("iterations")) {
+              control->cfg->setPropertyValue("Simulator", "quickstep iterations", "value", (int)(physicsmap["ode"]["iterations"]));
+            }
+            if (physicsmap["ode"].hasKey("sor")) {
+              control->cfg->setPropertyValue("Simulator", "quickstep sor", "value", (sReal)(physicsmap["ode"]["sor"]));
+            }
+            if (physicsmap["ode"].hasKey("adaptive_iterations")) {
+              control->cfg->setPropertyValue("Simulator", "adaptive iterations", "value", (bool)(physicsmap["ode"]["adaptive_iterations"]));
+            }
+            if (physicsmap["ode"].hasKey("max_iterations")) {
+              control->cfg->setPropertyValue("Simulator", "max iterations", "value", (int)(physicsmap["ode"]["max_iterations"]));
+            }
+            if (physicsmap["ode"].hasKey("max_constraint_error")) {
+              control->cfg->setPropertyValue("Simulator", "max constraint error", "value", (sReal)(physicsmap["ode"]["max_constraint_error"]));
+            }
           }
         }
         if (map.hasKey("environment")) {
@@ -38,6 +38,7 @@
 #include <mars/interfaces/ControllerData.h>
 #include <mars/interfaces/terrainStruct.h>
 #include <mars/utils/mathUtils.h>
+#include <mars/utils/MutexLocker.h>
 #include <QWidget>
 #include <mars/main_gui/MainGUI.h>
 
@@ -71,7 +72,7 @@ namespace mars {
     }
 
     Viz::Viz() : lib_manager::LibInterface(new lib_manager::LibManager()),
-                 configDir(".") {
+                 graphics(NULL), configDir("."), jointsDirty(false) {
 #ifdef WIN32
       // request a scheduler of 1ms
       timeBeginPeriod(1);
@@ -79,7 +80,9 @@ namespace mars {
     }
 
     Viz::Viz(lib_manager::LibManager *theManager) : lib_manager::LibInterface(theManager),
-                                                    configDir("."){
+                                                    graphics(NULL),
+                                                    configDir("."),
+                                                    jointsDirty(false) {
 #ifdef WIN32
       // request a scheduler of 1ms
       timeBeginPeriod(1);
@@ -90,6 +93,7 @@ namespace mars {
       //! close simulation
       exit_main(0);
 
+      if(graphics) graphics->removeGraphicsUpdateInterface(this);
       libManager->releaseLibrary("mars_graphics");
       libManager->releaseLibrary("cfg_manager");
 
@@ -156,6 +160,7 @@ namespace mars {
 
       graphics->initializeOSG(NULL, createWindow);
       graphics->hideCoords();
+      graphics->addGraphicsUpdateInterface(this);
 
       coreConfigFile = configDir+"/other_libs.txt";
       control = new ControlCenter();
@@ -189,7 +194,7 @@ namespace mars {
       load.prepareLoad();
       load.parseScene();
 
-      std::map<std::string, ForwardTransform> jointsI;
+      std::map<unsigned long, size_t> jointMapById;
       std::map<unsigned long, NodeData> nodeMapI;
       std::map<unsigned long, NodeData> nodeMapReady;
       std::map<unsigned long, NodeData>::iterator it1;
@@ -368,10 +373,14 @@ namespace mars {
                   else {
                     ft.linear = false;
                   }
-
-                  jointMapByName[jointIt->name] = ft;
-                  jointMapById[ft.jointId] = &jointMapByName[jointIt->name];
-                  jointMapByNodeId[ft.id] = &jointMapByName[jointIt->name];
+                  ft.dirty = false;
+
+                  jointMutex.lock();
+                  size_t jointIdx = joints.size();
+                  jointMapById[ft.jointId] = jointIdx;
+                  jointMapByName[jointIt->name] = jointIdx;
+                  joints.push_back(ft);
+                  jointMutex.unlock();
                   graphics->makeChild(it1->second.index, it2->second.index);
                   graphics->setDrawObjectPos(node.index, node.pos);
                   graphics->setDrawObjectRot(node.index, node.rot);
@@ -390,7 +399,7 @@ namespace mars {
                                                   data_broker::DATA_PACKAGE_READ_WRITE_FLAG);
                     control->dataBroker->registerSyncReceiver(this, "viz",
                                                               packageName,
-                                                              ft.id);
+                                                              (int)jointIdx);
                   }
 
                   nodeMapReady[it2->first] = it2->second;
@@ -412,7 +421,10 @@ namespace mars {
           ControllerData controller;
           controller.fromConfigMap(&load.controllerList[0], tmpPath, NULL);
           for(unsigned int i=0; i<controller.motors.size(); ++i) {
-            jointByControllerIdx.push_back(jointMapById[motorMapById[controller.motors[i]].jointIndex]);
+            std::map<unsigned long, size_t>::iterator it;
+            it = jointMapById.find(motorMapById[controller.motors[i]].jointIndex);
+            assert(it != jointMapById.end());
+            jointByControllerIdx.push_back(it->second);
           }
         }
       }
@@ -425,31 +437,62 @@ namespace mars {
 
 
     void Viz::setJointValue(std::string jointName, double value) {
-      std::map<std::string, ForwardTransform>::iterator it;
+      utils::MutexLocker locker(&jointMutex);
+      std::map<std::string, size_t>::iterator it;
       it = jointMapByName.find(jointName);
       if(it!=jointMapByName.end()) {
-        setJointValue(&jointMapByName[jointName], value);
+        updateJointValue(it->second, value);
       }
     }
 
     void Viz::setJointValue(unsigned int controllerIdx, double value) {
       assert(controllerIdx < jointByControllerIdx.size());
-      setJointValue(jointByControllerIdx[controllerIdx], value);
+      utils::MutexLocker locker(&jointMutex);
+      updateJointValue(jointByControllerIdx[controllerIdx], value);
     }
 
-    void Viz::setJointValue(ForwardTransform *joint, double value) {
-      joint->value = value;
-      if(joint->linear) {
-        utils::Vector v = joint->axis*joint->value + joint->relPos;
-        graphics->setDrawObjectPos(joint->id, joint->anchor+v);
+    void Viz::setJointValues(const std::vector<double> &values) {
+      assert(values.size() <= jointByControllerIdx.size());
+      utils::MutexLocker locker(&jointMutex);
+      for(size_t i=0; i<values.size(); ++i) {
+        updateJointValue(jointByControllerIdx[i], values[i]);
       }
-      else {
-        utils::Quaternion q = utils::angleAxisToQuaternion(joint->value+joint->offset,
-                                                           joint->axis);
-        utils::Vector v = q * joint->relPos;
-        graphics->setDrawObjectPos(joint->id, joint->anchor+v);
-        graphics->setDrawObjectRot(joint->id, q * joint->q);
+    }
+
+    // expects jointMutex to be locked
+    void Viz::updateJointValue(size_t joint, double value) {
+      joints[joint].value = value;
+      joints[joint].dirty = true;
+      jointsDirty = true;
+    }
+
+    void Viz::preGraphicsUpdate(void) {
+      utils::MutexLocker locker(&jointMutex);
+      if(!jointsDirty) return;
+      // The draw objects are children of their parent link, thus every
+      // joint only has to update its local transform.
+      std::vector<ForwardTransform>::iterator it;
+      interfaces::DrawObjectPose pose;
+      jointPoses.clear();
+      for(it=joints.begin(); it!=joints.end(); ++it) {
+        if(!it->dirty) continue;
+        it->dirty = false;
+        pose.id = it->id;
+        if(it->linear) {
+          // sliders keep their rest orientation
+          pose.pos = it->anchor + it->axis*it->value + it->relPos;
+          pose.rot = it->q;
+        }
+        else {
+          utils::Quaternion q = utils::angleAxisToQuaternion(it->value+it->offset,
+                                                             it->axis);
+          pose.pos = it->anchor + q * it->relPos;
+          pose.rot = q * it->q;
+        }
+        jointPoses.push_back(pose);
       }
+      if(!jointPoses.empty()) graphics->setDrawObjectPoses(jointPoses);
+      jointsDirty = false;
     }
 
     void Viz::setNodePosition(const std::string &nodeName, const utils::Vector &pos) {
@@ -481,7 +524,8 @@ namespace mars {
                           int id) {
       double value;
       package.get(0, &value);
-      setJointValue(jointMapByNodeId[id], value);
+      utils::MutexLocker locker(&jointMutex);
+      updateJointValue((size_t)id, value);
       // package.get("force1/x", force);
     }
 
@@ -35,7 +35,10 @@
 #include <lib_manager/LibInterface.hpp>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/NodeData.h>
+#include <mars/interfaces/graphics/GraphicsUpdateInterface.h>
+#include <mars/interfaces/graphics/draw_structs.h>
 #include <mars/data_broker/ReceiverInterface.h>
+#include <mars/utils/Mutex.h>
 
 namespace mars {
 
@@ -50,13 +53,15 @@ namespace mars {
       unsigned long id;
       unsigned long jointId;
       bool linear;
+      bool dirty;
       std::string name;
     };
 
     void exit_main(int signal);
 
     class Viz : public lib_manager::LibInterface,
-                public data_broker::ReceiverInterface {
+                public data_broker::ReceiverInterface,
+                public interfaces::GraphicsUpdateInterface {
     public:
       Viz();
       Viz(lib_manager::LibManager *theManager);
@@ -74,6 +79,18 @@ namespace mars {
       void loadScene(std::string filename, std::string robotname="");
       void setJointValue(std::string jointName, double value);
       void setJointValue(unsigned int controllerIdx, double value);
+      /**
+       * \brief sets all joints of the controller at once
+       *
+       * \a values is ordered like the motors of the loaded controller.
+       * The joint values are only stored here, the draw objects are updated
+       * in one pass before the next frame is rendered.
+       */
+      void setJointValues(const std::vector<double> &values);
+      /** \return the number of values setJointValues takes */
+      size_t getNumControllerJoints() const {
+        return jointByControllerIdx.size();
+      }
       void setNodePosition(const std::string &nodeName,
                            const utils::Vector &pos);
       void setNodePosition(const unsigned long &id, const utils::Vector &pos);
@@ -88,19 +105,27 @@ namespace mars {
                                const data_broker::DataPackage &package,
                                int callbackParam);
 
+      // GraphicsUpdateInterface methods
+      virtual void preGraphicsUpdate(void);
+
 
     private:
       std::string configDir;
 
       std::map<unsigned long, interfaces::NodeData> nodeMapById;
       std::map<std::string, interfaces::NodeData> nodeMapByName;
-      std::map<std::string, ForwardTransform> jointMapByName;
-      std::map<unsigned long, ForwardTransform*> jointMapById;
-      std::map<unsigned long, ForwardTransform*> jointMapByNodeId;
-      std::vector<ForwardTransform*> jointByControllerIdx;
+      // joints in the order they are reached from the root node;
+      // the maps only store indices into this array
+      std::vector<ForwardTransform> joints;
+      std::map<std::string, size_t> jointMapByName;
+      std::vector<size_t> jointByControllerIdx;
+      // protects joints, the values are set from the data broker thread
+      utils::Mutex jointMutex;
+      bool jointsDirty;
+      interfaces::DrawObjectPoseList jointPoses;
       interfaces::ControlCenter *control;
 
-      void setJointValue(ForwardTransform *joint, double value);
+      void updateJointValue(size_t joint, double value);
 
     };
 